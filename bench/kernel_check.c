@@ -0,0 +1,260 @@
+/* GStreamer
+ * Copyright (C) 2021 Allied Vision Technologies GmbH
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2.0 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * Compares the output of every SIMD kernel the CPU supports with its scalar version. Pixel counts and image widths that
+ * are not a multiple of the vector width are checked as well, so the scalar handling of the remaining pixels is
+ * covered. Debayered images are also converted in bands of a few rows to cover the mirrored border rows. Every output
+ * buffer is followed by guard bytes to detect writes past its end. Returns 0 if all kernels produced identical output.
+ */
+
+// The kernels are static, so their sources are compiled into this check directly
+#include "debayer.c"
+#include "unpack.c"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Bytes after every output buffer that must not be written
+#define GUARD_SIZE 64
+#define GUARD_VALUE 0xA5
+
+typedef struct
+{
+    const char *name;
+    bool is_supported;
+    VimbaXUnpackFunction_t unpack_10p;
+    VimbaXUnpackFunction_t unpack_12p;
+} UnpackKernel_t;
+
+typedef struct
+{
+    const char *name;
+    bool is_supported;
+    VimbaXDebayerFunction_t debayer;
+} DebayerKernel_t;
+
+static unsigned int num_failures = 0;
+
+static void fill_random(uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (uint8_t)(rand() & 0xFF);
+    }
+}
+
+static bool is_guard_intact(const uint8_t *guard)
+{
+    for (size_t i = 0; i < GUARD_SIZE; i++)
+    {
+        if (guard[i] != GUARD_VALUE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_unpack(const UnpackKernel_t *kernel, VimbaXPacking_t packing, size_t num_pixels)
+{
+    VimbaXUnpackFunction_t function = packing == VIMBAX_PACKING_10P ? kernel->unpack_10p : kernel->unpack_12p;
+    VimbaXUnpackFunction_t reference = packing == VIMBAX_PACKING_10P ? unpack_10p_scalar : unpack_12p_scalar;
+    // Exactly the packed size, so that reads past the end of the pixel data are found by memory checkers
+    size_t packed_size = (num_pixels * packed_bits_per_pixel(packing) + 7) / 8;
+    uint8_t *src = malloc(packed_size > 0 ? packed_size : 1);
+    uint16_t *expected = malloc(num_pixels * sizeof(uint16_t) + GUARD_SIZE);
+    uint16_t *actual = malloc(num_pixels * sizeof(uint16_t) + GUARD_SIZE);
+    fill_random(src, packed_size);
+    memset(actual, GUARD_VALUE, num_pixels * sizeof(uint16_t) + GUARD_SIZE);
+
+    reference(src, expected, num_pixels);
+    function(src, actual, num_pixels);
+    if (memcmp(expected, actual, num_pixels * sizeof(uint16_t)) != 0 ||
+        !is_guard_intact((const uint8_t *)actual + num_pixels * sizeof(uint16_t)))
+    {
+        printf("FAIL: %s unpack of %u bit packed data differs from scalar version for %zu pixels\n",
+               kernel->name,
+               packed_bits_per_pixel(packing),
+               num_pixels);
+        num_failures++;
+    }
+    free(src);
+    free(expected);
+    free(actual);
+}
+
+static void check_unpack_kernels(void)
+{
+    UnpackKernel_t kernels[] = {
+#if defined(UNPACK_X86_KERNELS)
+        {"SSE4.1", __builtin_cpu_supports("sse4.1"), unpack_10p_sse41, unpack_12p_sse41},
+        {"AVX2", __builtin_cpu_supports("avx2"), unpack_10p_avx2, unpack_12p_avx2},
+#elif defined(UNPACK_NEON_KERNELS)
+        {"NEON", true, unpack_10p_neon, unpack_12p_neon},
+#endif
+        {"scalar", true, unpack_10p_scalar, unpack_12p_scalar}};
+    // Around the vector widths of all kernels and a full image row
+    static const size_t pixel_counts[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 23, 24, 25, 31, 32, 33,
+                                          47, 48, 49, 63, 64, 65, 127, 128, 129, 1000, 1936, 4095};
+
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+    {
+        if (!kernels[i].is_supported)
+        {
+            printf("SKIP: %s unpack kernels are not supported by this CPU\n", kernels[i].name);
+            continue;
+        }
+        for (size_t j = 0; j < sizeof(pixel_counts) / sizeof(pixel_counts[0]); j++)
+        {
+            check_unpack(&kernels[i], VIMBAX_PACKING_10P, pixel_counts[j]);
+            check_unpack(&kernels[i], VIMBAX_PACKING_12P, pixel_counts[j]);
+        }
+        printf("checked %s unpack kernels\n", kernels[i].name);
+    }
+}
+
+// Converts the image with the kernel in bands of band_rows rows, the way the debayer thread pool of the element does
+static void debayer_in_bands(VimbaXDebayerFunction_t function,
+                             const uint8_t *src,
+                             size_t width,
+                             size_t height,
+                             VimbaXBayerPattern_t pattern,
+                             uint8_t *dest,
+                             size_t dest_stride,
+                             VimbaXDebayerOutput_t output,
+                             size_t band_rows)
+{
+    for (size_t first_row = 0; first_row < height; first_row += band_rows)
+    {
+        function(src, width, height, pattern, dest, dest_stride, output, first_row, band_rows);
+    }
+}
+
+static void check_debayer(const DebayerKernel_t *kernel,
+                          size_t width,
+                          size_t height,
+                          VimbaXBayerPattern_t pattern,
+                          VimbaXDebayerOutput_t output,
+                          size_t band_rows)
+{
+    size_t row_size = width * output_pixel_size(output);
+    // Row padding that must stay untouched, followed by the guard bytes after the last row
+    size_t dest_stride = row_size + 3;
+    size_t dest_size = dest_stride * height + GUARD_SIZE;
+    uint8_t *src = malloc(width * height);
+    uint8_t *expected = malloc(dest_size);
+    uint8_t *actual = malloc(dest_size);
+    fill_random(src, width * height);
+    memset(expected, GUARD_VALUE, dest_size);
+    memset(actual, GUARD_VALUE, dest_size);
+
+    debayer_scalar(src, width, height, pattern, expected, dest_stride, output, 0, height);
+    debayer_in_bands(kernel->debayer, src, width, height, pattern, actual, dest_stride, output, band_rows);
+    if (memcmp(expected, actual, dest_size) != 0)
+    {
+        size_t offset = 0;
+        while (expected[offset] == actual[offset])
+        {
+            offset++;
+        }
+        printf("FAIL: %s debayer to %s differs from scalar version for %zux%zu pattern %d in bands of %zu rows "
+               "(first difference in row %zu, byte %zu)\n",
+               kernel->name,
+               debayer_output_gst_format(output),
+               width,
+               height,
+               (int)pattern,
+               band_rows,
+               offset / dest_stride,
+               offset % dest_stride);
+        num_failures++;
+    }
+    free(src);
+    free(expected);
+    free(actual);
+}
+
+static void check_debayer_kernels(void)
+{
+    DebayerKernel_t kernels[] = {
+#if defined(DEBAYER_X86_KERNELS)
+        {"AVX2", __builtin_cpu_supports("avx2"), debayer_avx2},
+#elif defined(DEBAYER_NEON_KERNELS)
+        {"NEON", true, debayer_neon},
+#endif
+        {"scalar", true, debayer_scalar}};
+    // Around the vector widths of all kernels. Widths below 2 have no horizontal neighbours at all
+    static const size_t widths[] = {1, 2, 3, 4, 15, 16, 17, 18, 31, 32, 33, 34, 35, 63, 64, 65, 66, 97, 130};
+    static const size_t heights[] = {1, 2, 3, 4, 7};
+    static const size_t band_rows[] = {1, 2, 3, 64};
+    static const VimbaXBayerPattern_t patterns[] = {VIMBAX_BAYER_RGGB,
+                                                    VIMBAX_BAYER_GRBG,
+                                                    VIMBAX_BAYER_GBRG,
+                                                    VIMBAX_BAYER_BGGR};
+
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+    {
+        if (!kernels[i].is_supported)
+        {
+            printf("SKIP: %s debayer kernel is not supported by this CPU\n", kernels[i].name);
+            continue;
+        }
+        for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++)
+        {
+            for (size_t h = 0; h < sizeof(heights) / sizeof(heights[0]); h++)
+            {
+                for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+                {
+                    for (int output = 0; output < NUM_DEBAYER_OUTPUTS; output++)
+                    {
+                        for (size_t b = 0; b < sizeof(band_rows) / sizeof(band_rows[0]); b++)
+                        {
+                            check_debayer(&kernels[i],
+                                          widths[w],
+                                          heights[h],
+                                          patterns[p],
+                                          (VimbaXDebayerOutput_t)output,
+                                          band_rows[b]);
+                        }
+                    }
+                }
+            }
+        }
+        printf("checked %s debayer kernel\n", kernels[i].name);
+    }
+}
+
+int main(void)
+{
+#if defined(UNPACK_X86_KERNELS)
+    __builtin_cpu_init();
+#endif
+    srand(1);
+
+    check_unpack_kernels();
+    check_debayer_kernels();
+
+    if (num_failures > 0)
+    {
+        printf("%u checks failed\n", num_failures);
+        return 1;
+    }
+    return 0;
+}
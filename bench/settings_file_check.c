@@ -0,0 +1,163 @@
+/* GStreamer
+ * Copyright (C) 2021 Allied Vision Technologies GmbH
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2.0 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * Parses a settings file as written by VmbSettingsSave (the path is passed as the only argument) and compares the
+ * resulting feature list with the expected one. This covers the module of every section, the value inserted for each
+ * selector entry and the save and restore around every <Selector> element, also for selectors whose value is not part
+ * of the file. Malformed files must be rejected. Returns 0 if all checks passed.
+ */
+
+#include "settings_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+    VimbaXSettingsModule module;
+    VimbaXSettingsOperation operation;
+    const char *name;
+    const char *value;
+} ExpectedFeature;
+
+#define REMOTE VIMBAX_SETTINGS_MODULE_REMOTE_DEVICE
+#define STREAM VIMBAX_SETTINGS_MODULE_STREAM
+#define WRITE VIMBAX_SETTINGS_OPERATION_WRITE
+#define SAVE VIMBAX_SETTINGS_OPERATION_SAVE
+#define RESTORE VIMBAX_SETTINGS_OPERATION_RESTORE
+
+// Features of settings_file_sample.xml in the order they must be applied
+static const ExpectedFeature expected_features[] = {
+    {REMOTE, WRITE, "AcquisitionFrameRateEnable", "true"},
+    {REMOTE, WRITE, "ExposureAuto", "Off"},
+    {REMOTE, WRITE, "ExposureTime", "10000.0"},
+    {REMOTE, WRITE, "GainSelector", "All"},
+    {REMOTE, SAVE, "GainSelector", NULL},
+    {REMOTE, WRITE, "GainSelector", "All"},
+    {REMOTE, WRITE, "Gain", "6.0"},
+    {REMOTE, RESTORE, "GainSelector", NULL},
+    {REMOTE, SAVE, "LineSelector", NULL},
+    {REMOTE, WRITE, "LineSelector", "Line0"},
+    {REMOTE, WRITE, "LineMode", "Input"},
+    {REMOTE, WRITE, "LineSelector", "Line1"},
+    {REMOTE, WRITE, "LineMode", "Output"},
+    {REMOTE, WRITE, "LineSource", "ExposureActive"},
+    {REMOTE, RESTORE, "LineSelector", NULL},
+    {REMOTE, WRITE, "Width", "1936"},
+    {STREAM, WRITE, "StreamBufferHandlingMode", "OldestFirst"}};
+
+static unsigned int num_failures = 0;
+
+static void check_sample_file(const char *path)
+{
+    gchar *contents;
+    gsize length;
+    GError *error = NULL;
+    if (!g_file_get_contents(path, &contents, &length, &error))
+    {
+        printf("FAIL: could not read \"%s\": %s\n", path, error->message);
+        g_clear_error(&error);
+        num_failures++;
+        return;
+    }
+    GArray *features = parse_settings_file(contents, length, &error);
+    g_free(contents);
+    if (features == NULL)
+    {
+        printf("FAIL: could not parse \"%s\": %s\n", path, error->message);
+        g_clear_error(&error);
+        num_failures++;
+        return;
+    }
+
+    if (features->len != G_N_ELEMENTS(expected_features))
+    {
+        printf("FAIL: parsed %u features but expected %zu\n", features->len, G_N_ELEMENTS(expected_features));
+        num_failures++;
+    }
+    for (guint i = 0; i < MIN(features->len, G_N_ELEMENTS(expected_features)); i++)
+    {
+        const VimbaXSettingsFeature *feature = &g_array_index(features, VimbaXSettingsFeature, i);
+        const ExpectedFeature *expected = &expected_features[i];
+        if (feature->module != expected->module ||
+            feature->operation != expected->operation ||
+            strcmp(feature->name, expected->name) != 0 ||
+            g_strcmp0(feature->value, expected->value) != 0)
+        {
+            printf("FAIL: feature %u is \"%s\" = %s (module %d, operation %d) but expected \"%s\" = %s (module %d, "
+                   "operation %d)\n",
+                   i,
+                   feature->name,
+                   feature->value != NULL ? feature->value : "(none)",
+                   feature->module,
+                   feature->operation,
+                   expected->name,
+                   expected->value != NULL ? expected->value : "(none)",
+                   expected->module,
+                   expected->operation);
+            num_failures++;
+        }
+    }
+    free_settings_features(features);
+    printf("checked %s\n", path);
+}
+
+static void check_malformed_files(void)
+{
+    static const char *files[] = {
+        // Not closed
+        "<CameraSettings><RemoteDevice><Selector Name=\"GainSelector\"><EnumEntry Name=\"All\">",
+        // Feature without type
+        "<CameraSettings><Feature Name=\"Gain\">6.0</Feature></CameraSettings>",
+        // Feature type that can not be written individually
+        "<CameraSettings><Feature Name=\"LUTValueAll\" Type=\"Raw\">AAAA</Feature></CameraSettings>",
+        // Selector entry without name
+        "<CameraSettings><Selector Name=\"GainSelector\"><EnumEntry></EnumEntry></Selector></CameraSettings>"};
+    for (gsize i = 0; i < G_N_ELEMENTS(files); i++)
+    {
+        GError *error = NULL;
+        GArray *features = parse_settings_file(files[i], strlen(files[i]), &error);
+        if (features != NULL)
+        {
+            printf("FAIL: malformed settings file was accepted: %s\n", files[i]);
+            free_settings_features(features);
+            num_failures++;
+        }
+        g_clear_error(&error);
+    }
+    printf("checked malformed settings files\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        printf("Usage: %s <settings file>\n", argv[0]);
+        return 1;
+    }
+
+    check_sample_file(argv[1]);
+    check_malformed_files();
+
+    if (num_failures > 0)
+    {
+        printf("%u checks failed\n", num_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1312 @@
+/* GStreamer
+ * Copyright (C) 2021 Allied Vision Technologies GmbH
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2.0 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * Simulated VmbC backend for benchmarking vmbsrc without connected cameras. Implements the subset of the VmbC API used
+ * by the element for a single camera. A generator thread fills queued frames and calls the frame callback at the
+ * configured frame rate (or for every TriggerSoftware command and matching ActionCommand if TriggerMode is On).
+ * Enabled chunks report the frame ID and timestamp of the frame and the current exposure time and gain.
+ *
+ * The simulation is configured with the following environment variables:
+ *   VMBSIM_WIDTH, VMBSIM_HEIGHT       sensor size (default 1920x1080)
+ *   VMBSIM_PIXEL_FORMAT               initial PixelFormat (default Mono8)
+ *   VMBSIM_FRAME_RATE                 initial AcquisitionFrameRate in Hz (default 100)
+ *   VMBSIM_INCOMPLETE_RATIO           fraction of frames reported as incomplete (default 0)
+ *   VMBSIM_LINK_THROUGHPUT            link bandwidth in bytes per second limiting the frame rate (default 0, unlimited)
+ *
+ * Image content is not generated. Only the frame ID is written to the start of each filled buffer so that the cost of
+ * the simulation does not distort measurements of the element itself.
+ */
+
+#include <VmbC/VmbC.h>
+
+#include <glib.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+
+#define SIM_DEFAULT_WIDTH 1920
+#define SIM_DEFAULT_HEIGHT 1080
+#define SIM_DEFAULT_FRAME_RATE 100.0
+// Highest frame rate the simulated sensor supports if the link bandwidth is not limited
+#define SIM_MAX_FRAME_RATE 1000.0
+
+typedef struct
+{
+    const char *name;
+    // Bits per pixel of the packed pixel data
+    VmbUint32_t bits_per_pixel;
+} SimPixelFormat;
+
+static const SimPixelFormat sim_pixel_formats[] = {
+    {"Mono8", 8},
+    {"Mono10", 16},
+    {"Mono10p", 10},
+    {"Mono12", 16},
+    {"Mono12p", 12},
+    {"Mono16", 16},
+    {"BayerGR8", 8},
+    {"BayerRG8", 8},
+    {"BayerGB8", 8},
+    {"BayerBG8", 8},
+    {"BayerRG12", 16},
+    {"BayerRG12p", 12},
+    {"RGB8", 24},
+    {"BGR8", 24},
+    {"YCbCr422_8_CbYCrY", 16}};
+#define NUM_SIM_PIXEL_FORMATS (sizeof(sim_pixel_formats) / sizeof(sim_pixel_formats[0]))
+
+static const char *pixel_format_entries[NUM_SIM_PIXEL_FORMATS + 1];
+static const char *auto_entries[] = {"Off", "Once", "Continuous", NULL};
+static const char *trigger_selector_entries[] = {"FrameStart", "AcquisitionStart", NULL};
+static const char *trigger_mode_entries[] = {"Off", "On", NULL};
+static const char *trigger_source_entries[] = {"Software", "Line0", "Line1", "Action0", NULL};
+static const char *trigger_activation_entries[] = {"RisingEdge", "FallingEdge", "AnyEdge", NULL};
+static const char *chunk_selector_entries[] = {"ExposureTime", "Gain", "FrameID", "LineStatusAll", "Timestamp", NULL};
+
+typedef struct
+{
+    const char *name;
+    VmbFeatureDataType_t type;
+    VmbInt64_t int_value;
+    VmbInt64_t int_min;
+    VmbInt64_t int_max;
+    VmbInt64_t int_increment;
+    double float_value;
+    const char *enum_value;
+    const char **enum_entries;
+} SimFeature;
+
+static SimFeature sim_features[] = {
+    {"Width", VmbFeatureDataInt, SIM_DEFAULT_WIDTH, 8, SIM_DEFAULT_WIDTH, 8, 0, NULL, NULL},
+    {"Height", VmbFeatureDataInt, SIM_DEFAULT_HEIGHT, 8, SIM_DEFAULT_HEIGHT, 2, 0, NULL, NULL},
+    {"OffsetX", VmbFeatureDataInt, 0, 0, 0, 8, 0, NULL, NULL},
+    {"OffsetY", VmbFeatureDataInt, 0, 0, 0, 2, 0, NULL, NULL},
+    {"WidthMax", VmbFeatureDataInt, SIM_DEFAULT_WIDTH, SIM_DEFAULT_WIDTH, SIM_DEFAULT_WIDTH, 1, 0, NULL, NULL},
+    {"HeightMax", VmbFeatureDataInt, SIM_DEFAULT_HEIGHT, SIM_DEFAULT_HEIGHT, SIM_DEFAULT_HEIGHT, 1, 0, NULL, NULL},
+    {"PayloadSize", VmbFeatureDataInt, 0, 0, G_MAXINT32, 1, 0, NULL, NULL},
+    {"DeviceTimestampFrequency", VmbFeatureDataInt, 1000000000, 1000000000, 1000000000, 1, 0, NULL, NULL},
+    {"TimestampLatchValue", VmbFeatureDataInt, 0, 0, G_MAXINT64, 1, 0, NULL, NULL},
+    {"ExposureTime", VmbFeatureDataFloat, 0, 0, 0, 0, 5000.0, NULL, NULL},
+    {"Gain", VmbFeatureDataFloat, 0, 0, 0, 0, 0.0, NULL, NULL},
+    {"AcquisitionFrameRate", VmbFeatureDataFloat, 0, 0, 0, 0, SIM_DEFAULT_FRAME_RATE, NULL, NULL},
+    {"PixelFormat", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "Mono8", pixel_format_entries},
+    {"ExposureAuto", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "Off", auto_entries},
+    {"BalanceWhiteAuto", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "Off", auto_entries},
+    {"TriggerSelector", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "FrameStart", trigger_selector_entries},
+    {"TriggerMode", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "Off", trigger_mode_entries},
+    {"TriggerSource", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "Software", trigger_source_entries},
+    {"TriggerActivation", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "RisingEdge", trigger_activation_entries},
+    {"ChunkSelector", VmbFeatureDataEnum, 0, 0, 0, 0, 0, "ExposureTime", chunk_selector_entries},
+    {"ActionSelector", VmbFeatureDataInt, 0, 0, 0, 1, 0, NULL, NULL},
+    {"ActionDeviceKey", VmbFeatureDataInt, 0, 0, G_MAXUINT32, 1, 0, NULL, NULL},
+    {"ActionGroupKey", VmbFeatureDataInt, 0, 0, G_MAXUINT32, 1, 0, NULL, NULL},
+    {"ActionGroupMask", VmbFeatureDataInt, 0, 0, G_MAXUINT32, 1, 0, NULL, NULL},
+    {"AcquisitionStart", VmbFeatureDataCommand, 0, 0, 0, 0, 0, NULL, NULL},
+    {"AcquisitionStop", VmbFeatureDataCommand, 0, 0, 0, 0, 0, NULL, NULL},
+    {"TimestampLatch", VmbFeatureDataCommand, 0, 0, 0, 0, 0, NULL, NULL},
+    {"TriggerSoftware", VmbFeatureDataCommand, 0, 0, 0, 0, 0, NULL, NULL}};
+#define NUM_SIM_FEATURES (sizeof(sim_features) / sizeof(sim_features[0]))
+
+// Features of the system module (gVmbHandle) used to send action commands. Scheduled action commands are executed
+// immediately
+static SimFeature sim_system_features[] = {
+    {"ActionDeviceKey", VmbFeatureDataInt, 0, 0, G_MAXUINT32, 1, 0, NULL, NULL},
+    {"ActionGroupKey", VmbFeatureDataInt, 0, 0, G_MAXUINT32, 1, 0, NULL, NULL},
+    {"ActionGroupMask", VmbFeatureDataInt, 0, 0, G_MAXUINT32, 1, 0, NULL, NULL},
+    {"ActionScheduledTime", VmbFeatureDataInt, 0, 0, G_MAXINT64, 1, 0, NULL, NULL},
+    {"ActionCommand", VmbFeatureDataCommand, 0, 0, 0, 0, 0, NULL, NULL}};
+#define NUM_SIM_SYSTEM_FEATURES (sizeof(sim_system_features) / sizeof(sim_system_features[0]))
+
+typedef struct
+{
+    const SimFeature *feature;
+    VmbInvalidationCallback callback;
+    void *user_context;
+} SimInvalidationCallback;
+
+// Markers whose addresses serve as handles of the simulated camera and its stream
+static char camera_handle_marker;
+static char stream_handle_marker;
+#define SIM_CAMERA_HANDLE ((VmbHandle_t)&camera_handle_marker)
+#define SIM_STREAM_HANDLE ((VmbHandle_t)&stream_handle_marker)
+static VmbHandle_t sim_stream_handles[] = {SIM_STREAM_HANDLE};
+static char system_handle_marker;
+const VmbHandle_t gVmbHandle = (VmbHandle_t)&system_handle_marker;
+// Passed to VmbChunkAccessCallbacks. The chunk values are derived from the frame whose chunk data is accessed by the
+// calling thread
+static char chunk_handle_marker;
+#define SIM_CHUNK_HANDLE ((VmbHandle_t)&chunk_handle_marker)
+static GPrivate chunk_access_frame;
+
+static struct
+{
+    GMutex lock;
+    // Signalled when acquisition starts, a trigger arrives or the generator should stop
+    GCond cond;
+    bool is_started;
+    bool is_open;
+    bool is_capturing;
+    bool is_acquiring;
+    bool stop_generator;
+    GThread *generator;
+    // Frames queued via VmbCaptureFrameQueue in order
+    GQueue queued_frames;
+    VmbFrameCallback callback;
+    // Buffers allocated by the simulation for frames announced without buffer (AllocAndAnnounceFrame)
+    GHashTable *allocated_buffers;
+    guint pending_triggers;
+    // Registered SimInvalidationCallback entries
+    GArray *invalidation_callbacks;
+    guint64 frame_id;
+    double incomplete_ratio;
+    double link_throughput;
+    // Stream statistics (Stat* features of the stream module)
+    VmbInt64_t frames_delivered;
+    VmbInt64_t frames_underrun;
+    VmbInt64_t frames_incomplete;
+    bool chunk_mode_active;
+    // Bit i is set if chunk_selector_entries[i] is enabled
+    guint enabled_chunks;
+} sim;
+
+static double env_double(const char *name, double default_value)
+{
+    const char *value = g_getenv(name);
+    return value != NULL ? g_ascii_strtod(value, NULL) : default_value;
+}
+
+static SimFeature *find_feature(VmbHandle_t handle, const char *name)
+{
+    SimFeature *features = sim_features;
+    size_t num_features = NUM_SIM_FEATURES;
+    if (handle == gVmbHandle)
+    {
+        features = sim_system_features;
+        num_features = NUM_SIM_SYSTEM_FEATURES;
+    }
+    else if (handle != SIM_CAMERA_HANDLE)
+    {
+        return NULL;
+    }
+    if (name == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < num_features; i++)
+    {
+        if (strcmp(features[i].name, name) == 0)
+        {
+            return &features[i];
+        }
+    }
+    return NULL;
+}
+
+// Index of the chunk currently selected by ChunkSelector in chunk_selector_entries
+static guint selected_chunk(void)
+{
+    const char *selector = find_feature(SIM_CAMERA_HANDLE, "ChunkSelector")->enum_value;
+    guint index = 0;
+    while (strcmp(chunk_selector_entries[index], selector) != 0)
+    {
+        index++;
+    }
+    return index;
+}
+
+// Reads chunk values of the frame whose chunk data is accessed. Returns false if the chunk is not enabled
+static bool get_chunk_value(const char *name, VmbInt64_t *int_value, double *float_value)
+{
+    const VmbFrame_t *frame = g_private_get(&chunk_access_frame);
+    if (frame == NULL || name == NULL || strncmp(name, "Chunk", 5) != 0)
+    {
+        return false;
+    }
+    guint index = 0;
+    while (chunk_selector_entries[index] != NULL && strcmp(chunk_selector_entries[index], name + 5) != 0)
+    {
+        index++;
+    }
+    if (chunk_selector_entries[index] == NULL || !(sim.enabled_chunks & (1u << index)))
+    {
+        return false;
+    }
+    // Exposure time and gain are not recorded per frame and reported with their current values
+    if (int_value != NULL && strcmp(name, "ChunkFrameID") == 0)
+    {
+        *int_value = (VmbInt64_t)frame->frameID;
+    }
+    else if (int_value != NULL && strcmp(name, "ChunkTimestamp") == 0)
+    {
+        *int_value = (VmbInt64_t)frame->timestamp;
+    }
+    else if (int_value != NULL && strcmp(name, "ChunkLineStatusAll") == 0)
+    {
+        *int_value = 0;
+    }
+    else if (float_value != NULL && (strcmp(name, "ChunkExposureTime") == 0 || strcmp(name, "ChunkGain") == 0))
+    {
+        *float_value = find_feature(SIM_CAMERA_HANDLE, name + 5)->float_value;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static const SimPixelFormat *find_pixel_format(const char *name)
+{
+    for (size_t i = 0; i < NUM_SIM_PIXEL_FORMATS; i++)
+    {
+        if (strcmp(sim_pixel_formats[i].name, name) == 0)
+        {
+            return &sim_pixel_formats[i];
+        }
+    }
+    return NULL;
+}
+
+static VmbUint32_t payload_size(void)
+{
+    const SimPixelFormat *format = find_pixel_format(find_feature(SIM_CAMERA_HANDLE, "PixelFormat")->enum_value);
+    VmbInt64_t width = find_feature(SIM_CAMERA_HANDLE, "Width")->int_value;
+    VmbInt64_t height = find_feature(SIM_CAMERA_HANDLE, "Height")->int_value;
+    return (VmbUint32_t)((width * height * format->bits_per_pixel + 7) / 8);
+}
+
+// Frame rate the link bandwidth allows for the current payload size
+static double max_frame_rate(void)
+{
+    if (sim.link_throughput <= 0)
+    {
+        return SIM_MAX_FRAME_RATE;
+    }
+    return MIN(sim.link_throughput / MAX(payload_size(), 1), SIM_MAX_FRAME_RATE);
+}
+
+// Calls the invalidation callbacks registered for a feature whose value changed. Must be called without sim.lock held
+static void notify_invalidation(const SimFeature *feature)
+{
+    GArray *callbacks = g_array_new(FALSE, FALSE, sizeof(SimInvalidationCallback));
+    g_mutex_lock(&sim.lock);
+    for (guint i = 0; sim.invalidation_callbacks != NULL && i < sim.invalidation_callbacks->len; i++)
+    {
+        SimInvalidationCallback *entry = &g_array_index(sim.invalidation_callbacks, SimInvalidationCallback, i);
+        if (entry->feature == feature)
+        {
+            g_array_append_val(callbacks, *entry);
+        }
+    }
+    g_mutex_unlock(&sim.lock);
+    for (guint i = 0; i < callbacks->len; i++)
+    {
+        SimInvalidationCallback *entry = &g_array_index(callbacks, SimInvalidationCallback, i);
+        entry->callback(SIM_CAMERA_HANDLE, feature->name, entry->user_context);
+    }
+    g_array_free(callbacks, TRUE);
+}
+
+// Like real cameras the image size, the pixel format and parts of the trigger configuration can not change while
+// acquiring
+static bool is_locked_while_acquiring(const SimFeature *feature)
+{
+    static const char *locked_features[] = {"Width", "Height", "PixelFormat", "TriggerMode", "TriggerSource"};
+    for (size_t i = 0; i < sizeof(locked_features) / sizeof(locked_features[0]); i++)
+    {
+        if (strcmp(feature->name, locked_features[i]) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_trigger_mode_on(void)
+{
+    return strcmp(find_feature(SIM_CAMERA_HANDLE, "TriggerMode")->enum_value, "On") == 0;
+}
+
+// Whether an action command with the keys and mask currently set on the system module triggers the camera
+static bool is_action_command_accepted(void)
+{
+    if (strcmp(find_feature(SIM_CAMERA_HANDLE, "TriggerSource")->enum_value, "Action0") != 0)
+    {
+        return false;
+    }
+    return find_feature(gVmbHandle, "ActionDeviceKey")->int_value ==
+               find_feature(SIM_CAMERA_HANDLE, "ActionDeviceKey")->int_value &&
+           find_feature(gVmbHandle, "ActionGroupKey")->int_value ==
+               find_feature(SIM_CAMERA_HANDLE, "ActionGroupKey")->int_value &&
+           (find_feature(gVmbHandle, "ActionGroupMask")->int_value &
+            find_feature(SIM_CAMERA_HANDLE, "ActionGroupMask")->int_value) != 0;
+}
+
+static gpointer generator_thread(gpointer data)
+{
+    UNUSED(data);
+    GRand *rand = g_rand_new();
+    gint64 next_frame_time = g_get_monotonic_time();
+
+    g_mutex_lock(&sim.lock);
+    while (!sim.stop_generator)
+    {
+        if (!sim.is_acquiring)
+        {
+            g_cond_wait(&sim.cond, &sim.lock);
+            next_frame_time = g_get_monotonic_time();
+            continue;
+        }
+        if (is_trigger_mode_on())
+        {
+            if (sim.pending_triggers == 0)
+            {
+                g_cond_wait(&sim.cond, &sim.lock);
+                continue;
+            }
+            sim.pending_triggers--;
+        }
+        else
+        {
+            double frame_rate = MIN(find_feature(SIM_CAMERA_HANDLE, "AcquisitionFrameRate")->float_value, max_frame_rate());
+            frame_rate = MAX(frame_rate, 0.001);
+            next_frame_time += (gint64)(G_TIME_SPAN_SECOND / frame_rate);
+            gint64 now = g_get_monotonic_time();
+            if (next_frame_time < now)
+            {
+                // Do not try to catch up with frames the generator was too slow for
+                next_frame_time = now;
+            }
+            while (!sim.stop_generator && g_get_monotonic_time() < next_frame_time)
+            {
+                g_cond_wait_until(&sim.cond, &sim.lock, next_frame_time);
+            }
+            if (sim.stop_generator || !sim.is_acquiring)
+            {
+                continue;
+            }
+        }
+
+        VmbFrame_t *frame = g_queue_pop_head(&sim.queued_frames);
+        if (frame == NULL)
+        {
+            // Like a real camera the frame is lost if no buffer is queued
+            sim.frames_underrun++;
+            continue;
+        }
+
+        frame->frameID = sim.frame_id++;
+        frame->timestamp = (VmbUint64_t)g_get_monotonic_time() * 1000;
+        frame->width = (VmbUint32_t)find_feature(SIM_CAMERA_HANDLE, "Width")->int_value;
+        frame->height = (VmbUint32_t)find_feature(SIM_CAMERA_HANDLE, "Height")->int_value;
+        frame->offsetX = (VmbUint32_t)find_feature(SIM_CAMERA_HANDLE, "OffsetX")->int_value;
+        frame->offsetY = (VmbUint32_t)find_feature(SIM_CAMERA_HANDLE, "OffsetY")->int_value;
+        frame->imageData = frame->buffer;
+        frame->receiveFlags = VmbFrameFlagsDimension | VmbFrameFlagsOffset | VmbFrameFlagsFrameID |
+                              VmbFrameFlagsTimestamp | VmbFrameFlagsImageData;
+        frame->chunkDataPresent = sim.chunk_mode_active && sim.enabled_chunks != 0 ? VmbBoolTrue : VmbBoolFalse;
+        if (g_rand_double(rand) < sim.incomplete_ratio)
+        {
+            frame->receiveStatus = VmbFrameStatusIncomplete;
+            sim.frames_incomplete++;
+        }
+        else
+        {
+            frame->receiveStatus = VmbFrameStatusComplete;
+        }
+        if (frame->bufferSize >= sizeof(frame->frameID))
+        {
+            memcpy(frame->buffer, &frame->frameID, sizeof(frame->frameID));
+        }
+        sim.frames_delivered++;
+
+        VmbFrameCallback callback = sim.callback;
+        g_mutex_unlock(&sim.lock);
+        callback(SIM_CAMERA_HANDLE, SIM_STREAM_HANDLE, frame);
+        g_mutex_lock(&sim.lock);
+    }
+    g_mutex_unlock(&sim.lock);
+
+    g_rand_free(rand);
+    return NULL;
+}
+
+VmbError_t VMB_CALL VmbStartup(const VmbFilePathChar_t *pathConfiguration)
+{
+    UNUSED(pathConfiguration);
+    if (sim.is_started)
+    {
+        return VmbErrorSuccess;
+    }
+    g_mutex_init(&sim.lock);
+    g_cond_init(&sim.cond);
+    g_queue_init(&sim.queued_frames);
+    sim.allocated_buffers = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+
+    for (size_t i = 0; i < NUM_SIM_PIXEL_FORMATS; i++)
+    {
+        pixel_format_entries[i] = sim_pixel_formats[i].name;
+    }
+    pixel_format_entries[NUM_SIM_PIXEL_FORMATS] = NULL;
+
+    VmbInt64_t width = (VmbInt64_t)env_double("VMBSIM_WIDTH", SIM_DEFAULT_WIDTH);
+    VmbInt64_t height = (VmbInt64_t)env_double("VMBSIM_HEIGHT", SIM_DEFAULT_HEIGHT);
+    SimFeature *feature = find_feature(SIM_CAMERA_HANDLE, "Width");
+    feature->int_value = feature->int_max = width;
+    feature = find_feature(SIM_CAMERA_HANDLE, "Height");
+    feature->int_value = feature->int_max = height;
+    feature = find_feature(SIM_CAMERA_HANDLE, "WidthMax");
+    feature->int_value = feature->int_min = feature->int_max = width;
+    feature = find_feature(SIM_CAMERA_HANDLE, "HeightMax");
+    feature->int_value = feature->int_min = feature->int_max = height;
+
+    const char *pixel_format = g_getenv("VMBSIM_PIXEL_FORMAT");
+    if (pixel_format != NULL && find_pixel_format(pixel_format) != NULL)
+    {
+        find_feature(SIM_CAMERA_HANDLE, "PixelFormat")->enum_value = find_pixel_format(pixel_format)->name;
+    }
+    find_feature(SIM_CAMERA_HANDLE, "AcquisitionFrameRate")->float_value =
+        env_double("VMBSIM_FRAME_RATE", SIM_DEFAULT_FRAME_RATE);
+    sim.incomplete_ratio = env_double("VMBSIM_INCOMPLETE_RATIO", 0.0);
+    sim.link_throughput = env_double("VMBSIM_LINK_THROUGHPUT", 0.0);
+
+    sim.is_started = true;
+    return VmbErrorSuccess;
+}
+
+void VMB_CALL VmbShutdown(void)
+{
+}
+
+VmbError_t VMB_CALL VmbVersionQuery(VmbVersionInfo_t *versionInfo, VmbUint32_t sizeofVersionInfo)
+{
+    if (versionInfo == NULL || sizeofVersionInfo < sizeof(VmbVersionInfo_t))
+    {
+        return VmbErrorBadParameter;
+    }
+    versionInfo->major = 0;
+    versionInfo->minor = 0;
+    versionInfo->patch = 0;
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbCameraInfoQuery(const char *idString, VmbCameraInfo_t *info, VmbUint32_t sizeofCameraInfo)
+{
+    if (idString == NULL || info == NULL || sizeofCameraInfo < sizeof(VmbCameraInfo_t))
+    {
+        return VmbErrorBadParameter;
+    }
+    memset(info, 0, sizeof(VmbCameraInfo_t));
+    info->cameraIdString = "SIM";
+    info->cameraIdExtended = "SIM";
+    info->cameraName = "Simulated camera";
+    info->modelName = "VmbC simulation";
+    info->serialString = "SIM";
+    info->streamHandles = sim_stream_handles;
+    info->streamCount = 1;
+    info->permittedAccess = VmbAccessModeFull;
+    return VmbErrorSuccess;
+}
+
+// The simulation provides a single camera
+VmbError_t VMB_CALL VmbCamerasList(VmbCameraInfo_t *cameraInfo,
+                                   VmbUint32_t listLength,
+                                   VmbUint32_t *numFound,
+                                   VmbUint32_t sizeofCameraInfo)
+{
+    if (numFound == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    *numFound = 1;
+    if (cameraInfo == NULL)
+    {
+        return VmbErrorSuccess;
+    }
+    if (listLength < 1)
+    {
+        return VmbErrorMoreData;
+    }
+    return VmbCameraInfoQuery("SIM", cameraInfo, sizeofCameraInfo);
+}
+
+VmbError_t VMB_CALL VmbCameraOpen(const char *idString, VmbAccessMode_t accessMode, VmbHandle_t *cameraHandle)
+{
+    UNUSED(accessMode);
+    if (!sim.is_started)
+    {
+        return VmbErrorApiNotStarted;
+    }
+    if (idString == NULL || cameraHandle == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    sim.is_open = true;
+    *cameraHandle = SIM_CAMERA_HANDLE;
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbCameraClose(const VmbHandle_t cameraHandle)
+{
+    if (cameraHandle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    VmbCaptureEnd(cameraHandle);
+    VmbCaptureQueueFlush(cameraHandle);
+    sim.is_open = false;
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureIntGet(VmbHandle_t handle, const char *name, VmbInt64_t *value)
+{
+    if (value == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    if (handle == SIM_STREAM_HANDLE)
+    {
+        // Stream statistics
+        g_mutex_lock(&sim.lock);
+        VmbError_t result = VmbErrorSuccess;
+        if (strcmp(name, "StatFramesDelivered") == 0)
+        {
+            *value = sim.frames_delivered;
+        }
+        else if (strcmp(name, "StatFramesUnderrun") == 0)
+        {
+            *value = sim.frames_underrun;
+        }
+        else if (strcmp(name, "StatFramesIncomplete") == 0)
+        {
+            *value = sim.frames_incomplete;
+        }
+        else
+        {
+            result = VmbErrorNotFound;
+        }
+        g_mutex_unlock(&sim.lock);
+        return result;
+    }
+    if (handle == SIM_CHUNK_HANDLE)
+    {
+        g_mutex_lock(&sim.lock);
+        bool found = get_chunk_value(name, value, NULL);
+        g_mutex_unlock(&sim.lock);
+        return found ? VmbErrorSuccess : VmbErrorNotFound;
+    }
+
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataInt)
+    {
+        return VmbErrorWrongType;
+    }
+    g_mutex_lock(&sim.lock);
+    *value = strcmp(name, "PayloadSize") == 0 ? (VmbInt64_t)payload_size() : feature->int_value;
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureIntRangeQuery(VmbHandle_t handle, const char *name, VmbInt64_t *min, VmbInt64_t *max)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataInt)
+    {
+        return VmbErrorWrongType;
+    }
+    g_mutex_lock(&sim.lock);
+    VmbInt64_t range_max = feature->int_max;
+    if (strcmp(name, "OffsetX") == 0)
+    {
+        range_max = find_feature(handle, "WidthMax")->int_value - find_feature(handle, "Width")->int_value;
+    }
+    else if (strcmp(name, "OffsetY") == 0)
+    {
+        range_max = find_feature(handle, "HeightMax")->int_value - find_feature(handle, "Height")->int_value;
+    }
+    else if (strcmp(name, "Width") == 0)
+    {
+        range_max = find_feature(handle, "WidthMax")->int_value - find_feature(handle, "OffsetX")->int_value;
+    }
+    else if (strcmp(name, "Height") == 0)
+    {
+        range_max = find_feature(handle, "HeightMax")->int_value - find_feature(handle, "OffsetY")->int_value;
+    }
+    g_mutex_unlock(&sim.lock);
+    if (min != NULL)
+    {
+        *min = feature->int_min;
+    }
+    if (max != NULL)
+    {
+        *max = range_max;
+    }
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureIntIncrementQuery(VmbHandle_t handle, const char *name, VmbInt64_t *value)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataInt || value == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    *value = feature->int_increment;
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureIntSet(VmbHandle_t handle, const char *name, VmbInt64_t value)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataInt || strcmp(name, "PayloadSize") == 0)
+    {
+        return VmbErrorWrongType;
+    }
+    VmbInt64_t min;
+    VmbInt64_t max;
+    VmbFeatureIntRangeQuery(handle, name, &min, &max);
+    if (value < min || value > max || (value - min) % feature->int_increment != 0)
+    {
+        return VmbErrorInvalidValue;
+    }
+    g_mutex_lock(&sim.lock);
+    if (is_locked_while_acquiring(feature) && sim.is_acquiring)
+    {
+        g_mutex_unlock(&sim.lock);
+        return VmbErrorInvalidAccess;
+    }
+    bool is_changed = feature->int_value != value;
+    feature->int_value = value;
+    g_mutex_unlock(&sim.lock);
+    if (is_changed)
+    {
+        notify_invalidation(feature);
+    }
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureFloatGet(VmbHandle_t handle, const char *name, double *value)
+{
+    if (handle == SIM_CHUNK_HANDLE)
+    {
+        if (value == NULL)
+        {
+            return VmbErrorBadParameter;
+        }
+        g_mutex_lock(&sim.lock);
+        bool found = get_chunk_value(name, NULL, value);
+        g_mutex_unlock(&sim.lock);
+        return found ? VmbErrorSuccess : VmbErrorNotFound;
+    }
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataFloat || value == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    g_mutex_lock(&sim.lock);
+    *value = feature->float_value;
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureFloatRangeQuery(VmbHandle_t handle, const char *name, double *min, double *max)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataFloat)
+    {
+        return VmbErrorWrongType;
+    }
+    g_mutex_lock(&sim.lock);
+    bool is_frame_rate = strcmp(name, "AcquisitionFrameRate") == 0;
+    if (min != NULL)
+    {
+        *min = is_frame_rate ? 1.0 : 0.0;
+    }
+    if (max != NULL)
+    {
+        *max = is_frame_rate ? max_frame_rate() : G_MAXDOUBLE;
+    }
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureFloatSet(VmbHandle_t handle, const char *name, double value)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataFloat)
+    {
+        return VmbErrorWrongType;
+    }
+    if (value < 0)
+    {
+        return VmbErrorInvalidValue;
+    }
+    g_mutex_lock(&sim.lock);
+    feature->float_value = value;
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureEnumGet(VmbHandle_t handle, const char *name, const char **value)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataEnum || value == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    g_mutex_lock(&sim.lock);
+    *value = feature->enum_value;
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureEnumSet(VmbHandle_t handle, const char *name, const char *value)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataEnum || value == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    for (const char **entry = feature->enum_entries; *entry != NULL; entry++)
+    {
+        if (strcmp(*entry, value) == 0)
+        {
+            g_mutex_lock(&sim.lock);
+            if (is_locked_while_acquiring(feature) && sim.is_acquiring)
+            {
+                g_mutex_unlock(&sim.lock);
+                return VmbErrorInvalidAccess;
+            }
+            // Store the entry itself so the returned strings stay valid
+            bool is_changed = feature->enum_value != *entry;
+            feature->enum_value = *entry;
+            g_cond_broadcast(&sim.cond);
+            g_mutex_unlock(&sim.lock);
+            if (is_changed)
+            {
+                notify_invalidation(feature);
+            }
+            return VmbErrorSuccess;
+        }
+    }
+    return VmbErrorInvalidValue;
+}
+
+VmbError_t VMB_CALL VmbFeatureEnumRangeQuery(VmbHandle_t handle,
+                                             const char *name,
+                                             const char **nameArray,
+                                             VmbUint32_t arrayLength,
+                                             VmbUint32_t *numFound)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataEnum)
+    {
+        return VmbErrorWrongType;
+    }
+    VmbUint32_t count = 0;
+    while (feature->enum_entries[count] != NULL)
+    {
+        count++;
+    }
+    if (numFound != NULL)
+    {
+        *numFound = count;
+    }
+    if (nameArray != NULL)
+    {
+        for (VmbUint32_t i = 0; i < MIN(count, arrayLength); i++)
+        {
+            nameArray[i] = feature->enum_entries[i];
+        }
+        if (arrayLength < count)
+        {
+            return VmbErrorMoreData;
+        }
+    }
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureEnumIsAvailable(VmbHandle_t handle,
+                                              const char *name,
+                                              const char *value,
+                                              VmbBool_t *isAvailable)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataEnum || value == NULL || isAvailable == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    *isAvailable = VmbBoolFalse;
+    for (const char **entry = feature->enum_entries; *entry != NULL; entry++)
+    {
+        if (strcmp(*entry, value) == 0)
+        {
+            *isAvailable = VmbBoolTrue;
+        }
+    }
+    return VmbErrorSuccess;
+}
+
+// Enum entries of simulated features have no integer values of their own, so they are numbered by their position
+VmbError_t VMB_CALL VmbFeatureEnumAsString(VmbHandle_t handle,
+                                           const char *name,
+                                           VmbInt64_t intValue,
+                                           const char **stringValue)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataEnum || stringValue == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    for (VmbInt64_t i = 0; feature->enum_entries[i] != NULL; i++)
+    {
+        if (i == intValue)
+        {
+            *stringValue = feature->enum_entries[i];
+            return VmbErrorSuccess;
+        }
+    }
+    return VmbErrorNotFound;
+}
+
+VmbError_t VMB_CALL VmbFeatureCommandRun(VmbHandle_t handle, const char *name)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataCommand)
+    {
+        return VmbErrorWrongType;
+    }
+    g_mutex_lock(&sim.lock);
+    if (strcmp(name, "AcquisitionStart") == 0)
+    {
+        sim.is_acquiring = true;
+    }
+    else if (strcmp(name, "AcquisitionStop") == 0)
+    {
+        sim.is_acquiring = false;
+        sim.pending_triggers = 0;
+    }
+    else if (strcmp(name, "TimestampLatch") == 0)
+    {
+        find_feature(handle, "TimestampLatchValue")->int_value = g_get_monotonic_time() * 1000;
+    }
+    else if (strcmp(name, "TriggerSoftware") == 0)
+    {
+        sim.pending_triggers++;
+    }
+    else if (strcmp(name, "ActionCommand") == 0 && is_action_command_accepted())
+    {
+        sim.pending_triggers++;
+    }
+    g_cond_broadcast(&sim.cond);
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureBoolSet(VmbHandle_t handle, const char *name, VmbBool_t value)
+{
+    if (name == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    // Scheduled action commands are accepted but executed immediately
+    if (handle == gVmbHandle && strcmp(name, "ActionScheduledTimeEnable") == 0)
+    {
+        return VmbErrorSuccess;
+    }
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorNotFound;
+    }
+    VmbError_t result = VmbErrorSuccess;
+    g_mutex_lock(&sim.lock);
+    if (sim.is_acquiring && (strcmp(name, "ChunkModeActive") == 0 || strcmp(name, "ChunkEnable") == 0))
+    {
+        result = VmbErrorInvalidAccess;
+    }
+    else if (strcmp(name, "ChunkModeActive") == 0)
+    {
+        sim.chunk_mode_active = value == VmbBoolTrue;
+    }
+    else if (strcmp(name, "ChunkEnable") == 0)
+    {
+        if (value == VmbBoolTrue)
+        {
+            sim.enabled_chunks |= 1u << selected_chunk();
+        }
+        else
+        {
+            sim.enabled_chunks &= ~(1u << selected_chunk());
+        }
+    }
+    else
+    {
+        result = VmbErrorNotFound;
+    }
+    g_mutex_unlock(&sim.lock);
+    return result;
+}
+
+VmbError_t VMB_CALL VmbFeatureBoolGet(VmbHandle_t handle, const char *name, VmbBool_t *value)
+{
+    if (handle != SIM_CAMERA_HANDLE || name == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (value == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    VmbError_t result = VmbErrorSuccess;
+    g_mutex_lock(&sim.lock);
+    if (strcmp(name, "ChunkModeActive") == 0)
+    {
+        *value = sim.chunk_mode_active ? VmbBoolTrue : VmbBoolFalse;
+    }
+    else if (strcmp(name, "ChunkEnable") == 0)
+    {
+        *value = (sim.enabled_chunks & (1u << selected_chunk())) ? VmbBoolTrue : VmbBoolFalse;
+    }
+    else
+    {
+        result = VmbErrorNotFound;
+    }
+    g_mutex_unlock(&sim.lock);
+    return result;
+}
+
+// The simulated camera has no string features
+VmbError_t VMB_CALL VmbFeatureStringGet(VmbHandle_t handle,
+                                        const char *name,
+                                        char *buffer,
+                                        VmbUint32_t bufferSize,
+                                        VmbUint32_t *sizeFilled)
+{
+    UNUSED(handle);
+    UNUSED(name);
+    UNUSED(buffer);
+    UNUSED(bufferSize);
+    UNUSED(sizeFilled);
+    return VmbErrorNotFound;
+}
+
+VmbError_t VMB_CALL VmbFeatureStringSet(VmbHandle_t handle, const char *name, const char *value)
+{
+    UNUSED(handle);
+    UNUSED(name);
+    UNUSED(value);
+    return VmbErrorNotFound;
+}
+
+VmbError_t VMB_CALL VmbChunkDataAccess(const VmbFrame_t *frame, VmbChunkAccessCallback chunkAccessCallback, void *userContext)
+{
+    if (frame == NULL || chunkAccessCallback == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    if (!frame->chunkDataPresent)
+    {
+        return VmbErrorNoChunkData;
+    }
+    g_private_set(&chunk_access_frame, (gpointer)frame);
+    VmbError_t result = chunkAccessCallback(SIM_CHUNK_HANDLE, userContext);
+    g_private_set(&chunk_access_frame, NULL);
+    return result;
+}
+
+VmbError_t VMB_CALL VmbFeatureCommandIsDone(VmbHandle_t handle, const char *name, VmbBool_t *isDone)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (feature->type != VmbFeatureDataCommand || isDone == NULL)
+    {
+        return VmbErrorWrongType;
+    }
+    // Commands complete immediately
+    *isDone = VmbBoolTrue;
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureAccessQuery(VmbHandle_t handle,
+                                          const char *name,
+                                          VmbBool_t *isReadable,
+                                          VmbBool_t *isWriteable)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    g_mutex_lock(&sim.lock);
+    bool is_writeable = strcmp(name, "PayloadSize") != 0 && !(is_locked_while_acquiring(feature) && sim.is_acquiring);
+    g_mutex_unlock(&sim.lock);
+    if (isReadable != NULL)
+    {
+        *isReadable = feature->type != VmbFeatureDataCommand;
+    }
+    if (isWriteable != NULL)
+    {
+        *isWriteable = is_writeable;
+    }
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureInvalidationRegister(VmbHandle_t handle,
+                                                   const char *name,
+                                                   VmbInvalidationCallback callback,
+                                                   void *userContext)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    if (callback == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    SimInvalidationCallback entry = {feature, callback, userContext};
+    g_mutex_lock(&sim.lock);
+    if (sim.invalidation_callbacks == NULL)
+    {
+        sim.invalidation_callbacks = g_array_new(FALSE, FALSE, sizeof(SimInvalidationCallback));
+    }
+    g_array_append_val(sim.invalidation_callbacks, entry);
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFeatureInvalidationUnregister(VmbHandle_t handle,
+                                                     const char *name,
+                                                     VmbInvalidationCallback callback)
+{
+    SimFeature *feature = find_feature(handle, name);
+    if (feature == NULL)
+    {
+        return VmbErrorNotFound;
+    }
+    VmbError_t result = VmbErrorNotFound;
+    g_mutex_lock(&sim.lock);
+    for (guint i = 0; sim.invalidation_callbacks != NULL && i < sim.invalidation_callbacks->len; i++)
+    {
+        SimInvalidationCallback *entry = &g_array_index(sim.invalidation_callbacks, SimInvalidationCallback, i);
+        if (entry->feature == feature && entry->callback == callback)
+        {
+            g_array_remove_index(sim.invalidation_callbacks, i);
+            result = VmbErrorSuccess;
+            break;
+        }
+    }
+    g_mutex_unlock(&sim.lock);
+    return result;
+}
+
+VmbError_t VMB_CALL VmbPayloadSizeGet(VmbHandle_t handle, VmbUint32_t *payloadSize)
+{
+    if (handle != SIM_CAMERA_HANDLE && handle != SIM_STREAM_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    if (payloadSize == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    g_mutex_lock(&sim.lock);
+    *payloadSize = payload_size();
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFrameAnnounce(VmbHandle_t handle, const VmbFrame_t *frame, VmbUint32_t sizeofFrame)
+{
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    if (frame == NULL || sizeofFrame < sizeof(VmbFrame_t))
+    {
+        return VmbErrorBadParameter;
+    }
+    if (frame->buffer == NULL)
+    {
+        // Allocate the buffer like the transport layer would. VmbC writes the buffer pointer into the passed frame
+        VmbFrame_t *writable_frame = (VmbFrame_t *)frame;
+        writable_frame->buffer = g_malloc0(frame->bufferSize);
+        g_mutex_lock(&sim.lock);
+        g_hash_table_insert(sim.allocated_buffers, writable_frame, writable_frame->buffer);
+        g_mutex_unlock(&sim.lock);
+    }
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbFrameRevoke(VmbHandle_t handle, const VmbFrame_t *frame)
+{
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    g_mutex_lock(&sim.lock);
+    g_queue_remove(&sim.queued_frames, frame);
+    g_hash_table_remove(sim.allocated_buffers, frame);
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbCaptureStart(VmbHandle_t handle)
+{
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    g_mutex_lock(&sim.lock);
+    if (sim.is_capturing)
+    {
+        g_mutex_unlock(&sim.lock);
+        return VmbErrorInvalidCall;
+    }
+    sim.is_capturing = true;
+    sim.stop_generator = false;
+    g_mutex_unlock(&sim.lock);
+    sim.generator = g_thread_new("vmbc_sim", generator_thread, NULL);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbCaptureEnd(VmbHandle_t handle)
+{
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    g_mutex_lock(&sim.lock);
+    if (!sim.is_capturing)
+    {
+        g_mutex_unlock(&sim.lock);
+        return VmbErrorSuccess;
+    }
+    sim.is_capturing = false;
+    sim.stop_generator = true;
+    g_cond_broadcast(&sim.cond);
+    g_mutex_unlock(&sim.lock);
+    g_thread_join(sim.generator);
+    sim.generator = NULL;
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbCaptureFrameQueue(VmbHandle_t handle, const VmbFrame_t *frame, VmbFrameCallback callback)
+{
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    if (frame == NULL || callback == NULL)
+    {
+        return VmbErrorBadParameter;
+    }
+    g_mutex_lock(&sim.lock);
+    if (!sim.is_capturing)
+    {
+        g_mutex_unlock(&sim.lock);
+        return VmbErrorInvalidCall;
+    }
+    sim.callback = callback;
+    g_queue_push_tail(&sim.queued_frames, (gpointer)frame);
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbCaptureQueueFlush(VmbHandle_t handle)
+{
+    if (handle != SIM_CAMERA_HANDLE)
+    {
+        return VmbErrorBadHandle;
+    }
+    g_mutex_lock(&sim.lock);
+    g_queue_clear(&sim.queued_frames);
+    g_mutex_unlock(&sim.lock);
+    return VmbErrorSuccess;
+}
+
+VmbError_t VMB_CALL VmbSettingsLoad(VmbHandle_t handle,
+                                    const VmbFilePathChar_t *filePath,
+                                    const VmbFeaturePersistSettings_t *settings,
+                                    VmbUint32_t sizeofSettings)
+{
+    UNUSED(filePath);
+    UNUSED(settings);
+    UNUSED(sizeofSettings);
+    // Settings files are not interpreted by the simulation
+    return handle == SIM_CAMERA_HANDLE ? VmbErrorSuccess : VmbErrorBadHandle;
+}
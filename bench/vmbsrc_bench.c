@@ -0,0 +1,212 @@
+/* GStreamer
+ * Copyright (C) 2021 Allied Vision Technologies GmbH
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2.0 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * Benchmark of the vmbsrc element running against the simulated VmbC backend. For every requested output mode a
+ * pipeline "vmbsrc ! fakesink" is run and the sustained throughput, CPU time per frame, resident memory and the delay
+ * between frame callback and push (taken from the "stats" property of vmbsrc) are reported.
+ */
+
+#include <gst/gst.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+GST_PLUGIN_STATIC_DECLARE(vmbsrc);
+
+static gint frames_pushed = 0;
+
+static void on_handoff(GstElement *sink, GstBuffer *buffer, GstPad *pad, gpointer user_data)
+{
+    (void)sink;
+    (void)buffer;
+    (void)pad;
+    (void)user_data;
+    g_atomic_int_inc(&frames_pushed);
+}
+
+// Process CPU time (user and system) in microseconds
+static gint64 get_cpu_time(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (gint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * G_USEC_PER_SEC + usage.ru_utime.tv_usec +
+           usage.ru_stime.tv_usec;
+}
+
+// Current resident memory of the process in bytes
+static guint64 get_resident_memory(void)
+{
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL)
+    {
+        if (fscanf(statm, "%lu %lu", &size, &resident) != 2)
+        {
+            resident = 0;
+        }
+        fclose(statm);
+    }
+    return (guint64)resident * (guint64)sysconf(_SC_PAGESIZE);
+}
+
+static guint64 get_stats_uint64(const GstStructure *stats, const char *field)
+{
+    guint64 value = 0;
+    gst_structure_get_uint64(stats, field, &value);
+    return value;
+}
+
+static guint get_stats_uint(const GstStructure *stats, const char *field)
+{
+    guint value = 0;
+    gst_structure_get_uint(stats, field, &value);
+    return value;
+}
+
+static gboolean run_benchmark(const char *output_mode, const char *element_properties, guint warmup, guint duration)
+{
+    gchar *description = g_strdup_printf(
+        "vmbsrc name=src camera=SIM outputmode=%s %s ! fakesink name=sink sync=false signal-handoffs=true",
+        output_mode,
+        element_properties != NULL ? element_properties : "");
+    GError *error = NULL;
+    GstElement *pipeline = gst_parse_launch(description, &error);
+    g_free(description);
+    if (pipeline == NULL)
+    {
+        g_printerr("Could not create pipeline: %s\n", error != NULL ? error->message : "unknown error");
+        g_clear_error(&error);
+        return FALSE;
+    }
+
+    GstElement *src = gst_bin_get_by_name(GST_BIN(pipeline), "src");
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+    g_signal_connect(sink, "handoff", G_CALLBACK(on_handoff), NULL);
+
+    gboolean success = TRUE;
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    {
+        g_printerr("Could not start pipeline for output mode %s\n", output_mode);
+        success = FALSE;
+    }
+
+    if (success)
+    {
+        g_usleep((gulong)warmup * G_USEC_PER_SEC);
+
+        gint start_frames = g_atomic_int_get(&frames_pushed);
+        gint64 start_cpu = get_cpu_time();
+        gint64 start_time = g_get_monotonic_time();
+
+        g_usleep((gulong)duration * G_USEC_PER_SEC);
+
+        gint64 elapsed = g_get_monotonic_time() - start_time;
+        gint64 cpu = get_cpu_time() - start_cpu;
+        guint frames = (guint)(g_atomic_int_get(&frames_pushed) - start_frames);
+        guint64 resident_memory = get_resident_memory();
+
+        GstStructure *stats = NULL;
+        g_object_get(src, "stats", &stats, NULL);
+
+        GstBus *bus = gst_element_get_bus(pipeline);
+        GstMessage *message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+        if (message != NULL)
+        {
+            gst_message_parse_error(message, &error, NULL);
+            g_printerr("Pipeline error for output mode %s: %s\n", output_mode, error->message);
+            g_clear_error(&error);
+            gst_message_unref(message);
+            success = FALSE;
+        }
+        gst_object_unref(bus);
+
+        g_print("%-10s frames=%u fps=%.1f cpu_per_frame_us=%.1f rss_mib=%.1f "
+                "push_delay_avg_us=%.1f push_delay_p50_us=%.1f push_delay_p99_us=%.1f "
+                "incomplete=%u dropped=%u skipped=%u\n",
+                output_mode,
+                frames,
+                frames * (double)G_USEC_PER_SEC / elapsed,
+                frames > 0 ? (double)cpu / frames : 0.0,
+                resident_memory / (1024.0 * 1024.0),
+                stats != NULL ? get_stats_uint64(stats, "push-delay-average") / 1000.0 : 0.0,
+                stats != NULL ? get_stats_uint64(stats, "push-delay-p50") / 1000.0 : 0.0,
+                stats != NULL ? get_stats_uint64(stats, "push-delay-p99") / 1000.0 : 0.0,
+                stats != NULL ? get_stats_uint(stats, "frames-incomplete") : 0,
+                stats != NULL ? get_stats_uint(stats, "frames-dropped") : 0,
+                stats != NULL ? get_stats_uint(stats, "frames-skipped") : 0);
+        if (stats != NULL)
+        {
+            gst_structure_free(stats);
+        }
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(sink);
+    gst_object_unref(src);
+    gst_object_unref(pipeline);
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    gint warmup = 2;
+    gint duration = 10;
+    gchar *mode = NULL;
+    gchar *element_properties = NULL;
+    GOptionEntry entries[] = {
+        {"warmup", 'w', 0, G_OPTION_ARG_INT, &warmup, "Seconds to run before measuring (default 2)", "S"},
+        {"duration", 'd', 0, G_OPTION_ARG_INT, &duration, "Seconds to measure per output mode (default 10)", "S"},
+        {"mode", 'm', 0, G_OPTION_ARG_STRING, &mode, "Output mode to benchmark (Copy or ZeroCopy). All modes if not given", "MODE"},
+        {"properties", 'p', 0, G_OPTION_ARG_STRING, &element_properties, "Additional vmbsrc properties, e.g. \"numframebuffers=8\"", "PROPS"},
+        {NULL, 0, 0, G_OPTION_ARG_NONE, NULL, NULL, NULL}};
+
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("- benchmark vmbsrc against a simulated camera");
+    g_option_context_add_main_entries(context, entries, NULL);
+    g_option_context_add_group(context, gst_init_get_option_group());
+    if (!g_option_context_parse(context, &argc, &argv, &error))
+    {
+        g_printerr("%s\n", error->message);
+        g_clear_error(&error);
+        g_option_context_free(context);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    gst_init(&argc, &argv);
+    // Registered after gst_init so that it replaces an installed vmbsrc plugin using the real VmbC
+    GST_PLUGIN_STATIC_REGISTER(vmbsrc);
+
+    const char *output_modes[] = {"Copy", "ZeroCopy"};
+    gboolean success = TRUE;
+    for (size_t i = 0; i < sizeof(output_modes) / sizeof(output_modes[0]); i++)
+    {
+        if (mode != NULL && g_ascii_strcasecmp(mode, output_modes[i]) != 0)
+        {
+            continue;
+        }
+        success &= run_benchmark(output_modes[i], element_properties, (guint)MAX(warmup, 0), (guint)MAX(duration, 1));
+    }
+
+    g_free(mode);
+    g_free(element_properties);
+    return success ? 0 : 1;
+}
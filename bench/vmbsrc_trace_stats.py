@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Per-stage latency distributions of the frame trace points of vmbsrc.
+
+Reads either a GStreamer debug log containing the "vmbsrc-frame" tracer records (recorded with
+GST_DEBUG="GST_TRACER:7" GST_DEBUG_FILE=trace.log) or the text output of babeltrace2 for an LTTng
+trace of the vmbsrc:frame tracepoint (babeltrace2 --clock-cycles <trace dir> > trace.txt). The
+plugin must be built with ENABLE_TRACING (and ENABLE_LTTNG for LTTng traces).
+
+Every frame buffer is identified by its address. The time between two consecutive trace points of
+the same frame buffer is attributed to the transition between their stages, e.g. "callback ->
+dequeue" is the time a filled frame waited for the streaming thread.
+
+With --chrome-trace the transitions are additionally written in the Chrome trace event format,
+which can be opened with the Perfetto UI (https://ui.perfetto.dev) or chrome://tracing.
+"""
+
+import argparse
+import collections
+import json
+import re
+import sys
+
+# vmbsrc-frame, element=(string)vmbsrc0, stage=(string)callback, frame=(guint64)94..., frame-id=(guint64)12, ts=(guint64)1234;
+GST_RECORD = re.compile(
+    r"vmbsrc-frame, element=\(string\)\"?(?P<element>[^,\"]+)\"?, stage=\(string\)\"?(?P<stage>[^,\"]+)\"?, "
+    r"frame=\(guint64\)(?P<frame>\d+), frame-id=\(guint64\)(?P<frame_id>\d+), ts=\(guint64\)(?P<ts>\d+);"
+)
+# [1234567890] (+0.000001) host vmbsrc:frame: { cpu_id = 3 }, { element = "vmbsrc0", stage = "callback", frame = 0x..., frame_id = 12 }
+LTTNG_RECORD = re.compile(
+    r"^\[(?P<ts>[\d:.]+)\].*vmbsrc:frame:.*element = \"(?P<element>[^\"]+)\", stage = \"(?P<stage>[^\"]+)\", "
+    r"frame = (?P<frame>0x[0-9a-fA-F]+|\d+), frame_id = (?P<frame_id>\d+)"
+)
+
+
+def lttng_timestamp(text):
+    """Nanoseconds of a babeltrace2 timestamp, either clock cycles or HH:MM:SS.fraction."""
+    if ":" not in text:
+        return int(text)
+    hours, minutes, seconds = text.split(":")
+    whole, _, fraction = seconds.partition(".")
+    nanoseconds = int((fraction + "000000000")[:9])
+    return ((int(hours) * 60 + int(minutes)) * 60 + int(whole)) * 1000000000 + nanoseconds
+
+
+def read_records(lines):
+    """Yields (timestamp in ns, element, stage, frame, frame ID) for every trace point in the input."""
+    for line in lines:
+        match = GST_RECORD.search(line)
+        if match is not None:
+            yield (int(match["ts"]), match["element"], match["stage"], int(match["frame"]), int(match["frame_id"]))
+            continue
+        match = LTTNG_RECORD.search(line)
+        if match is not None:
+            yield (
+                lttng_timestamp(match["ts"]),
+                match["element"],
+                match["stage"],
+                int(match["frame"], 0),
+                int(match["frame_id"]),
+            )
+
+
+def percentile(sorted_values, fraction):
+    index = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", nargs="?", default="-", help="GStreamer debug log or babeltrace2 output (default: stdin)")
+    parser.add_argument("--element", help="only evaluate trace points of the element with this name")
+    parser.add_argument("--chrome-trace", metavar="FILE", help="write the transitions as Chrome trace events to FILE")
+    args = parser.parse_args()
+
+    source = sys.stdin if args.trace == "-" else open(args.trace, errors="replace")
+    with source:
+        records = sorted(record for record in read_records(source) if args.element in (None, record[1]))
+    if not records:
+        sys.exit("No vmbsrc-frame trace points found. Was the plugin built with ENABLE_TRACING?")
+
+    last_point = {}
+    latencies = collections.defaultdict(list)
+    events = []
+    slots = {}
+    pids = {}
+    for timestamp, element, stage, frame, frame_id in records:
+        key = (element, frame)
+        previous = last_point.get(key)
+        last_point[key] = (timestamp, stage)
+        if previous is None:
+            continue
+        transition = "%s -> %s" % (previous[1], stage)
+        latencies[(element, transition)].append(timestamp - previous[0])
+        if args.chrome_trace:
+            events.append(
+                {
+                    "name": transition,
+                    "ph": "X",
+                    "pid": pids.setdefault(element, len(pids)),
+                    "tid": slots.setdefault(key, len(slots)),
+                    "ts": previous[0] / 1000.0,
+                    "dur": (timestamp - previous[0]) / 1000.0,
+                    "args": {"frame-id": frame_id},
+                }
+            )
+
+    print("%-12s %-26s %8s %10s %10s %10s %10s %10s %10s" % ("element", "transition", "count", "min us", "mean us",
+                                                            "p50 us", "p90 us", "p99 us", "max us"))
+    for (element, transition), values in sorted(latencies.items()):
+        values.sort()
+        print(
+            "%-12s %-26s %8d %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f"
+            % (
+                element,
+                transition,
+                len(values),
+                values[0] / 1000.0,
+                sum(values) / len(values) / 1000.0,
+                percentile(values, 0.5) / 1000.0,
+                percentile(values, 0.9) / 1000.0,
+                percentile(values, 0.99) / 1000.0,
+                values[-1] / 1000.0,
+            )
+        )
+
+    if args.chrome_trace:
+        # Names the process tracks after the elements
+        for element, pid in pids.items():
+            events.append({"name": "process_name", "ph": "M", "pid": pid, "args": {"name": element}})
+        with open(args.chrome_trace, "w") as output:
+            json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, output)
+
+
+if __name__ == "__main__":
+    main()
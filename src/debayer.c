@@ -0,0 +1,441 @@
+#include "debayer.h"
+
+#include <string.h>
+
+// Same approach as the unpack kernels: SIMD code is compiled with function specific target attributes and selected at
+// runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEBAYER_X86_KERNELS
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define DEBAYER_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+// Converts a single row. prev and next are the rows above and below cur. green_parity is the parity of the columns
+// holding green pixels in this row and red_row tells whether the other pixels of the row are red (or blue)
+typedef void (*DebayerRowFunction_t)(const uint8_t *prev,
+                                     const uint8_t *cur,
+                                     const uint8_t *next,
+                                     uint8_t *dest,
+                                     size_t width,
+                                     unsigned int green_parity,
+                                     bool red_row,
+                                     VimbaXDebayerOutput_t output);
+
+static const char *const debayer_gst_formats[NUM_DEBAYER_OUTPUTS] = {"RGB", "BGRx", "GRAY8"};
+
+static size_t output_pixel_size(VimbaXDebayerOutput_t output)
+{
+    switch (output)
+    {
+    case VIMBAX_DEBAYER_RGB:
+        return 3;
+    case VIMBAX_DEBAYER_BGRX:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+// Rounded average of two values. Averages of four pixels are built from two of these so that the scalar code produces
+// exactly the same result as the vector kernels
+static inline unsigned int average(unsigned int a, unsigned int b)
+{
+    return (a + b + 1) >> 1;
+}
+
+// BT.601 luma with integer weights summing up to 256
+static inline uint8_t luma(unsigned int red, unsigned int green, unsigned int blue)
+{
+    return (uint8_t)((77 * red + 150 * green + 29 * blue + 128) >> 8);
+}
+
+// Bilinear interpolation of the pixels begin to end - 1 of a row. Columns outside of the image are mirrored, which keeps
+// the color of the missing neighbour
+static void debayer_pixels_scalar(const uint8_t *prev,
+                                  const uint8_t *cur,
+                                  const uint8_t *next,
+                                  uint8_t *dest,
+                                  size_t width,
+                                  size_t begin,
+                                  size_t end,
+                                  unsigned int green_parity,
+                                  bool red_row,
+                                  VimbaXDebayerOutput_t output)
+{
+    for (size_t x = begin; x < end; x++)
+    {
+        size_t left = x > 0 ? x - 1 : (width > 1 ? 1 : 0);
+        size_t right = x + 1 < width ? x + 1 : (width > 1 ? width - 2 : 0);
+        unsigned int horizontal = average(cur[left], cur[right]);
+        unsigned int vertical = average(prev[x], next[x]);
+        unsigned int green, row_color, other_color;
+        if ((x & 1) == green_parity)
+        {
+            green = cur[x];
+            row_color = horizontal;
+            other_color = vertical;
+        }
+        else
+        {
+            green = average(horizontal, vertical);
+            row_color = cur[x];
+            other_color = average(average(prev[left], prev[right]), average(next[left], next[right]));
+        }
+        unsigned int red = red_row ? row_color : other_color;
+        unsigned int blue = red_row ? other_color : row_color;
+
+        switch (output)
+        {
+        case VIMBAX_DEBAYER_RGB:
+            dest[3 * x] = (uint8_t)red;
+            dest[3 * x + 1] = (uint8_t)green;
+            dest[3 * x + 2] = (uint8_t)blue;
+            break;
+        case VIMBAX_DEBAYER_BGRX:
+            dest[4 * x] = (uint8_t)blue;
+            dest[4 * x + 1] = (uint8_t)green;
+            dest[4 * x + 2] = (uint8_t)red;
+            dest[4 * x + 3] = 0xFF;
+            break;
+        default:
+            dest[x] = luma(red, green, blue);
+            break;
+        }
+    }
+}
+
+static void debayer_row_scalar(const uint8_t *prev,
+                               const uint8_t *cur,
+                               const uint8_t *next,
+                               uint8_t *dest,
+                               size_t width,
+                               unsigned int green_parity,
+                               bool red_row,
+                               VimbaXDebayerOutput_t output)
+{
+    debayer_pixels_scalar(prev, cur, next, dest, width, 0, width, green_parity, red_row, output);
+}
+
+static void debayer_rows(DebayerRowFunction_t row_function,
+                         const uint8_t *src,
+                         size_t width,
+                         size_t height,
+                         VimbaXBayerPattern_t pattern,
+                         uint8_t *dest,
+                         size_t dest_stride,
+                         VimbaXDebayerOutput_t output,
+                         size_t first_row,
+                         size_t num_rows)
+{
+    // green columns of the first row and whether it contains red pixels. Both alternate from row to row
+    unsigned int first_green_parity = pattern == VIMBAX_BAYER_RGGB || pattern == VIMBAX_BAYER_BGGR ? 1 : 0;
+    bool first_red_row = pattern == VIMBAX_BAYER_RGGB || pattern == VIMBAX_BAYER_GRBG;
+    for (size_t y = first_row; y < first_row + num_rows && y < height; y++)
+    {
+        // mirrored rows have the same colors as the missing ones
+        size_t above = y > 0 ? y - 1 : (height > 1 ? 1 : 0);
+        size_t below = y + 1 < height ? y + 1 : (height > 1 ? height - 2 : 0);
+        row_function(src + above * width,
+                     src + y * width,
+                     src + below * width,
+                     dest + y * dest_stride,
+                     width,
+                     (first_green_parity + (unsigned int)y) & 1,
+                     ((y & 1) == 0) == first_red_row,
+                     output);
+    }
+}
+
+static void debayer_scalar(const uint8_t *src,
+                           size_t width,
+                           size_t height,
+                           VimbaXBayerPattern_t pattern,
+                           uint8_t *dest,
+                           size_t dest_stride,
+                           VimbaXDebayerOutput_t output,
+                           size_t first_row,
+                           size_t num_rows)
+{
+    debayer_rows(debayer_row_scalar, src, width, height, pattern, dest, dest_stride, output, first_row, num_rows);
+}
+
+#ifdef DEBAYER_X86_KERNELS
+__attribute__((target("avx2"))) static inline __m256i load_avx2(const uint8_t *src)
+{
+    return _mm256_loadu_si256((const __m256i *)src);
+}
+
+// Interleaves 16 pixels into 48 bytes of RGB. Every output vector collects its bytes from all three channels
+__attribute__((target("avx2"))) static void store_rgb_avx2(uint8_t *dest, __m128i red, __m128i green, __m128i blue)
+{
+    const __m128i red_0 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+    const __m128i green_0 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+    const __m128i blue_0 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+    const __m128i red_1 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+    const __m128i green_1 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+    const __m128i blue_1 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+    const __m128i red_2 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+    const __m128i green_2 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+    const __m128i blue_2 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+    _mm_storeu_si128((__m128i *)dest,
+                     _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(red, red_0), _mm_shuffle_epi8(green, green_0)),
+                                  _mm_shuffle_epi8(blue, blue_0)));
+    _mm_storeu_si128((__m128i *)(dest + 16),
+                     _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(red, red_1), _mm_shuffle_epi8(green, green_1)),
+                                  _mm_shuffle_epi8(blue, blue_1)));
+    _mm_storeu_si128((__m128i *)(dest + 32),
+                     _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(red, red_2), _mm_shuffle_epi8(green, green_2)),
+                                  _mm_shuffle_epi8(blue, blue_2)));
+}
+
+// luma of 16 pixels held in 16 bit lanes
+__attribute__((target("avx2"))) static inline __m256i luma_avx2(__m256i red, __m256i green, __m256i blue)
+{
+    __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(red, _mm256_set1_epi16(77)),
+                                   _mm256_mullo_epi16(green, _mm256_set1_epi16(150)));
+    sum = _mm256_add_epi16(sum, _mm256_add_epi16(_mm256_mullo_epi16(blue, _mm256_set1_epi16(29)),
+                                                 _mm256_set1_epi16(128)));
+    return _mm256_srli_epi16(sum, 8);
+}
+
+// Stores 32 interpolated pixels in the output format
+__attribute__((target("avx2"))) static void store_pixels_avx2(uint8_t *dest,
+                                                              __m256i red,
+                                                              __m256i green,
+                                                              __m256i blue,
+                                                              VimbaXDebayerOutput_t output)
+{
+    switch (output)
+    {
+    case VIMBAX_DEBAYER_RGB:
+        store_rgb_avx2(dest, _mm256_castsi256_si128(red), _mm256_castsi256_si128(green), _mm256_castsi256_si128(blue));
+        store_rgb_avx2(dest + 48,
+                       _mm256_extracti128_si256(red, 1),
+                       _mm256_extracti128_si256(green, 1),
+                       _mm256_extracti128_si256(blue, 1));
+        break;
+    case VIMBAX_DEBAYER_BGRX:
+    {
+        // unpack instructions interleave within 128 bit lanes. Swapping the middle 64 bit quarters first makes the low
+        // and high unpack results hold pixels 0-15 and 16-31 in order
+        __m256i b = _mm256_permute4x64_epi64(blue, 0xD8);
+        __m256i g = _mm256_permute4x64_epi64(green, 0xD8);
+        __m256i r = _mm256_permute4x64_epi64(red, 0xD8);
+        const __m256i x = _mm256_set1_epi8(-1);
+        __m256i bg_low = _mm256_unpacklo_epi8(b, g);
+        __m256i bg_high = _mm256_unpackhi_epi8(b, g);
+        __m256i rx_low = _mm256_unpacklo_epi8(r, x);
+        __m256i rx_high = _mm256_unpackhi_epi8(r, x);
+        // pixels 0-3 and 8-11, 4-7 and 12-15, 16-19 and 24-27, 20-23 and 28-31
+        __m256i bgrx_0 = _mm256_unpacklo_epi16(bg_low, rx_low);
+        __m256i bgrx_1 = _mm256_unpackhi_epi16(bg_low, rx_low);
+        __m256i bgrx_2 = _mm256_unpacklo_epi16(bg_high, rx_high);
+        __m256i bgrx_3 = _mm256_unpackhi_epi16(bg_high, rx_high);
+        _mm256_storeu_si256((__m256i *)dest, _mm256_permute2x128_si256(bgrx_0, bgrx_1, 0x20));
+        _mm256_storeu_si256((__m256i *)(dest + 32), _mm256_permute2x128_si256(bgrx_0, bgrx_1, 0x31));
+        _mm256_storeu_si256((__m256i *)(dest + 64), _mm256_permute2x128_si256(bgrx_2, bgrx_3, 0x20));
+        _mm256_storeu_si256((__m256i *)(dest + 96), _mm256_permute2x128_si256(bgrx_2, bgrx_3, 0x31));
+        break;
+    }
+    default:
+    {
+        // packing reverses the lane wise order of the unpack instructions
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i low = luma_avx2(_mm256_unpacklo_epi8(red, zero),
+                                _mm256_unpacklo_epi8(green, zero),
+                                _mm256_unpacklo_epi8(blue, zero));
+        __m256i high = luma_avx2(_mm256_unpackhi_epi8(red, zero),
+                                 _mm256_unpackhi_epi8(green, zero),
+                                 _mm256_unpackhi_epi8(blue, zero));
+        _mm256_storeu_si256((__m256i *)dest, _mm256_packus_epi16(low, high));
+        break;
+    }
+    }
+}
+
+__attribute__((target("avx2"))) static void debayer_row_avx2(const uint8_t *prev,
+                                                             const uint8_t *cur,
+                                                             const uint8_t *next,
+                                                             uint8_t *dest,
+                                                             size_t width,
+                                                             unsigned int green_parity,
+                                                             bool red_row,
+                                                             VimbaXDebayerOutput_t output)
+{
+    size_t pixel_size = output_pixel_size(output);
+    // The first columns need mirrored neighbours. Starting the vector loop at an even column gives every lane the
+    // column parity of its index
+    size_t x = width < 2 ? width : 2;
+    debayer_pixels_scalar(prev, cur, next, dest, width, 0, x, green_parity, red_row, output);
+    const __m256i green_lanes = _mm256_set1_epi16(green_parity == 0 ? 0x00FF : (short)0xFF00);
+    // each step reads one pixel behind its 32 pixels
+    for (; x + 33 <= width; x += 32)
+    {
+        __m256i center = load_avx2(cur + x);
+        __m256i horizontal = _mm256_avg_epu8(load_avx2(cur + x - 1), load_avx2(cur + x + 1));
+        __m256i vertical = _mm256_avg_epu8(load_avx2(prev + x), load_avx2(next + x));
+        __m256i diagonal = _mm256_avg_epu8(_mm256_avg_epu8(load_avx2(prev + x - 1), load_avx2(prev + x + 1)),
+                                           _mm256_avg_epu8(load_avx2(next + x - 1), load_avx2(next + x + 1)));
+        __m256i green = _mm256_blendv_epi8(_mm256_avg_epu8(horizontal, vertical), center, green_lanes);
+        __m256i row_color = _mm256_blendv_epi8(center, horizontal, green_lanes);
+        __m256i other_color = _mm256_blendv_epi8(diagonal, vertical, green_lanes);
+        store_pixels_avx2(dest + x * pixel_size,
+                          red_row ? row_color : other_color,
+                          green,
+                          red_row ? other_color : row_color,
+                          output);
+    }
+    debayer_pixels_scalar(prev, cur, next, dest, width, x, width, green_parity, red_row, output);
+}
+
+static void debayer_avx2(const uint8_t *src,
+                         size_t width,
+                         size_t height,
+                         VimbaXBayerPattern_t pattern,
+                         uint8_t *dest,
+                         size_t dest_stride,
+                         VimbaXDebayerOutput_t output,
+                         size_t first_row,
+                         size_t num_rows)
+{
+    debayer_rows(debayer_row_avx2, src, width, height, pattern, dest, dest_stride, output, first_row, num_rows);
+}
+#endif // DEBAYER_X86_KERNELS
+
+#ifdef DEBAYER_NEON_KERNELS
+static void debayer_row_neon(const uint8_t *prev,
+                             const uint8_t *cur,
+                             const uint8_t *next,
+                             uint8_t *dest,
+                             size_t width,
+                             unsigned int green_parity,
+                             bool red_row,
+                             VimbaXDebayerOutput_t output)
+{
+    size_t pixel_size = output_pixel_size(output);
+    // see the AVX2 kernel for the handling of the first columns
+    size_t x = width < 2 ? width : 2;
+    debayer_pixels_scalar(prev, cur, next, dest, width, 0, x, green_parity, red_row, output);
+    const uint8x16_t green_lanes = vreinterpretq_u8_u16(vdupq_n_u16(green_parity == 0 ? 0x00FF : 0xFF00));
+    for (; x + 17 <= width; x += 16)
+    {
+        uint8x16_t center = vld1q_u8(cur + x);
+        uint8x16_t horizontal = vrhaddq_u8(vld1q_u8(cur + x - 1), vld1q_u8(cur + x + 1));
+        uint8x16_t vertical = vrhaddq_u8(vld1q_u8(prev + x), vld1q_u8(next + x));
+        uint8x16_t diagonal = vrhaddq_u8(vrhaddq_u8(vld1q_u8(prev + x - 1), vld1q_u8(prev + x + 1)),
+                                         vrhaddq_u8(vld1q_u8(next + x - 1), vld1q_u8(next + x + 1)));
+        uint8x16_t green = vbslq_u8(green_lanes, center, vrhaddq_u8(horizontal, vertical));
+        uint8x16_t row_color = vbslq_u8(green_lanes, horizontal, center);
+        uint8x16_t other_color = vbslq_u8(green_lanes, vertical, diagonal);
+        uint8x16_t red = red_row ? row_color : other_color;
+        uint8x16_t blue = red_row ? other_color : row_color;
+        uint8_t *dest_pixels = dest + x * pixel_size;
+        switch (output)
+        {
+        case VIMBAX_DEBAYER_RGB:
+        {
+            uint8x16x3_t rgb = {{red, green, blue}};
+            vst3q_u8(dest_pixels, rgb);
+            break;
+        }
+        case VIMBAX_DEBAYER_BGRX:
+        {
+            uint8x16x4_t bgrx = {{blue, green, red, vdupq_n_u8(0xFF)}};
+            vst4q_u8(dest_pixels, bgrx);
+            break;
+        }
+        default:
+        {
+            uint16x8_t low = vmull_u8(vget_low_u8(red), vdup_n_u8(77));
+            low = vmlal_u8(low, vget_low_u8(green), vdup_n_u8(150));
+            low = vmlal_u8(low, vget_low_u8(blue), vdup_n_u8(29));
+            uint16x8_t high = vmull_u8(vget_high_u8(red), vdup_n_u8(77));
+            high = vmlal_u8(high, vget_high_u8(green), vdup_n_u8(150));
+            high = vmlal_u8(high, vget_high_u8(blue), vdup_n_u8(29));
+            // rounding shift to match the scalar luma
+            vst1q_u8(dest_pixels, vcombine_u8(vrshrn_n_u16(low, 8), vrshrn_n_u16(high, 8)));
+            break;
+        }
+        }
+    }
+    debayer_pixels_scalar(prev, cur, next, dest, width, x, width, green_parity, red_row, output);
+}
+
+static void debayer_neon(const uint8_t *src,
+                         size_t width,
+                         size_t height,
+                         VimbaXBayerPattern_t pattern,
+                         uint8_t *dest,
+                         size_t dest_stride,
+                         VimbaXDebayerOutput_t output,
+                         size_t first_row,
+                         size_t num_rows)
+{
+    debayer_rows(debayer_row_neon, src, width, height, pattern, dest, dest_stride, output, first_row, num_rows);
+}
+#endif // DEBAYER_NEON_KERNELS
+
+VimbaXBayerPattern_t bayer_pattern_from_vimbax_format(const char *vimbax_format)
+{
+    // Only 8 bit formats. Deeper formats are passed on as video/x-bayer
+    if (strcmp(vimbax_format, "BayerRG8") == 0)
+    {
+        return VIMBAX_BAYER_RGGB;
+    }
+    if (strcmp(vimbax_format, "BayerGR8") == 0)
+    {
+        return VIMBAX_BAYER_GRBG;
+    }
+    if (strcmp(vimbax_format, "BayerGB8") == 0)
+    {
+        return VIMBAX_BAYER_GBRG;
+    }
+    if (strcmp(vimbax_format, "BayerBG8") == 0)
+    {
+        return VIMBAX_BAYER_BGGR;
+    }
+    return VIMBAX_BAYER_NONE;
+}
+
+const char *debayer_output_gst_format(VimbaXDebayerOutput_t output)
+{
+    return output < NUM_DEBAYER_OUTPUTS ? debayer_gst_formats[output] : NULL;
+}
+
+bool debayer_output_from_gst_format(const char *gst_format, VimbaXDebayerOutput_t *output)
+{
+    for (int i = 0; i < NUM_DEBAYER_OUTPUTS; i++)
+    {
+        if (strcmp(gst_format, debayer_gst_formats[i]) == 0)
+        {
+            *output = (VimbaXDebayerOutput_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+VimbaXDebayerFunction_t get_debayer_function(const char **implementation_name)
+{
+    const char *name = "scalar";
+    VimbaXDebayerFunction_t function = debayer_scalar;
+#if defined(DEBAYER_X86_KERNELS)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        name = "AVX2";
+        function = debayer_avx2;
+    }
+#elif defined(DEBAYER_NEON_KERNELS)
+    name = "NEON";
+    function = debayer_neon;
+#endif
+
+    if (implementation_name != NULL)
+    {
+        *implementation_name = name;
+    }
+    return function;
+}
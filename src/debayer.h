@@ -0,0 +1,54 @@
+#ifndef DEBAYER_H_
+#define DEBAYER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Color filter arrangement of 8 bit Bayer pixel formats, named by the colors of the first two pixels of the first two
+// rows
+typedef enum
+{
+    VIMBAX_BAYER_NONE,
+    VIMBAX_BAYER_RGGB,
+    VIMBAX_BAYER_GRBG,
+    VIMBAX_BAYER_GBRG,
+    VIMBAX_BAYER_BGGR
+} VimbaXBayerPattern_t;
+
+// Formats Bayer image data can be converted to while copying
+typedef enum
+{
+    VIMBAX_DEBAYER_RGB,
+    VIMBAX_DEBAYER_BGRX,
+    VIMBAX_DEBAYER_GRAY8,
+    NUM_DEBAYER_OUTPUTS
+} VimbaXDebayerOutput_t;
+
+// Interpolates the rows first_row to first_row + num_rows - 1 of a Bayer image with width * height pixels and no row
+// padding. dest points at the first row of the complete output image. Rows and columns at the image border are
+// interpolated from mirrored neighbours, so row bands of the same image can be converted independently
+typedef void (*VimbaXDebayerFunction_t)(const uint8_t *src,
+                                        size_t width,
+                                        size_t height,
+                                        VimbaXBayerPattern_t pattern,
+                                        uint8_t *dest,
+                                        size_t dest_stride,
+                                        VimbaXDebayerOutput_t output,
+                                        size_t first_row,
+                                        size_t num_rows);
+
+// Bayer pattern of a VimbaX pixel format. Returns VIMBAX_BAYER_NONE for formats that can not be debayered
+VimbaXBayerPattern_t bayer_pattern_from_vimbax_format(const char *vimbax_format);
+
+// GStreamer video format name of a debayer output
+const char *debayer_output_gst_format(VimbaXDebayerOutput_t output);
+
+// debayer output producing the given GStreamer video format. Returns false if Bayer data can not be converted to it
+bool debayer_output_from_gst_format(const char *gst_format, VimbaXDebayerOutput_t *output);
+
+// select the fastest bilinear debayer implementation the CPU supports. If implementation_name is not NULL it is set to a
+// description of the selected implementation
+VimbaXDebayerFunction_t get_debayer_function(const char **implementation_name);
+
+#endif // DEBAYER_H_
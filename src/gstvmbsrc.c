@@ -34,6 +34,9 @@
 #include "helpers.h"
 #include "vimbax_helpers.h"
 #include "pixelformats.h"
+#include "thread_tuning.h"
+#include "settings_file.h"
+#include "vmbtrace.h"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -45,6 +48,8 @@
 #include <gst/video/video-info.h>
 #include <glib.h>
 
+#include <stdio.h>
+
 #ifdef _WIN32
 #include <stdlib.h>
 #endif
@@ -55,6 +60,27 @@
 static unsigned int vmb_open_count = 0;
 G_LOCK_DEFINE(vmb_open_count);
 
+// Sessions of all cameras opened in this process (camera ID -> GstVmbSrcSession*) and the lock protecting them
+static GHashTable *sessions = NULL;
+static GMutex session_lock;
+
+// Groups of elements with the same "group" property (name -> GstVmbSrcGroup*) and the lock protecting them
+static GHashTable *groups = NULL;
+static GMutex group_lock;
+// Serializes the action command features of the VimbaX system module, which the action threads of all groups write
+static GMutex action_command_lock;
+
+// Pushed into the filled frame queue by gst_vmbsrc_unlock to wake up a create call waiting for a frame
+static VmbFrame_t unlock_sentinel_frame;
+// Pushed into the filled frame queue by update_feature to wake up a create call that has to restart the acquisition
+static VmbFrame_t feature_update_sentinel_frame;
+// Pushed into the filled frame queue by record_thread once recording finished, so that create returns record_result
+static VmbFrame_t record_finished_sentinel_frame;
+// Pushed into the record queue to wait until record_thread wrote all frames before it (see flush_record_queue), and to
+// end record_thread
+static VmbFrame_t record_flush_sentinel_frame;
+static VmbFrame_t record_stop_sentinel_frame;
+
 GST_DEBUG_CATEGORY_STATIC(gst_vmbsrc_debug_category);
 #define GST_CAT_DEFAULT gst_vmbsrc_debug_category
 
@@ -68,9 +94,26 @@ static GstCaps *gst_vmbsrc_get_caps(GstBaseSrc *src, GstCaps *filter);
 static gboolean gst_vmbsrc_set_caps(GstBaseSrc *src, GstCaps *caps);
 static gboolean gst_vmbsrc_start(GstBaseSrc *src);
 static gboolean gst_vmbsrc_stop(GstBaseSrc *src);
+static gboolean gst_vmbsrc_unlock(GstBaseSrc *src);
+static gboolean gst_vmbsrc_unlock_stop(GstBaseSrc *src);
+static gboolean gst_vmbsrc_query(GstBaseSrc *src, GstQuery *query);
+static gboolean gst_vmbsrc_decide_allocation(GstBaseSrc *src, GstQuery *query);
+static gboolean gst_vmbsrc_event(GstBaseSrc *src, GstEvent *event);
+static GstPad *gst_vmbsrc_request_new_pad(GstElement *element,
+                                          GstPadTemplate *templ,
+                                          const gchar *name,
+                                          const GstCaps *caps);
+static void gst_vmbsrc_release_pad(GstElement *element, GstPad *pad);
 
 static GstFlowReturn gst_vmbsrc_create(GstPushSrc *src, GstBuffer **buf);
 
+// Camera features the reported caps depend on. Changes of their values invalidate the cached caps. PixelFormat is not
+// one of them, as the caps list all supported formats and set_caps and get_max_payload_size write it regularly. The
+// exposure time limits the resulting frame rate reported in the caps
+static const char *caps_features[] = {"Width", "Height", "AcquisitionFrameRate", "ExposureTime", "TriggerMode"};
+// Camera features latency queries depend on. Changes of their values drop the cached latency values
+static const char *latency_features[] = {"ExposureTime", "ExposureTimeAbs", "AcquisitionFrameRate", "AcquisitionFrameRateAbs", "TriggerMode"};
+
 enum
 {
     PROP_0,
@@ -89,9 +132,50 @@ enum
     PROP_TRIGGERSOURCE,
     PROP_TRIGGERACTIVATION,
     PROP_INCOMPLETE_FRAME_HANDLING,
-    PROP_ALLOCATION_MODE
+    PROP_ALLOCATION_MODE,
+    PROP_OUTPUT_MODE,
+    PROP_NUM_FRAME_BUFFERS,
+    PROP_ADAPTIVE_FRAME_BUFFERS,
+    PROP_MAX_FRAME_BUFFER_MEMORY,
+    PROP_TIMESTAMP_MODE,
+    PROP_STATS,
+    PROP_STATS_INTERVAL,
+    PROP_PACKED_FORMATS,
+    PROP_GROUP,
+    PROP_ACTION_DEVICE_KEY,
+    PROP_ACTION_GROUP_KEY,
+    PROP_ACTION_GROUP_MASK,
+    PROP_ACTION_COMMAND_RATE,
+    PROP_ACTION_SCHEDULE_DELAY,
+    PROP_CHUNK_MODE,
+    PROP_DELIVERY_MODE,
+    PROP_MAX_FRAME_AGE,
+    PROP_KEEP_OPEN,
+    PROP_CPU_AFFINITY,
+    PROP_THREAD_PRIORITY,
+    PROP_SPIN_WAIT,
+    PROP_DEBAYER,
+    PROP_DEBAYER_THREADS,
+    PROP_BATCH_SIZE,
+    PROP_RECORD_LOCATION,
+    PROP_RECORD_FRAMES,
+    PROP_PINNED_MEMORY,
+    PROP_CAMERA_EVENTS,
+    PROP_FRAME_SKIP,
+    PROP_MAX_FRAMERATE,
+    PROP_BINNING,
+    PROP_DECIMATION
+};
+
+enum
+{
+    SIGNAL_CAMERA_EVENT,
+    SIGNAL_TRIGGER,
+    NUM_SIGNALS
 };
 
+static guint gst_vmbsrc_signals[NUM_SIGNALS] = {0};
+
 /* pad templates */
 static GstStaticPadTemplate gst_vmbsrc_src_template =
     GST_STATIC_PAD_TEMPLATE("src",
@@ -99,6 +183,24 @@ static GstStaticPadTemplate gst_vmbsrc_src_template =
                             GST_PAD_ALWAYS,
                             GST_STATIC_CAPS(
                                 GST_VIDEO_CAPS_MAKE(GST_VIDEO_FORMATS_ALL) ";" GST_BAYER_CAPS_MAKE(GST_BAYER_FORMATS_ALL)));
+// Sub-rectangles of the acquired frames. Only formats with a single plane of whole bytes per pixel can be cropped
+static GstStaticPadTemplate gst_vmbsrc_roi_template =
+    GST_STATIC_PAD_TEMPLATE("roi_%u",
+                            GST_PAD_SRC,
+                            GST_PAD_REQUEST,
+                            GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(GST_VIDEO_FORMATS_ALL)));
+// Frames of additional streams of the camera. Data that can not be described as video is output with the caps
+// "application/x-vmbsrc-stream"
+static GstStaticPadTemplate gst_vmbsrc_stream_template =
+    GST_STATIC_PAD_TEMPLATE("stream_%u",
+                            GST_PAD_SRC,
+                            GST_PAD_REQUEST,
+                            GST_STATIC_CAPS(
+                                GST_VIDEO_CAPS_MAKE(GST_VIDEO_FORMATS_ALL) ";" GST_BAYER_CAPS_MAKE(GST_BAYER_FORMATS_ALL) ";"
+                                "application/x-vmbsrc-stream"));
+
+// Pushed to the queue of filled frames of a stream pad to end its task
+static VmbFrame_t stream_stop_sentinel_frame;
 
 /* Auto exposure modes */
 #define GST_ENUM_EXPOSUREAUTO_MODES (gst_vmbsrc_exposureauto_get_type())
@@ -196,7 +298,7 @@ static GType gst_vmbsrc_triggersource_get_type(void)
         /* The "nick" (last entry) will be used to pass the setting value on to the VimbaX FeatureEnum */
         // Commented out trigger sources require more complex setups and should be performed via XML configuration file
         {GST_VMBSRC_TRIGGERSOURCE_UNCHANGED, "Does not change the currently applied triggersource value on the device", "UNCHANGED"},
-        // {GST_VMBSRC_TRIGGERSOURCE_SOFTWARE, "Specifies that the trigger source will be generated by software using the TriggerSoftware command", "Software"},
+        {GST_VMBSRC_TRIGGERSOURCE_SOFTWARE, "Specifies that the trigger source will be generated by software using the TriggerSoftware command, which is run by the \"trigger\" action signal", "Software"},
         {GST_VMBSRC_TRIGGERSOURCE_LINE0, "Specifies which physical line (or pin) and associated I/O control block to use as external source for the trigger signal", "Line0"},
         {GST_VMBSRC_TRIGGERSOURCE_LINE1, "Specifies which physical line (or pin) and associated I/O control block to use as external source for the trigger signal", "Line1"},
         {GST_VMBSRC_TRIGGERSOURCE_LINE2, "Specifies which physical line (or pin) and associated I/O control block to use as external source for the trigger signal", "Line2"},
@@ -293,6 +395,7 @@ static GType gst_vmbsrc_allocationmode_get_type(void)
     static const GEnumValue allocationmode_values[] = {
         {GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_FRAME, "Allocate buffers in the plugin", "AnnounceFrame"},
         {GST_VMBSRC_ALLOCATION_MODE_ALLOC_AND_ANNOUNCE_FRAME, "Let the transport layer allocate buffers", "AllocAndAnnounceFrame"},
+        {GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS, "Announce buffers of the negotiated buffer pool and pass them downstream without copying", "AnnouncePoolBuffers"},
         {0, NULL, NULL}};
     if (!vmbsrc_allocationmode_type)
     {
@@ -302,15 +405,125 @@ static GType gst_vmbsrc_allocationmode_get_type(void)
     return vmbsrc_allocationmode_type;
 }
 
+/* Output modes */
+#define GST_ENUM_OUTPUTMODE_VALUES (gst_vmbsrc_outputmode_get_type())
+static GType gst_vmbsrc_outputmode_get_type(void)
+{
+    static GType vmbsrc_outputmode_type = 0;
+    static const GEnumValue outputmode_values[] = {
+        {GST_VMBSRC_OUTPUT_MODE_COPY, "Copy the image data of each frame into a newly allocated buffer", "Copy"},
+        {GST_VMBSRC_OUTPUT_MODE_ZERO_COPY, "Pass the frame buffers downstream without copying. Frames are requeued once downstream elements release them", "ZeroCopy"},
+        {0, NULL, NULL}};
+    if (!vmbsrc_outputmode_type)
+    {
+        vmbsrc_outputmode_type =
+            g_enum_register_static("GstVmbSrcOutputModeValues", outputmode_values);
+    }
+    return vmbsrc_outputmode_type;
+}
+
+/* Timestamp modes */
+#define GST_ENUM_TIMESTAMPMODE_VALUES (gst_vmbsrc_timestampmode_get_type())
+static GType gst_vmbsrc_timestampmode_get_type(void)
+{
+    static GType vmbsrc_timestampmode_type = 0;
+    static const GEnumValue timestampmode_values[] = {
+        {GST_VMBSRC_TIMESTAMP_MODE_PIPELINE_CLOCK, "Use the pipeline clock time at which the frame was dequeued", "PipelineClock"},
+        {GST_VMBSRC_TIMESTAMP_MODE_CAMERA, "Map the device timestamp of the frame to the pipeline clock", "Camera"},
+        {0, NULL, NULL}};
+    if (!vmbsrc_timestampmode_type)
+    {
+        vmbsrc_timestampmode_type =
+            g_enum_register_static("GstVmbSrcTimestampModeValues", timestampmode_values);
+    }
+    return vmbsrc_timestampmode_type;
+}
+
+/* Use of packed pixel formats */
+#define GST_ENUM_PACKEDFORMATS_VALUES (gst_vmbsrc_packedformats_get_type())
+static GType gst_vmbsrc_packedformats_get_type(void)
+{
+    static GType vmbsrc_packedformats_type = 0;
+    static const GEnumValue packedformats_values[] = {
+        {GST_VMBSRC_PACKED_FORMATS_AUTO, "Use the packed format if the link bandwidth limits the frame rate of the unpacked format", "Auto"},
+        {GST_VMBSRC_PACKED_FORMATS_NEVER, "Never use packed formats", "Never"},
+        {GST_VMBSRC_PACKED_FORMATS_ALWAYS, "Always use the packed format if the camera supports it", "Always"},
+        {0, NULL, NULL}};
+    if (!vmbsrc_packedformats_type)
+    {
+        vmbsrc_packedformats_type =
+            g_enum_register_static("GstVmbSrcPackedFormatsValues", packedformats_values);
+    }
+    return vmbsrc_packedformats_type;
+}
+
+/* Delivery of filled frames */
+#define GST_ENUM_DELIVERYMODE_VALUES (gst_vmbsrc_deliverymode_get_type())
+static GType gst_vmbsrc_deliverymode_get_type(void)
+{
+    static GType vmbsrc_deliverymode_type = 0;
+    static const GEnumValue deliverymode_values[] = {
+        {GST_VMBSRC_DELIVERY_MODE_FIFO, "Push every frame in the order it was received", "FIFO"},
+        {GST_VMBSRC_DELIVERY_MODE_LATEST, "Push only the newest frame. Older frames that were not pushed yet are requeued when a new frame arrives", "Latest"},
+        {GST_VMBSRC_DELIVERY_MODE_BOUNDED_LATENCY, "Requeue frames that were received longer than \"maxframeage\" ago without pushing them", "BoundedLatency"},
+        {0, NULL, NULL}};
+    if (!vmbsrc_deliverymode_type)
+    {
+        vmbsrc_deliverymode_type =
+            g_enum_register_static("GstVmbSrcDeliveryModeValues", deliverymode_values);
+    }
+    return vmbsrc_deliverymode_type;
+}
+
+/* Chunks attached to buffers as GstVmbFrameMeta. The nicks are the ChunkSelector entries of the chunks */
+#define GST_FLAGS_CHUNKMODE_VALUES (gst_vmbsrc_chunkmode_get_type())
+static GType gst_vmbsrc_chunkmode_get_type(void)
+{
+    static GType vmbsrc_chunkmode_type = 0;
+    static const GFlagsValue chunkmode_values[] = {
+        {GST_VMB_CHUNK_EXPOSURE_TIME, "Exposure time of the frame", "ExposureTime"},
+        {GST_VMB_CHUNK_GAIN, "Gain of the frame", "Gain"},
+        {GST_VMB_CHUNK_FRAME_ID, "Frame ID assigned by the camera", "FrameID"},
+        {GST_VMB_CHUNK_LINE_STATUS_ALL, "Status of all I/O lines at the start of the exposure", "LineStatusAll"},
+        {GST_VMB_CHUNK_TIMESTAMP, "Device timestamp of the frame", "Timestamp"},
+        {0, NULL, NULL}};
+    if (!vmbsrc_chunkmode_type)
+    {
+        vmbsrc_chunkmode_type =
+            g_flags_register_static("GstVmbSrcChunkModeValues", chunkmode_values);
+    }
+    return vmbsrc_chunkmode_type;
+}
+
+/* Camera events forwarded downstream. The nicks are the EventSelector entries of the events */
+#define GST_FLAGS_CAMERAEVENTS_VALUES (gst_vmbsrc_cameraevents_get_type())
+static GType gst_vmbsrc_cameraevents_get_type(void)
+{
+    static GType vmbsrc_cameraevents_type = 0;
+    static const GFlagsValue cameraevents_values[] = {
+        {GST_VMBSRC_CAMERA_EVENT_EXPOSURE_END, "End of the exposure of a frame", "ExposureEnd"},
+        {GST_VMBSRC_CAMERA_EVENT_FRAME_TRIGGER_READY, "Camera is ready to accept the next frame trigger", "FrameTriggerReady"},
+        {0, NULL, NULL}};
+    if (!vmbsrc_cameraevents_type)
+    {
+        vmbsrc_cameraevents_type =
+            g_flags_register_static("GstVmbSrcCameraEventsValues", cameraevents_values);
+    }
+    return vmbsrc_cameraevents_type;
+}
+
 /* class initialization */
 
+static void gst_vmbsrc_child_proxy_init(gpointer g_iface, gpointer iface_data);
+
 G_DEFINE_TYPE_WITH_CODE(GstVmbSrc,
                         gst_vmbsrc,
                         GST_TYPE_PUSH_SRC,
                         GST_DEBUG_CATEGORY_INIT(gst_vmbsrc_debug_category,
                                                 "vmbsrc",
                                                 0,
-                                                "debug category for vmbsrc element"))
+                                                "debug category for vmbsrc element");
+                        G_IMPLEMENT_INTERFACE(GST_TYPE_CHILD_PROXY, gst_vmbsrc_child_proxy_init))
 
 static void gst_vmbsrc_class_init(GstVmbSrcClass *klass)
 {
@@ -318,9 +531,17 @@ static void gst_vmbsrc_class_init(GstVmbSrcClass *klass)
     GstBaseSrcClass *base_src_class = GST_BASE_SRC_CLASS(klass);
     GstPushSrcClass *push_src_class = GST_PUSH_SRC_CLASS(klass);
 
+    GST_VMB_TRACE_INIT();
+
     /* Setting up pads and setting metadata should be moved to base_class_init if you intend to subclass this class. */
     gst_element_class_add_static_pad_template(GST_ELEMENT_CLASS(klass),
                                               &gst_vmbsrc_src_template);
+    gst_element_class_add_static_pad_template_with_gtype(GST_ELEMENT_CLASS(klass),
+                                                         &gst_vmbsrc_roi_template,
+                                                         GST_TYPE_VMB_ROI_PAD);
+    gst_element_class_add_static_pad_template_with_gtype(GST_ELEMENT_CLASS(klass),
+                                                         &gst_vmbsrc_stream_template,
+                                                         GST_TYPE_VMB_STREAM_PAD);
 
     gst_element_class_set_static_metadata(GST_ELEMENT_CLASS(klass),
                                           "VimbaX GStreamer source",
@@ -335,7 +556,14 @@ static void gst_vmbsrc_class_init(GstVmbSrcClass *klass)
     base_src_class->set_caps = GST_DEBUG_FUNCPTR(gst_vmbsrc_set_caps);
     base_src_class->start = GST_DEBUG_FUNCPTR(gst_vmbsrc_start);
     base_src_class->stop = GST_DEBUG_FUNCPTR(gst_vmbsrc_stop);
+    base_src_class->unlock = GST_DEBUG_FUNCPTR(gst_vmbsrc_unlock);
+    base_src_class->unlock_stop = GST_DEBUG_FUNCPTR(gst_vmbsrc_unlock_stop);
+    base_src_class->query = GST_DEBUG_FUNCPTR(gst_vmbsrc_query);
+    base_src_class->decide_allocation = GST_DEBUG_FUNCPTR(gst_vmbsrc_decide_allocation);
+    base_src_class->event = GST_DEBUG_FUNCPTR(gst_vmbsrc_event);
     push_src_class->create = GST_DEBUG_FUNCPTR(gst_vmbsrc_create);
+    GST_ELEMENT_CLASS(klass)->request_new_pad = GST_DEBUG_FUNCPTR(gst_vmbsrc_request_new_pad);
+    GST_ELEMENT_CLASS(klass)->release_pad = GST_DEBUG_FUNCPTR(gst_vmbsrc_release_pad);
 
     // Install properties
     g_object_class_install_property(
@@ -498,33 +726,399 @@ static void gst_vmbsrc_class_init(GstVmbSrcClass *klass)
         g_param_spec_enum(
             "allocationmode",
             "Buffer allocation strategy",
-            "Decides if frame buffers should be allocated by the gstreamer element itself or by the transport layer",
+            "Decides if frame buffers should be allocated by the gstreamer element itself, by the transport layer or taken from the buffer pool negotiated with downstream elements",
             GST_ENUM_ALLOCATIONMODE_VALUES,
             GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_FRAME,
             G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_OUTPUT_MODE,
+        g_param_spec_enum(
+            "outputmode",
+            "Frame output mode",
+            "Decides if image data is copied into new buffers or if the frame buffers themselves are passed downstream. In zero-copy mode image data is copied anyway if too few frame buffers would remain available to the camera",
+            GST_ENUM_OUTPUTMODE_VALUES,
+            GST_VMBSRC_OUTPUT_MODE_COPY,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_NUM_FRAME_BUFFERS,
+        g_param_spec_uint(
+            "numframebuffers",
+            "Number of frame buffers",
+            "Number of frame buffers announced to the camera when acquisition is started. More buffers allow higher frame rates and more frames held by downstream elements in zero-copy mode at the cost of memory",
+            1,
+            MAX_NUM_FRAME_BUFFERS,
+            DEFAULT_NUM_FRAME_BUFFERS,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_ADAPTIVE_FRAME_BUFFERS,
+        g_param_spec_boolean(
+            "adaptiveframebuffers",
+            "Adaptive frame buffers",
+            "Announce additional frame buffers while acquiring if the camera ran out of queued frames or frames arrived incomplete. The memory used for frame buffers is limited by \"maxframebuffermemory\"",
+            FALSE,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_MAX_FRAME_BUFFER_MEMORY,
+        g_param_spec_uint(
+            "maxframebuffermemory",
+            "Maximum frame buffer memory",
+            "Upper limit in MiB for the memory of all announced frame buffers up to which \"adaptiveframebuffers\" may announce additional frames",
+            1,
+            G_MAXUINT,
+            DEFAULT_MAX_FRAME_BUFFER_MEMORY,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_TIMESTAMP_MODE,
+        g_param_spec_enum(
+            "timestampmode",
+            "Timestamp mode",
+            "Decides how buffer timestamps are generated. In camera mode the device timestamp of each frame is mapped to the pipeline clock using a regression over periodically latched camera timestamps. Falls back to the pipeline clock if the camera does not report its timestamp frequency",
+            GST_ENUM_TIMESTAMPMODE_VALUES,
+            GST_VMBSRC_TIMESTAMP_MODE_PIPELINE_CLOCK,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_STATS,
+        g_param_spec_boxed(
+            "stats",
+            "Capture statistics",
+            "Counters of received, incomplete and dropped frames, filled frame queue depth, delays between frame reception and push and between ExposureEnd events and frame reception, and Stat* features reported by the camera and its stream",
+            GST_TYPE_STRUCTURE,
+            G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_STATS_INTERVAL,
+        g_param_spec_uint(
+            "statsinterval",
+            "Statistics interval",
+            "Interval in milliseconds at which the content of \"stats\" is posted as element message on the bus. 0 disables the messages",
+            0,
+            G_MAXUINT,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_PACKED_FORMATS,
+        g_param_spec_enum(
+            "packedformats",
+            "Packed pixel formats",
+            "Decides if packed pixel formats (e.g. Mono12p) are requested from the camera and unpacked to 16 bit per pixel while copying. Packed formats reduce the required link bandwidth, but prevent zero-copy output",
+            GST_ENUM_PACKEDFORMATS_VALUES,
+            GST_VMBSRC_PACKED_FORMATS_AUTO,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_GROUP,
+        g_param_spec_string(
+            "group",
+            "Camera group",
+            "Name of a group of vmbsrc elements whose cameras are opened concurrently and triggered together via action commands. Unless \"triggersource\" or a settings file is given, the cameras are configured to start frames on Action0. Buffer offsets of group members count frames since start so that frames of the same trigger have the same offset. Empty to not join a group",
+            "",
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_ACTION_DEVICE_KEY,
+        g_param_spec_uint(
+            "actiondevicekey",
+            "Action device key",
+            "Device key written to the camera and used for action commands of the group",
+            0,
+            G_MAXUINT32,
+            DEFAULT_ACTION_DEVICE_KEY,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_ACTION_GROUP_KEY,
+        g_param_spec_uint(
+            "actiongroupkey",
+            "Action group key",
+            "Group key written to the camera and used for action commands of the group",
+            0,
+            G_MAXUINT32,
+            DEFAULT_ACTION_GROUP_KEY,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_ACTION_GROUP_MASK,
+        g_param_spec_uint(
+            "actiongroupmask",
+            "Action group mask",
+            "Group mask written to the camera and used for action commands of the group",
+            0,
+            G_MAXUINT32,
+            DEFAULT_ACTION_GROUP_MASK,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_ACTION_COMMAND_RATE,
+        g_param_spec_double(
+            "actioncommandrate",
+            "Action command rate",
+            "Rate in Hz at which action commands are sent to the cameras of the group while all of them are acquiring. Taken from the first element of the group. 0 to not send action commands",
+            0,
+            G_MAXDOUBLE,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_ACTION_SCHEDULE_DELAY,
+        g_param_spec_uint(
+            "actionscheduledelay",
+            "Action schedule delay",
+            "Delay in microseconds after the current device time of the first camera of the group at which action commands are scheduled. Requires cameras synchronized via PTP. 0 to execute action commands immediately",
+            0,
+            G_MAXUINT,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_CHUNK_MODE,
+        g_param_spec_flags(
+            "chunkmode",
+            "Chunk mode",
+            "Chunks the camera transmits with every frame. Their values are attached to the buffers as GstVmbFrameMeta. If no chunk is selected the chunk settings of the camera are left unchanged and no meta is attached",
+            GST_FLAGS_CHUNKMODE_VALUES,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_DELIVERY_MODE,
+        g_param_spec_enum(
+            "deliverymode",
+            "Delivery mode",
+            "Decides which of the filled frames waiting to be pushed are delivered if downstream is slower than the camera. Frames that are not delivered are requeued to the camera right away and counted as \"frames-skipped\" in \"stats\"",
+            GST_ENUM_DELIVERYMODE_VALUES,
+            GST_VMBSRC_DELIVERY_MODE_FIFO,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_MAX_FRAME_AGE,
+        g_param_spec_uint(
+            "maxframeage",
+            "Maximum frame age",
+            "Time in milliseconds since reception after which a frame is not pushed anymore if \"deliverymode\" is BoundedLatency",
+            1,
+            G_MAXUINT,
+            100,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_KEEP_OPEN,
+        g_param_spec_boolean(
+            "keepopen",
+            "Keep camera open",
+            "Keep the camera open when the element is destroyed so that the next vmbsrc element for the same camera in this process can use it without opening it again. The camera stays open until then or until the process exits",
+            FALSE,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_CPU_AFFINITY,
+        g_param_spec_string(
+            "cpuaffinity",
+            "CPU affinity",
+            "Comma separated list of CPUs and CPU ranges (e.g. \"2\" or \"0,4-7\") the streaming thread of the element is pinned to. Empty to not change the affinity. Only supported on Linux",
+            "",
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_THREAD_PRIORITY,
+        g_param_spec_uint(
+            "threadpriority",
+            "Thread priority",
+            "SCHED_FIFO priority of the streaming thread of the element. Requires CAP_SYS_NICE or a matching RLIMIT_RTPRIO. 0 to keep the default scheduling. Only supported on Linux",
+            0,
+            MAX_THREAD_PRIORITY,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_SPIN_WAIT,
+        g_param_spec_uint(
+            "spinwait",
+            "Spin wait",
+            "Time in microseconds the streaming thread polls for the next frame before it blocks. Avoids the wakeup latency of the handoff from the frame callback at the cost of a busy core. 0 to always block",
+            0,
+            G_USEC_PER_SEC,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_DEBAYER,
+        g_param_spec_boolean(
+            "debayer",
+            "Debayer",
+            "Additionally offer RGB, BGRx and GRAY8 video/x-raw caps for 8 bit Bayer pixel formats. The image data is converted with bilinear interpolation while it is copied, which makes a separate bayer2rgb element unnecessary. Formats the camera supports natively are preferred",
+            FALSE,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_DEBAYER_THREADS,
+        g_param_spec_uint(
+            "debayerthreads",
+            "Debayer threads",
+            "Number of threads (including the streaming thread) converting row bands of debayered frames. 0 to use up to " G_STRINGIFY(DEFAULT_DEBAYER_THREADS) " threads depending on the number of processors. Takes effect with the next caps negotiation",
+            0,
+            MAX_DEBAYER_THREADS,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_BATCH_SIZE,
+        g_param_spec_uint(
+            "batchsize",
+            "Batch size",
+            "Maximum number of frames pushed together as a buffer list. Frames that are already waiting when a frame is pushed are added to the list, the element never waits for more frames. Buffer timestamps taken from the pipeline clock are corrected by the time a frame waited. 1 to push every frame separately",
+            1,
+            MAX_BATCH_SIZE,
+            1,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_RECORD_LOCATION,
+        g_param_spec_string(
+            "recordlocation",
+            "Record location",
+            "File the raw frame data is written to directly from the frame buffers, bypassing the page cache where supported. Frames are not pushed downstream while recording. An index with frame ID, timestamp and chunk data of every frame is written to the same path with \".idx\" appended. Empty to push frames downstream. Read when the element starts",
+            "",
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_RECORD_FRAMES,
+        g_param_spec_uint(
+            "recordframes",
+            "Record frames",
+            "Number of frames after which recording to \"recordlocation\" ends with EOS. Disk space for them is preallocated. 0 to record until the element is stopped",
+            0,
+            G_MAXUINT,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_PINNED_MEMORY,
+        g_param_spec_boolean(
+            "pinnedmemory",
+            "Pinned memory",
+            "Page-lock the frame buffers allocated in the \"AnnounceFrame\" allocation mode with the CUDA runtime, which is loaded when the buffers are allocated. Together with the \"ZeroCopy\" output mode, cudaupload can copy from the registered frame buffer and the frame is requeued once the upload released it. Only system memory is output: memory:CUDAMemory and memory:GLMemory caps and asynchronous transfers on a CUDA stream are not implemented. Frame buffers stay pageable if no CUDA runtime is found",
+            FALSE,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_CAMERA_EVENTS,
+        g_param_spec_flags(
+            "cameraevents",
+            "Camera events",
+            "Events of the camera whose notification is enabled when the element is started. Every event is pushed downstream as out-of-band custom event \"application/x-vmbsrc-camera-event\" and emitted as \"camera-event\" signal as soon as it arrives, ahead of the frame it belongs to",
+            GST_FLAGS_CAMERAEVENTS_VALUES,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_FRAME_SKIP,
+        g_param_spec_uint(
+            "frameskip",
+            "Frame skip",
+            "Number of frames dropped after every pushed frame. Dropped frames are requeued as soon as they are received, before any buffer is created for them",
+            0,
+            G_MAXUINT,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_MAX_FRAMERATE,
+        g_param_spec_double(
+            "maxframerate",
+            "Maximum frame rate",
+            "Highest rate (in frames per second) at which frames are pushed. Written to \"AcquisitionFrameRate\" if the camera provides it. Otherwise frames exceeding the rate are requeued as soon as they are received. 0 leaves the frame rate unchanged",
+            0,
+            G_MAXDOUBLE,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_BINNING,
+        g_param_spec_uint(
+            "binning",
+            "Binning",
+            "Number of sensor pixels combined horizontally and vertically into one image pixel (\"BinningHorizontal\" and \"BinningVertical\"). Applied when the element is started. 0 leaves the binning unchanged",
+            0,
+            G_MAXUINT,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_DECIMATION,
+        g_param_spec_uint(
+            "decimation",
+            "Decimation",
+            "Factor by which the camera skips sensor rows and columns (\"DecimationHorizontal\" and \"DecimationVertical\"). Applied when the element is started. 0 leaves the decimation unchanged",
+            0,
+            G_MAXUINT,
+            0,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+    /**
+     * GstVmbSrc::camera-event:
+     * @vmbsrc: the element that received the event
+     * @event: EventSelector entry of the event, e.g. "ExposureEnd". Also used as signal detail
+     * @frame_id: frame ID reported with the event. 0 if the event does not carry one
+     * @timestamp: device timestamp of the event in ticks of the camera
+     *
+     * Emitted from the VmbC event thread for every event selected in "cameraevents"
+     */
+    gst_vmbsrc_signals[SIGNAL_CAMERA_EVENT] = g_signal_new(
+        "camera-event",
+        G_TYPE_FROM_CLASS(klass),
+        G_SIGNAL_RUN_LAST | G_SIGNAL_DETAILED,
+        0,
+        NULL,
+        NULL,
+        NULL,
+        G_TYPE_NONE,
+        3,
+        G_TYPE_STRING,
+        G_TYPE_UINT64,
+        G_TYPE_UINT64);
+
+    /**
+     * GstVmbSrc::trigger:
+     * @vmbsrc: the element whose camera is triggered
+     * @trigger_id: (out) (optional): pointer to a guint64 receiving the ID of the trigger, counting from 1 since the
+     * element was started. The buffer of the triggered frame carries it as trigger_id of its GstVmbFrameMeta. The IDs
+     * are assigned to the received frames in the order of the triggers, so a trigger the camera ignores shifts the IDs
+     * of the following frames. 0 if the trigger was not sent, or if it was sent but the element did not set
+     * "triggersource" Software and "triggermode" On itself (e.g. because a settings file configured the trigger) and
+     * assigns no IDs. May be NULL
+     *
+     * Action signal running the TriggerSoftware command on the camera if at least one frame buffer is queued to capture
+     * the triggered frame into. Requires the camera to be configured for software triggers.
+     *
+     * Returns: TRUE if the trigger was sent
+     */
+    gst_vmbsrc_signals[SIGNAL_TRIGGER] = g_signal_new(
+        "trigger",
+        G_TYPE_FROM_CLASS(klass),
+        G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+        G_STRUCT_OFFSET(GstVmbSrcClass, trigger),
+        NULL,
+        NULL,
+        NULL,
+        G_TYPE_BOOLEAN,
+        1,
+        G_TYPE_POINTER);
+    klass->trigger = software_trigger;
 }
 
 static void gst_vmbsrc_init(GstVmbSrc *vmbsrc)
 {
     GST_TRACE_OBJECT(vmbsrc, "init");
     GST_INFO_OBJECT(vmbsrc, "gst-vmbsrc version %s", VERSION);
-    VmbError_t result = VmbErrorSuccess;
     // Start the VimbaX API
-    G_LOCK(vmb_open_count);
-    if (0 == vmb_open_count++)
-    {
-        result = VmbStartup(NULL);
-        GST_DEBUG_OBJECT(vmbsrc, "VmbStartup returned: %s", ErrorCodeToMessage(result));
-        if (result != VmbErrorSuccess)
-        {
-            GST_ERROR_OBJECT(vmbsrc, "VimbaX initialization failed");
-        }
-    }
-    else
-    {
-        GST_DEBUG_OBJECT(vmbsrc, "VmbStartup was already called. Current open count: %u", vmb_open_count);
-    }
-    G_UNLOCK(vmb_open_count);
+    VmbError_t result = acquire_vimbax_api(GST_OBJECT(vmbsrc));
 
     // Log the used VmbC version
     VmbVersionInfo_t version_info;
@@ -630,67 +1224,246 @@ static void gst_vmbsrc_init(GstVmbSrc *vmbsrc)
             g_object_class_find_property(
                 gobject_class,
                 "allocationmode")));
-
-    gst_video_info_init(&vmbsrc->video_info);
-}
-
-void gst_vmbsrc_set_property(GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
-{
-    GstVmbSrc *vmbsrc = GST_vmbsrc(object);
-
-    GST_DEBUG_OBJECT(vmbsrc, "set_property");
-
-    switch (property_id)
-    {
-    case PROP_CAMERA_ID:
-        if (strcmp(vmbsrc->camera.id, "") != 0)
-        {
-            free((void *)vmbsrc->camera.id); // Free memory of old entry
-        }
-        vmbsrc->camera.id = g_value_dup_string(value);
-        break;
-    case PROP_SETTINGS_FILENAME:
-        if (strcmp(vmbsrc->properties.settings_file_path, "") != 0)
-        {
-            free((void *)vmbsrc->properties.settings_file_path); // Free memory of old entry
-        }
-        vmbsrc->properties.settings_file_path = g_value_dup_string(value);
-        break;
-    case PROP_EXPOSURETIME:
-        vmbsrc->properties.exposuretime = g_value_get_double(value);
-        break;
-    case PROP_EXPOSUREAUTO:
-        vmbsrc->properties.exposureauto = g_value_get_enum(value);
-        break;
-    case PROP_BALANCEWHITEAUTO:
-        vmbsrc->properties.balancewhiteauto = g_value_get_enum(value);
-        break;
-    case PROP_GAIN:
-        vmbsrc->properties.gain = g_value_get_double(value);
-        break;
-    case PROP_OFFSETX:
-        vmbsrc->properties.offsetx = g_value_get_int(value);
-        break;
-    case PROP_OFFSETY:
-        vmbsrc->properties.offsety = g_value_get_int(value);
-        break;
-    case PROP_WIDTH:
-        vmbsrc->properties.width = g_value_get_int(value);
-        break;
-    case PROP_HEIGHT:
-        vmbsrc->properties.height = g_value_get_int(value);
+    vmbsrc->properties.output_mode = g_value_get_enum(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "outputmode")));
+    vmbsrc->properties.num_frame_buffers = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "numframebuffers")));
+    vmbsrc->properties.adaptive_frame_buffers = g_value_get_boolean(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "adaptiveframebuffers")));
+    vmbsrc->properties.max_frame_buffer_memory = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "maxframebuffermemory")));
+    vmbsrc->properties.timestamp_mode = g_value_get_enum(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "timestampmode")));
+    vmbsrc->properties.stats_interval = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "statsinterval")));
+    vmbsrc->properties.packed_formats = g_value_get_enum(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "packedformats")));
+    vmbsrc->properties.group = g_value_dup_string(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "group")));
+    vmbsrc->properties.action_device_key = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "actiondevicekey")));
+    vmbsrc->properties.action_group_key = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "actiongroupkey")));
+    vmbsrc->properties.action_group_mask = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "actiongroupmask")));
+    vmbsrc->properties.action_command_rate = g_value_get_double(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "actioncommandrate")));
+    vmbsrc->properties.action_schedule_delay = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "actionscheduledelay")));
+    vmbsrc->properties.chunk_mode = g_value_get_flags(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "chunkmode")));
+    vmbsrc->properties.delivery_mode = g_value_get_enum(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "deliverymode")));
+    vmbsrc->properties.max_frame_age = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "maxframeage")));
+    vmbsrc->properties.keep_open = g_value_get_boolean(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "keepopen")));
+    vmbsrc->properties.cpu_affinity = g_value_dup_string(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "cpuaffinity")));
+    vmbsrc->properties.thread_priority = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "threadpriority")));
+    vmbsrc->properties.spin_wait = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "spinwait")));
+    vmbsrc->properties.debayer = g_value_get_boolean(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "debayer")));
+    vmbsrc->properties.debayer_threads = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "debayerthreads")));
+    vmbsrc->properties.batch_size = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "batchsize")));
+    vmbsrc->properties.record_location = g_value_dup_string(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "recordlocation")));
+    vmbsrc->properties.record_frames = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "recordframes")));
+    vmbsrc->properties.pinned_memory = g_value_get_boolean(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "pinnedmemory")));
+    vmbsrc->properties.camera_events = g_value_get_flags(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "cameraevents")));
+    vmbsrc->properties.frame_skip = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "frameskip")));
+    vmbsrc->properties.max_framerate = g_value_get_double(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "maxframerate")));
+    vmbsrc->properties.binning = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "binning")));
+    vmbsrc->properties.decimation = g_value_get_uint(
+        g_param_spec_get_default_value(
+            g_object_class_find_property(
+                gobject_class,
+                "decimation")));
+
+    vmbsrc->frame_buffers = g_ptr_array_new();
+    vmbsrc->device_timestamp_caps = gst_caps_new_empty_simple("timestamp/x-vimbax-device");
+    g_mutex_init(&vmbsrc->frame_lock);
+    g_cond_init(&vmbsrc->frame_released);
+    g_mutex_init(&vmbsrc->debayer_lock);
+    g_cond_init(&vmbsrc->debayer_done);
+    g_mutex_init(&vmbsrc->record_lock);
+    g_cond_init(&vmbsrc->record_queue_flushed);
+    g_mutex_init(&vmbsrc->exposure_end_lock);
+    g_mutex_init(&vmbsrc->trigger_lock);
+    g_mutex_init(&vmbsrc->timestamp_latch_lock);
+    g_mutex_init(&vmbsrc->stats_lock);
+    g_cond_init(&vmbsrc->stats_cond);
+    g_mutex_init(&vmbsrc->calibration_lock);
+    g_cond_init(&vmbsrc->calibration_cond);
+
+    gst_video_info_init(&vmbsrc->video_info);
+}
+
+void gst_vmbsrc_set_property(GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(object);
+
+    GST_DEBUG_OBJECT(vmbsrc, "set_property");
+
+    switch (property_id)
+    {
+    case PROP_CAMERA_ID:
+        if (strcmp(vmbsrc->camera.id, "") != 0)
+        {
+            free((void *)vmbsrc->camera.id); // Free memory of old entry
+        }
+        vmbsrc->camera.id = g_value_dup_string(value);
+        break;
+    case PROP_SETTINGS_FILENAME:
+        if (strcmp(vmbsrc->properties.settings_file_path, "") != 0)
+        {
+            free((void *)vmbsrc->properties.settings_file_path); // Free memory of old entry
+        }
+        vmbsrc->properties.settings_file_path = g_value_dup_string(value);
+        break;
+    case PROP_EXPOSURETIME:
+        vmbsrc->properties.exposuretime = g_value_get_double(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_EXPOSURETIME);
+        break;
+    case PROP_EXPOSUREAUTO:
+        vmbsrc->properties.exposureauto = g_value_get_enum(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_EXPOSUREAUTO);
+        break;
+    case PROP_BALANCEWHITEAUTO:
+        vmbsrc->properties.balancewhiteauto = g_value_get_enum(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_BALANCEWHITEAUTO);
+        break;
+    case PROP_GAIN:
+        vmbsrc->properties.gain = g_value_get_double(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_GAIN);
+        break;
+    case PROP_OFFSETX:
+        vmbsrc->properties.offsetx = g_value_get_int(value);
+        break;
+    case PROP_OFFSETY:
+        vmbsrc->properties.offsety = g_value_get_int(value);
+        break;
+    case PROP_WIDTH:
+        vmbsrc->properties.width = g_value_get_int(value);
+        break;
+    case PROP_HEIGHT:
+        vmbsrc->properties.height = g_value_get_int(value);
         break;
     case PROP_TRIGGERSELECTOR:
         vmbsrc->properties.triggerselector = g_value_get_enum(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_TRIGGER);
         break;
     case PROP_TRIGGERMODE:
         vmbsrc->properties.triggermode = g_value_get_enum(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_TRIGGER);
         break;
     case PROP_TRIGGERSOURCE:
         vmbsrc->properties.triggersource = g_value_get_enum(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_TRIGGER);
         break;
     case PROP_TRIGGERACTIVATION:
         vmbsrc->properties.triggeractivation = g_value_get_enum(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_TRIGGER);
         break;
     case PROP_INCOMPLETE_FRAME_HANDLING:
         vmbsrc->properties.incomplete_frame_handling = g_value_get_enum(value);
@@ -698,6 +1471,137 @@ void gst_vmbsrc_set_property(GObject *object, guint property_id, const GValue *v
     case PROP_ALLOCATION_MODE:
         vmbsrc->properties.allocation_mode = g_value_get_enum(value);
         break;
+    case PROP_OUTPUT_MODE:
+        vmbsrc->properties.output_mode = g_value_get_enum(value);
+        break;
+    case PROP_NUM_FRAME_BUFFERS:
+        vmbsrc->properties.num_frame_buffers = g_value_get_uint(value);
+        break;
+    case PROP_ADAPTIVE_FRAME_BUFFERS:
+        vmbsrc->properties.adaptive_frame_buffers = g_value_get_boolean(value);
+        break;
+    case PROP_MAX_FRAME_BUFFER_MEMORY:
+        vmbsrc->properties.max_frame_buffer_memory = g_value_get_uint(value);
+        break;
+    case PROP_TIMESTAMP_MODE:
+        vmbsrc->properties.timestamp_mode = g_value_get_enum(value);
+        break;
+    case PROP_STATS_INTERVAL:
+        g_mutex_lock(&vmbsrc->stats_lock);
+        vmbsrc->properties.stats_interval = g_value_get_uint(value);
+        // Lets a running stats_thread wait for the new interval
+        g_cond_signal(&vmbsrc->stats_cond);
+        g_mutex_unlock(&vmbsrc->stats_lock);
+        break;
+    case PROP_PACKED_FORMATS:
+        vmbsrc->properties.packed_formats = g_value_get_enum(value);
+        // Decides which formats are reported in the caps
+        invalidate_cached_caps(vmbsrc);
+        break;
+    case PROP_GROUP:
+        if (vmbsrc->camera.is_acquiring)
+        {
+            GST_WARNING_OBJECT(vmbsrc, "\"group\" can not be changed while acquiring. Ignoring new value");
+            break;
+        }
+        leave_group(vmbsrc);
+        g_free(vmbsrc->properties.group);
+        vmbsrc->properties.group = g_value_dup_string(value);
+        if (vmbsrc->properties.group != NULL && strcmp(vmbsrc->properties.group, "") != 0)
+        {
+            join_group(vmbsrc, vmbsrc->properties.group);
+        }
+        break;
+    case PROP_ACTION_DEVICE_KEY:
+        vmbsrc->properties.action_device_key = g_value_get_uint(value);
+        break;
+    case PROP_ACTION_GROUP_KEY:
+        vmbsrc->properties.action_group_key = g_value_get_uint(value);
+        break;
+    case PROP_ACTION_GROUP_MASK:
+        vmbsrc->properties.action_group_mask = g_value_get_uint(value);
+        break;
+    case PROP_ACTION_COMMAND_RATE:
+        vmbsrc->properties.action_command_rate = g_value_get_double(value);
+        if (vmbsrc->group != NULL)
+        {
+            // Wake up the action thread to use the new rate
+            g_mutex_lock(&group_lock);
+            g_cond_broadcast(&vmbsrc->group->cond);
+            g_mutex_unlock(&group_lock);
+        }
+        break;
+    case PROP_ACTION_SCHEDULE_DELAY:
+        vmbsrc->properties.action_schedule_delay = g_value_get_uint(value);
+        break;
+    case PROP_CHUNK_MODE:
+        vmbsrc->properties.chunk_mode = g_value_get_flags(value);
+        break;
+    case PROP_DELIVERY_MODE:
+        vmbsrc->properties.delivery_mode = g_value_get_enum(value);
+        break;
+    case PROP_MAX_FRAME_AGE:
+        vmbsrc->properties.max_frame_age = g_value_get_uint(value);
+        break;
+    case PROP_KEEP_OPEN:
+        vmbsrc->properties.keep_open = g_value_get_boolean(value);
+        break;
+    case PROP_CPU_AFFINITY:
+        GST_OBJECT_LOCK(vmbsrc);
+        g_free(vmbsrc->properties.cpu_affinity);
+        vmbsrc->properties.cpu_affinity = g_value_dup_string(value);
+        vmbsrc->tuned_thread = NULL;
+        GST_OBJECT_UNLOCK(vmbsrc);
+        break;
+    case PROP_THREAD_PRIORITY:
+        GST_OBJECT_LOCK(vmbsrc);
+        vmbsrc->properties.thread_priority = g_value_get_uint(value);
+        vmbsrc->tuned_thread = NULL;
+        GST_OBJECT_UNLOCK(vmbsrc);
+        break;
+    case PROP_SPIN_WAIT:
+        vmbsrc->properties.spin_wait = g_value_get_uint(value);
+        break;
+    case PROP_DEBAYER:
+        vmbsrc->properties.debayer = g_value_get_boolean(value);
+        // Decides which formats are reported in the caps
+        invalidate_cached_caps(vmbsrc);
+        break;
+    case PROP_DEBAYER_THREADS:
+        vmbsrc->properties.debayer_threads = g_value_get_uint(value);
+        break;
+    case PROP_BATCH_SIZE:
+        vmbsrc->properties.batch_size = g_value_get_uint(value);
+        break;
+    case PROP_RECORD_LOCATION:
+        g_free(vmbsrc->properties.record_location);
+        vmbsrc->properties.record_location = g_value_dup_string(value);
+        break;
+    case PROP_RECORD_FRAMES:
+        vmbsrc->properties.record_frames = g_value_get_uint(value);
+        break;
+    case PROP_PINNED_MEMORY:
+        vmbsrc->properties.pinned_memory = g_value_get_boolean(value);
+        break;
+    case PROP_CAMERA_EVENTS:
+        vmbsrc->properties.camera_events = g_value_get_flags(value);
+        break;
+    case PROP_FRAME_SKIP:
+        vmbsrc->properties.frame_skip = g_value_get_uint(value);
+        // The reported framerate is divided by the number of skipped frames
+        invalidate_cached_caps(vmbsrc);
+        break;
+    case PROP_MAX_FRAMERATE:
+        vmbsrc->properties.max_framerate = g_value_get_double(value);
+        update_feature(vmbsrc, GST_VMBSRC_FEATURE_FRAMERATE);
+        invalidate_cached_caps(vmbsrc);
+        break;
+    case PROP_BINNING:
+        vmbsrc->properties.binning = g_value_get_uint(value);
+        break;
+    case PROP_DECIMATION:
+        vmbsrc->properties.decimation = g_value_get_uint(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -976,6 +1880,104 @@ void gst_vmbsrc_get_property(GObject *object, guint property_id, GValue *value,
     case PROP_ALLOCATION_MODE:
         g_value_set_enum(value, vmbsrc->properties.incomplete_frame_handling);
         break;
+    case PROP_OUTPUT_MODE:
+        g_value_set_enum(value, vmbsrc->properties.output_mode);
+        break;
+    case PROP_NUM_FRAME_BUFFERS:
+        g_value_set_uint(value, vmbsrc->properties.num_frame_buffers);
+        break;
+    case PROP_ADAPTIVE_FRAME_BUFFERS:
+        g_value_set_boolean(value, vmbsrc->properties.adaptive_frame_buffers);
+        break;
+    case PROP_MAX_FRAME_BUFFER_MEMORY:
+        g_value_set_uint(value, vmbsrc->properties.max_frame_buffer_memory);
+        break;
+    case PROP_TIMESTAMP_MODE:
+        g_value_set_enum(value, vmbsrc->properties.timestamp_mode);
+        break;
+    case PROP_STATS:
+        g_value_take_boxed(value, get_stats(vmbsrc));
+        break;
+    case PROP_STATS_INTERVAL:
+        g_value_set_uint(value, vmbsrc->properties.stats_interval);
+        break;
+    case PROP_PACKED_FORMATS:
+        g_value_set_enum(value, vmbsrc->properties.packed_formats);
+        break;
+    case PROP_GROUP:
+        g_value_set_string(value, vmbsrc->properties.group);
+        break;
+    case PROP_ACTION_DEVICE_KEY:
+        g_value_set_uint(value, vmbsrc->properties.action_device_key);
+        break;
+    case PROP_ACTION_GROUP_KEY:
+        g_value_set_uint(value, vmbsrc->properties.action_group_key);
+        break;
+    case PROP_ACTION_GROUP_MASK:
+        g_value_set_uint(value, vmbsrc->properties.action_group_mask);
+        break;
+    case PROP_ACTION_COMMAND_RATE:
+        g_value_set_double(value, vmbsrc->properties.action_command_rate);
+        break;
+    case PROP_ACTION_SCHEDULE_DELAY:
+        g_value_set_uint(value, vmbsrc->properties.action_schedule_delay);
+        break;
+    case PROP_CHUNK_MODE:
+        g_value_set_flags(value, vmbsrc->properties.chunk_mode);
+        break;
+    case PROP_DELIVERY_MODE:
+        g_value_set_enum(value, vmbsrc->properties.delivery_mode);
+        break;
+    case PROP_MAX_FRAME_AGE:
+        g_value_set_uint(value, vmbsrc->properties.max_frame_age);
+        break;
+    case PROP_KEEP_OPEN:
+        g_value_set_boolean(value, vmbsrc->properties.keep_open);
+        break;
+    case PROP_CPU_AFFINITY:
+        GST_OBJECT_LOCK(vmbsrc);
+        g_value_set_string(value, vmbsrc->properties.cpu_affinity);
+        GST_OBJECT_UNLOCK(vmbsrc);
+        break;
+    case PROP_THREAD_PRIORITY:
+        g_value_set_uint(value, vmbsrc->properties.thread_priority);
+        break;
+    case PROP_SPIN_WAIT:
+        g_value_set_uint(value, vmbsrc->properties.spin_wait);
+        break;
+    case PROP_DEBAYER:
+        g_value_set_boolean(value, vmbsrc->properties.debayer);
+        break;
+    case PROP_DEBAYER_THREADS:
+        g_value_set_uint(value, vmbsrc->properties.debayer_threads);
+        break;
+    case PROP_BATCH_SIZE:
+        g_value_set_uint(value, vmbsrc->properties.batch_size);
+        break;
+    case PROP_RECORD_LOCATION:
+        g_value_set_string(value, vmbsrc->properties.record_location);
+        break;
+    case PROP_RECORD_FRAMES:
+        g_value_set_uint(value, vmbsrc->properties.record_frames);
+        break;
+    case PROP_PINNED_MEMORY:
+        g_value_set_boolean(value, vmbsrc->properties.pinned_memory);
+        break;
+    case PROP_CAMERA_EVENTS:
+        g_value_set_flags(value, vmbsrc->properties.camera_events);
+        break;
+    case PROP_FRAME_SKIP:
+        g_value_set_uint(value, vmbsrc->properties.frame_skip);
+        break;
+    case PROP_MAX_FRAMERATE:
+        g_value_set_double(value, vmbsrc->properties.max_framerate);
+        break;
+    case PROP_BINNING:
+        g_value_set_uint(value, vmbsrc->properties.binning);
+        break;
+    case PROP_DECIMATION:
+        g_value_set_uint(value, vmbsrc->properties.decimation);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -988,34 +1990,86 @@ void gst_vmbsrc_finalize(GObject *object)
 
     GST_TRACE_OBJECT(vmbsrc, "finalize");
 
-    if (vmbsrc->camera.is_connected)
+    // The action thread of the group must no longer use this element or its camera
+    leave_group(vmbsrc);
+    g_free(vmbsrc->properties.group);
+    g_free(vmbsrc->properties.cpu_affinity);
+    g_free(vmbsrc->properties.record_location);
+    if (vmbsrc->settings_features != NULL)
     {
-        VmbError_t result = VmbCameraClose(vmbsrc->camera.handle);
-        if (result == VmbErrorSuccess)
+        free_settings_features(vmbsrc->settings_features);
+    }
+    g_free(vmbsrc->settings_checksum);
+
+    bool is_kept_open = false;
+    if (is_camera_connected(vmbsrc))
+    {
+        for (size_t i = 0; i < sizeof(caps_features) / sizeof(caps_features[0]); i++)
         {
-            GST_INFO_OBJECT(vmbsrc, "Closed camera %s", vmbsrc->camera.id);
+            VmbFeatureInvalidationUnregister(vmbsrc->camera.handle, caps_features[i], caps_feature_invalidated);
+        }
+        for (size_t i = 0; i < sizeof(latency_features) / sizeof(latency_features[0]); i++)
+        {
+            VmbFeatureInvalidationUnregister(vmbsrc->camera.handle, latency_features[i], latency_feature_invalidated);
+        }
+        is_kept_open = vmbsrc->properties.keep_open && keep_camera_open(vmbsrc);
+        if (is_kept_open)
+        {
+            GST_INFO_OBJECT(vmbsrc, "Keeping camera %s open for the next element using it", vmbsrc->camera.id);
         }
         else
         {
-            GST_ERROR_OBJECT(vmbsrc,
-                             "Closing camera %s failed. Got error code: %s",
-                             vmbsrc->camera.id,
-                             ErrorCodeToMessage(result));
+            forget_applied_settings(vmbsrc);
+            VmbError_t result = VmbCameraClose(vmbsrc->camera.handle);
+            if (result == VmbErrorSuccess)
+            {
+                GST_INFO_OBJECT(vmbsrc, "Closed camera %s", vmbsrc->camera.id);
+            }
+            else
+            {
+                GST_ERROR_OBJECT(vmbsrc,
+                                 "Closing camera %s failed. Got error code: %s",
+                                 vmbsrc->camera.id,
+                                 ErrorCodeToMessage(result));
+            }
         }
+        GST_OBJECT_LOCK(vmbsrc);
         vmbsrc->camera.is_connected = false;
+        GST_OBJECT_UNLOCK(vmbsrc);
     }
 
-    G_LOCK(vmb_open_count);
-    if (0 == --vmb_open_count)
+    // A camera kept open takes over the reference to the VimbaX API of this element
+    if (is_kept_open)
     {
-        VmbShutdown();
-        GST_INFO_OBJECT(vmbsrc, "VimbaX API was shut down");
+        GST_DEBUG_OBJECT(vmbsrc, "VmbShutdown not called. Camera is kept open");
     }
     else
     {
-        GST_DEBUG_OBJECT(vmbsrc, "VmbShutdown not called. Current open count: %u", vmb_open_count);
+        release_vimbax_api(GST_OBJECT(vmbsrc));
     }
-    G_UNLOCK(vmb_open_count);
+
+    g_ptr_array_free(vmbsrc->frame_buffers, TRUE);
+    g_free((void *)vmbsrc->camera.supported_formats);
+    gst_caps_replace(&vmbsrc->acquiring_caps, NULL);
+    gst_caps_replace(&vmbsrc->cached_caps, NULL);
+    gst_caps_unref(vmbsrc->device_timestamp_caps);
+    g_mutex_clear(&vmbsrc->frame_lock);
+    g_cond_clear(&vmbsrc->frame_released);
+    if (vmbsrc->debayer_pool != NULL)
+    {
+        g_thread_pool_free(vmbsrc->debayer_pool, FALSE, TRUE);
+    }
+    g_mutex_clear(&vmbsrc->debayer_lock);
+    g_cond_clear(&vmbsrc->debayer_done);
+    g_mutex_clear(&vmbsrc->record_lock);
+    g_cond_clear(&vmbsrc->record_queue_flushed);
+    g_mutex_clear(&vmbsrc->exposure_end_lock);
+    g_mutex_clear(&vmbsrc->trigger_lock);
+    g_mutex_clear(&vmbsrc->timestamp_latch_lock);
+    g_mutex_clear(&vmbsrc->stats_lock);
+    g_cond_clear(&vmbsrc->stats_cond);
+    g_mutex_clear(&vmbsrc->calibration_lock);
+    g_cond_clear(&vmbsrc->calibration_cond);
 
     G_OBJECT_CLASS(gst_vmbsrc_parent_class)->finalize(object);
 }
@@ -1023,94 +2077,60 @@ void gst_vmbsrc_finalize(GObject *object)
 /* get caps from subclass */
 static GstCaps *gst_vmbsrc_get_caps(GstBaseSrc *src, GstCaps *filter)
 {
-    UNUSED(filter); // enable compilation while treating warning of unused vairable as error
     GstVmbSrc *vmbsrc = GST_vmbsrc(src);
 
     GST_TRACE_OBJECT(vmbsrc, "get_caps");
 
-    GstCaps *caps;
-    caps = gst_pad_get_pad_template_caps(GST_BASE_SRC_PAD(src));
-    caps = gst_caps_make_writable(caps);
+    // Query the capabilities from the camera only if they changed since the last call. If no camera is connected the
+    // template caps are returned
+    GstCaps *caps = NULL;
+    if (is_camera_connected(vmbsrc))
+    {
+        GST_OBJECT_LOCK(vmbsrc);
+        if (vmbsrc->cached_caps != NULL)
+        {
+            caps = gst_caps_ref(vmbsrc->cached_caps);
+        }
+        guint caps_generation = vmbsrc->caps_generation;
+        GST_OBJECT_UNLOCK(vmbsrc);
 
-    // Query the capabilities from the camera and return sensible values. If no camera is connected the template caps
-    // are returned
-    if (vmbsrc->camera.is_connected)
+        if (caps == NULL)
+        {
+            caps = query_camera_caps(vmbsrc);
+            GST_OBJECT_LOCK(vmbsrc);
+            // Do not cache the caps if the features they were built from were invalidated in the meantime
+            if (caps_generation == vmbsrc->caps_generation)
+            {
+                gst_caps_replace(&vmbsrc->cached_caps, caps);
+            }
+            GST_OBJECT_UNLOCK(vmbsrc);
+        }
+    }
+    else
     {
-        VmbInt64_t vmb_width, vmb_height;
+        caps = gst_pad_get_pad_template_caps(GST_BASE_SRC_PAD(src));
+    }
 
-        VmbFeatureIntGet(vmbsrc->camera.handle, "Width", &vmb_width);
-        VmbFeatureIntGet(vmbsrc->camera.handle, "Height", &vmb_height);
+    if (filter != NULL)
+    {
+        GstCaps *intersection = gst_caps_intersect_full(filter, caps, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref(caps);
+        caps = intersection;
+    }
 
-        GValue width = G_VALUE_INIT;
-        GValue height = G_VALUE_INIT;
+    GST_DEBUG_OBJECT(vmbsrc, "returning caps: %" GST_PTR_FORMAT, caps);
 
-        g_value_init(&width, G_TYPE_INT);
-        g_value_init(&height, G_TYPE_INT);
+    return caps;
+}
 
-        g_value_set_int(&width, (gint)vmb_width);
-
-        g_value_set_int(&height, (gint)vmb_height);
-
-        GstStructure *raw_caps = gst_caps_get_structure(caps, 0);
-        GstStructure *bayer_caps = gst_caps_get_structure(caps, 1);
-
-        gst_structure_set_value(raw_caps, "width", &width);
-        gst_structure_set_value(raw_caps, "height", &height);
-        gst_structure_set(raw_caps,
-                          // TODO: Check if framerate should also be gotten from camera (e.g. as max-framerate here)
-                          // Mark the framerate as variable because triggering might cause variable framerate
-                          "framerate", GST_TYPE_FRACTION, 0, 1,
-                          NULL);
-
-        gst_structure_set_value(bayer_caps, "width", &width);
-        gst_structure_set_value(bayer_caps, "height", &height);
-        gst_structure_set(bayer_caps,
-                          // TODO: Check if framerate should also be gotten from camera (e.g. as max-framerate here)
-                          // Mark the framerate as variable because triggering might cause variable framerate
-                          "framerate", GST_TYPE_FRACTION, 0, 1,
-                          NULL);
-
-        // Query supported pixel formats from camera and map them to GStreamer formats
-        GValue pixel_format_raw_list = G_VALUE_INIT;
-        g_value_init(&pixel_format_raw_list, GST_TYPE_LIST);
-
-        GValue pixel_format_bayer_list = G_VALUE_INIT;
-        g_value_init(&pixel_format_bayer_list, GST_TYPE_LIST);
-
-        GValue pixel_format = G_VALUE_INIT;
-        g_value_init(&pixel_format, G_TYPE_STRING);
-
-        // Add all supported GStreamer format string to the reported caps
-        for (unsigned int i = 0; i < vmbsrc->camera.supported_formats_count; i++)
-        {
-            g_value_set_static_string(&pixel_format, vmbsrc->camera.supported_formats[i]->gst_format_name);
-            // TODO: Should this perhaps be done via a flag in vimbax_gst_format_matches?
-            if (starts_with(vmbsrc->camera.supported_formats[i]->vimbax_format_name, "Bayer"))
-            {
-                gst_value_list_append_value(&pixel_format_bayer_list, &pixel_format);
-            }
-            else
-            {
-                gst_value_list_append_value(&pixel_format_raw_list, &pixel_format);
-            }
-        }
-        gst_structure_set_value(raw_caps, "format", &pixel_format_raw_list);
-        gst_structure_set_value(bayer_caps, "format", &pixel_format_bayer_list);
-    }
-
-    GST_DEBUG_OBJECT(vmbsrc, "returning caps: %s", gst_caps_to_string(caps));
-
-    return caps;
-}
-
-/* notify the subclass of new caps */
-static gboolean gst_vmbsrc_set_caps(GstBaseSrc *src, GstCaps *caps)
-{
-    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
+/* notify the subclass of new caps */
+static gboolean gst_vmbsrc_set_caps(GstBaseSrc *src, GstCaps *caps)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
 
     GST_TRACE_OBJECT(vmbsrc, "set_caps");
 
-    GST_DEBUG_OBJECT(vmbsrc, "caps requested to be set: %s", gst_caps_to_string(caps));
+    GST_DEBUG_OBJECT(vmbsrc, "caps requested to be set: %" GST_PTR_FORMAT, caps);
 
     // TODO: save to assume that "format" is always exactly one format and not a list? gst_caps_is_fixed might otherwise
     // be a good check and gst_caps_normalize could help make sure of it
@@ -1121,36 +2141,37 @@ static gboolean gst_vmbsrc_set_caps(GstBaseSrc *src, GstCaps *caps)
                      "Looking for matching VimbaX pixel format to GSreamer format \"%s\"",
                      gst_format);
 
-    const char *vimbax_format = NULL;
-    for (unsigned int i = 0; i < vmbsrc->camera.supported_formats_count; i++)
-    {
-        if (strcmp(gst_format, vmbsrc->camera.supported_formats[i]->gst_format_name) == 0)
-        {
-            vimbax_format = vmbsrc->camera.supported_formats[i]->vimbax_format_name;
-            GST_DEBUG_OBJECT(vmbsrc, "Found matching VimbaX pixel format \"%s\"", vimbax_format);
-            break;
-        }
-    }
-    if (vimbax_format == NULL)
+    if (vmbsrc->camera.is_acquiring && vmbsrc->acquiring_caps != NULL &&
+        gst_caps_is_equal(caps, vmbsrc->acquiring_caps))
     {
-        GST_ERROR_OBJECT(vmbsrc,
-                         "Could not find a matching VimbaX pixel format for GStreamer format \"%s\"",
-                         gst_format);
-        return FALSE;
+        // Renegotiation resulted in the caps the camera is already acquiring images for
+        GST_DEBUG_OBJECT(vmbsrc, "Caps did not change. Continuing acquisition without changing camera settings");
+        return TRUE;
     }
 
     // Apply the requested caps to appropriate camera settings
     VmbError_t result;
     // Changing the pixel format can not be done while images are acquired
     result = stop_image_acquisition(vmbsrc);
-
-    if(vmbsrc->filled_frame_queue != NULL)
+    gst_caps_replace(&vmbsrc->acquiring_caps, NULL);
+    // Filled frames still carry image data in the previous format. They are queued again when acquisition restarts
+    drain_filled_frame_queue(vmbsrc);
+
+    // Selecting between packed and unpacked variants of the format may require trying them on the camera, so this is
+    // done after acquisition was stopped
+    const VimbaXGstFormatMatch_t *format_match = select_vimbax_format(vmbsrc, gst_format);
+    if (format_match == NULL)
     {
-        // current possibly non-empty frame queue layout is no longer valid so we use a new one
-        g_async_queue_unref(vmbsrc->filled_frame_queue); // delete current queue
-        vmbsrc->filled_frame_queue = g_async_queue_new(); // create new queue for our frames
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Could not find a matching VimbaX pixel format for GStreamer format \"%s\"",
+                         gst_format);
+        return FALSE;
     }
+    const char *vimbax_format = format_match->vimbax_format_name;
+    GST_DEBUG_OBJECT(vmbsrc, "Found matching VimbaX pixel format \"%s\"", vimbax_format);
 
+    // The negotiated format is written after the settings file at every start, so writing it does not change the state
+    // recorded for the applied settings file
     result = VmbFeatureEnumSet(vmbsrc->camera.handle,
                                "PixelFormat",
                                vimbax_format);
@@ -1162,16 +2183,53 @@ static gboolean gst_vmbsrc_set_caps(GstBaseSrc *src, GstCaps *caps)
                          ErrorCodeToMessage(result));
         return FALSE;
     }
+    const char *unpack_implementation = NULL;
+    vmbsrc->packing = format_match->packing;
+    vmbsrc->unpack_function = get_unpack_function(format_match->packing, &unpack_implementation);
+    if (vmbsrc->unpack_function != NULL)
+    {
+        GST_INFO_OBJECT(vmbsrc,
+                        "Unpacking image data of packed format \"%s\" with %s implementation",
+                        vimbax_format,
+                        unpack_implementation);
+    }
+    setup_debayering(vmbsrc, format_match, gst_format);
+
+    // Rows of the image data may be followed by padding bytes the camera inserts (e.g. for aligned rows). Cameras
+    // without the feature do not pad rows
+    VmbInt64_t line_padding = 0;
+    if (VmbFeatureIntGet(vmbsrc->camera.handle, "PaddingX", &line_padding) != VmbErrorSuccess || line_padding < 0)
+    {
+        line_padding = 0;
+    }
+    vmbsrc->line_padding = (guint)line_padding;
+    if (vmbsrc->line_padding != 0)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Camera pads rows of image data with %u bytes", vmbsrc->line_padding);
+        if (vmbsrc->unpack_function != NULL || vmbsrc->debayer_function != NULL)
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Unpacking and debayering expect rows without padding. Set PaddingX to 0");
+        }
+    }
 
     // width and height are always the value that is already written on the camera because get_caps only reports that
     // value. Setting it here is not necessary as the feature values are controlled via properties of the element.
 
-    // Buffer size needs to be increased if the new payload size is greater than the old one because that means the
-    // previously allocated buffers are not large enough. We simply check the size of the first buffer because they were
-    // all allocated with the same size
+    // Frame buffers are allocated for the largest PayloadSize of all supported formats, so they only need to be
+    // reallocated if the new payload size is still greater (e.g. because it could not be determined for every format).
+    // We simply check the size of the first buffer because they were all allocated with the same size
     VmbUint32_t new_payload_size;
     result = VmbPayloadSizeGet(vmbsrc->camera.handle, &new_payload_size);
-    if (vmbsrc->frame_buffers[0].bufferSize < new_payload_size || result != VmbErrorSuccess)
+    if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS)
+    {
+        // Frame buffers are taken from the buffer pool, which is only negotiated after the caps were set. They are
+        // allocated and acquisition is started by the first create call
+        revoke_and_free_buffers(vmbsrc);
+        result = VmbErrorSuccess;
+    }
+    else if (vmbsrc->frame_buffers->len == 0 ||
+        ((GstVmbSrcFrame *)g_ptr_array_index(vmbsrc->frame_buffers, 0))->frame.bufferSize < new_payload_size ||
+        result != VmbErrorSuccess)
     {
         // Also reallocate buffers if PayloadSize could not be read because it might have increased
         GST_DEBUG_OBJECT(vmbsrc,
@@ -1179,12 +2237,174 @@ static gboolean gst_vmbsrc_set_caps(GstBaseSrc *src, GstCaps *caps)
         revoke_and_free_buffers(vmbsrc);
         result = alloc_and_announce_buffers(vmbsrc);
     }
-    if (result == VmbErrorSuccess)
+    if (result == VmbErrorSuccess &&
+        vmbsrc->properties.allocation_mode != GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS)
     {
         result = start_image_acquisition(vmbsrc);
+        if (result == VmbErrorSuccess)
+        {
+            gst_caps_replace(&vmbsrc->acquiring_caps, caps);
+        }
+    }
+
+    if (result != VmbErrorSuccess || !gst_video_info_from_caps(&vmbsrc->video_info, caps))
+    {
+        return FALSE;
+    }
+    if (GST_ELEMENT(vmbsrc)->numsrcpads > 1 && !is_roi_format_supported(&vmbsrc->video_info))
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Regions can not be cropped from %s frames. ROI pads will not output buffers",
+                           gst_video_format_to_string(GST_VIDEO_INFO_FORMAT(&vmbsrc->video_info)));
+    }
+    return TRUE;
+}
+
+/* decide on the buffer pool and allocator used for output buffers */
+static gboolean gst_vmbsrc_decide_allocation(GstBaseSrc *src, GstQuery *query)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
+
+    GST_TRACE_OBJECT(vmbsrc, "decide_allocation");
+    vmbsrc->is_video_meta_supported = false;
+
+    GstCaps *caps;
+    GstVideoInfo info;
+    gst_query_parse_allocation(query, &caps, NULL);
+    if (caps == NULL || !gst_video_info_from_caps(&info, caps))
+    {
+        // Not raw video. Let the base class pick a generic pool
+        return GST_BASE_SRC_CLASS(gst_vmbsrc_parent_class)->decide_allocation(src, query);
+    }
+
+    // Prefer the pool and allocator proposed by downstream elements (e.g. DMA memory of encoders or converters)
+    // Formats not described by GstVideoInfo (e.g. Bayer) have no known size. Use the size of the copied image data
+    guint size = (guint)info.size;
+    if (GST_VIDEO_INFO_FORMAT(&info) == GST_VIDEO_FORMAT_ENCODED)
+    {
+        size = (guint)get_output_size(vmbsrc, &info);
+    }
+
+    GstBufferPool *pool = NULL;
+    guint min_buffers = 0;
+    guint max_buffers = 0;
+    bool update_pool = gst_query_get_n_allocation_pools(query) > 0;
+    if (update_pool)
+    {
+        guint pool_size;
+        gst_query_parse_nth_allocation_pool(query, 0, &pool, &pool_size, &min_buffers, &max_buffers);
+        size = MAX(size, pool_size);
+    }
+
+    GstAllocator *allocator = NULL;
+    GstAllocationParams params;
+    bool update_allocator = gst_query_get_n_allocation_params(query) > 0;
+    if (update_allocator)
+    {
+        gst_query_parse_nth_allocation_param(query, 0, &allocator, &params);
+    }
+    else
+    {
+        gst_allocation_params_init(&params);
+    }
+    // Keep the alignment the transport layer prefers so that pool buffers can be announced as frame buffers
+    VmbInt64_t buffer_alignment = get_buffer_alignment(vmbsrc);
+    params.align = MAX(params.align, (gsize)(buffer_alignment - 1));
+
+    if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS)
+    {
+        // Pool buffers must hold the complete payload of a frame, not only the image data
+        VmbUint32_t payload_size;
+        if (VmbPayloadSizeGet(vmbsrc->camera.handle, &payload_size) == VmbErrorSuccess)
+        {
+            size = MAX(size, payload_size);
+        }
+        // The announced frames permanently hold buffers of the pool and more frames may be announced in adaptive
+        // mode. Downstream elements need additional buffers, so the pool must not be limited
+        min_buffers = MAX(min_buffers, vmbsrc->properties.num_frame_buffers);
+        max_buffers = 0;
+    }
+
+    if (pool == NULL)
+    {
+        pool = gst_video_buffer_pool_new();
+    }
+    GstStructure *config = gst_buffer_pool_get_config(pool);
+    gst_buffer_pool_config_set_params(config, caps, size, min_buffers, max_buffers);
+    gst_buffer_pool_config_set_allocator(config, allocator, &params);
+    // With video meta, pool buffers can use the row padding of the camera, so each frame is copied in one piece and
+    // frame buffers of the pool receive the image data in the layout the meta describes
+    vmbsrc->is_video_meta_supported = gst_query_find_allocation_meta(query, GST_VIDEO_META_API_TYPE, NULL);
+    if (vmbsrc->is_video_meta_supported && gst_buffer_pool_has_option(pool, GST_BUFFER_POOL_OPTION_VIDEO_META))
+    {
+        gst_buffer_pool_config_add_option(config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+        gint pixel_stride = GST_VIDEO_INFO_N_PLANES(&info) == 1 ? GST_VIDEO_INFO_COMP_PSTRIDE(&info, 0) : 0;
+        if (vmbsrc->line_padding != 0 && pixel_stride > 0 && vmbsrc->line_padding % pixel_stride == 0 &&
+            gst_buffer_pool_has_option(pool, GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT))
+        {
+            GstVideoAlignment alignment;
+            gst_video_alignment_reset(&alignment);
+            alignment.padding_right = vmbsrc->line_padding / (guint)pixel_stride;
+            gst_buffer_pool_config_add_option(config, GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
+            gst_buffer_pool_config_set_video_alignment(config, &alignment);
+            size = MAX(size, (guint)(GST_VIDEO_INFO_SIZE(&info) + (gsize)vmbsrc->line_padding * GST_VIDEO_INFO_HEIGHT(&info)));
+            gst_buffer_pool_config_set_params(config, caps, size, min_buffers, max_buffers);
+        }
+    }
+    if (!gst_buffer_pool_set_config(pool, config))
+    {
+        // The pool may have adjusted the configuration. Accept it if it still fulfills our requirements
+        config = gst_buffer_pool_get_config(pool);
+        if (!gst_buffer_pool_config_validate_params(config, caps, size, min_buffers, max_buffers) ||
+            !gst_buffer_pool_set_config(pool, config))
+        {
+            GST_ERROR_OBJECT(vmbsrc, "Could not configure buffer pool");
+            if (allocator)
+            {
+                gst_object_unref(allocator);
+            }
+            gst_object_unref(pool);
+            return FALSE;
+        }
+    }
+    GST_DEBUG_OBJECT(vmbsrc,
+                     "Using buffer pool %" GST_PTR_FORMAT " with buffer size %u and alignment %" G_GINT64_FORMAT,
+                     pool,
+                     size,
+                     buffer_alignment);
+
+    if (update_allocator)
+    {
+        gst_query_set_nth_allocation_param(query, 0, allocator, &params);
+    }
+    else
+    {
+        gst_query_add_allocation_param(query, allocator, &params);
+    }
+    if (update_pool)
+    {
+        gst_query_set_nth_allocation_pool(query, 0, pool, size, min_buffers, max_buffers);
+    }
+    else
+    {
+        gst_query_add_allocation_pool(query, pool, size, min_buffers, max_buffers);
+    }
+    if (allocator)
+    {
+        gst_object_unref(allocator);
+    }
+    gst_object_unref(pool);
+
+    if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS &&
+        vmbsrc->frame_buffers->len > 0)
+    {
+        // Allocation was renegotiated while frames of the previous pool are announced. They are replaced by buffers of
+        // the new pool in the next create call
+        stop_image_acquisition(vmbsrc);
+        revoke_and_free_buffers(vmbsrc);
     }
 
-    return result == VmbErrorSuccess ? gst_video_info_from_caps(&vmbsrc->video_info, caps) : FALSE;
+    return TRUE;
 }
 
 /* start and stop processing, ideal for opening/closing the resource */
@@ -1194,15 +2414,48 @@ static gboolean gst_vmbsrc_start(GstBaseSrc *src)
 
     GST_TRACE_OBJECT(vmbsrc, "start");
 
+    GST_OBJECT_LOCK(vmbsrc);
+    vmbsrc->push_delay_average = 0;
+    vmbsrc->push_delay_max = 0;
+    vmbsrc->reported_push_delay = 0;
+    vmbsrc->latency_message_time = 0;
+    vmbsrc->exposure_end_delay_average = 0;
+    vmbsrc->exposure_end_delay_max = 0;
+    vmbsrc->num_software_triggers = 0;
+    vmbsrc->num_triggered_frames = 0;
+    vmbsrc->last_triggered_frame_id = 0;
+    // Only set by apply_trigger_settings, which is not run if a settings file is given
+    vmbsrc->is_software_triggered = FALSE;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    g_mutex_lock(&vmbsrc->exposure_end_lock);
+    vmbsrc->num_exposure_ends = 0;
+    g_mutex_unlock(&vmbsrc->exposure_end_lock);
+    g_atomic_int_set(&vmbsrc->stats.frames_received, 0);
+    g_atomic_int_set(&vmbsrc->stats.frames_incomplete, 0);
+    g_atomic_int_set(&vmbsrc->stats.frames_dropped, 0);
+    g_atomic_int_set(&vmbsrc->stats.frames_skipped, 0);
+    g_atomic_int_set(&vmbsrc->stats.frames_rate_limited, 0);
+    vmbsrc->frames_until_push = 0;
+    vmbsrc->next_push_time = 0;
+    g_atomic_int_set(&vmbsrc->stats.requeue_failures, 0);
+    g_atomic_int_set(&vmbsrc->stats.queue_depth_max, 0);
+    g_atomic_int_set(&vmbsrc->stats.queue_depth_average, 0);
+    for (int i = 0; i < NUM_PUSH_DELAY_HISTOGRAM_BUCKETS; i++)
+    {
+        g_atomic_int_set(&vmbsrc->stats.push_delay_histogram[i], 0);
+    }
+    vmbsrc->last_stats_post = g_get_monotonic_time();
+
     // Prepare queue for filled frames from which vmbsrc_create can take them
     vmbsrc->filled_frame_queue = g_async_queue_new();
 
     VmbError_t result;
 
     // TODO: Error handling
-    if (!vmbsrc->camera.is_connected)
+    if (!is_camera_connected(vmbsrc))
     {
-        result = open_camera_connection(vmbsrc);
+        // Cameras of a group are opened together when the first member is started
+        result = vmbsrc->group != NULL ? open_group_cameras(vmbsrc) : open_camera_connection(vmbsrc);
         if (result != VmbErrorSuccess)
         {
             // Can't connect to camera. Abort execution by returning FALSE. This stops the pipeline!
@@ -1217,30 +2470,7 @@ static gboolean gst_vmbsrc_start(GstBaseSrc *src)
                            "\"%s\" was given as settingsfile. Other feature settings passed as element properties will be ignored!",
                            vmbsrc->properties.settings_file_path);
 
-        VmbFilePathChar_t *buffer;
-#ifdef _WIN32
-        size_t num_char = strlen(vmbsrc->properties.settings_file_path);
-        size_t num_wchar = 0;
-        mbstowcs_s(&num_wchar, NULL, 0, vmbsrc->properties.settings_file_path, num_char);
-        buffer = calloc(num_wchar, sizeof(VmbFilePathChar_t));
-        mbstowcs_s(NULL, buffer, num_wchar, vmbsrc->properties.settings_file_path, num_char);
-#else
-        buffer = vmbsrc->properties.settings_file_path;
-#endif
-        result = VmbSettingsLoad(vmbsrc->camera.handle,
-                                 buffer,
-                                 NULL,
-                                 sizeof(VmbFeaturePersistSettings_t));
-#ifdef _WIN32
-        free(buffer);
-#endif
-        if (result != VmbErrorSuccess)
-        {
-            GST_ERROR_OBJECT(vmbsrc,
-                             "Could not load settings from file \"%s\". Got error code %s",
-                             vmbsrc->properties.settings_file_path,
-                             ErrorCodeToMessage(result));
-        }
+        result = apply_settings_file(vmbsrc);
     }
     else
     {
@@ -1249,9 +2479,37 @@ static gboolean gst_vmbsrc_start(GstBaseSrc *src)
         result = apply_feature_settings(vmbsrc);
     }
 
+    if (result == VmbErrorSuccess && vmbsrc->group != NULL)
+    {
+        result = apply_action_settings(vmbsrc);
+    }
+    if (result == VmbErrorSuccess && vmbsrc->properties.chunk_mode != 0)
+    {
+        result = apply_chunk_settings(vmbsrc);
+    }
+    if (result == VmbErrorSuccess && vmbsrc->properties.camera_events != 0)
+    {
+        result = apply_camera_event_settings(vmbsrc);
+    }
+    vmbsrc->has_first_frame_id = false;
+    reset_roi_pads(vmbsrc);
+    if (result == VmbErrorSuccess)
+    {
+        prepare_stream_pads(vmbsrc);
+    }
+
+    // Frame buffers are allocated for unbuffered writes if the recorder exists when they are announced
+    if (result == VmbErrorSuccess && !start_recording(vmbsrc))
+    {
+        gst_base_src_start_complete(src, GST_FLOW_ERROR);
+        return FALSE;
+    }
+
     // Is this necessary?
     if (result == VmbErrorSuccess)
     {
+        start_stats_thread(vmbsrc);
+        start_calibration_thread(vmbsrc);
         gst_base_src_start_complete(src, GST_FLOW_OK);
     }
     else
@@ -1270,9 +2528,17 @@ static gboolean gst_vmbsrc_stop(GstBaseSrc *src)
 
     GST_TRACE_OBJECT(vmbsrc, "stop");
 
+    stop_stats_thread(vmbsrc);
+    stop_calibration_thread(vmbsrc);
+    // No camera event may be pushed while the pads are deactivated and their streams are torn down
+    disable_camera_events(vmbsrc);
     stop_image_acquisition(vmbsrc);
+    release_stream_pads(vmbsrc);
+    // Frames that were already received are still written before the frame buffers are freed
+    stop_recording(vmbsrc);
 
     revoke_and_free_buffers(vmbsrc);
+    gst_caps_replace(&vmbsrc->acquiring_caps, NULL);
 
     // Unref the filled frame queue so it is deleted properly
     g_async_queue_unref(vmbsrc->filled_frame_queue);
@@ -1280,126 +2546,398 @@ static gboolean gst_vmbsrc_stop(GstBaseSrc *src)
     return TRUE;
 }
 
-/* ask the subclass to create a buffer */
-static GstFlowReturn gst_vmbsrc_create(GstPushSrc *src, GstBuffer **buf)
+static GstPad *gst_vmbsrc_request_new_pad(GstElement *element,
+                                          GstPadTemplate *templ,
+                                          const gchar *name,
+                                          const GstCaps *caps)
 {
-    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
+    GstVmbSrc *vmbsrc = GST_vmbsrc(element);
+    UNUSED(caps);
+
+    bool is_stream_pad = strcmp(GST_PAD_TEMPLATE_NAME_TEMPLATE(templ), "stream_%u") == 0;
+    guint stream_index = 0;
+    GST_OBJECT_LOCK(vmbsrc);
+    gchar *pad_name;
+    if (is_stream_pad)
+    {
+        stream_index = vmbsrc->next_stream_pad_index;
+        if (name != NULL && sscanf(name, "stream_%u", &stream_index) != 1)
+        {
+            stream_index = 0;
+        }
+        pad_name = g_strdup_printf("stream_%u", stream_index);
+        vmbsrc->next_stream_pad_index = MAX(vmbsrc->next_stream_pad_index, stream_index + 1);
+    }
+    else
+    {
+        pad_name = name != NULL ? g_strdup(name) : g_strdup_printf("roi_%u", vmbsrc->next_roi_pad_index);
+        vmbsrc->next_roi_pad_index++;
+    }
+    GST_OBJECT_UNLOCK(vmbsrc);
 
-    GST_TRACE_OBJECT(vmbsrc, "create");
+    if (is_stream_pad &&
+        (stream_index == 0 || (is_camera_connected(vmbsrc) && stream_index >= vmbsrc->camera.info.streamCount)))
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Can not output stream %u on a request pad. Stream 0 is output on the src pad",
+                           stream_index);
+        g_free(pad_name);
+        return NULL;
+    }
 
-    bool submit_frame = false;
-    VmbFrame_t *frame;
-    do
+    GstPad *pad = g_object_new(is_stream_pad ? GST_TYPE_VMB_STREAM_PAD : GST_TYPE_VMB_ROI_PAD,
+                               "name",
+                               pad_name,
+                               "direction",
+                               GST_PAD_SRC,
+                               "template",
+                               templ,
+                               NULL);
+    g_free(pad_name);
+    if (is_stream_pad)
     {
-        // Wait until we can get a filled frame (added to queue in vimbax_frame_callback)
-        frame = NULL;
-        GstStateChangeReturn ret;
-        GstState state;
-        do
-        {
-            // Try to get a filled frame for 10 microseconds
-            frame = g_async_queue_timeout_pop(vmbsrc->filled_frame_queue, 10);
-            // Get the current state of the element. Should return immediately since we are not doing ASYNC state changes
-            // but wait at most for 100 nanoseconds
-            ret = gst_element_get_state(GST_ELEMENT(vmbsrc), &state, NULL, 100); // timeout is given in nanoseconds
-            UNUSED(ret);
-            if (state != GST_STATE_PLAYING)
-            {
-                // The src should not create any more data. Stop waiting for frame and do not fill buf
-                GST_INFO_OBJECT(vmbsrc, "Element state is no longer \"GST_STATE_PLAYING\". Aborting create call.");
-                return GST_FLOW_FLUSHING;
-            }
-        } while (frame == NULL);
-        // We got a frame. Check receive status and handle incomplete frames according to
-        // vmbsrc->properties.incomplete_frame_handling
-        if (frame->receiveStatus == VmbFrameStatusIncomplete)
+        GST_VMB_STREAM_PAD(pad)->stream_index = stream_index;
+    }
+    // Caps queries are answered with the caps of the region or stream once they were pushed
+    gst_pad_use_fixed_caps(pad);
+    if (GST_STATE(element) > GST_STATE_READY)
+    {
+        // Pads added later are not activated by the state change of the element
+        gst_pad_set_active(pad, TRUE);
+    }
+    if (!gst_element_add_pad(element, pad))
+    {
+        // A pad with the requested name already exists. The pad was released by gst_element_add_pad
+        return NULL;
+    }
+    if (is_stream_pad)
+    {
+        if (GST_STATE(element) > GST_STATE_READY)
         {
-            GST_WARNING_OBJECT(vmbsrc,
-                               "Received frame with ID \"%llu\" was incomplete", frame->frameID);
-            if (vmbsrc->properties.incomplete_frame_handling == GST_VMBSRC_INCOMPLETE_FRAME_HANDLING_SUBMIT)
+            if (prepare_stream_pad(vmbsrc, GST_VMB_STREAM_PAD(pad)))
             {
-                GST_DEBUG_OBJECT(vmbsrc,
-                                 "Submitting incomplete frame because \"incompleteframehandling\" requested it");
-                submit_frame = true;
+                // The acquisition already started the other streams, so the stream of this pad is captured right away.
+                // A concurrent restart of the acquisition starts it as well, which start_stream_pad_capture tolerates
+                g_mutex_lock(&vmbsrc->frame_lock);
+                bool is_acquiring = vmbsrc->camera.is_acquiring;
+                g_mutex_unlock(&vmbsrc->frame_lock);
+                if (is_acquiring)
+                {
+                    start_stream_pad_capture(vmbsrc, GST_VMB_STREAM_PAD(pad));
+                }
             }
             else
             {
-                // frame should be dropped -> requeue VimbaX buffer here since image data will not be used
-                GST_DEBUG_OBJECT(vmbsrc, "Dropping incomplete frame and requeueing buffer to capture queue");
-                VmbCaptureFrameQueue(vmbsrc->camera.handle, frame, &vimbax_frame_callback);
+                GST_WARNING_OBJECT(vmbsrc,
+                                   "Stream pad %s stays idle until the element is started again",
+                                   GST_PAD_NAME(pad));
             }
         }
-        else
+        GST_DEBUG_OBJECT(vmbsrc, "Added stream pad %s", GST_PAD_NAME(pad));
+        return pad;
+    }
+    // Lets gst-launch set the region as "<element>::roi_0::x"
+    gst_child_proxy_child_added(GST_CHILD_PROXY(element), G_OBJECT(pad), GST_OBJECT_NAME(pad));
+    GST_DEBUG_OBJECT(vmbsrc, "Added ROI pad %s", GST_PAD_NAME(pad));
+    return pad;
+}
+
+static void gst_vmbsrc_release_pad(GstElement *element, GstPad *pad)
+{
+    if (G_TYPE_CHECK_INSTANCE_TYPE(pad, GST_TYPE_VMB_STREAM_PAD))
+    {
+        GST_DEBUG_OBJECT(element, "Releasing stream pad %s", GST_PAD_NAME(pad));
+        // The task must be stopped before the pad is deactivated, which waits for the task
+        release_stream_pad(GST_VMB_STREAM_PAD(pad));
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(element, "Releasing ROI pad %s", GST_PAD_NAME(pad));
+        gst_child_proxy_child_removed(GST_CHILD_PROXY(element), G_OBJECT(pad), GST_OBJECT_NAME(pad));
+    }
+    gst_pad_set_active(pad, FALSE);
+    gst_element_remove_pad(element, pad);
+}
+
+/* GstChildProxy exposing the ROI pads so that their properties can be set by name */
+static GObject *gst_vmbsrc_child_proxy_get_child_by_index(GstChildProxy *child_proxy, guint index)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(child_proxy);
+    GObject *child = NULL;
+    GST_OBJECT_LOCK(vmbsrc);
+    // The always src pad is not a child
+    for (GList *pad = GST_ELEMENT(vmbsrc)->srcpads; pad != NULL; pad = pad->next)
+    {
+        if (G_TYPE_CHECK_INSTANCE_TYPE(pad->data, GST_TYPE_VMB_ROI_PAD) && index-- == 0)
         {
-            GST_TRACE_OBJECT(vmbsrc, "frame was complete");
-            submit_frame = true;
+            child = gst_object_ref(pad->data);
+            break;
         }
-    } while (!submit_frame);
-
-    // Prepare output buffer that will be filled with frame data
-    GstBuffer *buffer = gst_buffer_new_and_alloc(frame->bufferSize);
+    }
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return child;
+}
 
-    // Add a timestamp to the buffer. This is done before copying image data in to keep the
-    // timestamp as close to acquisition as possible
-    GstClock *clock = gst_element_get_clock(GST_ELEMENT(vmbsrc));
-    GstClockTime timestamp = GST_CLOCK_TIME_NONE;
-    if (clock)
+static guint gst_vmbsrc_child_proxy_get_children_count(GstChildProxy *child_proxy)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(child_proxy);
+    guint count = 0;
+    GST_OBJECT_LOCK(vmbsrc);
+    for (GList *pad = GST_ELEMENT(vmbsrc)->srcpads; pad != NULL; pad = pad->next)
     {
-        timestamp = gst_clock_get_time(clock) - gst_element_get_base_time(GST_ELEMENT(vmbsrc));
-        g_object_unref(clock);
+        if (G_TYPE_CHECK_INSTANCE_TYPE(pad->data, GST_TYPE_VMB_ROI_PAD))
+        {
+            count++;
+        }
     }
-    GST_BUFFER_TIMESTAMP(buffer) = timestamp;
-    GST_BUFFER_DURATION(buffer) = GST_CLOCK_TIME_NONE;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return count;
+}
 
-    // copy over frame data into the GStreamer buffer
-    // TODO: Investigate if we can work without copying to improve performance?
-    gst_buffer_fill(
-        buffer,
-        0,
-        frame->buffer,
-        frame->bufferSize);
+static void gst_vmbsrc_child_proxy_init(gpointer g_iface, gpointer iface_data)
+{
+    GstChildProxyInterface *iface = g_iface;
+    UNUSED(iface_data);
+    iface->get_child_by_index = gst_vmbsrc_child_proxy_get_child_by_index;
+    iface->get_children_count = gst_vmbsrc_child_proxy_get_children_count;
+}
 
-    // requeue frame after we copied the image data for VimbaX to use again
-    VmbCaptureFrameQueue(vmbsrc->camera.handle, frame, &vimbax_frame_callback);
+/* unlock any pending access to the resource. subclasses should unlock any function ASAP. */
+static gboolean gst_vmbsrc_unlock(GstBaseSrc *src)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
 
-    // Manually calculate the stride for pixel rows as it might not be identical to GStreamer
-    // expectations
-    gint stride[GST_VIDEO_MAX_PLANES] = {0};
-    gint num_planes = vmbsrc->video_info.finfo->n_planes;
+    GST_TRACE_OBJECT(vmbsrc, "unlock");
 
-    for (gint i = 0; i < num_planes; ++i)
+    g_atomic_int_set(&vmbsrc->is_unlocked, 1);
+    // Wake up a create call that is blocked waiting for a filled frame
+    if (vmbsrc->filled_frame_queue != NULL)
     {
-        stride[i] = vmbsrc->video_info.width * vmbsrc->video_info.finfo->pixel_stride[i];
+        g_async_queue_push(vmbsrc->filled_frame_queue, &unlock_sentinel_frame);
     }
 
-    gst_buffer_add_video_meta_full(buffer,
-                                   GST_VIDEO_FRAME_FLAG_NONE,
-                                   vmbsrc->video_info.finfo->format,
-                                   vmbsrc->video_info.width,
-                                   vmbsrc->video_info.height,
-                                   num_planes,
-                                   vmbsrc->video_info.offset,
-                                   stride);
+    return TRUE;
+}
+
+/* Clear any pending unlock request, as we succeeded in unlocking */
+static gboolean gst_vmbsrc_unlock_stop(GstBaseSrc *src)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
 
-    GST_BUFFER_OFFSET(buffer) = vmbsrc->num_frames_pushed;
-    GST_BUFFER_OFFSET_END(buffer) = ++(vmbsrc->num_frames_pushed);
+    GST_TRACE_OBJECT(vmbsrc, "unlock_stop");
 
-    // Set filled GstBuffer as output to pass down the pipeline
-    *buf = buffer;
+    // Remove sentinels that were not consumed by a create call
+    if (vmbsrc->filled_frame_queue != NULL)
+    {
+        while (g_async_queue_remove(vmbsrc->filled_frame_queue, &unlock_sentinel_frame))
+        {
+        }
+    }
+    g_atomic_int_set(&vmbsrc->is_unlocked, 0);
 
-    return GST_FLOW_OK;
+    return TRUE;
 }
 
-static gboolean plugin_init(GstPlugin *plugin)
+/* notify subclasses of a query */
+static gboolean gst_vmbsrc_query(GstBaseSrc *src, GstQuery *query)
 {
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
 
-    /* FIXME Remember to set the rank if it's an element that is meant to be autoplugged by decodebin. */
-    return gst_element_register(plugin, "vmbsrc", GST_RANK_NONE,
-                                GST_TYPE_vmbsrc);
-}
-
-GST_PLUGIN_DEFINE(GST_VERSION_MAJOR,
-                  GST_VERSION_MINOR,
+    switch (GST_QUERY_TYPE(query))
+    {
+    case GST_QUERY_LATENCY:
+    {
+        if (!is_camera_connected(vmbsrc))
+        {
+            // Without camera there is nothing to base the latency on
+            break;
+        }
+        // Camera values are only read again after one of the latency features changed. An invalidation during the
+        // reads clears is_latency_cached again, so the next query reads the new values
+        GST_OBJECT_LOCK(vmbsrc);
+        bool is_latency_cached = vmbsrc->is_latency_cached;
+        vmbsrc->is_latency_cached = true;
+        GST_OBJECT_UNLOCK(vmbsrc);
+        if (!is_latency_cached)
+        {
+            GstClockTime exposure_duration = get_exposure_duration(vmbsrc);
+            GstClockTime frame_interval = get_frame_interval(vmbsrc);
+            GST_OBJECT_LOCK(vmbsrc);
+            vmbsrc->cached_exposure_duration = exposure_duration;
+            vmbsrc->cached_frame_interval = frame_interval;
+            GST_OBJECT_UNLOCK(vmbsrc);
+        }
+        GST_OBJECT_LOCK(vmbsrc);
+        GstClockTime exposure_duration = vmbsrc->cached_exposure_duration;
+        GstClockTime frame_interval = vmbsrc->cached_frame_interval;
+        GstClockTime push_delay_average = vmbsrc->push_delay_average;
+        GstClockTime push_delay_max = vmbsrc->push_delay_max;
+        GST_OBJECT_UNLOCK(vmbsrc);
+
+        // A frame is at least delayed by the time it takes from the frame callback until it is pushed. Timestamps
+        // taken at dequeue already include the exposure, only device timestamps lie before it
+        GstClockTime min_latency = push_delay_average;
+        if (vmbsrc->properties.timestamp_mode == GST_VMBSRC_TIMESTAMP_MODE_CAMERA &&
+            GST_CLOCK_TIME_IS_VALID(exposure_duration))
+        {
+            min_latency += exposure_duration;
+        }
+        // Each additionally queued frame buffer may hold a frame for another frame interval. If frames are triggered
+        // the interval is unknown and the largest measured delay is used instead
+        GstClockTime max_latency;
+        if (GST_CLOCK_TIME_IS_VALID(frame_interval))
+        {
+            g_mutex_lock(&vmbsrc->frame_lock);
+            guint num_frame_buffers = MAX(vmbsrc->frame_buffers->len, vmbsrc->properties.num_frame_buffers);
+            g_mutex_unlock(&vmbsrc->frame_lock);
+            max_latency = min_latency + (num_frame_buffers - 1) * frame_interval;
+        }
+        else
+        {
+            max_latency = min_latency + (push_delay_max - push_delay_average);
+        }
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "Reporting latency min %" GST_TIME_FORMAT " max %" GST_TIME_FORMAT,
+                         GST_TIME_ARGS(min_latency),
+                         GST_TIME_ARGS(max_latency));
+        gst_query_set_latency(query, TRUE, min_latency, max_latency);
+        return TRUE;
+    }
+    default:
+        break;
+    }
+
+    return GST_BASE_SRC_CLASS(gst_vmbsrc_parent_class)->query(src, query);
+}
+
+static gboolean gst_vmbsrc_event(GstBaseSrc *src, GstEvent *event)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
+
+    // Lets downstream elements request a frame the same way as the "trigger" action signal
+    if (GST_EVENT_TYPE(event) == GST_EVENT_CUSTOM_UPSTREAM && gst_event_has_name(event, "application/x-vmbsrc-trigger"))
+    {
+        return software_trigger(vmbsrc, NULL);
+    }
+
+    return GST_BASE_SRC_CLASS(gst_vmbsrc_parent_class)->event(src, event);
+}
+
+/* ask the subclass to create a buffer */
+static GstFlowReturn gst_vmbsrc_create(GstPushSrc *src, GstBuffer **buf)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(src);
+
+    GST_TRACE_OBJECT(vmbsrc, "create");
+
+    // GstBaseSrc may run create on a new streaming thread after the task was restarted
+    GST_OBJECT_LOCK(vmbsrc);
+    bool needs_tuning = vmbsrc->tuned_thread != g_thread_self();
+    GST_OBJECT_UNLOCK(vmbsrc);
+    if (needs_tuning)
+    {
+        tune_streaming_thread(vmbsrc);
+    }
+
+    if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS &&
+        !vmbsrc->camera.is_acquiring)
+    {
+        // Frame buffers are taken from the buffer pool, which is active once allocation was decided
+        VmbError_t result = VmbErrorSuccess;
+        if (vmbsrc->frame_buffers->len == 0)
+        {
+            result = alloc_and_announce_buffers(vmbsrc);
+        }
+        if (result == VmbErrorSuccess)
+        {
+            result = start_image_acquisition(vmbsrc);
+        }
+        if (result == VmbErrorSuccess)
+        {
+            // Lets set_caps keep the camera settings if renegotiation results in the same caps. decide_allocation
+            // still replaces the frame buffers if a new buffer pool is negotiated
+            GstCaps *caps = gst_pad_get_current_caps(GST_BASE_SRC_PAD(vmbsrc));
+            gst_caps_replace(&vmbsrc->acquiring_caps, caps);
+            if (caps != NULL)
+            {
+                gst_caps_unref(caps);
+            }
+        }
+        else
+        {
+            GST_ELEMENT_ERROR(vmbsrc,
+                              RESOURCE,
+                              FAILED,
+                              ("Could not start acquisition with frame buffers of the negotiated buffer pool"),
+                              ("Got error code: %s", ErrorCodeToMessage(result)));
+            return GST_FLOW_ERROR;
+        }
+    }
+
+    VmbFrame_t *frame;
+    GstFlowReturn ret = take_filled_frame(vmbsrc, true, &frame);
+    if (ret != GST_FLOW_OK)
+    {
+        if (ret == GST_FLOW_EOS)
+        {
+            // GstBaseSrc only sends EOS on its own src pad
+            push_request_pad_event(vmbsrc, gst_event_new_eos());
+        }
+        return ret;
+    }
+    GstBuffer *buffer = create_output_buffer(vmbsrc, frame);
+
+    // Frames that are already waiting are pushed together with this one as a buffer list, which saves the per buffer
+    // overhead of the push at high frame rates. This never waits for further frames
+    guint batch_size = vmbsrc->properties.batch_size;
+    GstBufferList *buffer_list = NULL;
+    while (batch_size > 1 && (buffer_list == NULL || gst_buffer_list_length(buffer_list) < batch_size))
+    {
+        if (take_filled_frame(vmbsrc, false, &frame) != GST_FLOW_OK || frame == NULL)
+        {
+            break;
+        }
+        if (buffer_list == NULL)
+        {
+            buffer_list = gst_buffer_list_new_sized(batch_size);
+            gst_buffer_list_add(buffer_list, buffer);
+        }
+        gst_buffer_list_add(buffer_list, create_output_buffer(vmbsrc, frame));
+    }
+
+    if (buffer_list != NULL)
+    {
+        for (guint i = 0; i < gst_buffer_list_length(buffer_list); i++)
+        {
+            push_roi_buffers(vmbsrc, gst_buffer_list_get(buffer_list, i));
+        }
+        GST_LOG_OBJECT(vmbsrc, "Pushing %u frames as buffer list", gst_buffer_list_length(buffer_list));
+        // GstBaseSrc pushes the submitted list because no buffer is returned
+        gst_base_src_submit_buffer_list(GST_BASE_SRC(vmbsrc), buffer_list);
+        *buf = NULL;
+    }
+    else
+    {
+        push_roi_buffers(vmbsrc, buffer);
+        // Set filled GstBuffer as output to pass down the pipeline
+        *buf = buffer;
+    }
+
+    return GST_FLOW_OK;
+}
+
+static gboolean plugin_init(GstPlugin *plugin)
+{
+
+    /* FIXME Remember to set the rank if it's an element that is meant to be autoplugged by decodebin. */
+    return gst_element_register(plugin, "vmbsrc", GST_RANK_NONE,
+                                GST_TYPE_vmbsrc) &&
+           gst_device_provider_register(plugin, "vmbdeviceprovider", GST_RANK_PRIMARY,
+                                        GST_TYPE_VMB_DEVICE_PROVIDER);
+}
+
+GST_PLUGIN_DEFINE(GST_VERSION_MAJOR,
+                  GST_VERSION_MINOR,
                   vmbsrc,
                   DESCRIPTION,
                   plugin_init,
@@ -1409,682 +2947,5347 @@ GST_PLUGIN_DEFINE(GST_VERSION_MAJOR,
                   HOMEPAGE_URL)
 
 /**
- * @brief Opens the connection to the camera given by the ID passed as vmbsrc property and stores the resulting handle
+ * @brief Takes the next filled frame that should be pushed from filled_frame_queue. Incomplete frames and frames that
+ * exceeded "maxframeage" are requeued on the way according to the element settings
+ *
+ * @param vmbsrc Provides the filled frame queue and the frame handling settings
+ * @param wait Block until a frame arrives and apply pending feature changes before. Otherwise only frames that are
+ * already waiting are taken
+ * @param filled_frame Set to the frame to push. NULL if wait is false and no frame is waiting
+ * @return GstFlowReturn GST_FLOW_FLUSHING if the element was unlocked, GST_FLOW_ERROR if pending feature changes could
+ * not be applied
+ */
+GstFlowReturn take_filled_frame(GstVmbSrc *vmbsrc, bool wait, VmbFrame_t **filled_frame)
+{
+    bool submit_frame = false;
+    VmbFrame_t *frame;
+    do
+    {
+        if (g_atomic_int_get(&vmbsrc->is_unlocked))
+        {
+            // The src should not create any more data. Do not wait for a frame and do not fill buf
+            GST_INFO_OBJECT(vmbsrc, "Element was unlocked. Aborting create call.");
+            return GST_FLOW_FLUSHING;
+        }
+        if (wait)
+        {
+            // Property changes that can not be written while acquiring are applied before waiting for the next frame
+            if (apply_pending_features(vmbsrc) != VmbErrorSuccess)
+            {
+                GST_ELEMENT_ERROR(vmbsrc,
+                                  RESOURCE,
+                                  FAILED,
+                                  ("Could not restart acquisition after changing camera features"),
+                                  (NULL));
+                return GST_FLOW_ERROR;
+            }
+            // Block until we get a filled frame (added to queue in vimbax_frame_callback) or gst_vmbsrc_unlock wakes us
+            // up
+            frame = pop_filled_frame(vmbsrc);
+        }
+        else
+        {
+            frame = g_async_queue_try_pop(vmbsrc->filled_frame_queue);
+            if (frame == NULL || frame == &unlock_sentinel_frame || frame == &feature_update_sentinel_frame ||
+                frame == &record_finished_sentinel_frame)
+            {
+                // Sentinels are left for the next create call, which waits and applies feature changes
+                if (frame != NULL)
+                {
+                    g_async_queue_push_front(vmbsrc->filled_frame_queue, frame);
+                }
+                *filled_frame = NULL;
+                return GST_FLOW_OK;
+            }
+        }
+        if (frame == &unlock_sentinel_frame)
+        {
+            GST_INFO_OBJECT(vmbsrc, "Element was unlocked while waiting for a frame. Aborting create call.");
+            return GST_FLOW_FLUSHING;
+        }
+        if (frame == &feature_update_sentinel_frame)
+        {
+            // Checks for pending feature changes again
+            continue;
+        }
+        if (frame == &record_finished_sentinel_frame)
+        {
+            GST_INFO_OBJECT(vmbsrc, "Recording finished after %u frames", vmbsrc->num_frames_recorded);
+            return vmbsrc->record_result;
+        }
+        update_queue_depth_stats(vmbsrc);
+        GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_DEQUEUE, frame, frame->frameID);
+        // The frame may have waited for this create call longer than allowed
+        if (is_frame_stale(vmbsrc, ((GstVmbSrcFrame *)frame->context[1])->receive_time, g_get_monotonic_time()))
+        {
+            GST_LOG_OBJECT(vmbsrc, "Skipping frame with ID \"%llu\" that exceeded \"maxframeage\"", frame->frameID);
+            g_atomic_int_inc(&vmbsrc->stats.frames_skipped);
+            queue_frame(vmbsrc, frame);
+            continue;
+        }
+        // Announce more frames if the capture engine ran out of queued frames or transmission could not keep up
+        if (vmbsrc->properties.adaptive_frame_buffers &&
+            (g_atomic_int_compare_and_exchange(&vmbsrc->frame_starvation, 1, 0) ||
+             frame->receiveStatus == VmbFrameStatusIncomplete))
+        {
+            grow_frame_buffers(vmbsrc);
+        }
+        // We got a frame. Check receive status and handle incomplete frames according to
+        // vmbsrc->properties.incomplete_frame_handling
+        if (frame->receiveStatus == VmbFrameStatusIncomplete)
+        {
+            // Counted in the statistics. Logging every incomplete frame would further slow down high frame rates
+            g_atomic_int_inc(&vmbsrc->stats.frames_incomplete);
+            GST_LOG_OBJECT(vmbsrc, "Received frame with ID \"%llu\" was incomplete", frame->frameID);
+            if (vmbsrc->properties.incomplete_frame_handling == GST_VMBSRC_INCOMPLETE_FRAME_HANDLING_SUBMIT)
+            {
+                GST_DEBUG_OBJECT(vmbsrc,
+                                 "Submitting incomplete frame because \"incompleteframehandling\" requested it");
+                submit_frame = true;
+            }
+            else
+            {
+                // frame should be dropped -> requeue VimbaX buffer here since image data will not be used
+                GST_LOG_OBJECT(vmbsrc, "Dropping incomplete frame and requeueing buffer to capture queue");
+                g_atomic_int_inc(&vmbsrc->stats.frames_dropped);
+                queue_frame(vmbsrc, frame);
+            }
+        }
+        else
+        {
+            GST_TRACE_OBJECT(vmbsrc, "frame was complete");
+            submit_frame = true;
+        }
+    } while (!submit_frame);
+
+    *filled_frame = frame;
+    return GST_FLOW_OK;
+}
+
+
+/**
+ * @brief Creates the buffer passed downstream for a filled frame. The frame is either wrapped or copied and requeued
+ *
+ * @param vmbsrc Provides the output settings and the negotiated video info
+ * @param frame Filled frame taken from filled_frame_queue
+ * @return GstBuffer* Buffer with timestamps, offsets and metadata of the frame
+ */
+GstBuffer *create_output_buffer(GstVmbSrc *vmbsrc, VmbFrame_t *frame)
+{
+    // Read before the frame might be requeued and overwritten
+    gint64 receive_time = ((GstVmbSrcFrame *)frame->context[1])->receive_time;
+    VmbUint64_t frame_id = frame->frameID;
+
+    // Device timestamp of the frame in nanoseconds if the camera reported one
+    GstClockTime device_time = GST_CLOCK_TIME_NONE;
+    GstVmbSrcTimestampCalibration *calibration = &vmbsrc->timestamp_calibration;
+    if (calibration->tick_frequency != 0 && (frame->receiveFlags & VmbFrameFlagsTimestamp))
+    {
+        device_time = gst_util_uint64_scale(frame->timestamp, GST_SECOND, calibration->tick_frequency);
+    }
+
+    // Chunk data is part of the frame buffer, so it must be parsed before the frame might be requeued by copy_frame
+    GstVmbChunkValues chunk_values = {0};
+    chunk_values.trigger_id = ((GstVmbSrcFrame *)frame->context[1])->trigger_id;
+    if (vmbsrc->properties.chunk_mode != 0 && frame->chunkDataPresent)
+    {
+        chunk_values.fields = vmbsrc->properties.chunk_mode;
+        VmbError_t result = VmbChunkDataAccess(frame, read_chunk_values, &chunk_values);
+        if (result != VmbErrorSuccess)
+        {
+            GST_LOG_OBJECT(vmbsrc, "Could not access chunk data of frame. Got error code: %s", ErrorCodeToMessage(result));
+            chunk_values.fields = 0;
+        }
+    }
+
+    // Take the timestamp before preparing the output buffer to keep it as close to acquisition as possible
+    GstClock *clock = gst_element_get_clock(GST_ELEMENT(vmbsrc));
+    GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+    if (clock)
+    {
+        GstClockTime base_time = gst_element_get_base_time(GST_ELEMENT(vmbsrc));
+        if (vmbsrc->properties.timestamp_mode == GST_VMBSRC_TIMESTAMP_MODE_CAMERA && GST_CLOCK_TIME_IS_VALID(device_time))
+        {
+            // The mapping is updated by calibration_thread, as latching a device timestamp is a round trip to the camera
+            GST_OBJECT_LOCK(vmbsrc);
+            bool is_calibrated = calibration->is_calibrated && calibration->clock == clock;
+            GstClockTime internal = calibration->internal;
+            GstClockTime external = calibration->external;
+            GstClockTime rate_num = calibration->rate_num;
+            GstClockTime rate_denom = calibration->rate_denom;
+            GST_OBJECT_UNLOCK(vmbsrc);
+            if (is_calibrated)
+            {
+                GstClockTime clock_time =
+                    gst_clock_adjust_with_calibration(NULL, device_time, internal, external, rate_num, rate_denom);
+                timestamp = clock_time > base_time ? clock_time - base_time : 0;
+            }
+            else
+            {
+                // Frames are timestamped on arrival until the thread calibrated the mapping for the new clock
+                g_mutex_lock(&vmbsrc->calibration_lock);
+                g_cond_signal(&vmbsrc->calibration_cond);
+                g_mutex_unlock(&vmbsrc->calibration_lock);
+            }
+        }
+        if (!GST_CLOCK_TIME_IS_VALID(timestamp))
+        {
+            timestamp = gst_clock_get_time(clock) - base_time;
+            if (vmbsrc->properties.batch_size > 1)
+            {
+                // Frames of a batch are converted one after another. Taking back the time a frame waited in the queue
+                // keeps the spacing of the frames in their timestamps
+                GstClockTime waited = (GstClockTime)MAX(g_get_monotonic_time() - receive_time, 0) * GST_USECOND;
+                timestamp -= MIN(timestamp, waited);
+            }
+        }
+        g_object_unref(clock);
+    }
+
+    // The layout of the image data in the frame buffer depends on the camera (data offset and row padding) and might
+    // not be identical to GStreamer expectations
+    gsize offset[GST_VIDEO_MAX_PLANES] = {0};
+    gint stride[GST_VIDEO_MAX_PLANES] = {0};
+    gint num_planes = vmbsrc->video_info.finfo->n_planes;
+    get_frame_layout(vmbsrc, frame, offset, stride);
+
+    GstBuffer *buffer = NULL;
+    // Packed and debayered image data must always be converted into a separate buffer. Frames in a layout downstream
+    // can only read with GstVideoMeta are repacked while copying if downstream does not support it
+    if (vmbsrc->unpack_function == NULL && vmbsrc->debayer_function == NULL &&
+        (vmbsrc->is_video_meta_supported || is_default_layout(&vmbsrc->video_info, offset, stride)) &&
+        (vmbsrc->properties.output_mode == GST_VMBSRC_OUTPUT_MODE_ZERO_COPY ||
+         ((GstVmbSrcFrame *)frame->context[1])->pool_buffer != NULL))
+    {
+        // Hand the frame buffer itself downstream. It is requeued once the last reference to the buffer is dropped
+        buffer = wrap_frame(vmbsrc, frame);
+    }
+    if (buffer == NULL)
+    {
+        // copy over frame data into a GStreamer buffer and requeue the frame for VimbaX to use again
+        buffer = copy_frame(vmbsrc, frame, offset, stride);
+    }
+
+    GST_BUFFER_TIMESTAMP(buffer) = timestamp;
+    GST_BUFFER_DURATION(buffer) = GST_CLOCK_TIME_NONE;
+
+    if (GST_CLOCK_TIME_IS_VALID(device_time))
+    {
+        gst_buffer_add_reference_timestamp_meta(buffer, vmbsrc->device_timestamp_caps, device_time, GST_CLOCK_TIME_NONE);
+    }
+
+    if (chunk_values.fields != 0 || chunk_values.trigger_id != 0)
+    {
+        gst_buffer_add_vmb_frame_meta(buffer, &chunk_values);
+    }
+
+    // Buffers of a downstream pool and converted image data already describe their own layout. Otherwise the buffer holds
+    // the image data in the layout of the frame
+    if (gst_buffer_get_video_meta(buffer) == NULL)
+    {
+        gst_buffer_add_video_meta_full(buffer,
+                                       GST_VIDEO_FRAME_FLAG_NONE,
+                                       vmbsrc->video_info.finfo->format,
+                                       vmbsrc->video_info.width,
+                                       vmbsrc->video_info.height,
+                                       num_planes,
+                                       offset,
+                                       stride);
+    }
+
+    if (vmbsrc->group != NULL)
+    {
+        // All cameras of the group received the same triggers since their first frame, so frames captured for the same
+        // action command get the same offset on every member. Frames lost on the way still count
+        if (!vmbsrc->has_first_frame_id)
+        {
+            vmbsrc->first_frame_id = frame_id;
+            vmbsrc->has_first_frame_id = true;
+        }
+        GST_BUFFER_OFFSET(buffer) = frame_id - vmbsrc->first_frame_id;
+        GST_BUFFER_OFFSET_END(buffer) = GST_BUFFER_OFFSET(buffer) + 1;
+        ++(vmbsrc->num_frames_pushed);
+    }
+    else
+    {
+        GST_BUFFER_OFFSET(buffer) = vmbsrc->num_frames_pushed;
+        GST_BUFFER_OFFSET_END(buffer) = ++(vmbsrc->num_frames_pushed);
+    }
+
+    update_push_delay(vmbsrc, receive_time);
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_PUSH, frame, frame_id);
+
+    return buffer;
+}
+
+
+/**
+ * @brief Opens the connection to the camera given by the ID passed as vmbsrc property and stores the resulting handle
+ *
+ * @param vmbsrc Provides access to the camera ID and holds the resulting handle
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t open_camera_connection(GstVmbSrc *vmbsrc)
+{
+    GstVmbSrcSession *session = get_session(vmbsrc->camera.id);
+
+    // Use the handle of a camera that a previous element kept open
+    g_mutex_lock(&session_lock);
+    VmbHandle_t kept_handle = session->handle;
+    session->handle = NULL;
+    if (kept_handle != NULL)
+    {
+        vmbsrc->camera.info = session->info;
+    }
+    g_mutex_unlock(&session_lock);
+
+    VmbError_t result = VmbErrorSuccess;
+    if (kept_handle != NULL)
+    {
+        vmbsrc->camera.handle = kept_handle;
+        // The session held a reference to the VimbaX API while the camera was not used by an element. This element
+        // holds its own reference, so the count can not drop to 0 here
+        G_LOCK(vmb_open_count);
+        vmb_open_count--;
+        G_UNLOCK(vmb_open_count);
+        GST_INFO_OBJECT(vmbsrc,
+                        "Using camera %s (model \"%s\", serial \"%s\") that was kept open",
+                        vmbsrc->camera.id,
+                        vmbsrc->camera.info.modelName,
+                        vmbsrc->camera.info.serialString);
+    }
+    else
+    {
+        // The camera may have been changed by other applications while it was closed
+        forget_applied_settings(vmbsrc);
+        result = VmbCameraOpen(vmbsrc->camera.id, VmbAccessModeFull, &vmbsrc->camera.handle);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        if (kept_handle == NULL)
+        {
+            VmbCameraInfoQuery(vmbsrc->camera.id, &vmbsrc->camera.info, sizeof(vmbsrc->camera.info));
+            GST_INFO_OBJECT(vmbsrc,
+                            "Successfully opened camera %s (model \"%s\", serial \"%s\")",
+                            vmbsrc->camera.id,
+                            vmbsrc->camera.info.modelName,
+                            vmbsrc->camera.info.serialString); // TODO: This seems to show N/A for some cameras (observed with USB)
+
+            // A camera that was kept open still uses the packet size negotiated when it was opened
+            adjust_packet_size(vmbsrc, session);
+        }
+
+        // Querying all PixelFormat entries is slow, so the format table is only determined once per camera
+        g_mutex_lock(&session_lock);
+        bool has_supported_formats = session->has_supported_formats;
+        if (has_supported_formats)
+        {
+            g_free((void *)vmbsrc->camera.supported_formats);
+            vmbsrc->camera.supported_formats = g_new(const VimbaXGstFormatMatch_t *, session->supported_formats_count);
+            memcpy((void *)vmbsrc->camera.supported_formats,
+                   session->supported_formats,
+                   session->supported_formats_count * sizeof(*session->supported_formats));
+            vmbsrc->camera.supported_formats_count = session->supported_formats_count;
+        }
+        g_mutex_unlock(&session_lock);
+        if (has_supported_formats)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Using %u supported formats determined earlier", vmbsrc->camera.supported_formats_count);
+        }
+        else
+        {
+            map_supported_pixel_formats(vmbsrc);
+            g_mutex_lock(&session_lock);
+            session->supported_formats = g_new(const VimbaXGstFormatMatch_t *, vmbsrc->camera.supported_formats_count);
+            memcpy((void *)session->supported_formats,
+                   vmbsrc->camera.supported_formats,
+                   vmbsrc->camera.supported_formats_count * sizeof(*session->supported_formats));
+            session->supported_formats_count = vmbsrc->camera.supported_formats_count;
+            session->has_supported_formats = true;
+            g_mutex_unlock(&session_lock);
+        }
+
+        // Caps are only queried from the camera again after one of the features they depend on changed
+        invalidate_cached_caps(vmbsrc);
+        for (size_t i = 0; i < sizeof(caps_features) / sizeof(caps_features[0]); i++)
+        {
+            VmbError_t register_result = VmbFeatureInvalidationRegister(vmbsrc->camera.handle,
+                                                                        caps_features[i],
+                                                                        caps_feature_invalidated,
+                                                                        vmbsrc);
+            if (register_result != VmbErrorSuccess)
+            {
+                GST_WARNING_OBJECT(vmbsrc,
+                                   "Could not register invalidation callback for \"%s\". Got error code: %s",
+                                   caps_features[i],
+                                   ErrorCodeToMessage(register_result));
+            }
+        }
+        GST_OBJECT_LOCK(vmbsrc);
+        vmbsrc->is_latency_cached = false;
+        GST_OBJECT_UNLOCK(vmbsrc);
+        for (size_t i = 0; i < sizeof(latency_features) / sizeof(latency_features[0]); i++)
+        {
+            // Not every camera has all of them (e.g. the legacy feature names), so failures are not reported
+            VmbFeatureInvalidationRegister(vmbsrc->camera.handle,
+                                           latency_features[i],
+                                           latency_feature_invalidated,
+                                           vmbsrc);
+        }
+
+        // Needed to convert device timestamps to nanoseconds. The feature name differs between transport layers
+        memset(&vmbsrc->timestamp_calibration, 0, sizeof(vmbsrc->timestamp_calibration));
+        VmbInt64_t tick_frequency = 0;
+        if (VmbErrorSuccess == VmbFeatureIntGet(vmbsrc->camera.handle, "DeviceTimestampFrequency", &tick_frequency) ||
+            VmbErrorSuccess == VmbFeatureIntGet(vmbsrc->camera.handle, "GevTimestampTickFrequency", &tick_frequency))
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Device timestamp frequency is %lld Hz", tick_frequency);
+            vmbsrc->timestamp_calibration.tick_frequency = tick_frequency > 0 ? (VmbUint64_t)tick_frequency : 0;
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Could not read the device timestamp frequency. Device timestamps will not be used");
+        }
+    }
+    else
+    {
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Could not open camera %s. Got error code: %s",
+                         vmbsrc->camera.id,
+                         ErrorCodeToMessage(result));
+        // TODO: List available cameras in this case?
+        // TODO: Can we signal an error to the pipeline to stop immediately?
+    }
+    vmbsrc->camera.is_acquiring = false;
+    // Published last, as the cameras of group members are opened by another thread (see is_camera_connected)
+    GST_OBJECT_LOCK(vmbsrc);
+    vmbsrc->camera.is_connected = result == VmbErrorSuccess;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return result;
+}
+
+/**
+ * @brief Checks whether the camera of the element is open. The camera of a group member may be opened by the thread of
+ * another member (see open_group_cameras), which writes the camera state before it sets is_connected under the object
+ * lock. Reading the flag under the object lock therefore also makes the rest of the camera state visible
+ *
+ * @param vmbsrc The element whose camera is checked
+ * @return true if the camera is open
+ */
+bool is_camera_connected(GstVmbSrc *vmbsrc)
+{
+    GST_OBJECT_LOCK(vmbsrc);
+    bool is_connected = vmbsrc->camera.is_connected;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return is_connected;
+}
+
+/**
+ * @brief Returns the session of a camera, creating it if this is the first time the camera is used in this process
+ *
+ * @param camera_id ID of the camera
+ * @return GstVmbSrcSession* The session of the camera. Its members are protected by session_lock
+ */
+GstVmbSrcSession *get_session(const char *camera_id)
+{
+    g_mutex_lock(&session_lock);
+    if (sessions == NULL)
+    {
+        sessions = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+    GstVmbSrcSession *session = g_hash_table_lookup(sessions, camera_id);
+    if (session == NULL)
+    {
+        session = g_new0(GstVmbSrcSession, 1);
+        g_hash_table_insert(sessions, g_strdup(camera_id), session);
+    }
+    g_mutex_unlock(&session_lock);
+    return session;
+}
+
+/**
+ * @brief Sets the GVSP packet size of a GigE camera to the highest value the network path supports
+ *
+ * "GVSPAdjustPacketSize" probes the network path and can take seconds, so its result is remembered in the session and
+ * written directly when the camera is opened again.
+ *
+ * @param vmbsrc Provides the stream handle of the opened camera
+ * @param session Session of the camera holding the remembered packet size
+ */
+void adjust_packet_size(GstVmbSrc *vmbsrc, GstVmbSrcSession *session)
+{
+    VmbHandle_t stream_handle = vmbsrc->camera.info.streamHandles[0];
+    g_mutex_lock(&session_lock);
+    VmbInt64_t packet_size = session->packet_size;
+    g_mutex_unlock(&session_lock);
+    if (packet_size > 0)
+    {
+        if (VmbErrorSuccess == VmbFeatureIntSet(stream_handle, "GVSPPacketSize", packet_size))
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Set \"GVSPPacketSize\" to previously negotiated %lld", packet_size);
+            return;
+        }
+        GST_DEBUG_OBJECT(vmbsrc, "Could not set previously negotiated packet size. Adjusting packet size again");
+    }
+
+    // Set the GeV packet size to the highest possible value if a GigE camera is used
+    if (VmbErrorSuccess != VmbFeatureCommandRun(stream_handle, "GVSPAdjustPacketSize"))
+    {
+        return;
+    }
+    VmbError_t result = WaitForCommandDone(stream_handle, "GVSPAdjustPacketSize", FEATURE_COMMAND_TIMEOUT);
+    if (result == VmbErrorSuccess && VmbErrorSuccess == VmbFeatureIntGet(stream_handle, "GVSPPacketSize", &packet_size))
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Negotiated \"GVSPPacketSize\" of %lld", packet_size);
+        g_mutex_lock(&session_lock);
+        session->packet_size = packet_size;
+        g_mutex_unlock(&session_lock);
+    }
+    else if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Adjusting the packet size failed. Got error code: %s", ErrorCodeToMessage(result));
+    }
+}
+
+/**
+ * @brief Hands the open camera of a finalized element to its session so that the next element can use it
+ *
+ * The session takes over the reference to the VimbaX API held by the element.
+ *
+ * @param vmbsrc Element whose camera should be kept open. Acquisition must be stopped and all frames revoked
+ * @return true if the session took the handle, false if it already holds another handle for the camera
+ */
+bool keep_camera_open(GstVmbSrc *vmbsrc)
+{
+    GstVmbSrcSession *session = get_session(vmbsrc->camera.id);
+    g_mutex_lock(&session_lock);
+    bool is_kept_open = session->handle == NULL;
+    if (is_kept_open)
+    {
+        session->handle = vmbsrc->camera.handle;
+        session->info = vmbsrc->camera.info;
+    }
+    g_mutex_unlock(&session_lock);
+    return is_kept_open;
+}
+
+/**
+ * @brief Thread function opening the camera of a group member
+ *
+ * @param data The GstVmbSrc whose camera should be opened. A reference to it is released when the camera was opened
+ * @return gpointer The VmbError_t returned by open_camera_connection (use GPOINTER_TO_INT)
+ */
+gpointer open_camera_connection_thread(gpointer data)
+{
+    GstVmbSrc *vmbsrc = GST_vmbsrc(data);
+    VmbError_t result = open_camera_connection(vmbsrc);
+    gst_object_unref(vmbsrc);
+    return GINT_TO_POINTER(result);
+}
+
+/**
+ * @brief Adds the element to the group with the given name, creating the group if it does not exist yet
+ *
+ * @param vmbsrc Element joining the group. Must not be a member of another group
+ * @param name Name of the group
+ */
+void join_group(GstVmbSrc *vmbsrc, const char *name)
+{
+    g_mutex_lock(&group_lock);
+    if (groups == NULL)
+    {
+        groups = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+    GstVmbSrcGroup *group = g_hash_table_lookup(groups, name);
+    if (group == NULL)
+    {
+        group = g_new0(GstVmbSrcGroup, 1);
+        group->name = g_strdup(name);
+        group->members = g_ptr_array_new();
+        g_mutex_init(&group->open_lock);
+        g_cond_init(&group->cond);
+        g_hash_table_insert(groups, group->name, group);
+    }
+    g_ptr_array_add(group->members, vmbsrc);
+    vmbsrc->group = group;
+    GST_DEBUG_OBJECT(vmbsrc, "Joined group \"%s\" which now has %u members", name, group->members->len);
+    g_cond_broadcast(&group->cond);
+    g_mutex_unlock(&group_lock);
+}
+
+/**
+ * @brief Removes the element from its group. The group is freed when its last member leaves
+ *
+ * @param vmbsrc Element leaving its group. Nothing is done if it is not a member of a group
+ */
+void leave_group(GstVmbSrc *vmbsrc)
+{
+    GstVmbSrcGroup *group = vmbsrc->group;
+    if (group == NULL)
+    {
+        return;
+    }
+
+    g_mutex_lock(&group_lock);
+    // The action thread may still be sending a command with the settings and camera of this element
+    while (group->commanding_member == vmbsrc)
+    {
+        g_cond_wait(&group->cond, &group_lock);
+    }
+    g_ptr_array_remove(group->members, vmbsrc);
+    vmbsrc->group = NULL;
+    bool is_empty = group->members->len == 0;
+    if (is_empty)
+    {
+        g_hash_table_remove(groups, group->name);
+        group->stop_action_thread = true;
+    }
+    g_cond_broadcast(&group->cond);
+    g_mutex_unlock(&group_lock);
+    GST_DEBUG_OBJECT(vmbsrc, "Left group \"%s\"", group->name);
+
+    if (is_empty)
+    {
+        if (group->action_thread != NULL)
+        {
+            g_thread_join(group->action_thread);
+        }
+        g_ptr_array_free(group->members, TRUE);
+        g_mutex_clear(&group->open_lock);
+        g_cond_clear(&group->cond);
+        g_free(group->name);
+        g_free(group);
+    }
+}
+
+/**
+ * @brief Opens the cameras of all members of the group of the element concurrently
+ *
+ * Opening a camera (including adjusting the GigE packet size) takes a considerable amount of time. Opening all cameras
+ * of the group at once when the first member is started keeps the startup time independent of the number of cameras.
+ * Members started later find their camera already connected. Other members only read the camera state written by the
+ * opening threads after is_camera_connected returned true or after they held open_lock themselves.
+ *
+ * @param vmbsrc Member of a group whose camera is not connected yet
+ * @return VmbError_t Return status of opening the camera of vmbsrc. An error if its camera could not be opened, also
+ * when it was opened by the thread of another member
+ */
+VmbError_t open_group_cameras(GstVmbSrc *vmbsrc)
+{
+    GstVmbSrcGroup *group = vmbsrc->group;
+    g_mutex_lock(&group->open_lock);
+
+    GPtrArray *threads = g_ptr_array_new();
+    GPtrArray *opened_members = g_ptr_array_new();
+    g_mutex_lock(&group_lock);
+    for (guint i = 0; i < group->members->len; i++)
+    {
+        GstVmbSrc *member = g_ptr_array_index(group->members, i);
+        if (!is_camera_connected(member))
+        {
+            g_ptr_array_add(opened_members, member);
+            g_ptr_array_add(threads,
+                            g_thread_new("vmbsrc-open", open_camera_connection_thread, gst_object_ref(member)));
+        }
+    }
+    g_mutex_unlock(&group_lock);
+    GST_INFO_OBJECT(vmbsrc, "Opening %u cameras of group \"%s\"", threads->len, group->name);
+
+    VmbError_t result = VmbErrorSuccess;
+    for (guint i = 0; i < threads->len; i++)
+    {
+        VmbError_t thread_result = GPOINTER_TO_INT(g_thread_join(g_ptr_array_index(threads, i)));
+        if (g_ptr_array_index(opened_members, i) == vmbsrc)
+        {
+            result = thread_result;
+        }
+    }
+    g_ptr_array_free(threads, TRUE);
+    g_ptr_array_free(opened_members, TRUE);
+    // The camera of this element may have been opened by the thread of another member, which failed to open it
+    if (result == VmbErrorSuccess && !is_camera_connected(vmbsrc))
+    {
+        GST_ERROR_OBJECT(vmbsrc, "Camera %s of group \"%s\" could not be opened", vmbsrc->camera.id, group->name);
+        result = VmbErrorDeviceNotOpen;
+    }
+
+    g_mutex_unlock(&group->open_lock);
+    return result;
+}
+
+/**
+ * @brief Configures the camera of a group member to be triggered by the action commands of the group
+ *
+ * The action keys and mask are always written. The trigger is configured to start frames on Action0 unless the
+ * "triggersource" property was set or the camera settings were loaded from a file.
+ *
+ * @param vmbsrc Member of a group providing the camera handle and the action settings
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t apply_action_settings(GstVmbSrc *vmbsrc)
+{
+    // Cameras only execute action commands whose keys and mask match their own
+    const struct
+    {
+        const char *name;
+        VmbInt64_t value;
+    } action_features[] = {
+        {"ActionSelector", 0},
+        {"ActionDeviceKey", vmbsrc->properties.action_device_key},
+        {"ActionGroupKey", vmbsrc->properties.action_group_key},
+        {"ActionGroupMask", vmbsrc->properties.action_group_mask}};
+    VmbError_t result = VmbErrorSuccess;
+    for (size_t i = 0; i < sizeof(action_features) / sizeof(action_features[0]); i++)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"%s\" to %lld", action_features[i].name, action_features[i].value);
+        result = VmbFeatureIntSet(vmbsrc->camera.handle, action_features[i].name, action_features[i].value);
+        if (result != VmbErrorSuccess)
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to set \"%s\" to %lld. Return code was: %s",
+                             action_features[i].name,
+                             action_features[i].value,
+                             ErrorCodeToMessage(result));
+            return result;
+        }
+    }
+
+    if (vmbsrc->properties.triggersource != GST_VMBSRC_TRIGGERSOURCE_UNCHANGED ||
+        strcmp(vmbsrc->properties.settings_file_path, "") != 0)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Keeping configured trigger settings for group \"%s\"", vmbsrc->group->name);
+        return result;
+    }
+    const char *trigger_features[][2] = {
+        {"TriggerSelector", "FrameStart"},
+        {"TriggerSource", "Action0"},
+        {"TriggerMode", "On"}};
+    for (size_t i = 0; i < sizeof(trigger_features) / sizeof(trigger_features[0]); i++)
+    {
+        if (i == 0 && vmbsrc->properties.triggerselector != GST_VMBSRC_TRIGGERSELECTOR_UNCHANGED)
+        {
+            // Already selected by apply_trigger_settings
+            continue;
+        }
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"%s\" to %s", trigger_features[i][0], trigger_features[i][1]);
+        result = VmbFeatureEnumSet(vmbsrc->camera.handle, trigger_features[i][0], trigger_features[i][1]);
+        if (result != VmbErrorSuccess)
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to set \"%s\" to %s. Return code was: %s",
+                             trigger_features[i][0],
+                             trigger_features[i][1],
+                             ErrorCodeToMessage(result));
+            if (result == VmbErrorInvalidValue)
+            {
+                log_available_enum_entries(vmbsrc, trigger_features[i][0]);
+            }
+            return result;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Updates the number of acquiring members of the group and starts its action thread once needed
+ *
+ * @param vmbsrc Element whose acquisition was started or stopped. Nothing is done if it is not a member of a group
+ * @param is_acquiring true if acquisition was started
+ */
+void update_group_acquisition(GstVmbSrc *vmbsrc, bool is_acquiring)
+{
+    GstVmbSrcGroup *group = vmbsrc->group;
+    if (group == NULL)
+    {
+        return;
+    }
+
+    g_mutex_lock(&group_lock);
+    if (is_acquiring)
+    {
+        group->num_acquiring++;
+        if (group->action_thread == NULL)
+        {
+            group->action_thread = g_thread_new("vmbsrc-action", group_action_thread, group);
+        }
+    }
+    else if (group->num_acquiring > 0)
+    {
+        group->num_acquiring--;
+    }
+    GST_DEBUG_OBJECT(vmbsrc,
+                     "%u of %u members of group \"%s\" are acquiring",
+                     group->num_acquiring,
+                     group->members->len,
+                     group->name);
+    g_cond_broadcast(&group->cond);
+    g_mutex_unlock(&group_lock);
+}
+
+/**
+ * @brief Thread function sending action commands at the "actioncommandrate" of the first group member
+ *
+ * Action commands are only sent while all members are acquiring so that every camera captures a frame for every
+ * command and the frame sets stay complete.
+ *
+ * @param data The GstVmbSrcGroup whose cameras are triggered
+ * @return gpointer Always NULL
+ */
+gpointer group_action_thread(gpointer data)
+{
+    GstVmbSrcGroup *group = data;
+    gint64 next_command_time = 0;
+
+    g_mutex_lock(&group_lock);
+    while (!group->stop_action_thread)
+    {
+        GstVmbSrc *vmbsrc = group->members->len > 0 ? g_ptr_array_index(group->members, 0) : NULL;
+        if (vmbsrc == NULL || vmbsrc->properties.action_command_rate <= 0 ||
+            group->num_acquiring < group->members->len)
+        {
+            g_cond_wait(&group->cond, &group_lock);
+            next_command_time = 0;
+            continue;
+        }
+
+        gint64 now = g_get_monotonic_time();
+        if (now < next_command_time)
+        {
+            g_cond_wait_until(&group->cond, &group_lock, next_command_time);
+            continue;
+        }
+        // Do not try to catch up on commands missed while waiting, e.g. for a slow action command
+        gint64 interval = (gint64)(G_USEC_PER_SEC / vmbsrc->properties.action_command_rate);
+        next_command_time = MAX(next_command_time + interval, now);
+
+        // The command involves several round trips to the cameras, so it is sent without holding the group lock.
+        // leave_group waits until it was sent, which keeps vmbsrc valid
+        group->commanding_member = vmbsrc;
+        g_mutex_unlock(&group_lock);
+        run_action_command(vmbsrc);
+        g_mutex_lock(&group_lock);
+        group->commanding_member = NULL;
+        g_cond_broadcast(&group->cond);
+    }
+    g_mutex_unlock(&group_lock);
+    return NULL;
+}
+
+/**
+ * @brief Sends an action command with the action keys and mask of the element to all cameras
+ *
+ * If "actionscheduledelay" is set, the command is scheduled for that delay after the current device time of the
+ * camera of the element, which requires all cameras to be synchronized via PTP.
+ *
+ * @param vmbsrc Provides the action settings and the camera whose device time is used for scheduled commands
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t run_action_command(GstVmbSrc *vmbsrc)
+{
+    VmbInt64_t scheduled_time = 0;
+    if (vmbsrc->properties.action_schedule_delay > 0 && vmbsrc->timestamp_calibration.tick_frequency != 0)
+    {
+        VmbInt64_t ticks;
+        if (latch_device_timestamp(vmbsrc, &ticks) == VmbErrorSuccess)
+        {
+            scheduled_time = ticks + (VmbInt64_t)gst_util_uint64_scale(vmbsrc->properties.action_schedule_delay,
+                                                                       vmbsrc->timestamp_calibration.tick_frequency,
+                                                                       G_USEC_PER_SEC);
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Could not latch device timestamp. Sending action command unscheduled");
+        }
+    }
+
+    g_mutex_lock(&action_command_lock);
+    VmbError_t result = VmbFeatureIntSet(gVmbHandle, "ActionDeviceKey", vmbsrc->properties.action_device_key);
+    if (result == VmbErrorSuccess)
+    {
+        result = VmbFeatureIntSet(gVmbHandle, "ActionGroupKey", vmbsrc->properties.action_group_key);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        result = VmbFeatureIntSet(gVmbHandle, "ActionGroupMask", vmbsrc->properties.action_group_mask);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        result = VmbFeatureBoolSet(gVmbHandle,
+                                   "ActionScheduledTimeEnable",
+                                   scheduled_time != 0 ? VmbBoolTrue : VmbBoolFalse);
+        if (result == VmbErrorNotFound && scheduled_time == 0)
+        {
+            // Transport layers without scheduled action commands
+            result = VmbErrorSuccess;
+        }
+    }
+    if (result == VmbErrorSuccess && scheduled_time != 0)
+    {
+        result = VmbFeatureIntSet(gVmbHandle, "ActionScheduledTime", scheduled_time);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        GST_TRACE_OBJECT(vmbsrc, "Sending action command scheduled at %lld", scheduled_time);
+        result = VmbFeatureCommandRun(gVmbHandle, "ActionCommand");
+    }
+    g_mutex_unlock(&action_command_lock);
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Failed to send action command. Got error code: %s", ErrorCodeToMessage(result));
+    }
+    return result;
+}
+
+/**
+ * @brief Default handler of the "trigger" action signal. Runs the TriggerSoftware command on the camera if a frame
+ * buffer is queued that the triggered frame can be captured into
+ *
+ * @param vmbsrc Provides the camera handle and counts the sent triggers
+ * @param trigger_id Holds the ID of the trigger, or 0 if it was not sent or the element assigns no IDs because it did
+ * not configure the software trigger itself. May be NULL
+ * @return gboolean TRUE if the trigger was sent
+ */
+gboolean software_trigger(GstVmbSrc *vmbsrc, guint64 *trigger_id)
+{
+    guint64 id = 0;
+    if (trigger_id != NULL)
+    {
+        *trigger_id = 0;
+    }
+
+    g_mutex_lock(&vmbsrc->frame_lock);
+    bool is_acquiring = vmbsrc->camera.is_acquiring;
+    g_mutex_unlock(&vmbsrc->frame_lock);
+    if (!is_acquiring || g_atomic_int_get(&vmbsrc->num_frames_queued) == 0)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "No frame buffer is queued to capture the triggered frame into. Not triggering");
+        return FALSE;
+    }
+
+    g_mutex_lock(&vmbsrc->trigger_lock);
+    // Counted before the trigger is sent because the triggered frame may be received before the command returns. Frames
+    // are only assigned to triggers if this element configured the camera for software triggers, as otherwise the
+    // received frames are not known to be captured for them
+    GST_OBJECT_LOCK(vmbsrc);
+    id = vmbsrc->is_software_triggered ? ++vmbsrc->num_software_triggers : 0;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    GST_TRACE_OBJECT(vmbsrc, "Sending software trigger %" G_GUINT64_FORMAT, id);
+    VmbError_t result = VmbFeatureCommandRun(vmbsrc->camera.handle, "TriggerSoftware");
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Failed to run \"TriggerSoftware\". Got error code: %s", ErrorCodeToMessage(result));
+        GST_OBJECT_LOCK(vmbsrc);
+        if (id != 0 && vmbsrc->num_software_triggers == id)
+        {
+            vmbsrc->num_software_triggers--;
+            vmbsrc->num_triggered_frames = MIN(vmbsrc->num_triggered_frames, vmbsrc->num_software_triggers);
+        }
+        GST_OBJECT_UNLOCK(vmbsrc);
+        id = 0;
+    }
+    g_mutex_unlock(&vmbsrc->trigger_lock);
+    if (trigger_id != NULL)
+    {
+        *trigger_id = id;
+    }
+    return result == VmbErrorSuccess;
+}
+
+/**
+ * @brief Activates the chunk mode of the camera and enables exactly the chunks selected in "chunkmode"
+ *
+ * @param vmbsrc Provides access to the camera handle and holds the selected chunks
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t apply_chunk_settings(GstVmbSrc *vmbsrc)
+{
+    GST_DEBUG_OBJECT(vmbsrc, "Setting \"ChunkModeActive\" to true");
+    VmbError_t result = VmbFeatureBoolSet(vmbsrc->camera.handle, "ChunkModeActive", VmbBoolTrue);
+    if (result != VmbErrorSuccess)
+    {
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Failed to set \"ChunkModeActive\" to true. Return code was: %s",
+                         ErrorCodeToMessage(result));
+        return result;
+    }
+
+    GFlagsClass *chunk_flags = g_type_class_ref(GST_FLAGS_CHUNKMODE_VALUES);
+    for (guint i = 0; i < chunk_flags->n_values; i++)
+    {
+        const GFlagsValue *chunk = &chunk_flags->values[i];
+        bool enable = (vmbsrc->properties.chunk_mode & chunk->value) != 0;
+        result = VmbFeatureEnumSet(vmbsrc->camera.handle, "ChunkSelector", chunk->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting \"ChunkEnable\" of %s to %s", chunk->value_nick, enable ? "true" : "false");
+            result = VmbFeatureBoolSet(vmbsrc->camera.handle, "ChunkEnable", enable ? VmbBoolTrue : VmbBoolFalse);
+        }
+        if (result != VmbErrorSuccess)
+        {
+            if (!enable)
+            {
+                // Chunks the camera does not provide do not need to be disabled
+                result = VmbErrorSuccess;
+                continue;
+            }
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to enable chunk %s. Return code was: %s",
+                             chunk->value_nick,
+                             ErrorCodeToMessage(result));
+            if (result == VmbErrorInvalidValue)
+            {
+                log_available_enum_entries(vmbsrc, "ChunkSelector");
+            }
+            break;
+        }
+    }
+    g_type_class_unref(chunk_flags);
+    return result;
+}
+
+/**
+ * @brief Enables the notification of the events selected in "cameraevents" and registers camera_event_invalidated for
+ * them
+ *
+ * @param vmbsrc Provides access to the camera handle and holds the selected events
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t apply_camera_event_settings(GstVmbSrc *vmbsrc)
+{
+    VmbError_t result = VmbErrorSuccess;
+    GFlagsClass *event_flags = g_type_class_ref(GST_FLAGS_CAMERAEVENTS_VALUES);
+    for (guint i = 0; i < event_flags->n_values; i++)
+    {
+        const GFlagsValue *event = &event_flags->values[i];
+        if ((vmbsrc->properties.camera_events & event->value) == 0)
+        {
+            continue;
+        }
+        result = VmbFeatureEnumSet(vmbsrc->camera.handle, "EventSelector", event->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting \"EventNotification\" of %s to On", event->value_nick);
+            result = VmbFeatureEnumSet(vmbsrc->camera.handle, "EventNotification", "On");
+        }
+        if (result == VmbErrorSuccess)
+        {
+            // The event feature is invalidated every time the camera sends the event
+            gchar *feature = g_strconcat("Event", event->value_nick, NULL);
+            result = VmbFeatureInvalidationRegister(vmbsrc->camera.handle, feature, camera_event_invalidated, vmbsrc);
+            g_free(feature);
+        }
+        if (result != VmbErrorSuccess)
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to enable event %s. Return code was: %s",
+                             event->value_nick,
+                             ErrorCodeToMessage(result));
+            if (result == VmbErrorInvalidValue)
+            {
+                log_available_enum_entries(vmbsrc, "EventSelector");
+            }
+            break;
+        }
+        vmbsrc->enabled_camera_events |= event->value;
+    }
+    g_type_class_unref(event_flags);
+    return result;
+}
+
+/**
+ * @brief Unregisters camera_event_invalidated and disables the notification of all events enabled by
+ * apply_camera_event_settings
+ *
+ * @param vmbsrc Provides access to the camera handle and holds the enabled events
+ */
+void disable_camera_events(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->enabled_camera_events == 0)
+    {
+        return;
+    }
+    // The same events are enabled again by the next start with the same "cameraevents", which is part of the state
+    // recorded for the applied settings file
+    GFlagsClass *event_flags = g_type_class_ref(GST_FLAGS_CAMERAEVENTS_VALUES);
+    for (guint i = 0; i < event_flags->n_values; i++)
+    {
+        const GFlagsValue *event = &event_flags->values[i];
+        if ((vmbsrc->enabled_camera_events & event->value) == 0)
+        {
+            continue;
+        }
+        gchar *feature = g_strconcat("Event", event->value_nick, NULL);
+        VmbFeatureInvalidationUnregister(vmbsrc->camera.handle, feature, camera_event_invalidated);
+        g_free(feature);
+        if (VmbFeatureEnumSet(vmbsrc->camera.handle, "EventSelector", event->value_nick) != VmbErrorSuccess ||
+            VmbFeatureEnumSet(vmbsrc->camera.handle, "EventNotification", "Off") != VmbErrorSuccess)
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Failed to disable the notification of event %s", event->value_nick);
+        }
+    }
+    g_type_class_unref(event_flags);
+    vmbsrc->enabled_camera_events = 0;
+}
+
+/**
+ * @brief Called by VmbC from its event thread when the camera sent one of the events selected in "cameraevents". Pushes
+ * the event downstream as out-of-band custom event and emits the "camera-event" signal without waiting for the frame
+ * it belongs to
+ *
+ * @param handle Handle of the camera that sent the event
+ * @param name Name of the invalidated event feature, "Event" followed by the EventSelector entry
+ * @param user_context The GstVmbSrc that enabled the event
+ */
+void VMB_CALL camera_event_invalidated(const VmbHandle_t handle, const char *name, void *user_context)
+{
+    GstVmbSrc *vmbsrc = user_context;
+    gint64 arrival_time = g_get_monotonic_time();
+    const char *event_name = g_str_has_prefix(name, "Event") ? name + strlen("Event") : name;
+
+    // The data of an event is reported by features named after the event feature
+    VmbInt64_t value;
+    guint64 frame_id = 0;
+    guint64 timestamp = 0;
+    gchar *feature = g_strconcat(name, "FrameID", NULL);
+    if (VmbFeatureIntGet(handle, feature, &value) == VmbErrorSuccess)
+    {
+        frame_id = (guint64)value;
+    }
+    g_free(feature);
+    feature = g_strconcat(name, "Timestamp", NULL);
+    if (VmbFeatureIntGet(handle, feature, &value) == VmbErrorSuccess)
+    {
+        timestamp = (guint64)value;
+    }
+    g_free(feature);
+    GST_LOG_OBJECT(vmbsrc, "Got event %s for frame %" G_GUINT64_FORMAT " at device time %" G_GUINT64_FORMAT,
+                   event_name, frame_id, timestamp);
+
+    if (strcmp(event_name, "ExposureEnd") == 0)
+    {
+        g_mutex_lock(&vmbsrc->exposure_end_lock);
+        GstVmbSrcExposureEnd *exposure_end =
+            &vmbsrc->exposure_ends[vmbsrc->num_exposure_ends++ % NUM_EXPOSURE_END_EVENTS];
+        exposure_end->frame_id = frame_id;
+        exposure_end->arrival_time = arrival_time;
+        g_mutex_unlock(&vmbsrc->exposure_end_lock);
+    }
+
+    GstVmbSrcTimestampCalibration *calibration = &vmbsrc->timestamp_calibration;
+    GstClockTime device_time = calibration->tick_frequency != 0
+                                   ? gst_util_uint64_scale(timestamp, GST_SECOND, calibration->tick_frequency)
+                                   : GST_CLOCK_TIME_NONE;
+    GstEvent *event = gst_event_new_custom(
+        GST_EVENT_CUSTOM_DOWNSTREAM_OOB,
+        gst_structure_new("application/x-vmbsrc-camera-event",
+                          "event", G_TYPE_STRING, event_name,
+                          "frame-id", G_TYPE_UINT64, frame_id,
+                          "timestamp", G_TYPE_UINT64, timestamp,
+                          "device-time", G_TYPE_UINT64, device_time,
+                          NULL));
+    push_request_pad_event(vmbsrc, gst_event_ref(event));
+    // Events sent before the first frame of the acquisition would precede the stream-start and segment of the src pad
+    GstEvent *segment_event = gst_pad_get_sticky_event(GST_BASE_SRC_PAD(vmbsrc), GST_EVENT_SEGMENT, 0);
+    if (segment_event != NULL)
+    {
+        gst_event_unref(segment_event);
+        gst_pad_push_event(GST_BASE_SRC_PAD(vmbsrc), event);
+    }
+    else
+    {
+        gst_event_unref(event);
+    }
+
+    g_signal_emit(vmbsrc,
+                  gst_vmbsrc_signals[SIGNAL_CAMERA_EVENT],
+                  g_quark_from_string(event_name),
+                  event_name,
+                  frame_id,
+                  timestamp);
+}
+
+/**
+ * @brief Updates the measurement of the delay between the ExposureEnd event of a frame and its vimbax_frame_callback.
+ * Frames whose event did not arrive before them are not measured
+ *
+ * @param vmbsrc Holds the received ExposureEnd events and the measured delays
+ * @param frame_id Frame ID of the received frame
+ * @param receive_time Monotonic time (in microseconds) at which the frame was received
+ */
+void update_exposure_end_delay(GstVmbSrc *vmbsrc, guint64 frame_id, gint64 receive_time)
+{
+    gint64 arrival_time = -1;
+    g_mutex_lock(&vmbsrc->exposure_end_lock);
+    guint num_events = MIN(vmbsrc->num_exposure_ends, NUM_EXPOSURE_END_EVENTS);
+    // Search from the newest event because the event of a frame arrives shortly before the frame itself
+    for (guint i = 1; i <= num_events; i++)
+    {
+        const GstVmbSrcExposureEnd *exposure_end =
+            &vmbsrc->exposure_ends[(vmbsrc->num_exposure_ends - i) % NUM_EXPOSURE_END_EVENTS];
+        if (exposure_end->frame_id == frame_id)
+        {
+            arrival_time = exposure_end->arrival_time;
+            break;
+        }
+    }
+    g_mutex_unlock(&vmbsrc->exposure_end_lock);
+    if (arrival_time < 0)
+    {
+        return;
+    }
+
+    GstClockTime delay = MAX(receive_time - arrival_time, 0) * GST_USECOND;
+    GST_OBJECT_LOCK(vmbsrc);
+    if (vmbsrc->exposure_end_delay_average == 0)
+    {
+        vmbsrc->exposure_end_delay_average = delay;
+    }
+    else
+    {
+        vmbsrc->exposure_end_delay_average =
+            (vmbsrc->exposure_end_delay_average * (PUSH_DELAY_AVERAGE_WEIGHT - 1) + delay) / PUSH_DELAY_AVERAGE_WEIGHT;
+    }
+    vmbsrc->exposure_end_delay_max = MAX(vmbsrc->exposure_end_delay_max, delay);
+    GST_OBJECT_UNLOCK(vmbsrc);
+}
+
+/**
+ * @brief VmbChunkAccessCallback reading the values of the selected chunks of a frame
+ *
+ * @param featureAccessHandle Handle through which the chunk features of the frame can be read
+ * @param userContext GstVmbChunkValues whose fields are the chunks to read. Fields of chunks that could not be read are
+ * cleared
+ * @return VmbError_t Always VmbErrorSuccess. Missing chunks are reported via the fields of userContext
+ */
+VmbError_t VMB_CALL read_chunk_values(VmbHandle_t featureAccessHandle, void *userContext)
+{
+    GstVmbChunkValues *values = (GstVmbChunkValues *)userContext;
+    VmbInt64_t int_value;
+    if ((values->fields & GST_VMB_CHUNK_EXPOSURE_TIME) &&
+        VmbFeatureFloatGet(featureAccessHandle, "ChunkExposureTime", &values->exposure_time) != VmbErrorSuccess)
+    {
+        values->fields &= ~GST_VMB_CHUNK_EXPOSURE_TIME;
+    }
+    if ((values->fields & GST_VMB_CHUNK_GAIN) &&
+        VmbFeatureFloatGet(featureAccessHandle, "ChunkGain", &values->gain) != VmbErrorSuccess)
+    {
+        values->fields &= ~GST_VMB_CHUNK_GAIN;
+    }
+    if (values->fields & GST_VMB_CHUNK_FRAME_ID)
+    {
+        if (VmbFeatureIntGet(featureAccessHandle, "ChunkFrameID", &int_value) == VmbErrorSuccess)
+        {
+            values->frame_id = (guint64)int_value;
+        }
+        else
+        {
+            values->fields &= ~GST_VMB_CHUNK_FRAME_ID;
+        }
+    }
+    if (values->fields & GST_VMB_CHUNK_LINE_STATUS_ALL)
+    {
+        if (VmbFeatureIntGet(featureAccessHandle, "ChunkLineStatusAll", &int_value) == VmbErrorSuccess)
+        {
+            values->line_status_all = (guint64)int_value;
+        }
+        else
+        {
+            values->fields &= ~GST_VMB_CHUNK_LINE_STATUS_ALL;
+        }
+    }
+    if (values->fields & GST_VMB_CHUNK_TIMESTAMP)
+    {
+        if (VmbFeatureIntGet(featureAccessHandle, "ChunkTimestamp", &int_value) == VmbErrorSuccess)
+        {
+            values->timestamp = (guint64)int_value;
+        }
+        else
+        {
+            values->fields &= ~GST_VMB_CHUNK_TIMESTAMP;
+        }
+    }
+    return VmbErrorSuccess;
+}
+
+/**
+ * @brief Applies the settings file given in "settingsfile" to the camera, writing only features whose values differ
+ *
+ * The file is parsed into a feature list that is kept until the file content changes. If the same file content was
+ * already applied completely to the open camera and no feature was written from element properties since then, nothing
+ * is written at all. Files that can not be parsed or whose features can not all be written individually are loaded
+ * with VmbSettingsLoad instead.
+ *
+ * @param vmbsrc Provides the settings file path and the camera handle used for the VmbC calls
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t apply_settings_file(GstVmbSrc *vmbsrc)
+{
+    gchar *contents;
+    gsize length;
+    GError *error = NULL;
+    if (!g_file_get_contents(vmbsrc->properties.settings_file_path, &contents, &length, &error))
+    {
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Could not read settings file \"%s\": %s",
+                         vmbsrc->properties.settings_file_path,
+                         error->message);
+        g_clear_error(&error);
+        return VmbErrorIO;
+    }
+    gchar *checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar *)contents, length);
+    // The action, chunk and event settings are written after the file at every start. They are recorded together with
+    // the file, as the features they leave behind differ from the file if they change between starts
+    gchar *applied_state = g_strdup_printf("%s:%d:%u:%u:%u:%u:%u",
+                                           checksum,
+                                           vmbsrc->group != NULL,
+                                           vmbsrc->properties.action_device_key,
+                                           vmbsrc->properties.action_group_key,
+                                           vmbsrc->properties.action_group_mask,
+                                           vmbsrc->properties.chunk_mode,
+                                           vmbsrc->properties.camera_events);
+
+    GstVmbSrcSession *session = get_session(vmbsrc->camera.id);
+    g_mutex_lock(&session_lock);
+    bool is_applied = g_strcmp0(session->applied_settings_checksum, applied_state) == 0;
+    g_mutex_unlock(&session_lock);
+    if (is_applied)
+    {
+        GST_INFO_OBJECT(vmbsrc, "Settings file was already applied to the camera. Not writing any features");
+        g_free(contents);
+        g_free(checksum);
+        g_free(applied_state);
+        return VmbErrorSuccess;
+    }
+
+    if (g_strcmp0(vmbsrc->settings_checksum, checksum) != 0)
+    {
+        if (vmbsrc->settings_features != NULL)
+        {
+            free_settings_features(vmbsrc->settings_features);
+        }
+        vmbsrc->settings_features = parse_settings_file(contents, length, &error);
+        if (vmbsrc->settings_features == NULL)
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Could not parse settings file \"%s\" (%s). Loading it with VmbSettingsLoad",
+                               vmbsrc->properties.settings_file_path,
+                               error->message);
+            g_clear_error(&error);
+        }
+        else
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Parsed %u features from settings file", vmbsrc->settings_features->len);
+        }
+        g_free(vmbsrc->settings_checksum);
+        vmbsrc->settings_checksum = g_strdup(checksum);
+    }
+    g_free(contents);
+    g_free(checksum);
+
+    // The settings file may change any feature the caps depend on
+    invalidate_cached_caps(vmbsrc);
+    VmbError_t result = VmbErrorNotSupported;
+    if (vmbsrc->settings_features != NULL)
+    {
+        result = write_settings_features(vmbsrc, vmbsrc->settings_features);
+    }
+    if (result != VmbErrorSuccess)
+    {
+        result = load_settings_file(vmbsrc);
+    }
+
+    if (result == VmbErrorSuccess)
+    {
+        g_mutex_lock(&session_lock);
+        g_free(session->applied_settings_checksum);
+        session->applied_settings_checksum = applied_state;
+        g_mutex_unlock(&session_lock);
+    }
+    else
+    {
+        g_free(applied_state);
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the features of a parsed settings file in file order, skipping features that already have their value.
+ * Features of the stream module are written to the first stream. Files with features of other modules are not written
+ * at all, so that they are loaded with VmbSettingsLoad instead
+ *
+ * Features that fail, e.g. because they are only writable after a feature later in the file was written, are retried
+ * in further passes over the whole list, so that selectors are set again before the features they select. Passes stop
+ * once all features were written or a pass did not reduce the number of failures. Selectors saved before a <Selector>
+ * element of the file are read from the camera in every pass and written back after the element.
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls
+ * @param features VimbaXSettingsFeature entries in file order
+ * @return VmbError_t VmbErrorSuccess if all features have their value, VmbErrorNotSupported if the file has features of
+ * other modules, otherwise the error of the last failed feature
+ */
+VmbError_t write_settings_features(GstVmbSrc *vmbsrc, GArray *features)
+{
+    for (guint i = 0; i < features->len; i++)
+    {
+        const VimbaXSettingsFeature *feature = &g_array_index(features, VimbaXSettingsFeature, i);
+        if (feature->module == VIMBAX_SETTINGS_MODULE_OTHER ||
+            (feature->module == VIMBAX_SETTINGS_MODULE_STREAM && vmbsrc->camera.info.streamCount == 0))
+        {
+            GST_DEBUG_OBJECT(vmbsrc,
+                             "Feature \"%s\" of the settings file does not belong to the camera or its stream",
+                             feature->name);
+            return VmbErrorNotSupported;
+        }
+    }
+
+    guint previous_failures = G_MAXUINT;
+    for (guint pass = 1; pass <= MAX_SETTINGS_FILE_PASSES; pass++)
+    {
+        VmbError_t result = VmbErrorSuccess;
+        guint failures = 0;
+        // Selector values read by saves that were not restored yet, innermost last. NULL if the value could not be read
+        GPtrArray *saved_values = g_ptr_array_new_with_free_func(g_free);
+        for (guint i = 0; i < features->len; i++)
+        {
+            const VimbaXSettingsFeature *feature = &g_array_index(features, VimbaXSettingsFeature, i);
+            VmbHandle_t handle = feature->module == VIMBAX_SETTINGS_MODULE_STREAM ? vmbsrc->camera.info.streamHandles[0]
+                                                                                    : vmbsrc->camera.handle;
+            const gchar *value = feature->value;
+            if (feature->operation == VIMBAX_SETTINGS_OPERATION_SAVE)
+            {
+                g_ptr_array_add(saved_values, read_feature_value(handle, feature->name, feature->type));
+                continue;
+            }
+            if (feature->operation == VIMBAX_SETTINGS_OPERATION_RESTORE)
+            {
+                value = saved_values->len > 0 ? g_ptr_array_index(saved_values, saved_values->len - 1) : NULL;
+                if (value == NULL)
+                {
+                    // A selector that can not be read is left at the value of the last entry
+                    GST_LOG_OBJECT(vmbsrc, "Pass %u: Not restoring \"%s\" as it could not be read", pass, feature->name);
+                    if (saved_values->len > 0)
+                    {
+                        g_ptr_array_remove_index(saved_values, saved_values->len - 1);
+                    }
+                    continue;
+                }
+            }
+            VmbError_t feature_result;
+            switch (feature->type)
+            {
+            case VmbFeatureDataInt:
+                feature_result = FeatureIntSetIfChanged(handle, feature->name, g_ascii_strtoll(value, NULL, 10));
+                break;
+            case VmbFeatureDataFloat:
+                feature_result = FeatureFloatSetIfChanged(handle, feature->name, g_ascii_strtod(value, NULL));
+                break;
+            case VmbFeatureDataEnum:
+                feature_result = FeatureEnumSetIfChanged(handle, feature->name, value);
+                break;
+            case VmbFeatureDataBool:
+                feature_result = FeatureBoolSetIfChanged(handle,
+                                                         feature->name,
+                                                         g_ascii_strcasecmp(value, "true") == 0 ||
+                                                                 strcmp(value, "1") == 0
+                                                             ? VmbBoolTrue
+                                                             : VmbBoolFalse);
+                break;
+            default:
+                feature_result = FeatureStringSetIfChanged(handle, feature->name, value);
+                break;
+            }
+            if (feature_result != VmbErrorSuccess)
+            {
+                GST_LOG_OBJECT(vmbsrc,
+                               "Pass %u: Could not set \"%s\" to %s. Got error code: %s",
+                               pass,
+                               feature->name,
+                               value,
+                               ErrorCodeToMessage(feature_result));
+                failures++;
+                result = feature_result;
+            }
+            if (feature->operation == VIMBAX_SETTINGS_OPERATION_RESTORE)
+            {
+                g_ptr_array_remove_index(saved_values, saved_values->len - 1);
+            }
+        }
+        g_ptr_array_free(saved_values, TRUE);
+        GST_DEBUG_OBJECT(vmbsrc, "Pass %u over settings file features: %u of %u failed", pass, failures, features->len);
+        if (failures == 0 || failures >= previous_failures || pass == MAX_SETTINGS_FILE_PASSES)
+        {
+            if (failures > 0)
+            {
+                GST_WARNING_OBJECT(vmbsrc,
+                                   "%u features of the settings file could not be written individually",
+                                   failures);
+            }
+            return result;
+        }
+        previous_failures = failures;
+    }
+    return VmbErrorSuccess;
+}
+
+/**
+ * @brief Reads the current value of a feature in the text form used by settings files
+ *
+ * @param handle Handle of the module providing the feature
+ * @param name Name of the feature
+ * @param type Type of the feature as given in the settings file
+ * @return gchar* The value, which must be freed with g_free, or NULL if the feature could not be read
+ */
+gchar *read_feature_value(VmbHandle_t handle, const char *name, VmbFeatureDataType_t type)
+{
+    switch (type)
+    {
+    case VmbFeatureDataInt:
+    {
+        VmbInt64_t value;
+        return VmbFeatureIntGet(handle, name, &value) == VmbErrorSuccess
+                   ? g_strdup_printf("%" G_GINT64_FORMAT, (gint64)value)
+                   : NULL;
+    }
+    case VmbFeatureDataFloat:
+    {
+        double value;
+        gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+        return VmbFeatureFloatGet(handle, name, &value) == VmbErrorSuccess
+                   ? g_strdup(g_ascii_dtostr(buffer, sizeof(buffer), value))
+                   : NULL;
+    }
+    case VmbFeatureDataEnum:
+    {
+        const char *value;
+        return VmbFeatureEnumGet(handle, name, &value) == VmbErrorSuccess ? g_strdup(value) : NULL;
+    }
+    case VmbFeatureDataBool:
+    {
+        VmbBool_t value;
+        return VmbFeatureBoolGet(handle, name, &value) == VmbErrorSuccess ? g_strdup(value ? "true" : "false") : NULL;
+    }
+    default:
+    {
+        VmbUint32_t size = 0;
+        if (VmbFeatureStringGet(handle, name, NULL, 0, &size) != VmbErrorSuccess || size == 0)
+        {
+            return NULL;
+        }
+        gchar *value = g_malloc(size);
+        if (VmbFeatureStringGet(handle, name, value, size, NULL) != VmbErrorSuccess)
+        {
+            g_free(value);
+            return NULL;
+        }
+        return value;
+    }
+    }
+}
+
+/**
+ * @brief Loads the settings file given in "settingsfile" to the camera with VmbSettingsLoad
+ *
+ * @param vmbsrc Provides the settings file path and the camera handle used for the VmbC calls
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t load_settings_file(GstVmbSrc *vmbsrc)
+{
+    VmbFilePathChar_t *buffer;
+#ifdef _WIN32
+    size_t num_char = strlen(vmbsrc->properties.settings_file_path);
+    size_t num_wchar = 0;
+    mbstowcs_s(&num_wchar, NULL, 0, vmbsrc->properties.settings_file_path, num_char);
+    buffer = calloc(num_wchar, sizeof(VmbFilePathChar_t));
+    mbstowcs_s(NULL, buffer, num_wchar, vmbsrc->properties.settings_file_path, num_char);
+#else
+    buffer = vmbsrc->properties.settings_file_path;
+#endif
+    VmbError_t result = VmbSettingsLoad(vmbsrc->camera.handle,
+                                        buffer,
+                                        NULL,
+                                        sizeof(VmbFeaturePersistSettings_t));
+#ifdef _WIN32
+    free(buffer);
+#endif
+    if (result != VmbErrorSuccess)
+    {
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Could not load settings from file \"%s\". Got error code %s",
+                         vmbsrc->properties.settings_file_path,
+                         ErrorCodeToMessage(result));
+    }
+    return result;
+}
+
+/**
+ * @brief Marks the camera state as no longer matching any previously applied settings file. Called by the functions
+ * writing camera features from element properties, so that the next start applies the settings file again. Features
+ * written at every start after the settings file (PixelFormat and the action, chunk and event settings) and formats
+ * that are only tried on the camera and restored do not forget the settings
+ *
+ * @param vmbsrc Element whose camera state changed
+ */
+void forget_applied_settings(GstVmbSrc *vmbsrc)
+{
+    GstVmbSrcSession *session = get_session(vmbsrc->camera.id);
+    g_mutex_lock(&session_lock);
+    g_free(session->applied_settings_checksum);
+    session->applied_settings_checksum = NULL;
+    g_mutex_unlock(&session_lock);
+}
+
+/**
+ * @brief Applies the values defiend in the vmbsrc properties to their corresponding camera features
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
+ * modified features
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t apply_feature_settings(GstVmbSrc *vmbsrc)
+{
+    bool was_acquiring = vmbsrc->camera.is_acquiring;
+    if (vmbsrc->camera.is_acquiring)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Camera was acquiring. Stopping to change feature settings");
+        stop_image_acquisition(vmbsrc);
+    }
+
+    // All property values are written now, including changes that were waiting for an acquisition restart
+    GST_OBJECT_LOCK(vmbsrc);
+    vmbsrc->pending_features = 0;
+    GST_OBJECT_UNLOCK(vmbsrc);
+
+    VmbError_t result = apply_features(vmbsrc,
+                                       GST_VMBSRC_FEATURE_EXPOSURETIME | GST_VMBSRC_FEATURE_EXPOSUREAUTO |
+                                           GST_VMBSRC_FEATURE_BALANCEWHITEAUTO | GST_VMBSRC_FEATURE_GAIN);
+
+    // Binning and decimation change the sensor size the ROI is fitted into
+    result = apply_binning_settings(vmbsrc);
+
+    result = set_roi(vmbsrc);
+
+    result = apply_features(vmbsrc, GST_VMBSRC_FEATURE_TRIGGER);
+
+    // The frame rate range depends on the trigger settings
+    result = apply_features(vmbsrc, GST_VMBSRC_FEATURE_FRAMERATE);
+
+    if (was_acquiring)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Camera was acquiring before changing feature settings. Restarting.");
+        result = start_image_acquisition(vmbsrc);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Writes the values of the vmbsrc properties belonging to the given features to the camera
+ *
+ * Does not check whether the features are currently writable. Failures are logged and the remaining features are
+ * written regardless.
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
+ * modified features
+ * @param features GstVmbSrcFeatureFlags selecting the features to write
+ * @return VmbError_t Return status of the last written feature
+ */
+VmbError_t apply_features(GstVmbSrc *vmbsrc, guint features)
+{
+    VmbError_t result = VmbErrorSuccess;
+    GEnumValue *enum_entry;
+
+    // The camera state no longer matches a previously applied settings file
+    forget_applied_settings(vmbsrc);
+
+    // exposure time
+    // TODO: Workaround for cameras with legacy "ExposureTimeAbs" feature should be replaced with a general legacy
+    // feature name handling approach: A static table maps each property, e.g. "exposuretime", to a list of (feature
+    // name, set function, get function) pairs, e.g. [("ExposureTime", setExposureTime, getExposureTime),
+    // ("ExposureTimeAbs", setExposureTimeAbs, getExposureTimeAbs)]. On startup, the feature list of the connected
+    // camera obtained from VmbFeaturesList() is used to determine which set/get function to use.
+
+    if (features & GST_VMBSRC_FEATURE_EXPOSURETIME)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"ExposureTime\" to %f", vmbsrc->properties.exposuretime);
+        result = FeatureFloatSetIfChanged(vmbsrc->camera.handle, "ExposureTime", vmbsrc->properties.exposuretime);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        }
+        else if (result == VmbErrorNotFound)
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Failed to set \"ExposureTime\" to %f. Return code was: %s Attempting \"ExposureTimeAbs\"",
+                               vmbsrc->properties.exposuretime,
+                               ErrorCodeToMessage(result));
+            result = FeatureFloatSetIfChanged(vmbsrc->camera.handle, "ExposureTimeAbs", vmbsrc->properties.exposuretime);
+            if (result == VmbErrorSuccess)
+            {
+                GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+            }
+            else
+            {
+                GST_WARNING_OBJECT(vmbsrc,
+                                   "Failed to set \"ExposureTimeAbs\" to %f. Return code was: %s",
+                                   vmbsrc->properties.exposuretime,
+                                   ErrorCodeToMessage(result));
+            }
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Failed to set \"ExposureTime\" to %f. Return code was: %s",
+                               vmbsrc->properties.exposuretime,
+                               ErrorCodeToMessage(result));
+        }
+    }
+
+    // Exposure Auto
+    if (features & GST_VMBSRC_FEATURE_EXPOSUREAUTO)
+    {
+        enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_EXPOSUREAUTO_MODES), vmbsrc->properties.exposureauto);
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"ExposureAuto\" to %s", enum_entry->value_nick);
+        result = FeatureEnumSetIfChanged(vmbsrc->camera.handle, "ExposureAuto", enum_entry->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Failed to set \"ExposureAuto\" to %s. Return code was: %s",
+                               enum_entry->value_nick,
+                               ErrorCodeToMessage(result));
+        }
+    }
+
+    // Auto whitebalance
+    if (features & GST_VMBSRC_FEATURE_BALANCEWHITEAUTO)
+    {
+        enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_BALANCEWHITEAUTO_MODES),
+                                      vmbsrc->properties.balancewhiteauto);
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"BalanceWhiteAuto\" to %s", enum_entry->value_nick);
+        result = FeatureEnumSetIfChanged(vmbsrc->camera.handle, "BalanceWhiteAuto", enum_entry->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Failed to set \"BalanceWhiteAuto\" to %s. Return code was: %s",
+                               enum_entry->value_nick,
+                               ErrorCodeToMessage(result));
+        }
+    }
+
+    // gain
+    if (features & GST_VMBSRC_FEATURE_GAIN)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"Gain\" to %f", vmbsrc->properties.gain);
+        result = FeatureFloatSetIfChanged(vmbsrc->camera.handle, "Gain", vmbsrc->properties.gain);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Failed to set \"Gain\" to %f. Return code was: %s",
+                               vmbsrc->properties.gain,
+                               ErrorCodeToMessage(result));
+        }
+    }
+
+    // trigger
+    if (features & GST_VMBSRC_FEATURE_TRIGGER)
+    {
+        result = apply_trigger_settings(vmbsrc);
+    }
+
+    // frame rate
+    if (features & GST_VMBSRC_FEATURE_FRAMERATE)
+    {
+        bool is_limited_by_camera = vmbsrc->properties.max_framerate > 0 &&
+                                    limit_acquisition_framerate(vmbsrc, vmbsrc->properties.max_framerate);
+        g_atomic_int_set(&vmbsrc->is_framerate_limited_by_camera, is_limited_by_camera);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Lets the camera acquire frames at the given rate via "AcquisitionFrameRate" (or the legacy
+ * "AcquisitionFrameRateAbs"). Rates below the range of the camera are set to its lowest rate
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls
+ * @param framerate Requested frame rate in frames per second
+ * @return true if the camera acquires at most framerate frames per second. Otherwise frames exceeding the rate must be
+ * dropped by the element
+ */
+bool limit_acquisition_framerate(GstVmbSrc *vmbsrc, double framerate)
+{
+    forget_applied_settings(vmbsrc);
+    // Cameras without the feature always apply AcquisitionFrameRate
+    VmbError_t result = VmbFeatureBoolSet(vmbsrc->camera.handle, "AcquisitionFrameRateEnable", VmbBoolTrue);
+    if (result != VmbErrorSuccess && result != VmbErrorNotFound)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "Failed to set \"AcquisitionFrameRateEnable\" to true. Return code was: %s",
+                         ErrorCodeToMessage(result));
+    }
+
+    const char *feature = "AcquisitionFrameRate";
+    double min_framerate = 0;
+    double max_framerate = 0;
+    result = VmbFeatureFloatRangeQuery(vmbsrc->camera.handle, feature, &min_framerate, &max_framerate);
+    if (result == VmbErrorNotFound)
+    {
+        feature = "AcquisitionFrameRateAbs";
+        result = VmbFeatureFloatRangeQuery(vmbsrc->camera.handle, feature, &min_framerate, &max_framerate);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        double camera_framerate = CLAMP(framerate, min_framerate, max_framerate);
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"%s\" to %f", feature, camera_framerate);
+        result = FeatureFloatSetIfChanged(vmbsrc->camera.handle, feature, camera_framerate);
+        if (result == VmbErrorSuccess)
+        {
+            if (camera_framerate <= framerate)
+            {
+                return true;
+            }
+            GST_INFO_OBJECT(vmbsrc,
+                            "Camera can not acquire slower than %f frames per second. Dropping frames in the element",
+                            camera_framerate);
+            return false;
+        }
+    }
+    GST_INFO_OBJECT(vmbsrc,
+                    "Failed to set \"%s\" to %f. Return code was: %s Dropping frames in the element instead",
+                    feature,
+                    framerate,
+                    ErrorCodeToMessage(result));
+    return false;
+}
+
+/**
+ * @brief Writes "binning" and "decimation" to the horizontal and vertical binning and decimation features
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values
+ * @return VmbError_t Return status of the last written feature
+ */
+VmbError_t apply_binning_settings(GstVmbSrc *vmbsrc)
+{
+    forget_applied_settings(vmbsrc);
+    const struct
+    {
+        guint value;
+        const char *features[2];
+    } settings[] = {
+        {vmbsrc->properties.binning, {"BinningHorizontal", "BinningVertical"}},
+        {vmbsrc->properties.decimation, {"DecimationHorizontal", "DecimationVertical"}}};
+
+    VmbError_t result = VmbErrorSuccess;
+    for (size_t i = 0; i < sizeof(settings) / sizeof(settings[0]); i++)
+    {
+        if (settings[i].value == 0)
+        {
+            continue;
+        }
+        for (size_t j = 0; j < 2; j++)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting \"%s\" to %u", settings[i].features[j], settings[i].value);
+            result = FeatureIntSetIfChanged(vmbsrc->camera.handle, settings[i].features[j], settings[i].value);
+            if (result != VmbErrorSuccess)
+            {
+                GST_WARNING_OBJECT(vmbsrc,
+                                   "Failed to set \"%s\" to %u. Return code was: %s",
+                                   settings[i].features[j],
+                                   settings[i].value,
+                                   ErrorCodeToMessage(result));
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Checks whether vimbax_frame_callback should requeue a received frame right away because of "frameskip" or
+ * because it exceeds "maxframerate" and the camera does not limit its frame rate itself
+ *
+ * @param vmbsrc Holds the rate settings and the state of the frame dropping
+ * @param receive_time Monotonic time (in microseconds) at which the frame was received
+ * @return true if the frame should be dropped
+ */
+bool is_frame_rate_limited(GstVmbSrc *vmbsrc, gint64 receive_time)
+{
+    double max_framerate = vmbsrc->properties.max_framerate;
+    if (max_framerate > 0 && !g_atomic_int_get(&vmbsrc->is_framerate_limited_by_camera))
+    {
+        if (receive_time < vmbsrc->next_push_time)
+        {
+            return true;
+        }
+        gint64 interval = (gint64)(G_USEC_PER_SEC / max_framerate);
+        // Stay on the grid of the rate unless frames arrived too slowly to keep up with it
+        vmbsrc->next_push_time = receive_time - vmbsrc->next_push_time < interval ? vmbsrc->next_push_time + interval
+                                                                                   : receive_time + interval;
+    }
+    if (vmbsrc->frames_until_push > 0)
+    {
+        vmbsrc->frames_until_push--;
+        return true;
+    }
+    vmbsrc->frames_until_push = vmbsrc->properties.frame_skip;
+    return false;
+}
+
+/**
+ * @brief Determines the rate at which frames are pushed from the frame rate of the camera, "maxframerate" and
+ * "frameskip". The frame rate of the camera follows changes of the exposure time and bandwidth, so it is only reported
+ * as fixed rate if one of the properties requests a rate. Otherwise the rate is variable and the frame rate of the
+ * camera is its upper bound
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the rate settings
+ * @param framerate_num Holds the numerator of the frame rate. 0 if the frame rate is variable
+ * @param framerate_denom Holds the denominator of the frame rate
+ * @param max_framerate_num Holds the numerator of the highest frame rate
+ * @param max_framerate_denom Holds the denominator of the highest frame rate
+ * @return false if no upper bound of the frame rate is known, e.g. because the camera is triggered. The frame rate is
+ * variable then
+ */
+bool get_output_framerate(GstVmbSrc *vmbsrc,
+                          gint *framerate_num,
+                          gint *framerate_denom,
+                          gint *max_framerate_num,
+                          gint *max_framerate_denom)
+{
+    *framerate_num = 0;
+    *framerate_denom = 1;
+
+    const char *trigger_mode;
+    if (VmbFeatureEnumGet(vmbsrc->camera.handle, "TriggerMode", &trigger_mode) == VmbErrorSuccess &&
+        strcmp(trigger_mode, "On") == 0)
+    {
+        return false;
+    }
+
+    // The resulting frame rate also accounts for limits of the exposure time and bandwidth
+    static const char *framerate_features[] = {"AcquisitionResultingFrameRate", "AcquisitionFrameRate", "AcquisitionFrameRateAbs"};
+    double framerate = 0;
+    for (size_t i = 0; i < sizeof(framerate_features) / sizeof(framerate_features[0]) && framerate <= 0; i++)
+    {
+        if (VmbFeatureFloatGet(vmbsrc->camera.handle, framerate_features[i], &framerate) != VmbErrorSuccess)
+        {
+            framerate = 0;
+        }
+    }
+    if (framerate <= 0)
+    {
+        return false;
+    }
+
+    if (vmbsrc->properties.max_framerate > 0)
+    {
+        framerate = MIN(framerate, vmbsrc->properties.max_framerate);
+    }
+    framerate /= (double)vmbsrc->properties.frame_skip + 1;
+    gst_util_double_to_fraction(framerate, max_framerate_num, max_framerate_denom);
+    if (vmbsrc->properties.max_framerate > 0 || vmbsrc->properties.frame_skip > 0)
+    {
+        *framerate_num = *max_framerate_num;
+        *framerate_denom = *max_framerate_denom;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether all camera features written for the given features can currently be written
+ *
+ * Features the camera does not provide are considered writable. Writing them fails regardless of the acquisition state
+ * and is reported when they are written.
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the property values deciding
+ * which trigger features are written
+ * @param features GstVmbSrcFeatureFlags selecting the features to check
+ * @return true if every feature reports write access
+ */
+bool are_features_writable(GstVmbSrc *vmbsrc, guint features)
+{
+    const char *feature_names[8];
+    size_t num_features = 0;
+    if (features & GST_VMBSRC_FEATURE_EXPOSURETIME)
+    {
+        feature_names[num_features++] = "ExposureTime";
+    }
+    if (features & GST_VMBSRC_FEATURE_EXPOSUREAUTO)
+    {
+        feature_names[num_features++] = "ExposureAuto";
+    }
+    if (features & GST_VMBSRC_FEATURE_BALANCEWHITEAUTO)
+    {
+        feature_names[num_features++] = "BalanceWhiteAuto";
+    }
+    if (features & GST_VMBSRC_FEATURE_GAIN)
+    {
+        feature_names[num_features++] = "Gain";
+    }
+    if (features & GST_VMBSRC_FEATURE_TRIGGER)
+    {
+        // Only features that apply_trigger_settings actually changes
+        if (vmbsrc->properties.triggerselector != GST_VMBSRC_TRIGGERSELECTOR_UNCHANGED)
+        {
+            feature_names[num_features++] = "TriggerSelector";
+        }
+        if (vmbsrc->properties.triggeractivation != GST_VMBSRC_TRIGGERACTIVATION_UNCHANGED)
+        {
+            feature_names[num_features++] = "TriggerActivation";
+        }
+        if (vmbsrc->properties.triggersource != GST_VMBSRC_TRIGGERSOURCE_UNCHANGED)
+        {
+            feature_names[num_features++] = "TriggerSource";
+        }
+        if (vmbsrc->properties.triggermode != GST_VMBSRC_TRIGGERMODE_UNCHANGED)
+        {
+            feature_names[num_features++] = "TriggerMode";
+        }
+    }
+    if ((features & GST_VMBSRC_FEATURE_FRAMERATE) && vmbsrc->properties.max_framerate > 0)
+    {
+        feature_names[num_features++] = "AcquisitionFrameRate";
+    }
+
+    for (size_t i = 0; i < num_features; i++)
+    {
+        VmbBool_t is_readable = VmbBoolFalse;
+        VmbBool_t is_writable = VmbBoolFalse;
+        VmbError_t result = VmbFeatureAccessQuery(vmbsrc->camera.handle,
+                                                  feature_names[i],
+                                                  &is_readable,
+                                                  &is_writable);
+        if (result == VmbErrorNotFound && strcmp(feature_names[i], "ExposureTime") == 0)
+        {
+            // Legacy feature name also used by apply_features
+            result = VmbFeatureAccessQuery(vmbsrc->camera.handle, "ExposureTimeAbs", &is_readable, &is_writable);
+        }
+        if (result == VmbErrorNotFound)
+        {
+            continue;
+        }
+        if (result != VmbErrorSuccess || !is_writable)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "\"%s\" is currently not writable", feature_names[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a feature whose property was changed to the camera if the camera is acquiring
+ *
+ * Features that are writable while acquiring are written immediately. Other features are remembered in
+ * pending_features and written by the next create call, which stops and restarts the acquisition once for all features
+ * changed in the meantime. If the camera is not acquiring nothing is written here, as all features are written by
+ * apply_feature_settings when the element is started.
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
+ * modified features
+ * @param feature The feature whose property was changed
+ */
+void update_feature(GstVmbSrc *vmbsrc, GstVmbSrcFeatureFlags feature)
+{
+    if (!vmbsrc->camera.is_acquiring)
+    {
+        return;
+    }
+    if (are_features_writable(vmbsrc, feature))
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Writing changed feature while acquiring");
+        apply_features(vmbsrc, feature);
+        return;
+    }
+
+    GST_DEBUG_OBJECT(vmbsrc, "Feature can not be written while acquiring. Deferring it to a restart of the acquisition");
+    GST_OBJECT_LOCK(vmbsrc);
+    vmbsrc->pending_features |= feature;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    // A create call might wait a long time for the next frame, e.g. if the camera waits for a trigger
+    if (vmbsrc->filled_frame_queue != NULL)
+    {
+        g_async_queue_push(vmbsrc->filled_frame_queue, &feature_update_sentinel_frame);
+    }
+}
+
+/**
+ * @brief Writes the features remembered in pending_features, restarting the acquisition if the camera is acquiring
+ *
+ * Frames that were already filled when the acquisition is stopped are dropped and queued again for capturing.
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
+ * modified features
+ * @return VmbError_t Return status of restarting the acquisition
+ */
+VmbError_t apply_pending_features(GstVmbSrc *vmbsrc)
+{
+    GST_OBJECT_LOCK(vmbsrc);
+    guint features = vmbsrc->pending_features;
+    vmbsrc->pending_features = 0;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    if (features == 0)
+    {
+        return VmbErrorSuccess;
+    }
+    if (!vmbsrc->camera.is_acquiring)
+    {
+        // Acquisition was stopped in the meantime, so the features are writable now
+        apply_features(vmbsrc, features);
+        return VmbErrorSuccess;
+    }
+
+    GST_DEBUG_OBJECT(vmbsrc, "Restarting acquisition to write features that are not writable while acquiring");
+    stop_image_acquisition(vmbsrc);
+
+    drain_filled_frame_queue(vmbsrc);
+
+    apply_features(vmbsrc, features);
+
+    VmbError_t result = start_image_acquisition(vmbsrc);
+    if (result != VmbErrorSuccess)
+    {
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Could not restart acquisition after writing features. Got error code: %s",
+                         ErrorCodeToMessage(result));
+    }
+    return result;
+}
+
+/**
+ * @brief Helper function to set Width, Height, OffsetX and OffsetY feature in correct order to define the region of
+ * interest (ROI) on the sensor.
+ *
+ * The values for setting the ROI are defined as GStreamer properties of the vmbsrc element. If INT_MAX are used for
+ * the width/height property (the default value) the full corresponding sensor size for that feature is used.
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
+ * modified features
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t set_roi(GstVmbSrc *vmbsrc)
+{
+    forget_applied_settings(vmbsrc);
+    // TODO: Improve error handling (Perhaps more explicit allowed values are enough?) Early exit on errors?
+
+    // Remember the current image size to invalidate the cached caps only if it actually changes
+    VmbInt64_t previous_width = 0;
+    VmbInt64_t previous_height = 0;
+    VmbFeatureIntGet(vmbsrc->camera.handle, "Width", &previous_width);
+    VmbFeatureIntGet(vmbsrc->camera.handle, "Height", &previous_height);
+
+    // Reset OffsetX and OffsetY to 0 so that full sensor width is usable for width/height
+    VmbError_t result;
+    GST_DEBUG_OBJECT(vmbsrc, "Temporarily resetting \"OffsetX\" and \"OffsetY\" to 0");
+    result = FeatureIntSetIfChanged(vmbsrc->camera.handle, "OffsetX", 0);
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to set \"OffsetX\" to 0. Return code was: %s",
+                           ErrorCodeToMessage(result));
+    }
+    result = FeatureIntSetIfChanged(vmbsrc->camera.handle, "OffsetY", 0);
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to set \"OffsetY\" to 0. Return code was: %s",
+                           ErrorCodeToMessage(result));
+    }
+
+    VmbInt64_t vmb_width;
+    result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "Width", NULL, &vmb_width);
+
+    // Set Width to full sensor if no explicit width was set
+    if (vmbsrc->properties.width == INT_MAX)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "Setting \"Width\" to full width. Got sensor width \"%lld\" (Return Code %s)",
+                         vmb_width,
+                         ErrorCodeToMessage(result));
+        g_object_set(vmbsrc, "width", (int)vmb_width, NULL);
+    }
+    GST_DEBUG_OBJECT(vmbsrc, "Setting \"Width\" to %d", vmbsrc->properties.width);
+    result = FeatureIntSetIfChanged(vmbsrc->camera.handle, "Width", vmbsrc->properties.width);
+    if (result == VmbErrorSuccess)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+    }
+    else
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to set \"Width\" to value \"%d\". Return code was: %s",
+                           vmbsrc->properties.width,
+                           ErrorCodeToMessage(result));
+    }
+
+    VmbInt64_t vmb_height;
+    result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "Height", NULL, &vmb_height);
+    // Set Height to full sensor if no explicit height was set
+    if (vmbsrc->properties.height == INT_MAX)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "Setting \"Height\" to full height. Got sensor height \"%lld\" (Return Code %s)",
+                         vmb_height,
+                         ErrorCodeToMessage(result));
+        g_object_set(vmbsrc, "height", (int)vmb_height, NULL);
+    }
+    GST_DEBUG_OBJECT(vmbsrc, "Setting \"Height\" to %d", vmbsrc->properties.height);
+    result = FeatureIntSetIfChanged(vmbsrc->camera.handle, "Height", vmbsrc->properties.height);
+    if (result == VmbErrorSuccess)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+    }
+    else
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to set \"Height\" to value \"%d\". Return code was: %s",
+                           vmbsrc->properties.height,
+                           ErrorCodeToMessage(result));
+    }
+    // offsetx
+    if (vmbsrc->properties.offsetx == -1)
+    {
+        VmbInt64_t vmb_offsetx = (vmb_width - vmbsrc->properties.width) >> 1;
+        GST_DEBUG_OBJECT(vmbsrc, "ROI centering along x-axis requested. Desired offsetx=%lld",
+                         vmb_offsetx);
+        // Check if the desired value is valid. If not round to nearest valid value
+        VmbInt64_t offsetx_min = 0;
+        VmbInt64_t offsetx_max = 0;
+        VmbInt64_t offsetx_increment = 0;
+        result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "OffsetX", &offsetx_min, &offsetx_max);
+        if (result == VmbErrorSuccess)
+        {
+            result = VmbFeatureIntIncrementQuery(vmbsrc->camera.handle, "OffsetX", &offsetx_increment);
+            if (result == VmbErrorSuccess)
+            {
+                VmbInt64_t valid_vmb_offsetx = RoundToNearestValidValue(vmb_offsetx, offsetx_min, offsetx_max, offsetx_increment);
+                if (valid_vmb_offsetx != vmb_offsetx)
+                {
+                    GST_DEBUG_OBJECT(vmbsrc,
+                                     "Desired offsetx=%lld was not valid. Using nearest valid value=%lld",
+                                     vmb_offsetx,
+                                     valid_vmb_offsetx);
+                    vmb_offsetx = valid_vmb_offsetx;
+                }
+            }
+            else
+            {
+                GST_DEBUG_OBJECT(vmbsrc,
+                                 "Error during imcrement query for OffsetX. Using inital desired value: %s",
+                                 ErrorCodeToMessage(result));
+            }
+        }
+        else
+        {
+            GST_DEBUG_OBJECT(vmbsrc,
+                             "Error during range query for OffsetX. Using inital desired value: %s",
+                             ErrorCodeToMessage(result));
+        }
+        g_object_set(vmbsrc, "offsetx", (int)vmb_offsetx, NULL);
+    }
+    GST_DEBUG_OBJECT(vmbsrc, "Setting \"OffsetX\" to %d", vmbsrc->properties.offsetx);
+    result = FeatureIntSetIfChanged(vmbsrc->camera.handle, "OffsetX", vmbsrc->properties.offsetx);
+    if (result == VmbErrorSuccess)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+    }
+    else
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to set \"OffsetX\" to value \"%d\". Return code was: %s",
+                           vmbsrc->properties.offsetx,
+                           ErrorCodeToMessage(result));
+    }
+
+    // offsety
+    if (vmbsrc->properties.offsety == -1)
+    {
+        VmbInt64_t vmb_offsety = (vmb_height - vmbsrc->properties.height) >> 1;
+        GST_DEBUG_OBJECT(vmbsrc, "ROI centering along y-axis requested. Desired offsety=%lld",
+                         vmb_offsety);
+        // Check if the desired value is valid. If not round to nearest valid value
+        VmbInt64_t offsety_min = 0;
+        VmbInt64_t offsety_max = 0;
+        VmbInt64_t offsety_increment = 0;
+        result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "OffsetY", &offsety_min, &offsety_max);
+        if (result == VmbErrorSuccess)
+        {
+            result = VmbFeatureIntIncrementQuery(vmbsrc->camera.handle, "OffsetY", &offsety_increment);
+            if (result == VmbErrorSuccess)
+            {
+                VmbInt64_t valid_vmb_offsety = RoundToNearestValidValue(vmb_offsety, offsety_min, offsety_max, offsety_increment);
+                if (valid_vmb_offsety != vmb_offsety)
+                {
+                    GST_DEBUG_OBJECT(vmbsrc,
+                                     "Desired offsety=%lld was not valid. Using nearest valid value=%lld",
+                                     vmb_offsety,
+                                     valid_vmb_offsety);
+                    vmb_offsety = valid_vmb_offsety;
+                }
+            }
+            else
+            {
+                GST_DEBUG_OBJECT(vmbsrc,
+                                 "Error during imcrement query for OffsetY. Using inital desired value: %s",
+                                 ErrorCodeToMessage(result));
+            }
+        }
+        else
+        {
+            GST_DEBUG_OBJECT(vmbsrc,
+                             "Error during range query for OffsetY. Using inital desired value: %s",
+                             ErrorCodeToMessage(result));
+        }
+        g_object_set(vmbsrc, "offsety", (int)vmb_offsety, NULL);
+    }
+    GST_DEBUG_OBJECT(vmbsrc, "Setting \"OffsetY\" to %d", vmbsrc->properties.offsety);
+    result = FeatureIntSetIfChanged(vmbsrc->camera.handle, "OffsetY", vmbsrc->properties.offsety);
+    if (result == VmbErrorSuccess)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+    }
+    else
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to set \"OffsetY\" to value \"%d\". Return code was: %s",
+                           vmbsrc->properties.offsety,
+                           ErrorCodeToMessage(result));
+    }
+
+    // Not every transport layer reports invalidations of features changed by the application itself
+    if (previous_width != vmbsrc->properties.width || previous_height != vmbsrc->properties.height)
+    {
+        invalidate_cached_caps(vmbsrc);
+    }
+    return result;
+}
+
+/**
+ * @brief Helper function to apply values to TriggerSelector, TriggerMode, TriggerSource and TriggerActivation in the
+ * correct order
+ *
+ * Trigger settings are always applied in the order
+ * 1. TriggerSelector
+ * 2. TriggerActivation
+ * 3. TriggerSource
+ * 4. TriggerMode
+ *
+ * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
+ * modified features
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t apply_trigger_settings(GstVmbSrc *vmbsrc)
+{
+    forget_applied_settings(vmbsrc);
+    GST_DEBUG_OBJECT(vmbsrc, "Applying trigger settings");
+
+    VmbError_t result = VmbErrorSuccess;
+    GEnumValue *enum_entry;
+    bool is_source_software = false;
+    bool is_mode_on = false;
+
+    // TODO: Should  the function start by disabling triggering for all TriggerSelectors to make sure only one is
+    // enabled after the function is done?
+
+    // TriggerSelector
+    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERSELECTOR_VALUES),
+                                  vmbsrc->properties.triggerselector);
+    if (enum_entry->value == GST_VMBSRC_TRIGGERSELECTOR_UNCHANGED)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "\"TriggerSelector\" is set to %s. Not changing camera value", enum_entry->value_nick);
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerSelector\" to %s", enum_entry->value_nick);
+        result = FeatureEnumSetIfChanged(vmbsrc->camera.handle, "TriggerSelector", enum_entry->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        }
+        else
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to set \"TriggerSelector\" to %s. Return code was: %s",
+                             enum_entry->value_nick,
+                             ErrorCodeToMessage(result));
+            if (result == VmbErrorInvalidValue)
+            {
+                log_available_enum_entries(vmbsrc, "TriggerSelector");
+            }
+        }
+    }
+
+    // TriggerActivation
+    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERACTIVATION_VALUES),
+                                  vmbsrc->properties.triggeractivation);
+    if (enum_entry->value == GST_VMBSRC_TRIGGERACTIVATION_UNCHANGED)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "\"TriggerActivation\" is set to %s. Not changing camera value", enum_entry->value_nick);
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerActivation\" to %s", enum_entry->value_nick);
+        result = FeatureEnumSetIfChanged(vmbsrc->camera.handle, "TriggerActivation", enum_entry->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        }
+        else
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to set \"TriggerActivation\" to %s. Return code was: %s",
+                             enum_entry->value_nick,
+                             ErrorCodeToMessage(result));
+            if (result == VmbErrorInvalidValue)
+            {
+                log_available_enum_entries(vmbsrc, "TriggerActivation");
+            }
+        }
+    }
+
+    // TriggerSource
+    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERSOURCE_VALUES),
+                                  vmbsrc->properties.triggersource);
+    if (enum_entry->value == GST_VMBSRC_TRIGGERSOURCE_UNCHANGED)
+    {
+
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "\"TriggerSource\" is set to %s. Not changing camera value", enum_entry->value_nick);
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerSource\" to %s", enum_entry->value_nick);
+        result = FeatureEnumSetIfChanged(vmbsrc->camera.handle, "TriggerSource", enum_entry->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+            is_source_software = enum_entry->value == GST_VMBSRC_TRIGGERSOURCE_SOFTWARE;
+        }
+        else
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to set \"TriggerSource\" to %s. Return code was: %s",
+                             enum_entry->value_nick,
+                             ErrorCodeToMessage(result));
+            if (result == VmbErrorInvalidValue)
+            {
+                log_available_enum_entries(vmbsrc, "TriggerSource");
+            }
+        }
+    }
+
+    // TriggerMode
+    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERMODE_VALUES),
+                                  vmbsrc->properties.triggermode);
+    if (enum_entry->value == GST_VMBSRC_TRIGGERMODE_UNCHANGED)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "\"TriggerMode\" is set to %s. Not changing camera value", enum_entry->value_nick);
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerMode\" to %s", enum_entry->value_nick);
+        result = FeatureEnumSetIfChanged(vmbsrc->camera.handle, "TriggerMode", enum_entry->value_nick);
+        if (result == VmbErrorSuccess)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+            is_mode_on = enum_entry->value == GST_VMBSRC_TRIGGERMODE_ON;
+        }
+        else
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Failed to set \"TriggerMode\" to %s. Return code was: %s",
+                             enum_entry->value_nick,
+                             ErrorCodeToMessage(result));
+        }
+    }
+
+    // Triggers sent before the change are not assigned to frames captured afterwards
+    GST_OBJECT_LOCK(vmbsrc);
+    vmbsrc->is_software_triggered = is_source_software && is_mode_on;
+    vmbsrc->num_triggered_frames = vmbsrc->num_software_triggers;
+    vmbsrc->last_triggered_frame_id = 0;
+    GST_OBJECT_UNLOCK(vmbsrc);
+
+    return result;
+}
+
+/**
+ * @brief Gets the PayloadSize from the connected camera, allocates and announces frame buffers for capturing
+ *
+ * Unless frames are taken from the buffer pool, they are allocated large enough for the PayloadSize of every
+ * supported pixel format (see get_max_payload_size).
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and holds the frame buffers
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t alloc_and_announce_buffers(GstVmbSrc *vmbsrc)
+{
+    VmbUint32_t payload_size;
+    VmbError_t result = VmbPayloadSizeGet(vmbsrc->camera.handle, &payload_size);
+    if (result == VmbErrorSuccess)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Got \"PayloadSize\" of: %u", payload_size);
+        if (vmbsrc->properties.allocation_mode != GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS)
+        {
+            // Pool buffers are sized for the negotiated caps. Other frames are large enough for every supported format
+            // so that changing the pixel format does not require reallocating them
+            payload_size = MAX(payload_size, get_max_payload_size(vmbsrc));
+            GST_DEBUG_OBJECT(vmbsrc, "Allocating frames with %u bytes to fit all supported pixel formats", payload_size);
+        }
+        GST_DEBUG_OBJECT(vmbsrc, "Allocating and announcing %u VimbaX frames", vmbsrc->properties.num_frame_buffers);
+        GEnumValue *allocation_mode = g_enum_get_value(g_type_class_ref(GST_ENUM_ALLOCATIONMODE_VALUES), vmbsrc->properties.allocation_mode);
+        GST_DEBUG_OBJECT(vmbsrc, "Using allocation mode %s", allocation_mode->value_nick);
+        g_mutex_lock(&vmbsrc->frame_lock);
+        for (guint i = 0; i < vmbsrc->properties.num_frame_buffers; i++)
+        {
+            result = announce_frame(vmbsrc, payload_size);
+            if (result != VmbErrorSuccess)
+            {
+                break;
+            }
+        }
+        vmbsrc->can_grow_frame_buffers = true;
+        g_mutex_unlock(&vmbsrc->frame_lock);
+    }
+    return result;
+}
+
+/**
+ * @brief Determines the largest PayloadSize of all supported pixel formats with the current ROI
+ *
+ * Every supported pixel format is set on the camera to read its PayloadSize. The previous pixel format is restored
+ * afterwards. Must only be called while the camera is not acquiring.
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and the supported formats
+ * @return VmbUint32_t Largest PayloadSize or 0 if it could not be determined for any format
+ */
+VmbUint32_t get_max_payload_size(GstVmbSrc *vmbsrc)
+{
+    const char *current_format = NULL;
+    if (VmbFeatureEnumGet(vmbsrc->camera.handle, "PixelFormat", &current_format) != VmbErrorSuccess)
+    {
+        return 0;
+    }
+
+    VmbUint32_t max_payload_size = 0;
+    for (VmbUint32_t i = 0; i < vmbsrc->camera.supported_formats_count; i++)
+    {
+        const char *vimbax_format = vmbsrc->camera.supported_formats[i]->vimbax_format_name;
+        VmbUint32_t payload_size;
+        if (VmbFeatureEnumSet(vmbsrc->camera.handle, "PixelFormat", vimbax_format) == VmbErrorSuccess &&
+            VmbPayloadSizeGet(vmbsrc->camera.handle, &payload_size) == VmbErrorSuccess)
+        {
+            GST_TRACE_OBJECT(vmbsrc, "\"PayloadSize\" for \"%s\" is %u", vimbax_format, payload_size);
+            max_payload_size = MAX(max_payload_size, payload_size);
+        }
+    }
+
+    VmbError_t result = VmbFeatureEnumSet(vmbsrc->camera.handle, "PixelFormat", current_format);
+    if (result != VmbErrorSuccess)
+    {
+        GST_ERROR_OBJECT(vmbsrc,
+                         "Could not restore \"PixelFormat\" to \"%s\". Got error code: %s",
+                         current_format,
+                         ErrorCodeToMessage(result));
+    }
+    return max_payload_size;
+}
+
+/**
+ * @brief Allocates a single frame buffer (depending on the allocation mode), announces it and adds it to
+ * vmbsrc->frame_buffers. Must be called with vmbsrc->frame_lock held
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and holds the frame buffers
+ * @param payload_size Size of the frame buffer in bytes
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t announce_frame(GstVmbSrc *vmbsrc, VmbUint32_t payload_size)
+{
+    GstVmbSrcFrame *vmb_frame = g_new0(GstVmbSrcFrame, 1);
+    vmb_frame->vmbsrc = vmbsrc;
+    if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_FRAME || vmbsrc->recorder != NULL)
+    {
+        // The element is responsible for allocating frame buffers. Unbuffered writes of recorded frames need buffers
+        // whose address and size are aligned to the block size, so the element always allocates them while recording
+        gsize alignment = (gsize)get_buffer_alignment(vmbsrc);
+        gsize size = payload_size;
+        if (vmbsrc->recorder != NULL)
+        {
+            alignment = MAX(alignment, RAW_RECORDER_ALIGNMENT);
+            size = GST_ROUND_UP_N(size, RAW_RECORDER_ALIGNMENT);
+        }
+        vmb_frame->frame.buffer = VmbAlignedAlloc(alignment, size);
+        if (NULL == vmb_frame->frame.buffer)
+        {
+            g_free(vmb_frame);
+            return VmbErrorResources;
+        }
+        vmb_frame->owns_buffer = true;
+        if (vmbsrc->properties.pinned_memory)
+        {
+            pin_frame_buffer(vmbsrc, vmb_frame, size);
+        }
+    }
+    else if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS)
+    {
+        // The frame buffer is the memory of a pool buffer. The memory must be CPU accessible (e.g. system memory or
+        // DMABuf) and stays mapped for as long as the frame is announced
+        GstBuffer *pool_buffer = NULL;
+        GstBufferPool *pool = gst_base_src_get_buffer_pool(GST_BASE_SRC(vmbsrc));
+        if (pool != NULL)
+        {
+            GstBufferPoolAcquireParams params = {.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT};
+            if (gst_buffer_pool_acquire_buffer(pool, &pool_buffer, &params) != GST_FLOW_OK)
+            {
+                pool_buffer = NULL;
+            }
+            gst_object_unref(pool);
+        }
+        // Mapping several memories would merge them into a temporary copy the camera data could not be written to
+        if (pool_buffer == NULL ||
+            gst_buffer_n_memory(pool_buffer) != 1 ||
+            !gst_buffer_map(pool_buffer, &vmb_frame->pool_buffer_map, GST_MAP_READWRITE))
+        {
+            GST_ERROR_OBJECT(vmbsrc, "Could not get a mappable buffer from the negotiated buffer pool");
+            if (pool_buffer != NULL)
+            {
+                gst_buffer_unref(pool_buffer);
+            }
+            g_free(vmb_frame);
+            return VmbErrorResources;
+        }
+        vmb_frame->pool_buffer = pool_buffer;
+        if (vmb_frame->pool_buffer_map.size < payload_size)
+        {
+            GST_ERROR_OBJECT(vmbsrc,
+                             "Buffer pool provided %" G_GSIZE_FORMAT " bytes but frames need %u bytes",
+                             vmb_frame->pool_buffer_map.size,
+                             payload_size);
+            free_frame(vmb_frame);
+            return VmbErrorResources;
+        }
+        vmb_frame->frame.buffer = vmb_frame->pool_buffer_map.data;
+    }
+    else
+    {
+        // The transport layer will allocate suitable buffers
+        vmb_frame->frame.buffer = NULL;
+    }
+
+    vmb_frame->frame.bufferSize = payload_size;
+    vmb_frame->frame.context[0] = vmbsrc->recorder != NULL ? vmbsrc->record_queue : vmbsrc->filled_frame_queue;
+    vmb_frame->frame.context[1] = vmb_frame;
+
+    // Announce Frame
+    VmbError_t result = VmbFrameAnnounce(vmbsrc->camera.handle,
+                                         &vmb_frame->frame,
+                                         (VmbUint32_t)sizeof(VmbFrame_t));
+    if (result != VmbErrorSuccess)
+    {
+        free_frame(vmb_frame);
+        return result;
+    }
+    g_ptr_array_add(vmbsrc->frame_buffers, vmb_frame);
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_ANNOUNCE, &vmb_frame->frame, 0);
+    return result;
+}
+
+/**
+ * @brief Collects the requested ROI pads of the element
+ *
+ * @param vmbsrc The element whose pads are collected
+ * @return GList* New references to all GstVmbRoiPads. Free with g_list_free_full(pads, gst_object_unref)
+ */
+GList *get_roi_pads(GstVmbSrc *vmbsrc)
+{
+    GList *pads = NULL;
+    GST_OBJECT_LOCK(vmbsrc);
+    for (GList *pad = GST_ELEMENT(vmbsrc)->srcpads; pad != NULL; pad = pad->next)
+    {
+        if (G_TYPE_CHECK_INSTANCE_TYPE(pad->data, GST_TYPE_VMB_ROI_PAD))
+        {
+            pads = g_list_prepend(pads, gst_object_ref(pad->data));
+        }
+    }
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return pads;
+}
+
+/**
+ * @brief Makes the ROI pads start a new stream with the next frame
+ *
+ * @param vmbsrc The element whose ROI pads are reset
+ */
+void reset_roi_pads(GstVmbSrc *vmbsrc)
+{
+    GList *pads = get_roi_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        GstVmbRoiPad *pad = item->data;
+        GST_OBJECT_LOCK(pad);
+        pad->needs_stream_start = TRUE;
+        GST_OBJECT_UNLOCK(pad);
+        gst_caps_replace(&pad->caps, NULL);
+    }
+    g_list_free_full(pads, gst_object_unref);
+}
+
+/**
+ * @brief Checks whether regions can be cut out of frames in the given format by offsetting into the frame data
+ *
+ * @param info Negotiated format of the frames
+ * @return true for formats with a single plane and a whole number of bytes per pixel
+ */
+bool is_roi_format_supported(const GstVideoInfo *info)
+{
+    const GstVideoFormatInfo *finfo = info->finfo;
+    return finfo != NULL &&
+           GST_VIDEO_FORMAT_INFO_FORMAT(finfo) != GST_VIDEO_FORMAT_UNKNOWN &&
+           GST_VIDEO_FORMAT_INFO_FORMAT(finfo) != GST_VIDEO_FORMAT_ENCODED &&
+           GST_VIDEO_FORMAT_INFO_N_PLANES(finfo) == 1 &&
+           !GST_VIDEO_FORMAT_INFO_IS_TILED(finfo) &&
+           !(GST_VIDEO_FORMAT_INFO_FLAGS(finfo) & GST_VIDEO_FORMAT_FLAG_COMPLEX) &&
+           GST_VIDEO_FORMAT_INFO_PSTRIDE(finfo, 0) > 0;
+}
+
+/**
+ * @brief Sends the events preceding the buffers of an ROI pad and updates its region when the region or the negotiated
+ * frame format changed
+ *
+ * @param vmbsrc Holds the negotiated frame format
+ * @param pad The ROI pad to prepare
+ * @return true if buffers can be pushed on the pad
+ */
+bool prepare_roi_pad(GstVmbSrc *vmbsrc, GstVmbRoiPad *pad)
+{
+    const GstVideoInfo *frame_info = &vmbsrc->video_info;
+    if (!is_roi_format_supported(frame_info))
+    {
+        return false;
+    }
+
+    GST_OBJECT_LOCK(pad);
+    bool needs_stream_start = pad->needs_stream_start;
+    GST_OBJECT_UNLOCK(pad);
+    if (needs_stream_start)
+    {
+        gchar *stream_id = gst_pad_create_stream_id(GST_PAD(pad), GST_ELEMENT(vmbsrc), GST_PAD_NAME(pad));
+        gst_pad_push_event(GST_PAD(pad), gst_event_new_stream_start(stream_id));
+        g_free(stream_id);
+        gst_caps_replace(&pad->caps, NULL);
+    }
+
+    GST_OBJECT_LOCK(pad);
+    bool is_region_changed = pad->is_region_changed;
+    pad->is_region_changed = FALSE;
+    guint x = pad->x;
+    guint y = pad->y;
+    guint width = pad->width;
+    guint height = pad->height;
+    GST_OBJECT_UNLOCK(pad);
+
+    if (pad->caps == NULL ||
+        is_region_changed ||
+        GST_VIDEO_INFO_FORMAT(&pad->frame_info) != GST_VIDEO_INFO_FORMAT(frame_info) ||
+        GST_VIDEO_INFO_WIDTH(&pad->frame_info) != GST_VIDEO_INFO_WIDTH(frame_info) ||
+        GST_VIDEO_INFO_HEIGHT(&pad->frame_info) != GST_VIDEO_INFO_HEIGHT(frame_info))
+    {
+        // Regions of subsampled formats must start and end at whole macro pixels
+        guint x_align = 1;
+        guint y_align = 1;
+        for (guint i = 0; i < GST_VIDEO_INFO_N_COMPONENTS(frame_info); i++)
+        {
+            x_align = MAX(x_align, 1u << GST_VIDEO_FORMAT_INFO_W_SUB(frame_info->finfo, i));
+            y_align = MAX(y_align, 1u << GST_VIDEO_FORMAT_INFO_H_SUB(frame_info->finfo, i));
+        }
+        guint frame_width = GST_VIDEO_INFO_WIDTH(frame_info);
+        guint frame_height = GST_VIDEO_INFO_HEIGHT(frame_info);
+        x = GST_ROUND_DOWN_N(MIN(x, frame_width - x_align), x_align);
+        y = GST_ROUND_DOWN_N(MIN(y, frame_height - y_align), y_align);
+        width = width == 0 || width > frame_width - x ? frame_width - x : width;
+        height = height == 0 || height > frame_height - y ? frame_height - y : height;
+        width = MAX(GST_ROUND_DOWN_N(width, x_align), x_align);
+        height = MAX(GST_ROUND_DOWN_N(height, y_align), y_align);
+
+        GstCaps *caps = gst_video_info_to_caps(frame_info);
+        gst_caps_set_simple(caps, "width", G_TYPE_INT, (gint)width, "height", G_TYPE_INT, (gint)height, NULL);
+        gst_video_info_from_caps(&pad->region_info, caps);
+        pad->frame_info = *frame_info;
+        pad->region_x = x;
+        pad->region_y = y;
+        GST_DEBUG_OBJECT(pad, "Outputting region %ux%u at %u,%u", width, height, x, y);
+        if (!gst_pad_push_event(GST_PAD(pad), gst_event_new_caps(caps)))
+        {
+            GST_WARNING_OBJECT(pad, "Downstream did not accept caps %" GST_PTR_FORMAT, caps);
+        }
+
+        // Buffers can share the frame memory if downstream reads their layout from GstVideoMeta
+        GstQuery *query = gst_query_new_allocation(caps, FALSE);
+        pad->has_video_meta = gst_pad_peer_query(GST_PAD(pad), query) &&
+                              gst_query_find_allocation_meta(query, GST_VIDEO_META_API_TYPE, NULL);
+        gst_query_unref(query);
+        gst_caps_take(&pad->caps, caps);
+    }
+
+    if (needs_stream_start)
+    {
+        GstSegment segment;
+        gst_segment_init(&segment, GST_FORMAT_TIME);
+        gst_pad_push_event(GST_PAD(pad), gst_event_new_segment(&segment));
+        // Camera events are only pushed on the pad from now on, so they can not precede the stream-start and segment
+        GST_OBJECT_LOCK(pad);
+        pad->needs_stream_start = FALSE;
+        GST_OBJECT_UNLOCK(pad);
+    }
+    return true;
+}
+
+/**
+ * @brief Creates the buffer of an ROI pad from an output buffer of the element. If downstream supports GstVideoMeta the
+ * buffer shares the memory of the output buffer and describes the region via its video meta, otherwise the region is
+ * copied
+ *
+ * @param vmbsrc Holds the negotiated frame format
+ * @param pad The prepared ROI pad (see prepare_roi_pad)
+ * @param buffer Output buffer of the element holding the complete frame
+ * @return GstBuffer* Buffer holding the region, or NULL if it could not be created
+ */
+GstBuffer *create_roi_buffer(GstVmbSrc *vmbsrc, GstVmbRoiPad *pad, GstBuffer *buffer)
+{
+    GstVideoMeta *frame_meta = gst_buffer_get_video_meta(buffer);
+    if (frame_meta == NULL)
+    {
+        return NULL;
+    }
+    gsize offset = frame_meta->offset[0] + (gsize)pad->region_y * frame_meta->stride[0] +
+                   (gsize)pad->region_x * GST_VIDEO_FORMAT_INFO_PSTRIDE(vmbsrc->video_info.finfo, 0);
+    guint width = GST_VIDEO_INFO_WIDTH(&pad->region_info);
+    guint height = GST_VIDEO_INFO_HEIGHT(&pad->region_info);
+    // The release of a wrapped pool buffer frame is tied to the memory shared from the pool buffer (see wrap_frame).
+    // Copying the region might share the pool memory itself instead, so the region of such frames is always copied
+    GstMemory *memory = gst_buffer_n_memory(buffer) == 1 ? gst_buffer_peek_memory(buffer, 0) : NULL;
+    bool is_pool_frame = memory != NULL && gst_mini_object_get_qdata(GST_MINI_OBJECT(memory),
+                                                                     g_quark_from_static_string("GstVmbSrcFrame")) != NULL;
+
+    if (pad->has_video_meta && !is_pool_frame)
+    {
+        // Shares the memory, so zero-copy frames are only requeued once the regions were released as well
+        GstBuffer *roi_buffer = gst_buffer_copy_region(buffer, GST_BUFFER_COPY_ALL, 0, -1);
+        GstVideoMeta *meta = gst_buffer_get_video_meta(roi_buffer);
+        if (meta == NULL)
+        {
+            meta = gst_buffer_add_video_meta_full(roi_buffer,
+                                                  GST_VIDEO_FRAME_FLAG_NONE,
+                                                  GST_VIDEO_INFO_FORMAT(&pad->region_info),
+                                                  width,
+                                                  height,
+                                                  1,
+                                                  frame_meta->offset,
+                                                  frame_meta->stride);
+        }
+        meta->width = width;
+        meta->height = height;
+        meta->offset[0] = offset;
+        return roi_buffer;
+    }
+
+    GstBuffer *roi_buffer = gst_buffer_new_allocate(NULL, GST_VIDEO_INFO_SIZE(&pad->region_info), NULL);
+    gst_buffer_copy_into(roi_buffer,
+                         buffer,
+                         GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS | GST_BUFFER_COPY_META,
+                         0,
+                         -1);
+    // The copied video meta describes the complete frame
+    GstVideoMeta *meta = gst_buffer_get_video_meta(roi_buffer);
+    if (meta != NULL)
+    {
+        gst_buffer_remove_meta(roi_buffer, (GstMeta *)meta);
+    }
+    GstMapInfo src_map;
+    GstMapInfo dest_map;
+    if (!gst_buffer_map(buffer, &src_map, GST_MAP_READ))
+    {
+        gst_buffer_unref(roi_buffer);
+        return NULL;
+    }
+    if (!gst_buffer_map(roi_buffer, &dest_map, GST_MAP_WRITE))
+    {
+        gst_buffer_unmap(buffer, &src_map);
+        gst_buffer_unref(roi_buffer);
+        return NULL;
+    }
+    gsize row_size = (gsize)width * GST_VIDEO_FORMAT_INFO_PSTRIDE(vmbsrc->video_info.finfo, 0);
+    gsize dest_stride = (gsize)GST_VIDEO_INFO_PLANE_STRIDE(&pad->region_info, 0);
+    for (guint row = 0; row < height; row++)
+    {
+        memcpy(dest_map.data + row * dest_stride, src_map.data + offset + (gsize)row * frame_meta->stride[0], row_size);
+    }
+    gst_buffer_unmap(roi_buffer, &dest_map);
+    gst_buffer_unmap(buffer, &src_map);
+    return roi_buffer;
+}
+
+/**
+ * @brief Pushes the region of every linked ROI pad cut out of an output buffer. Flow errors of ROI pads are only logged
+ * so that they do not stop the stream of the other pads. The regions are pushed from the streaming thread of the src
+ * pad, so every ROI branch must start with a queue to not block the capture while its consumer is busy
+ *
+ * @param vmbsrc The element whose ROI pads are pushed on
+ * @param buffer Output buffer of the element holding the complete frame. It is not consumed
+ */
+void push_roi_buffers(GstVmbSrc *vmbsrc, GstBuffer *buffer)
+{
+    if (GST_ELEMENT(vmbsrc)->numsrcpads <= 1)
+    {
+        return;
+    }
+    GList *pads = get_roi_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        GstVmbRoiPad *pad = item->data;
+        if (!gst_pad_is_linked(GST_PAD(pad)) || !prepare_roi_pad(vmbsrc, pad))
+        {
+            continue;
+        }
+        GstBuffer *roi_buffer = create_roi_buffer(vmbsrc, pad, buffer);
+        if (roi_buffer == NULL)
+        {
+            GST_LOG_OBJECT(pad, "Could not create region buffer");
+            continue;
+        }
+        GstFlowReturn result = gst_pad_push(GST_PAD(pad), roi_buffer);
+        if (result != GST_FLOW_OK && result != GST_FLOW_FLUSHING && result != GST_FLOW_NOT_LINKED)
+        {
+            GST_LOG_OBJECT(pad, "Pushing region buffer returned %s", gst_flow_get_name(result));
+        }
+    }
+    g_list_free_full(pads, gst_object_unref);
+}
+
+/**
+ * @brief Pushes an event on every ROI and stream pad that already sent its stream-start and segment. Called from the
+ * streaming threads as well as from the event thread of VimbaX, so the state of the pads is read under their object
+ * locks. Pads that did not start their stream yet do not get the event
+ *
+ * @param vmbsrc The element whose request pads the event is pushed on
+ * @param event The event to push. It is consumed
+ */
+void push_request_pad_event(GstVmbSrc *vmbsrc, GstEvent *event)
+{
+    GList *pads = get_roi_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        GstVmbRoiPad *pad = item->data;
+        GST_OBJECT_LOCK(pad);
+        gboolean needs_stream_start = pad->needs_stream_start;
+        GST_OBJECT_UNLOCK(pad);
+        if (!needs_stream_start)
+        {
+            gst_pad_push_event(GST_PAD(pad), gst_event_ref(event));
+        }
+    }
+    g_list_free_full(pads, gst_object_unref);
+    pads = get_stream_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        GstVmbStreamPad *pad = item->data;
+        GST_OBJECT_LOCK(pad);
+        gboolean needs_stream_start = pad->needs_stream_start;
+        GST_OBJECT_UNLOCK(pad);
+        if (!needs_stream_start)
+        {
+            gst_pad_push_event(GST_PAD(pad), gst_event_ref(event));
+        }
+    }
+    g_list_free_full(pads, gst_object_unref);
+    gst_event_unref(event);
+}
+
+/**
+ * @brief Collects the requested stream pads of the element
+ *
+ * @param vmbsrc The element whose pads are collected
+ * @return GList* New references to all GstVmbStreamPads. Free with g_list_free_full(pads, gst_object_unref)
+ */
+GList *get_stream_pads(GstVmbSrc *vmbsrc)
+{
+    GList *pads = NULL;
+    GST_OBJECT_LOCK(vmbsrc);
+    for (GList *pad = GST_ELEMENT(vmbsrc)->srcpads; pad != NULL; pad = pad->next)
+    {
+        if (G_TYPE_CHECK_INSTANCE_TYPE(pad->data, GST_TYPE_VMB_STREAM_PAD))
+        {
+            pads = g_list_prepend(pads, gst_object_ref(pad->data));
+        }
+    }
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return pads;
+}
+
+/**
+ * @brief Prepares the capture of every requested stream pad. Pads whose stream can not be captured stay idle
+ *
+ * @param vmbsrc The element whose stream pads are prepared
+ */
+void prepare_stream_pads(GstVmbSrc *vmbsrc)
+{
+    GList *pads = get_stream_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        GstVmbStreamPad *pad = item->data;
+        GST_OBJECT_LOCK(pad);
+        pad->needs_stream_start = TRUE;
+        GST_OBJECT_UNLOCK(pad);
+        if (!prepare_stream_pad(vmbsrc, pad))
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Stream pad %s stays idle", GST_PAD_NAME(pad));
+        }
+    }
+    g_list_free_full(pads, gst_object_unref);
+}
+
+/**
+ * @brief Announces frames to the stream of a stream pad, creates the buffer pool of the pad and starts its task. The
+ * frames are captured once start_stream_capture is called
+ *
+ * @param vmbsrc Provides the stream handles of the camera and the number of frames to announce
+ * @param pad The pad to prepare
+ * @return true if the stream can be captured
+ */
+bool prepare_stream_pad(GstVmbSrc *vmbsrc, GstVmbStreamPad *pad)
+{
+    if (pad->frames != NULL)
+    {
+        return true;
+    }
+    if (pad->stream_index >= vmbsrc->camera.info.streamCount)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Camera provides %u streams. Stream %u can not be captured",
+                           vmbsrc->camera.info.streamCount,
+                           pad->stream_index);
+        return false;
+    }
+    pad->stream_handle = vmbsrc->camera.info.streamHandles[pad->stream_index];
+
+    VmbUint32_t payload_size;
+    VmbError_t result = VmbPayloadSizeGet(pad->stream_handle, &payload_size);
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Could not read payload size of stream %u. Got error code: %s",
+                           pad->stream_index,
+                           ErrorCodeToMessage(result));
+        return false;
+    }
+
+    pad->frames = g_new0(VmbFrame_t, vmbsrc->properties.num_frame_buffers);
+    pad->num_frames = 0;
+    for (guint i = 0; i < vmbsrc->properties.num_frame_buffers && result == VmbErrorSuccess; i++)
+    {
+        VmbFrame_t *frame = &pad->frames[i];
+        // The transport layer allocates buffers suitable for the stream
+        frame->buffer = NULL;
+        frame->bufferSize = payload_size;
+        frame->context[0] = pad;
+        result = VmbFrameAnnounce(pad->stream_handle, frame, (VmbUint32_t)sizeof(VmbFrame_t));
+        if (result == VmbErrorSuccess)
+        {
+            pad->num_frames++;
+            GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_ANNOUNCE, frame, 0);
+        }
+    }
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Could not announce frames to stream %u. Got error code: %s",
+                           pad->stream_index,
+                           ErrorCodeToMessage(result));
+        release_stream_pad(pad);
+        return false;
+    }
+
+    // Buffers are copies of the frames, so the pool is independent of the pool negotiated on the src pad
+    pad->pool = gst_buffer_pool_new();
+    GstStructure *config = gst_buffer_pool_get_config(pad->pool);
+    gst_buffer_pool_config_set_params(config, NULL, payload_size, 2, 0);
+    if (!gst_buffer_pool_set_config(pad->pool, config) || !gst_buffer_pool_set_active(pad->pool, TRUE))
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Could not activate buffer pool of stream %u", pad->stream_index);
+        release_stream_pad(pad);
+        return false;
+    }
+
+    GST_DEBUG_OBJECT(vmbsrc,
+                     "Announced %u frames of %u bytes to stream %u",
+                     pad->num_frames,
+                     payload_size,
+                     pad->stream_index);
+    gst_pad_start_task(GST_PAD(pad), stream_pad_loop, pad, NULL);
+    return true;
+}
+
+/**
+ * @brief Stops the capture and the task of every stream pad and revokes their frames
+ *
+ * @param vmbsrc The element whose stream pads are released
+ */
+void release_stream_pads(GstVmbSrc *vmbsrc)
+{
+    GList *pads = get_stream_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        release_stream_pad(item->data);
+    }
+    g_list_free_full(pads, gst_object_unref);
+}
+
+/**
+ * @brief Stops the capture and the task of a stream pad and revokes its frames
+ *
+ * @param pad The pad to release. Nothing is done if it was not prepared
+ */
+void release_stream_pad(GstVmbStreamPad *pad)
+{
+    if (pad->frames == NULL)
+    {
+        return;
+    }
+    g_mutex_lock(&pad->lock);
+    if (pad->is_capturing)
+    {
+        VmbCaptureEnd(pad->stream_handle);
+        VmbCaptureQueueFlush(pad->stream_handle);
+        pad->is_capturing = FALSE;
+    }
+    g_mutex_unlock(&pad->lock);
+
+    g_async_queue_push(pad->filled_frames, &stream_stop_sentinel_frame);
+    gst_pad_stop_task(GST_PAD(pad));
+    // Frames filled before the capture ended are no longer valid
+    while (g_async_queue_try_pop(pad->filled_frames) != NULL)
+    {
+    }
+
+    for (guint i = 0; i < pad->num_frames; i++)
+    {
+        VmbFrameRevoke(pad->stream_handle, &pad->frames[i]);
+    }
+    g_free(pad->frames);
+    pad->frames = NULL;
+    pad->num_frames = 0;
+    if (pad->pool != NULL)
+    {
+        gst_buffer_pool_set_active(pad->pool, FALSE);
+        gst_object_unref(pad->pool);
+        pad->pool = NULL;
+    }
+}
+
+/**
+ * @brief Starts the capture engine of every prepared stream pad and queues its frames. Called before AcquisitionStart
+ *
+ * @param vmbsrc The element whose streams are captured
+ */
+void start_stream_capture(GstVmbSrc *vmbsrc)
+{
+    GList *pads = get_stream_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        start_stream_pad_capture(vmbsrc, item->data);
+    }
+    g_list_free_full(pads, gst_object_unref);
+}
+
+/**
+ * @brief Starts the capture engine of a prepared stream pad and queues its frames. Nothing is done if the pad was not
+ * prepared or is already capturing
+ *
+ * @param vmbsrc Provides the tracing context
+ * @param pad The pad whose stream is captured
+ */
+void start_stream_pad_capture(GstVmbSrc *vmbsrc, GstVmbStreamPad *pad)
+{
+    if (pad->frames == NULL)
+    {
+        return;
+    }
+    g_mutex_lock(&pad->lock);
+    VmbError_t result = VmbErrorSuccess;
+    if (!pad->is_capturing)
+    {
+        result = VmbCaptureStart(pad->stream_handle);
+        if (result == VmbErrorSuccess)
+        {
+            pad->capture_generation++;
+            for (guint i = 0; i < pad->num_frames && result == VmbErrorSuccess; i++)
+            {
+                pad->frames[i].context[1] = GUINT_TO_POINTER(pad->capture_generation);
+                GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_QUEUE, &pad->frames[i], 0);
+                result = VmbCaptureFrameQueue(pad->stream_handle, &pad->frames[i], stream_frame_callback);
+            }
+            pad->is_capturing = TRUE;
+        }
+    }
+    g_mutex_unlock(&pad->lock);
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Could not start capturing stream %u. Got error code: %s",
+                           pad->stream_index,
+                           ErrorCodeToMessage(result));
+    }
+}
+
+/**
+ * @brief Stops the capture engine of every capturing stream pad. Called after AcquisitionStop
+ *
+ * @param vmbsrc The element whose streams are no longer captured
+ */
+void stop_stream_capture(GstVmbSrc *vmbsrc)
+{
+    GList *pads = get_stream_pads(vmbsrc);
+    for (GList *item = pads; item != NULL; item = item->next)
+    {
+        GstVmbStreamPad *pad = item->data;
+        g_mutex_lock(&pad->lock);
+        if (pad->is_capturing)
+        {
+            VmbCaptureEnd(pad->stream_handle);
+            VmbCaptureQueueFlush(pad->stream_handle);
+            pad->is_capturing = FALSE;
+        }
+        g_mutex_unlock(&pad->lock);
+    }
+    g_list_free_full(pads, gst_object_unref);
+}
+
+void VMB_CALL stream_frame_callback(const VmbHandle_t camera_handle, const VmbHandle_t stream_handle, VmbFrame_t *frame)
+{
+    UNUSED(camera_handle);
+    UNUSED(stream_handle);
+    GstVmbStreamPad *pad = frame->context[0];
+    GST_VMB_TRACE(GST_PAD_PARENT(pad), GST_VMB_TRACE_CALLBACK, frame, frame->frameID);
+    g_async_queue_push(pad->filled_frames, frame);
+}
+
+/**
+ * @brief Task function of a stream pad. Copies the next filled frame of the stream into a buffer, requeues the frame
+ * and pushes the buffer
+ *
+ * @param user_data The GstVmbStreamPad whose frames are pushed
+ */
+void stream_pad_loop(gpointer user_data)
+{
+    GstVmbStreamPad *pad = user_data;
+    GstVmbSrc *vmbsrc = GST_vmbsrc(GST_PAD_PARENT(pad));
+    VmbFrame_t *frame = g_async_queue_pop(pad->filled_frames);
+    if (frame == &stream_stop_sentinel_frame)
+    {
+        gst_pad_pause_task(GST_PAD(pad));
+        return;
+    }
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_DEQUEUE, frame, frame->frameID);
+
+    GstBuffer *buffer = NULL;
+    GstCaps *caps = NULL;
+    g_mutex_lock(&pad->lock);
+    // Frames filled before the acquisition was restarted were already queued again by start_stream_capture
+    if (pad->is_capturing && GPOINTER_TO_UINT(frame->context[1]) == pad->capture_generation)
+    {
+        if (frame->receiveStatus == VmbFrameStatusComplete)
+        {
+            caps = create_stream_caps(vmbsrc, frame);
+            buffer = copy_stream_frame(vmbsrc, pad, frame);
+        }
+        else
+        {
+            GST_LOG_OBJECT(pad, "Dropping frame %llu with receive status %d", frame->frameID, frame->receiveStatus);
+        }
+        GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_REQUEUE, frame, frame->frameID);
+        if (VmbCaptureFrameQueue(pad->stream_handle, frame, stream_frame_callback) != VmbErrorSuccess)
+        {
+            g_atomic_int_inc(&vmbsrc->stats.requeue_failures);
+        }
+    }
+    g_mutex_unlock(&pad->lock);
+    if (buffer == NULL)
+    {
+        if (caps != NULL)
+        {
+            gst_caps_unref(caps);
+        }
+        return;
+    }
+
+    GST_OBJECT_LOCK(pad);
+    gboolean needs_stream_start = pad->needs_stream_start;
+    GST_OBJECT_UNLOCK(pad);
+    if (needs_stream_start)
+    {
+        gchar *stream_id = gst_pad_create_stream_id(GST_PAD(pad), GST_ELEMENT(vmbsrc), GST_PAD_NAME(pad));
+        gst_pad_push_event(GST_PAD(pad), gst_event_new_stream_start(stream_id));
+        g_free(stream_id);
+        // The sticky events of the previous stream were dropped when the pad was deactivated
+        gst_caps_replace(&pad->caps, NULL);
+    }
+    if (pad->caps == NULL || !gst_caps_is_equal(pad->caps, caps))
+    {
+        gst_caps_replace(&pad->caps, caps);
+        gst_pad_push_event(GST_PAD(pad), gst_event_new_caps(caps));
+    }
+    gst_caps_unref(caps);
+    if (needs_stream_start)
+    {
+        GstSegment segment;
+        gst_segment_init(&segment, GST_FORMAT_TIME);
+        gst_pad_push_event(GST_PAD(pad), gst_event_new_segment(&segment));
+        GST_OBJECT_LOCK(pad);
+        pad->needs_stream_start = FALSE;
+        GST_OBJECT_UNLOCK(pad);
+    }
+
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_PUSH, frame, GST_BUFFER_OFFSET(buffer));
+    GstFlowReturn ret = gst_pad_push(GST_PAD(pad), buffer);
+    if (ret != GST_FLOW_OK)
+    {
+        GST_DEBUG_OBJECT(pad, "Pausing task after push returned %s", gst_flow_get_name(ret));
+        gst_pad_pause_task(GST_PAD(pad));
+        if (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS)
+        {
+            GST_ELEMENT_FLOW_ERROR(vmbsrc, ret);
+        }
+    }
+}
+
+/**
+ * @brief Builds the caps of a frame of an additional stream from the pixel format and size reported with the frame
+ *
+ * @param vmbsrc Provides the camera handle used to look up the name of the pixel format
+ * @param frame The filled frame
+ * @return GstCaps* video/x-raw or video/x-bayer caps for pixel formats that are passed on without conversion,
+ * "application/x-vmbsrc-stream" caps for all other data
+ */
+GstCaps *create_stream_caps(GstVmbSrc *vmbsrc, const VmbFrame_t *frame)
+{
+    const char *vimbax_format = NULL;
+    const VimbaXGstFormatMatch_t *match = NULL;
+    if (VmbFeatureEnumAsString(vmbsrc->camera.handle, "PixelFormat", frame->pixelFormat, &vimbax_format) ==
+        VmbErrorSuccess)
+    {
+        match = gst_format_from_vimbax_format(vimbax_format);
+    }
+    if (match != NULL && match->packing == VIMBAX_PACKING_NONE)
+    {
+        // Bayer formats are not known to GstVideoFormat
+        bool is_raw = gst_video_format_from_string(match->gst_format_name) != GST_VIDEO_FORMAT_UNKNOWN;
+        return gst_caps_new_simple(is_raw ? "video/x-raw" : "video/x-bayer",
+                                   "format", G_TYPE_STRING, match->gst_format_name,
+                                   "width", G_TYPE_INT, (gint)frame->width,
+                                   "height", G_TYPE_INT, (gint)frame->height,
+                                   "framerate", GST_TYPE_FRACTION, 0, 1,
+                                   NULL);
+    }
+    // e.g. depth or confidence data in pixel formats without GStreamer equivalent
+    return gst_caps_new_simple("application/x-vmbsrc-stream",
+                               "pixel-format", G_TYPE_UINT, (guint)frame->pixelFormat,
+                               "width", G_TYPE_INT, (gint)frame->width,
+                               "height", G_TYPE_INT, (gint)frame->height,
+                               NULL);
+}
+
+/**
+ * @brief Copies the image data of a filled frame of an additional stream into a buffer of the pool of its pad
+ *
+ * @param vmbsrc Provides the clock the buffer is timestamped with
+ * @param pad The stream pad the frame was captured for
+ * @param frame The filled frame. It can be requeued once this function returns
+ * @return GstBuffer* The filled buffer or NULL if no buffer could be acquired from the pool
+ */
+GstBuffer *copy_stream_frame(GstVmbSrc *vmbsrc, GstVmbStreamPad *pad, const VmbFrame_t *frame)
+{
+    GstBuffer *buffer = NULL;
+    if (gst_buffer_pool_acquire_buffer(pad->pool, &buffer, NULL) != GST_FLOW_OK)
+    {
+        GST_WARNING_OBJECT(pad, "Could not acquire a buffer for frame %llu", frame->frameID);
+        return NULL;
+    }
+    const VmbUint8_t *image_data = frame->imageData != NULL ? frame->imageData : frame->buffer;
+    gsize size = frame->bufferSize - (gsize)(image_data - (const VmbUint8_t *)frame->buffer);
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_COPY_START, frame, frame->frameID);
+    gst_buffer_fill(buffer, 0, image_data, size);
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_COPY_END, frame, frame->frameID);
+    gst_buffer_set_size(buffer, size);
+
+    GstClock *clock = gst_element_get_clock(GST_ELEMENT(vmbsrc));
+    if (clock != NULL)
+    {
+        GST_BUFFER_PTS(buffer) = gst_clock_get_time(clock) - gst_element_get_base_time(GST_ELEMENT(vmbsrc));
+        gst_object_unref(clock);
+    }
+    GST_BUFFER_OFFSET(buffer) = frame->frameID;
+    return buffer;
+}
+
+/**
+ * @brief Loads the CUDA runtime used to page-lock frame buffers. It is only looked for once per process
+ *
+ * @param vmbsrc Used for logging
+ * @return true if frame buffers can be pinned
+ */
+bool load_pinned_memory_support(GstVmbSrc *vmbsrc)
+{
+    static gsize is_initialized = 0;
+    static bool is_supported = false;
+    if (g_once_init_enter(&is_initialized))
+    {
+        const char *library_name = NULL;
+        is_supported = pinned_memory_init(&library_name);
+        if (is_supported)
+        {
+            GST_INFO_OBJECT(vmbsrc, "Pinning frame buffers with %s", library_name);
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc, "No CUDA runtime found. Frame buffers are not pinned despite \"pinnedmemory\"");
+        }
+        g_once_init_leave(&is_initialized, 1);
+    }
+    return is_supported;
+}
+
+/**
+ * @brief Page-locks the element allocated buffer of a frame. Failures are logged and leave the buffer pageable, which
+ * only makes uploads slower
+ *
+ * @param vmbsrc Used for logging
+ * @param vmb_frame Frame whose buffer was just allocated
+ * @param size Number of allocated bytes
+ */
+void pin_frame_buffer(GstVmbSrc *vmbsrc, GstVmbSrcFrame *vmb_frame, gsize size)
+{
+    if (!load_pinned_memory_support(vmbsrc))
+    {
+        return;
+    }
+    int error = pin_memory(vmb_frame->frame.buffer, size);
+    if (error != 0)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Could not pin frame buffer. cudaHostRegister returned error %d", error);
+        return;
+    }
+    vmb_frame->is_pinned = true;
+}
+
+/**
+ * @brief Frees the memory of a frame that is no longer announced
+ *
+ * @param vmb_frame The frame to free
+ */
+void free_frame(GstVmbSrcFrame *vmb_frame)
+{
+    if (vmb_frame->owns_buffer)
+    {
+        // The element allocated the frame buffer, so it must free the memory also
+        if (vmb_frame->is_pinned)
+        {
+            unpin_memory(vmb_frame->frame.buffer);
+        }
+        VmbAlignedFree(vmb_frame->frame.buffer);
+    }
+    if (vmb_frame->pool_buffer != NULL)
+    {
+        // Returns the buffer to the pool it was taken from
+        gst_buffer_unmap(vmb_frame->pool_buffer, &vmb_frame->pool_buffer_map);
+        gst_buffer_unref(vmb_frame->pool_buffer);
+    }
+    g_free(vmb_frame);
+}
+
+/**
+ * @brief Reads the frame buffer alignment the transport layer prefers. Some transport layers provide higher
+ * performance if specific alignment is observed. If the camera has no such requirement 1 is returned
+ *
+ * @param vmbsrc Provides the stream handle used for the VmbC call
+ * @return VmbInt64_t Alignment of frame buffers in bytes
+ */
+VmbInt64_t get_buffer_alignment(GstVmbSrc *vmbsrc)
+{
+    VmbInt64_t buffer_alignment = 1;
+    VmbError_t result = VmbFeatureIntGet(vmbsrc->camera.info.streamHandles[0],
+                                         "StreamBufferAlignment",
+                                         &buffer_alignment);
+    // The result is not really important so we do not have to check it. If the camera
+    // requires alignment, the call will have succeeded. If alignment does not matter,
+    // the call failed but the default value of 1 was not changed
+    GST_DEBUG_OBJECT(vmbsrc,
+                     "Using \"StreamBufferAlignment\" of: %llu (read result was %s)",
+                     buffer_alignment,
+                     ErrorCodeToMessage(result));
+    return MAX(buffer_alignment, 1);
+}
+
+/**
+ * @brief Announces and queues additional frames while acquisition is running. The number of frames grows by half of
+ * the current number, limited by MAX_NUM_FRAME_BUFFERS and the "maxframebuffermemory" property
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and holds the frame buffers
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t grow_frame_buffers(GstVmbSrc *vmbsrc)
+{
+    VmbError_t result = VmbErrorSuccess;
+    g_mutex_lock(&vmbsrc->frame_lock);
+    if (!vmbsrc->camera.is_acquiring || !vmbsrc->can_grow_frame_buffers || vmbsrc->frame_buffers->len == 0)
+    {
+        g_mutex_unlock(&vmbsrc->frame_lock);
+        return result;
+    }
+
+    // All frames were allocated with the same size
+    VmbUint32_t payload_size = ((GstVmbSrcFrame *)g_ptr_array_index(vmbsrc->frame_buffers, 0))->frame.bufferSize;
+    guint64 max_num_frames = ((guint64)vmbsrc->properties.max_frame_buffer_memory * 1024 * 1024) / MAX(payload_size, 1);
+    max_num_frames = MIN(max_num_frames, MAX_NUM_FRAME_BUFFERS);
+    guint num_frames = vmbsrc->frame_buffers->len;
+    if (num_frames >= max_num_frames)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Not announcing more frames. Limit of %" G_GUINT64_FORMAT " frames (\"maxframebuffermemory\" is %u MiB) reached",
+                           max_num_frames,
+                           vmbsrc->properties.max_frame_buffer_memory);
+        vmbsrc->can_grow_frame_buffers = false;
+        g_mutex_unlock(&vmbsrc->frame_lock);
+        return result;
+    }
+
+    guint num_new_frames = (guint)MIN(MAX(num_frames / 2, 1), max_num_frames - num_frames);
+    GST_DEBUG_OBJECT(vmbsrc, "Announcing %u additional VimbaX frames", num_new_frames);
+    for (guint i = 0; i < num_new_frames; i++)
+    {
+        result = announce_frame(vmbsrc, payload_size);
+        if (result == VmbErrorSuccess)
+        {
+            GstVmbSrcFrame *vmb_frame = g_ptr_array_index(vmbsrc->frame_buffers, vmbsrc->frame_buffers->len - 1);
+            result = queue_frame(vmbsrc, &vmb_frame->frame);
+        }
+        if (result != VmbErrorSuccess)
+        {
+            // Not every transport layer supports announcing frames while the capture engine is running. Do not try
+            // again until the frame buffers are reallocated
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Failed to announce additional frame. Got error code: %s",
+                               ErrorCodeToMessage(result));
+            vmbsrc->can_grow_frame_buffers = false;
+            break;
+        }
+    }
+    GST_INFO_OBJECT(vmbsrc, "Now using %u VimbaX frames", vmbsrc->frame_buffers->len);
+    g_mutex_unlock(&vmbsrc->frame_lock);
+    return result;
+}
+
+/**
+ * @brief Revokes frame buffers, frees their memory and removes them from vmbsrc->frame_buffers
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and the frame buffers
+ */
+void revoke_and_free_buffers(GstVmbSrc *vmbsrc)
+{
+    // The recorder may still be writing the data of received frames
+    if (vmbsrc->record_thread != NULL)
+    {
+        flush_record_queue(vmbsrc);
+    }
+
+    // Frames handed out in zero-copy mode must not be freed while downstream elements still access their data. Give
+    // downstream some time to release them
+    g_mutex_lock(&vmbsrc->frame_lock);
+    gint64 end_time = g_get_monotonic_time() + FRAME_RELEASE_TIMEOUT;
+    while (vmbsrc->num_frames_in_use > 0)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Waiting for %u frames to be released by downstream elements",
+                         vmbsrc->num_frames_in_use);
+        if (!g_cond_wait_until(&vmbsrc->frame_released, &vmbsrc->frame_lock, end_time))
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "%u frames were not released by downstream elements in time. Their memory is freed once they are released",
+                               vmbsrc->num_frames_in_use);
+            break;
+        }
+    }
+
+    for (guint i = 0; i < vmbsrc->frame_buffers->len; i++)
+    {
+        GstVmbSrcFrame *vmb_frame = g_ptr_array_index(vmbsrc->frame_buffers, i);
+        if (vmb_frame->is_in_use)
+        {
+            // release_wrapped_frame takes care of revoking and freeing the frame. The transport layer frees the buffers
+            // it allocated when their frame is revoked, so those are kept announced until downstream released them
+            vmb_frame->is_orphaned = true;
+            vmbsrc->num_frames_in_use--;
+            if (vmb_frame->owns_buffer || vmb_frame->pool_buffer != NULL)
+            {
+                VmbFrameRevoke(vmbsrc->camera.handle, &vmb_frame->frame);
+            }
+            continue;
+        }
+        VmbFrameRevoke(vmbsrc->camera.handle, &vmb_frame->frame);
+        free_frame(vmb_frame);
+    }
+    g_ptr_array_set_size(vmbsrc->frame_buffers, 0);
+    g_mutex_unlock(&vmbsrc->frame_lock);
+}
+
+/**
+ * @brief Queues a frame to the capture engine and keeps track of the number of queued frames
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls
+ * @param frame The frame to queue
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t queue_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame)
+{
+    // Count the frame before queueing it because the callback may already run before VmbCaptureFrameQueue returns
+    g_atomic_int_inc(&vmbsrc->num_frames_queued);
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_QUEUE, frame, frame->frameID);
+    VmbError_t result = VmbCaptureFrameQueue(vmbsrc->camera.handle, frame, &vimbax_frame_callback);
+    if (result != VmbErrorSuccess)
+    {
+        g_atomic_int_add(&vmbsrc->num_frames_queued, -1);
+        g_atomic_int_inc(&vmbsrc->stats.requeue_failures);
+    }
+    return result;
+}
+
+/**
+ * @brief Opens the files given by "recordlocation" and starts the thread writing filled frames to them
+ *
+ * @param vmbsrc Holds the record settings and the recorder state
+ * @return true if recording was started or is not requested, false if the files could not be opened
+ */
+bool start_recording(GstVmbSrc *vmbsrc)
+{
+    vmbsrc->num_frames_recorded = 0;
+    vmbsrc->record_result = GST_FLOW_OK;
+    if (vmbsrc->properties.record_location == NULL || strcmp(vmbsrc->properties.record_location, "") == 0)
+    {
+        return true;
+    }
+
+    int error;
+    vmbsrc->recorder = raw_recorder_open(vmbsrc->properties.record_location, &error);
+    if (vmbsrc->recorder == NULL)
+    {
+        GST_ELEMENT_ERROR(vmbsrc,
+                          RESOURCE,
+                          OPEN_WRITE,
+                          ("Could not open \"%s\" for recording", vmbsrc->properties.record_location),
+                          ("%s", g_strerror(error)));
+        return false;
+    }
+    GST_INFO_OBJECT(vmbsrc,
+                    "Recording frames to \"%s\" with %s writes",
+                    vmbsrc->properties.record_location,
+                    raw_recorder_is_unbuffered(vmbsrc->recorder) ? "unbuffered" : "buffered");
+    vmbsrc->record_queue = g_async_queue_new();
+    vmbsrc->record_thread = g_thread_new("vmbsrc-record", record_thread, vmbsrc);
+    return true;
+}
+
+/**
+ * @brief Waits until all frames received so far are written and closes the record files
+ *
+ * @param vmbsrc Holds the recorder state. Nothing is done if the element is not recording
+ */
+void stop_recording(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->record_thread == NULL)
+    {
+        return;
+    }
+    g_async_queue_push(vmbsrc->record_queue, &record_stop_sentinel_frame);
+    g_thread_join(vmbsrc->record_thread);
+    vmbsrc->record_thread = NULL;
+    int error = raw_recorder_close(vmbsrc->recorder);
+    if (error != 0)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Could not close record files: %s", g_strerror(error));
+    }
+    vmbsrc->recorder = NULL;
+    g_async_queue_unref(vmbsrc->record_queue);
+    vmbsrc->record_queue = NULL;
+    GST_INFO_OBJECT(vmbsrc,
+                    "Recorded %u frames to \"%s\"",
+                    vmbsrc->num_frames_recorded,
+                    vmbsrc->properties.record_location);
+}
+
+/**
+ * @brief Blocks until record_thread handled all frames that were added to the record queue before
+ *
+ * @param vmbsrc Holds the record queue
+ */
+void flush_record_queue(GstVmbSrc *vmbsrc)
+{
+    g_mutex_lock(&vmbsrc->record_lock);
+    vmbsrc->is_record_queue_flushed = false;
+    g_async_queue_push(vmbsrc->record_queue, &record_flush_sentinel_frame);
+    while (!vmbsrc->is_record_queue_flushed)
+    {
+        g_cond_wait(&vmbsrc->record_queue_flushed, &vmbsrc->record_lock);
+    }
+    g_mutex_unlock(&vmbsrc->record_lock);
+}
+
+/**
+ * @brief Thread function writing the frames of the record queue to disk. Each frame is requeued to the capture engine
+ * as soon as its data was written
+ *
+ * Once "recordframes" frames were written or a write failed, record_finished_sentinel_frame is pushed to the filled
+ * frame queue so that create ends the stream. Later frames are requeued without writing them.
+ *
+ * @param data The GstVmbSrc that is recording
+ * @return gpointer Always NULL
+ */
+gpointer record_thread(gpointer data)
+{
+    GstVmbSrc *vmbsrc = data;
+    bool is_finished = false;
+    for (;;)
+    {
+        VmbFrame_t *frame = g_async_queue_pop(vmbsrc->record_queue);
+        if (frame == &record_stop_sentinel_frame)
+        {
+            return NULL;
+        }
+        if (frame == &record_flush_sentinel_frame)
+        {
+            g_mutex_lock(&vmbsrc->record_lock);
+            vmbsrc->is_record_queue_flushed = true;
+            g_cond_signal(&vmbsrc->record_queue_flushed);
+            g_mutex_unlock(&vmbsrc->record_lock);
+            continue;
+        }
+        if (frame->receiveStatus == VmbFrameStatusIncomplete)
+        {
+            g_atomic_int_inc(&vmbsrc->stats.frames_incomplete);
+            if (vmbsrc->properties.incomplete_frame_handling != GST_VMBSRC_INCOMPLETE_FRAME_HANDLING_SUBMIT)
+            {
+                GST_LOG_OBJECT(vmbsrc, "Not recording incomplete frame with ID \"%llu\"", frame->frameID);
+                g_atomic_int_inc(&vmbsrc->stats.frames_dropped);
+                queue_frame(vmbsrc, frame);
+                continue;
+            }
+        }
+        if (!is_finished)
+        {
+            int error = record_frame(vmbsrc, frame);
+            if (error != 0)
+            {
+                GST_ELEMENT_ERROR(vmbsrc,
+                                  RESOURCE,
+                                  WRITE,
+                                  ("Could not record frame to \"%s\"", vmbsrc->properties.record_location),
+                                  ("%s", g_strerror(error)));
+                vmbsrc->record_result = GST_FLOW_ERROR;
+                is_finished = true;
+            }
+            else if (vmbsrc->properties.record_frames != 0 &&
+                     vmbsrc->num_frames_recorded >= vmbsrc->properties.record_frames)
+            {
+                vmbsrc->record_result = GST_FLOW_EOS;
+                is_finished = true;
+            }
+            if (is_finished)
+            {
+                g_async_queue_push(vmbsrc->filled_frame_queue, &record_finished_sentinel_frame);
+            }
+        }
+        queue_frame(vmbsrc, frame);
+    }
+}
+
+/**
+ * @brief Writes the data of a filled frame and its index entry to the record files
+ *
+ * @param vmbsrc Holds the recorder and the chunk settings
+ * @param frame Filled frame whose buffer was allocated by the element with RAW_RECORDER_ALIGNMENT
+ * @return int 0 on success or an errno value
+ */
+int record_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame)
+{
+    size_t size = GST_ROUND_UP_N((size_t)frame->bufferSize, RAW_RECORDER_ALIGNMENT);
+    if (vmbsrc->num_frames_recorded == 0 && vmbsrc->properties.record_frames != 0)
+    {
+        // Reserving the space of all frames up front keeps block allocation out of the writes
+        int error = raw_recorder_preallocate(vmbsrc->recorder, (uint64_t)size * vmbsrc->properties.record_frames);
+        if (error != 0)
+        {
+            GST_DEBUG_OBJECT(vmbsrc, "Could not preallocate record file: %s", g_strerror(error));
+        }
+    }
+
+    VimbaXRawRecorderIndexEntry_t entry = {0};
+    int error = raw_recorder_write_frame(vmbsrc->recorder, frame->buffer, size, &entry.offset);
+    if (error != 0)
+    {
+        return error;
+    }
+
+    entry.frame_id = frame->frameID;
+    entry.timestamp = (frame->receiveFlags & VmbFrameFlagsTimestamp) ? frame->timestamp : 0;
+    entry.size = frame->bufferSize;
+    entry.pixel_format = frame->pixelFormat;
+    entry.width = frame->width;
+    entry.height = frame->height;
+    entry.receive_status = frame->receiveStatus;
+    if (vmbsrc->properties.chunk_mode != 0 && frame->chunkDataPresent)
+    {
+        GstVmbChunkValues chunk_values = {0};
+        chunk_values.fields = vmbsrc->properties.chunk_mode;
+        if (VmbChunkDataAccess(frame, read_chunk_values, &chunk_values) == VmbErrorSuccess)
+        {
+            entry.chunk_fields = chunk_values.fields;
+            entry.exposure_time = chunk_values.exposure_time;
+            entry.gain = chunk_values.gain;
+            entry.chunk_frame_id = chunk_values.frame_id;
+            entry.line_status_all = chunk_values.line_status_all;
+            entry.chunk_timestamp = chunk_values.timestamp;
+        }
+    }
+    error = raw_recorder_write_index(vmbsrc->recorder, &entry);
+    if (error == 0)
+    {
+        vmbsrc->num_frames_recorded++;
+    }
+    return error;
+}
+
+/**
+ * @brief Applies "cpuaffinity" and "threadpriority" to the calling streaming thread
+ *
+ * Failures are logged as warnings and do not stop the stream, since missing privileges should not prevent capturing.
+ *
+ * @param vmbsrc Holds the thread settings and records the tuned thread
+ */
+void tune_streaming_thread(GstVmbSrc *vmbsrc)
+{
+    GST_OBJECT_LOCK(vmbsrc);
+    gchar *cpu_affinity = g_strdup(vmbsrc->properties.cpu_affinity);
+    guint thread_priority = vmbsrc->properties.thread_priority;
+    vmbsrc->tuned_thread = g_thread_self();
+    GST_OBJECT_UNLOCK(vmbsrc);
+
+    if (cpu_affinity != NULL && strcmp(cpu_affinity, "") != 0)
+    {
+        int error = set_current_thread_affinity(cpu_affinity);
+        if (error == 0)
+        {
+            GST_INFO_OBJECT(vmbsrc, "Pinned streaming thread to CPUs %s", cpu_affinity);
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Could not pin streaming thread to CPUs \"%s\": %s",
+                               cpu_affinity,
+                               g_strerror(error));
+        }
+    }
+    g_free(cpu_affinity);
+
+    if (thread_priority > 0)
+    {
+        int error = set_current_thread_priority(thread_priority);
+        if (error == 0)
+        {
+            GST_INFO_OBJECT(vmbsrc, "Running streaming thread with SCHED_FIFO priority %u", thread_priority);
+        }
+        else
+        {
+            GST_WARNING_OBJECT(vmbsrc,
+                               "Could not set SCHED_FIFO priority %u for streaming thread: %s",
+                               thread_priority,
+                               g_strerror(error));
+        }
+    }
+}
+
+/**
+ * @brief Takes the next entry from filled_frame_queue, polling for up to "spinwait" microseconds before blocking
+ *
+ * @param vmbsrc Holds the queue of filled frames
+ * @return VmbFrame_t* The oldest filled frame or one of the sentinel frames
+ */
+VmbFrame_t *pop_filled_frame(GstVmbSrc *vmbsrc)
+{
+    guint spin_wait = vmbsrc->properties.spin_wait;
+    if (spin_wait > 0)
+    {
+        gint64 deadline = g_get_monotonic_time() + spin_wait;
+        do
+        {
+            VmbFrame_t *frame = g_async_queue_try_pop(vmbsrc->filled_frame_queue);
+            if (frame != NULL)
+            {
+                return frame;
+            }
+        } while (g_get_monotonic_time() < deadline);
+    }
+    return g_async_queue_pop(vmbsrc->filled_frame_queue);
+}
+
+/**
+ * @brief Checks whether a filled frame should not be pushed anymore because of the delivery mode
+ *
+ * In Latest mode this only applies to frames that were superseded by a newer frame, which is handled by
+ * skip_stale_frames, so a single frame is never stale.
+ *
+ * @param vmbsrc Holds the delivery settings
+ * @param receive_time Monotonic time (in microseconds) at which the frame was received
+ * @param now Current monotonic time (in microseconds)
+ * @return true if the frame is older than "maxframeage" in BoundedLatency mode
+ */
+bool is_frame_stale(GstVmbSrc *vmbsrc, gint64 receive_time, gint64 now)
+{
+    return vmbsrc->properties.delivery_mode == GST_VMBSRC_DELIVERY_MODE_BOUNDED_LATENCY &&
+           now - receive_time > (gint64)vmbsrc->properties.max_frame_age * G_TIME_SPAN_MILLISECOND;
+}
+
+/**
+ * @brief Requeues filled frames waiting in filled_frame_queue that should not be pushed anymore
+ *
+ * Called from vimbax_frame_callback before a new frame is added. In Latest mode all waiting frames are superseded by
+ * the new frame, in BoundedLatency mode frames older than "maxframeage" are requeued. Frames are taken from the head of
+ * the queue, which holds the oldest frame, until the first frame that is kept or a sentinel is found.
+ *
+ * @param vmbsrc Holds the queue of filled frames and the delivery settings
+ * @param now Monotonic time (in microseconds) at which the new frame was received
+ */
+void skip_stale_frames(GstVmbSrc *vmbsrc, gint64 now)
+{
+    GAsyncQueue *queue = vmbsrc->filled_frame_queue;
+    bool skip_all = vmbsrc->properties.delivery_mode == GST_VMBSRC_DELIVERY_MODE_LATEST;
+    guint num_skipped_frames = 0;
+    while (true)
+    {
+        g_async_queue_lock(queue);
+        VmbFrame_t *frame = g_async_queue_try_pop_unlocked(queue);
+        if (frame == NULL)
+        {
+            g_async_queue_unlock(queue);
+            break;
+        }
+        if (frame == &unlock_sentinel_frame || frame == &feature_update_sentinel_frame ||
+            (!skip_all && !is_frame_stale(vmbsrc, ((GstVmbSrcFrame *)frame->context[1])->receive_time, now)))
+        {
+            // All following frames were received later
+            g_async_queue_push_front_unlocked(queue, frame);
+            g_async_queue_unlock(queue);
+            break;
+        }
+        g_async_queue_unlock(queue);
+        g_atomic_int_inc(&vmbsrc->stats.frames_skipped);
+        num_skipped_frames++;
+        queue_frame(vmbsrc, frame);
+    }
+    if (num_skipped_frames > 0)
+    {
+        GST_LOG_OBJECT(vmbsrc, "Requeued %u filled frames that were superseded or too old", num_skipped_frames);
+    }
+}
+
+/**
+ * @brief Latches the current device timestamp of the camera and reads it. Concurrent latches of the same camera are
+ * serialized, as a second latch could overwrite the value before the first one read it
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls
+ * @param ticks Holds the latched device timestamp in ticks
+ * @return VmbError_t Return status indicating errors if they occurred
+ */
+VmbError_t latch_device_timestamp(GstVmbSrc *vmbsrc, VmbInt64_t *ticks)
+{
+    g_mutex_lock(&vmbsrc->timestamp_latch_lock);
+    // SFNC names the features TimestampLatch/TimestampLatchValue. Older GigE cameras use the GigE Vision names instead
+    const char *latch_command = "TimestampLatch";
+    const char *latch_value = "TimestampLatchValue";
+    VmbError_t result = VmbFeatureCommandRun(vmbsrc->camera.handle, latch_command);
+    if (result != VmbErrorSuccess)
+    {
+        latch_command = "GevTimestampControlLatch";
+        latch_value = "GevTimestampValue";
+        result = VmbFeatureCommandRun(vmbsrc->camera.handle, latch_command);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        result = WaitForCommandDone(vmbsrc->camera.handle, latch_command, FEATURE_COMMAND_TIMEOUT);
+    }
+    if (result == VmbErrorSuccess)
+    {
+        result = VmbFeatureIntGet(vmbsrc->camera.handle, latch_value, ticks);
+    }
+    g_mutex_unlock(&vmbsrc->timestamp_latch_lock);
+    return result;
+}
+
+/**
+ * @brief Latches a device timestamp, pairs it with the current time of the pipeline clock and updates the mapping of
+ * device timestamps to the pipeline clock from the most recent samples. Only called by calibration_thread. The mapping
+ * read by the streaming thread is updated under the object lock
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and holds the timestamp calibration
+ * @param clock The pipeline clock device timestamps are mapped to
+ */
+void calibrate_device_timestamps(GstVmbSrc *vmbsrc, GstClock *clock)
+{
+    GstVmbSrcTimestampCalibration *calibration = &vmbsrc->timestamp_calibration;
+    if (calibration->clock != clock)
+    {
+        // Samples taken with a different clock are meaningless for the new one
+        GST_OBJECT_LOCK(vmbsrc);
+        calibration->clock = clock;
+        calibration->is_calibrated = false;
+        GST_OBJECT_UNLOCK(vmbsrc);
+        calibration->num_samples = 0;
+    }
+
+    VmbInt64_t ticks;
+    GstClockTime before = gst_clock_get_time(clock);
+    VmbError_t result = latch_device_timestamp(vmbsrc, &ticks);
+    GstClockTime after = gst_clock_get_time(clock);
+    calibration->last_calibration = after;
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc,
+                           "Failed to latch device timestamp. Got error code: %s",
+                           ErrorCodeToMessage(result));
+        return;
+    }
+
+    // The latch happened at some point between both clock readings
+    guint index = calibration->num_samples % NUM_TIMESTAMP_CALIBRATION_SAMPLES;
+    calibration->samples[2 * index] = gst_util_uint64_scale((guint64)ticks, GST_SECOND, calibration->tick_frequency);
+    calibration->samples[2 * index + 1] = before + (after - before) / 2;
+    calibration->num_samples++;
+
+    guint num_samples = MIN(calibration->num_samples, NUM_TIMESTAMP_CALIBRATION_SAMPLES);
+    GstClockTime internal;
+    GstClockTime external;
+    GstClockTime rate_num;
+    GstClockTime rate_denom;
+    if (num_samples == 1)
+    {
+        // Only an offset can be determined from a single sample
+        internal = calibration->samples[2 * index];
+        external = calibration->samples[2 * index + 1];
+        rate_num = 1;
+        rate_denom = 1;
+    }
+    else
+    {
+        gdouble r_squared;
+        if (!gst_calculate_linear_regression(calibration->samples,
+                                             NULL,
+                                             num_samples,
+                                             &rate_num,
+                                             &rate_denom,
+                                             &external,
+                                             &internal,
+                                             &r_squared))
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Could not calculate mapping of device timestamps to the pipeline clock");
+            return;
+        }
+    }
+    GST_OBJECT_LOCK(vmbsrc);
+    calibration->internal = internal;
+    calibration->external = external;
+    calibration->rate_num = rate_num;
+    calibration->rate_denom = rate_denom;
+    calibration->is_calibrated = true;
+    GST_OBJECT_UNLOCK(vmbsrc);
+    GST_DEBUG_OBJECT(vmbsrc,
+                     "Device timestamp calibration from %u samples: internal %" GST_TIME_FORMAT ", external %" GST_TIME_FORMAT ", rate %" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT,
+                     num_samples,
+                     GST_TIME_ARGS(internal),
+                     GST_TIME_ARGS(external),
+                     rate_num,
+                     rate_denom);
+}
+
+/**
+ * @brief Starts the thread recalibrating the mapping of device timestamps to the pipeline clock if frames are
+ * timestamped with the device timestamps
+ *
+ * @param vmbsrc The element whose timestamps are calibrated. Nothing is done if the thread is already running
+ */
+void start_calibration_thread(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->calibration_thread != NULL ||
+        vmbsrc->properties.timestamp_mode != GST_VMBSRC_TIMESTAMP_MODE_CAMERA ||
+        vmbsrc->timestamp_calibration.tick_frequency == 0)
+    {
+        return;
+    }
+    vmbsrc->is_calibration_thread_stopping = false;
+    vmbsrc->calibration_thread = g_thread_new("vmbsrc-calibration", calibration_thread, vmbsrc);
+}
+
+/**
+ * @brief Stops the thread recalibrating the device timestamp mapping and waits until it ended
+ *
+ * @param vmbsrc The element whose timestamps are calibrated. Nothing is done if the thread is not running
+ */
+void stop_calibration_thread(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->calibration_thread == NULL)
+    {
+        return;
+    }
+    g_mutex_lock(&vmbsrc->calibration_lock);
+    vmbsrc->is_calibration_thread_stopping = true;
+    g_cond_signal(&vmbsrc->calibration_cond);
+    g_mutex_unlock(&vmbsrc->calibration_lock);
+    g_thread_join(vmbsrc->calibration_thread);
+    vmbsrc->calibration_thread = NULL;
+}
+
+/**
+ * @brief Thread function recalibrating the mapping of device timestamps to the pipeline clock every
+ * TIMESTAMP_CALIBRATION_INTERVAL, and right away when the pipeline clock changed. Latching a device timestamp blocks
+ * for a round trip to the camera, so it is kept off the streaming thread
+ *
+ * @param data The GstVmbSrc whose timestamps are calibrated
+ * @return gpointer Always NULL
+ */
+gpointer calibration_thread(gpointer data)
+{
+    GstVmbSrc *vmbsrc = data;
+    GstVmbSrcTimestampCalibration *calibration = &vmbsrc->timestamp_calibration;
+    g_mutex_lock(&vmbsrc->calibration_lock);
+    while (!vmbsrc->is_calibration_thread_stopping)
+    {
+        // The clock is only known once the pipeline selected it
+        GstClock *clock = gst_element_get_clock(GST_ELEMENT(vmbsrc));
+        GstClockTime wait_time = TIMESTAMP_CALIBRATION_INTERVAL;
+        if (clock != NULL && calibration->clock == clock && calibration->num_samples > 0)
+        {
+            GstClockTime elapsed = gst_clock_get_time(clock) - calibration->last_calibration;
+            wait_time = elapsed < TIMESTAMP_CALIBRATION_INTERVAL ? TIMESTAMP_CALIBRATION_INTERVAL - elapsed : 0;
+        }
+        else if (clock != NULL)
+        {
+            wait_time = 0;
+        }
+        if (wait_time > 0)
+        {
+            if (clock != NULL)
+            {
+                gst_object_unref(clock);
+            }
+            // Woken up early by the streaming thread if the clock changed, or if the thread should stop
+            g_cond_wait_until(&vmbsrc->calibration_cond,
+                              &vmbsrc->calibration_lock,
+                              g_get_monotonic_time() + (gint64)(wait_time / GST_USECOND));
+            continue;
+        }
+        g_mutex_unlock(&vmbsrc->calibration_lock);
+        calibrate_device_timestamps(vmbsrc, clock);
+        gst_object_unref(clock);
+        g_mutex_lock(&vmbsrc->calibration_lock);
+    }
+    g_mutex_unlock(&vmbsrc->calibration_lock);
+    return NULL;
+}
+
+/**
+ * @brief Gets the interval between frames from the configured acquisition frame rate
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls
+ * @return GstClockTime The frame interval or GST_CLOCK_TIME_NONE if it is unknown, e.g. because frames are triggered
+ */
+GstClockTime get_frame_interval(GstVmbSrc *vmbsrc)
+{
+    const char *trigger_mode;
+    if (VmbErrorSuccess == VmbFeatureEnumGet(vmbsrc->camera.handle, "TriggerMode", &trigger_mode) &&
+        strcmp(trigger_mode, "On") == 0)
+    {
+        return GST_CLOCK_TIME_NONE;
+    }
+
+    double frame_rate;
+    VmbError_t result = VmbFeatureFloatGet(vmbsrc->camera.handle, "AcquisitionFrameRate", &frame_rate);
+    if (result != VmbErrorSuccess)
+    {
+        // Fallback for cameras with the legacy feature name
+        result = VmbFeatureFloatGet(vmbsrc->camera.handle, "AcquisitionFrameRateAbs", &frame_rate);
+    }
+    if (result != VmbErrorSuccess || frame_rate <= 0)
+    {
+        return GST_CLOCK_TIME_NONE;
+    }
+    return (GstClockTime)(GST_SECOND / frame_rate);
+}
+
+/**
+ * @brief Gets the exposure time currently used by the camera
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls
+ * @return GstClockTime The exposure duration or GST_CLOCK_TIME_NONE if it could not be read
+ */
+GstClockTime get_exposure_duration(GstVmbSrc *vmbsrc)
+{
+    double exposure_time;
+    VmbError_t result = VmbFeatureFloatGet(vmbsrc->camera.handle, "ExposureTime", &exposure_time);
+    if (result != VmbErrorSuccess)
+    {
+        // Fallback for cameras with the legacy feature name
+        result = VmbFeatureFloatGet(vmbsrc->camera.handle, "ExposureTimeAbs", &exposure_time);
+    }
+    if (result != VmbErrorSuccess || exposure_time < 0)
+    {
+        return GST_CLOCK_TIME_NONE;
+    }
+    // ExposureTime is given in microseconds
+    return (GstClockTime)(exposure_time * GST_USECOND);
+}
+
+/**
+ * @brief Updates the measurement of the delay between vimbax_frame_callback and pushing the frame. Posts a latency
+ * message if the average delay changed significantly since the last one, at most once per LATENCY_MESSAGE_INTERVAL
+ *
+ * @param vmbsrc Holds the measured delays
+ * @param receive_time Monotonic time (in microseconds) at which the pushed frame was received
+ */
+void update_push_delay(GstVmbSrc *vmbsrc, gint64 receive_time)
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 delay_us = MAX(now - receive_time, 0);
+    GstClockTime delay = delay_us * GST_USECOND;
+    bool post_latency = false;
+
+    guint bucket = delay_us < 2 ? 0 : MIN(g_bit_nth_msf((gulong)delay_us, -1), NUM_PUSH_DELAY_HISTOGRAM_BUCKETS - 1);
+    g_atomic_int_inc(&vmbsrc->stats.push_delay_histogram[bucket]);
+
+    GST_OBJECT_LOCK(vmbsrc);
+    if (vmbsrc->push_delay_average == 0)
+    {
+        vmbsrc->push_delay_average = delay;
+    }
+    else
+    {
+        vmbsrc->push_delay_average =
+            (vmbsrc->push_delay_average * (PUSH_DELAY_AVERAGE_WEIGHT - 1) + delay) / PUSH_DELAY_AVERAGE_WEIGHT;
+    }
+    vmbsrc->push_delay_max = MAX(vmbsrc->push_delay_max, delay);
+    // Every latency message makes the pipeline query and redistribute the latency, so a delay jittering around the
+    // threshold must not post one per frame
+    if ((GST_CLOCK_DIFF(vmbsrc->reported_push_delay, vmbsrc->push_delay_average) > (GstClockTimeDiff)PUSH_DELAY_UPDATE_THRESHOLD ||
+         GST_CLOCK_DIFF(vmbsrc->push_delay_average, vmbsrc->reported_push_delay) > (GstClockTimeDiff)PUSH_DELAY_UPDATE_THRESHOLD) &&
+        now - vmbsrc->latency_message_time >= LATENCY_MESSAGE_INTERVAL)
+    {
+        vmbsrc->reported_push_delay = vmbsrc->push_delay_average;
+        vmbsrc->latency_message_time = now;
+        post_latency = true;
+    }
+    GST_OBJECT_UNLOCK(vmbsrc);
+
+    if (post_latency)
+    {
+        GST_DEBUG_OBJECT(vmbsrc, "Average push delay changed to %" GST_TIME_FORMAT, GST_TIME_ARGS(vmbsrc->reported_push_delay));
+        gst_element_post_message(GST_ELEMENT(vmbsrc), gst_message_new_latency(GST_OBJECT(vmbsrc)));
+    }
+}
+
+/**
+ * @brief Returns the upper bound of the push delay histogram bucket below which the given fraction of pushed frames lies
+ *
+ * @param histogram Push delay histogram with NUM_PUSH_DELAY_HISTOGRAM_BUCKETS buckets
+ * @param total Number of frames counted in the histogram
+ * @param fraction Requested fraction of frames (e.g. 0.99 for the 99th percentile)
+ * @return GstClockTime Upper bound of the delay or GST_CLOCK_TIME_NONE if no frame was counted
+ */
+GstClockTime push_delay_percentile(const guint *histogram, guint64 total, double fraction)
+{
+    if (total == 0)
+    {
+        return GST_CLOCK_TIME_NONE;
+    }
+    guint64 threshold = (guint64)(fraction * total);
+    guint64 count = 0;
+    for (int i = 0; i < NUM_PUSH_DELAY_HISTOGRAM_BUCKETS; i++)
+    {
+        count += histogram[i];
+        if (count >= threshold)
+        {
+            return (G_GUINT64_CONSTANT(1) << (i + 1)) * GST_USECOND;
+        }
+    }
+    return GST_CLOCK_TIME_NONE;
+}
+
+/**
+ * @brief Creates a structure holding the current capture statistics, including the Stat* features of the camera and
+ * its stream
+ *
+ * @param vmbsrc Holds the statistic counters and provides the handles used for the VmbC calls
+ * @return GstStructure* The statistics. Must be freed by the caller
+ */
+GstStructure *get_stats(GstVmbSrc *vmbsrc)
+{
+    guint histogram[NUM_PUSH_DELAY_HISTOGRAM_BUCKETS];
+    guint64 num_pushed = 0;
+    for (int i = 0; i < NUM_PUSH_DELAY_HISTOGRAM_BUCKETS; i++)
+    {
+        histogram[i] = (guint)g_atomic_int_get(&vmbsrc->stats.push_delay_histogram[i]);
+        num_pushed += histogram[i];
+    }
+    GST_OBJECT_LOCK(vmbsrc);
+    GstClockTime push_delay_average = vmbsrc->push_delay_average;
+    GstClockTime push_delay_max = vmbsrc->push_delay_max;
+    GstClockTime exposure_end_delay_average = vmbsrc->exposure_end_delay_average;
+    GstClockTime exposure_end_delay_max = vmbsrc->exposure_end_delay_max;
+    GST_OBJECT_UNLOCK(vmbsrc);
+
+    GstStructure *stats = gst_structure_new(
+        "application/x-vmbsrc-stats",
+        "frames-received", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.frames_received),
+        "frames-incomplete", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.frames_incomplete),
+        "frames-dropped", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.frames_dropped),
+        "frames-skipped", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.frames_skipped),
+        "frames-rate-limited", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.frames_rate_limited),
+        "requeue-failures", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.requeue_failures),
+        "queue-depth-max", G_TYPE_UINT, (guint)g_atomic_int_get(&vmbsrc->stats.queue_depth_max),
+        "queue-depth-average", G_TYPE_DOUBLE, (double)g_atomic_int_get(&vmbsrc->stats.queue_depth_average) / QUEUE_DEPTH_AVERAGE_SCALE,
+        "push-delay-average", G_TYPE_UINT64, push_delay_average,
+        "push-delay-max", G_TYPE_UINT64, push_delay_max,
+        "push-delay-p50", G_TYPE_UINT64, push_delay_percentile(histogram, num_pushed, 0.5),
+        "push-delay-p90", G_TYPE_UINT64, push_delay_percentile(histogram, num_pushed, 0.9),
+        "push-delay-p99", G_TYPE_UINT64, push_delay_percentile(histogram, num_pushed, 0.99),
+        "exposure-end-delay-average", G_TYPE_UINT64, exposure_end_delay_average,
+        "exposure-end-delay-max", G_TYPE_UINT64, exposure_end_delay_max,
+        NULL);
+
+    if (is_camera_connected(vmbsrc))
+    {
+        add_stat_features(stats, vmbsrc->camera.handle);
+        if (vmbsrc->camera.info.streamCount > 0)
+        {
+            add_stat_features(stats, vmbsrc->camera.info.streamHandles[0]);
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief Adds the values of the Stat* features (e.g. StatFramesDropped, StatPacketsMissed) the given module provides
+ * to the statistics structure. Features that are not available are skipped
  *
- * @param vmbsrc Provides access to the camera ID and holds the resulting handle
+ * @param stats Structure the values are added to. Feature names are used as field names
+ * @param handle Handle of the module (camera or stream) whose features are read
+ */
+void add_stat_features(GstStructure *stats, VmbHandle_t handle)
+{
+    static const char *stat_features[] = {
+        "StatFramesDelivered",
+        "StatFramesDropped",
+        "StatFramesIncomplete",
+        "StatFramesUnderrun",
+        "StatFramesShoved",
+        "StatFrameRescues",
+        "StatFrameRate",
+        "StatPacketsReceived",
+        "StatPacketsMissed",
+        "StatPacketsErrors",
+        "StatPacketsRequested",
+        "StatPacketsResent",
+        "StatLocalRate",
+        "StatTimeElapsed"};
+    for (size_t i = 0; i < sizeof(stat_features) / sizeof(stat_features[0]); i++)
+    {
+        VmbInt64_t int_value;
+        double float_value;
+        if (VmbErrorSuccess == VmbFeatureIntGet(handle, stat_features[i], &int_value))
+        {
+            gst_structure_set(stats, stat_features[i], G_TYPE_INT64, (gint64)int_value, NULL);
+        }
+        else if (VmbErrorSuccess == VmbFeatureFloatGet(handle, stat_features[i], &float_value))
+        {
+            gst_structure_set(stats, stat_features[i], G_TYPE_DOUBLE, float_value, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Updates the maximum and running average depth of the filled frame queue. Called from the streaming thread
+ * whenever a frame was taken from the queue
+ *
+ * @param vmbsrc Holds the filled frame queue and the statistic counters
+ */
+void update_queue_depth_stats(GstVmbSrc *vmbsrc)
+{
+    // Count the frame that was just taken from the queue
+    gint depth = MAX(g_async_queue_length(vmbsrc->filled_frame_queue), 0) + 1;
+    if (depth > g_atomic_int_get(&vmbsrc->stats.queue_depth_max))
+    {
+        g_atomic_int_set(&vmbsrc->stats.queue_depth_max, depth);
+    }
+    // Only the streaming thread writes the average, so reading and writing it separately is fine
+    gint average = g_atomic_int_get(&vmbsrc->stats.queue_depth_average);
+    average += (depth * QUEUE_DEPTH_AVERAGE_SCALE - average) / PUSH_DELAY_AVERAGE_WEIGHT;
+    g_atomic_int_set(&vmbsrc->stats.queue_depth_average, average);
+}
+
+/**
+ * @brief Posts the current capture statistics as element message on the bus
+ *
+ * @param vmbsrc The element posting the message
+ */
+void post_stats_message(GstVmbSrc *vmbsrc)
+{
+    vmbsrc->last_stats_post = g_get_monotonic_time();
+    gst_element_post_message(GST_ELEMENT(vmbsrc), gst_message_new_element(GST_OBJECT(vmbsrc), get_stats(vmbsrc)));
+}
+
+/**
+ * @brief Starts the thread posting the statistics messages. It idles while "statsinterval" is 0
+ *
+ * @param vmbsrc The element posting the messages
+ */
+void start_stats_thread(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->stats_thread != NULL)
+    {
+        return;
+    }
+    vmbsrc->is_stats_thread_stopping = false;
+    vmbsrc->stats_thread = g_thread_new("vmbsrc-stats", stats_thread, vmbsrc);
+}
+
+/**
+ * @brief Stops the thread posting the statistics messages and waits until it ended
+ *
+ * @param vmbsrc The element posting the messages. Nothing is done if the thread is not running
+ */
+void stop_stats_thread(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->stats_thread == NULL)
+    {
+        return;
+    }
+    g_mutex_lock(&vmbsrc->stats_lock);
+    vmbsrc->is_stats_thread_stopping = true;
+    g_cond_signal(&vmbsrc->stats_cond);
+    g_mutex_unlock(&vmbsrc->stats_lock);
+    g_thread_join(vmbsrc->stats_thread);
+    vmbsrc->stats_thread = NULL;
+}
+
+/**
+ * @brief Thread function posting the statistics messages every "statsinterval" milliseconds. Reading the Stat*
+ * features is a register access on the camera for each feature, so it is kept off the streaming thread
+ *
+ * @param data The GstVmbSrc posting the messages
+ * @return gpointer Always NULL
+ */
+gpointer stats_thread(gpointer data)
+{
+    GstVmbSrc *vmbsrc = data;
+    g_mutex_lock(&vmbsrc->stats_lock);
+    while (!vmbsrc->is_stats_thread_stopping)
+    {
+        if (vmbsrc->properties.stats_interval == 0)
+        {
+            g_cond_wait(&vmbsrc->stats_cond, &vmbsrc->stats_lock);
+            continue;
+        }
+        gint64 post_time = vmbsrc->last_stats_post + (gint64)vmbsrc->properties.stats_interval * G_TIME_SPAN_MILLISECOND;
+        if (g_get_monotonic_time() < post_time)
+        {
+            // Woken up early if the interval changed or the thread should stop
+            g_cond_wait_until(&vmbsrc->stats_cond, &vmbsrc->stats_lock, post_time);
+            continue;
+        }
+        g_mutex_unlock(&vmbsrc->stats_lock);
+        post_stats_message(vmbsrc);
+        g_mutex_lock(&vmbsrc->stats_lock);
+    }
+    g_mutex_unlock(&vmbsrc->stats_lock);
+    return NULL;
+}
+
+/**
+ * @brief Starts the capture engine, queues VimbaX frames and runs the AcquisitionStart command feature. Frame buffers
+ * must be allocated before running this function.
+ *
+ * @param vmbsrc Provides the camera handle used for the VmbC calls and access to the queued frame buffers
  * @return VmbError_t Return status indicating errors if they occurred
  */
-VmbError_t open_camera_connection(GstVmbSrc *vmbsrc)
+VmbError_t start_image_acquisition(GstVmbSrc *vmbsrc)
 {
-    VmbError_t result = VmbCameraOpen(vmbsrc->camera.id, VmbAccessModeFull, &vmbsrc->camera.handle);
+    // Start Capture Engine
+    GST_DEBUG_OBJECT(vmbsrc, "Starting the capture engine");
+    VmbError_t result = VmbCaptureStart(vmbsrc->camera.handle);
     if (result == VmbErrorSuccess)
     {
-        VmbCameraInfoQuery(vmbsrc->camera.id, &vmbsrc->camera.info, sizeof(vmbsrc->camera.info));
-        GST_INFO_OBJECT(vmbsrc,
-                        "Successfully opened camera %s (model \"%s\", serial \"%s\")",
-                        vmbsrc->camera.id,
-                        vmbsrc->camera.info.modelName,
-                        vmbsrc->camera.info.serialString); // TODO: This seems to show N/A for some cameras (observed with USB)
+        // Hold the frame lock until acquisition is running so that frames released by downstream elements in the
+        // meantime are not lost for capturing
+        g_mutex_lock(&vmbsrc->frame_lock);
+        GST_DEBUG_OBJECT(vmbsrc, "Queueing the VimbaX frames");
+        for (guint i = 0; i < vmbsrc->frame_buffers->len; i++)
+        {
+            GstVmbSrcFrame *vmb_frame = g_ptr_array_index(vmbsrc->frame_buffers, i);
+            if (vmb_frame->is_in_use)
+            {
+                // Frame is still held downstream and will be queued when it is released
+                continue;
+            }
+            // Queue Frame
+            result = queue_frame(vmbsrc, &vmb_frame->frame);
+            if (VmbErrorSuccess != result)
+            {
+                break;
+            }
+        }
 
-        // Set the GeV packet size to the highest possible value if a GigE camera is used
-        if (VmbErrorSuccess == VmbFeatureCommandRun(vmbsrc->camera.info.streamHandles[0], "GVSPAdjustPacketSize"))
+        if (VmbErrorSuccess == result)
         {
-            VmbBool_t is_command_done = VmbBoolFalse;
-            do
+            // AcquisitionStart starts all streams of the camera
+            start_stream_capture(vmbsrc);
+
+            // Start Acquisition
+            GST_DEBUG_OBJECT(vmbsrc, "Running \"AcquisitionStart\" feature");
+            result = VmbFeatureCommandRun(vmbsrc->camera.handle, "AcquisitionStart");
+            if (VmbErrorSuccess == result &&
+                VmbErrorTimeout == WaitForCommandDone(vmbsrc->camera.handle, "AcquisitionStart", FEATURE_COMMAND_TIMEOUT))
             {
-                if (VmbErrorSuccess != VmbFeatureCommandIsDone(vmbsrc->camera.info.streamHandles[0],
-                                                               "GVSPAdjustPacketSize",
-                                                               &is_command_done))
-                {
-                    break;
-                }
-            } while (VmbBoolFalse == is_command_done);
+                GST_WARNING_OBJECT(vmbsrc, "\"AcquisitionStart\" did not complete in time");
+            }
+            vmbsrc->camera.is_acquiring = true;
+        }
+        g_mutex_unlock(&vmbsrc->frame_lock);
+        if (vmbsrc->camera.is_acquiring)
+        {
+            update_group_acquisition(vmbsrc, true);
         }
-        vmbsrc->camera.is_connected = true;
-        map_supported_pixel_formats(vmbsrc);
-    }
-    else
-    {
-        GST_ERROR_OBJECT(vmbsrc,
-                         "Could not open camera %s. Got error code: %s",
-                         vmbsrc->camera.id,
-                         ErrorCodeToMessage(result));
-        vmbsrc->camera.is_connected = false;
-        // TODO: List available cameras in this case?
-        // TODO: Can we signal an error to the pipeline to stop immediately?
     }
-    vmbsrc->camera.is_acquiring = false;
     return result;
 }
 
 /**
- * @brief Applies the values defiend in the vmbsrc properties to their corresponding camera features
+ * @brief Runs the AcquisitionStop command feature, stops the capture engine and flushes the capture queue
  *
- * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
- * modified features
+ * @param vmbsrc Provides the camera handle which is used for the VmbC function calls
  * @return VmbError_t Return status indicating errors if they occurred
  */
-VmbError_t apply_feature_settings(GstVmbSrc *vmbsrc)
+VmbError_t stop_image_acquisition(GstVmbSrc *vmbsrc)
 {
+    // Frames released by downstream elements from now on must no longer be requeued
+    g_mutex_lock(&vmbsrc->frame_lock);
     bool was_acquiring = vmbsrc->camera.is_acquiring;
-    if (vmbsrc->camera.is_acquiring)
+    vmbsrc->camera.is_acquiring = false;
+    g_mutex_unlock(&vmbsrc->frame_lock);
+    if (was_acquiring)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Camera was acquiring. Stopping to change feature settings");
-        stop_image_acquisition(vmbsrc);
+        // The group stops sending action commands until this camera acquires again
+        update_group_acquisition(vmbsrc, false);
     }
-    GEnumValue *enum_entry;
 
-    // exposure time
-    // TODO: Workaround for cameras with legacy "ExposureTimeAbs" feature should be replaced with a general legacy
-    // feature name handling approach: A static table maps each property, e.g. "exposuretime", to a list of (feature
-    // name, set function, get function) pairs, e.g. [("ExposureTime", setExposureTime, getExposureTime),
-    // ("ExposureTimeAbs", setExposureTimeAbs, getExposureTimeAbs)]. On startup, the feature list of the connected
-    // camera obtained from VmbFeaturesList() is used to determine which set/get function to use.
+    // Stop Acquisition
+    GST_DEBUG_OBJECT(vmbsrc, "Running \"AcquisitionStop\" feature");
+    VmbError_t result = VmbFeatureCommandRun(vmbsrc->camera.handle, "AcquisitionStop");
+    if (VmbErrorSuccess == result &&
+        VmbErrorTimeout == WaitForCommandDone(vmbsrc->camera.handle, "AcquisitionStop", FEATURE_COMMAND_TIMEOUT))
+    {
+        GST_WARNING_OBJECT(vmbsrc, "\"AcquisitionStop\" did not complete in time");
+    }
 
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"ExposureTime\" to %f", vmbsrc->properties.exposuretime);
-    VmbError_t result = VmbFeatureFloatSet(vmbsrc->camera.handle, "ExposureTime", vmbsrc->properties.exposuretime);
-    if (result == VmbErrorSuccess)
+    // Stop Capture Engine
+    GST_DEBUG_OBJECT(vmbsrc, "Stopping the capture engine");
+    result = VmbCaptureEnd(vmbsrc->camera.handle);
+
+    // Flush the capture queue
+    GST_DEBUG_OBJECT(vmbsrc, "Flushing the capture queue");
+    VmbCaptureQueueFlush(vmbsrc->camera.handle);
+    g_atomic_int_set(&vmbsrc->num_frames_queued, 0);
+    g_atomic_int_set(&vmbsrc->frame_starvation, 0);
+    stop_stream_capture(vmbsrc);
+
+    return result;
+}
+
+/**
+ * @brief Removes all filled frames from the filled frame queue after acquisition was stopped
+ *
+ * The removed frames are not held downstream, so start_image_acquisition queues them for capturing again. Pending
+ * unlock requests are kept in the queue.
+ *
+ * @param vmbsrc Holds the filled frame queue
+ */
+void drain_filled_frame_queue(GstVmbSrc *vmbsrc)
+{
+    if (vmbsrc->filled_frame_queue == NULL)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        return;
     }
-    else if (result == VmbErrorNotFound)
+    bool was_unlocked = false;
+    guint num_drained_frames = 0;
+    VmbFrame_t *frame;
+    while ((frame = g_async_queue_try_pop(vmbsrc->filled_frame_queue)) != NULL)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"ExposureTime\" to %f. Return code was: %s Attempting \"ExposureTimeAbs\"",
-                           vmbsrc->properties.exposuretime,
-                           ErrorCodeToMessage(result));
-        result = VmbFeatureFloatSet(vmbsrc->camera.handle, "ExposureTimeAbs", vmbsrc->properties.exposuretime);
-        if (result == VmbErrorSuccess)
+        if (frame == &unlock_sentinel_frame)
         {
-            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+            was_unlocked = true;
         }
-        else
+        else if (frame != &feature_update_sentinel_frame)
         {
-            GST_WARNING_OBJECT(vmbsrc,
-                               "Failed to set \"ExposureTimeAbs\" to %f. Return code was: %s",
-                               vmbsrc->properties.exposuretime,
-                               ErrorCodeToMessage(result));
+            num_drained_frames++;
         }
     }
-    else
+    if (was_unlocked)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"ExposureTime\" to %f. Return code was: %s",
-                           vmbsrc->properties.exposuretime,
-                           ErrorCodeToMessage(result));
+        g_async_queue_push(vmbsrc->filled_frame_queue, &unlock_sentinel_frame);
     }
+    GST_DEBUG_OBJECT(vmbsrc, "Removed %u filled frames that were not pushed yet", num_drained_frames);
+}
 
-    // Exposure Auto
-    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_EXPOSUREAUTO_MODES), vmbsrc->properties.exposureauto);
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"ExposureAuto\" to %s", enum_entry->value_nick);
-    result = VmbFeatureEnumSet(vmbsrc->camera.handle, "ExposureAuto", enum_entry->value_nick);
-    if (result == VmbErrorSuccess)
+void VMB_CALL vimbax_frame_callback(const VmbHandle_t camera_handle, const VmbHandle_t stream_handle, VmbFrame_t *frame)
+{
+    UNUSED(camera_handle); // enable compilation while treating warning of unused vairable as error
+    UNUSED(stream_handle);
+    GST_TRACE("Got Frame");
+    GstVmbSrcFrame *vmb_frame = frame->context[1];
+    vmb_frame->receive_time = g_get_monotonic_time();
+    GstVmbSrc *vmbsrc = vmb_frame->vmbsrc;
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_CALLBACK, frame, frame->frameID);
+    g_atomic_int_inc(&vmbsrc->stats.frames_received);
+    // Before the rate limit, as a frame that is dropped was still captured for a trigger
+    vmb_frame->trigger_id = assign_trigger_id(vmbsrc, frame);
+    if (is_frame_rate_limited(vmbsrc, vmb_frame->receive_time))
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        // Requeued right away, so the frame never counts as taken from the camera
+        g_atomic_int_inc(&vmbsrc->stats.frames_rate_limited);
+        g_atomic_int_add(&vmbsrc->num_frames_queued, -1);
+        queue_frame(vmbsrc, frame);
+        return;
     }
-    else
+    if (g_atomic_int_dec_and_test(&vmbsrc->num_frames_queued))
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"ExposureAuto\" to %s. Return code was: %s",
-                           enum_entry->value_nick,
-                           ErrorCodeToMessage(result));
+        // This was the last queued frame. The camera has no buffer to fill until a frame is requeued
+        g_atomic_int_set(&vmbsrc->frame_starvation, 1);
     }
-
-    // Auto whitebalance
-    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_BALANCEWHITEAUTO_MODES),
-                                  vmbsrc->properties.balancewhiteauto);
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"BalanceWhiteAuto\" to %s", enum_entry->value_nick);
-    result = VmbFeatureEnumSet(vmbsrc->camera.handle, "BalanceWhiteAuto", enum_entry->value_nick);
-    if (result == VmbErrorSuccess)
+    if (vmbsrc->properties.delivery_mode != GST_VMBSRC_DELIVERY_MODE_FIFO && vmbsrc->recorder == NULL)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        // Hand frames that will not be pushed back to the camera instead of keeping them until the next create call
+        skip_stale_frames(vmbsrc, vmb_frame->receive_time);
     }
-    else
+    if (vmbsrc->enabled_camera_events & GST_VMBSRC_CAMERA_EVENT_EXPOSURE_END)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"BalanceWhiteAuto\" to %s. Return code was: %s",
-                           enum_entry->value_nick,
-                           ErrorCodeToMessage(result));
+        update_exposure_end_delay(vmbsrc, frame->frameID, vmb_frame->receive_time);
     }
+    g_async_queue_push(frame->context[0], frame); // context[0] holds vmbsrc->filled_frame_queue or record_queue
 
-    // gain
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"Gain\" to %f", vmbsrc->properties.gain);
-    result = VmbFeatureFloatSet(vmbsrc->camera.handle, "Gain", vmbsrc->properties.gain);
-    if (result == VmbErrorSuccess)
-    {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
-    }
-    else
+    // requeueing the frame is done after it was consumed in vmbsrc_create
+}
+
+/**
+ * @brief Assigns a received frame to the oldest software trigger without a frame. Frames the camera captured but that
+ * were lost on the way to the host are skipped via the gaps in the frame IDs, so that they do not shift the IDs of the
+ * following frames. Triggers the camera ignored can not be detected and shift the IDs until the trigger settings are
+ * applied again or the element is restarted
+ *
+ * @param vmbsrc Counts the sent triggers and the frames assigned to them
+ * @param frame The received frame
+ * @return guint64 ID of the trigger the frame was captured for, or 0 if there is no pending trigger or the element
+ * did not configure the camera for software triggers
+ */
+guint64 assign_trigger_id(GstVmbSrc *vmbsrc, const VmbFrame_t *frame)
+{
+    guint64 trigger_id = 0;
+    GST_OBJECT_LOCK(vmbsrc);
+    if (vmbsrc->is_software_triggered)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"Gain\" to %f. Return code was: %s",
-                           vmbsrc->properties.gain,
-                           ErrorCodeToMessage(result));
+        if ((frame->receiveFlags & VmbFrameFlagsFrameID) && vmbsrc->last_triggered_frame_id != 0 &&
+            frame->frameID > vmbsrc->last_triggered_frame_id + 1)
+        {
+            guint64 num_lost_frames = frame->frameID - vmbsrc->last_triggered_frame_id - 1;
+            GST_DEBUG_OBJECT(vmbsrc, "%" G_GUINT64_FORMAT " triggered frames were lost", num_lost_frames);
+            vmbsrc->num_triggered_frames = MIN(vmbsrc->num_triggered_frames + num_lost_frames,
+                                               vmbsrc->num_software_triggers);
+        }
+        if (frame->receiveFlags & VmbFrameFlagsFrameID)
+        {
+            vmbsrc->last_triggered_frame_id = frame->frameID;
+        }
+        if (vmbsrc->num_triggered_frames < vmbsrc->num_software_triggers)
+        {
+            trigger_id = ++vmbsrc->num_triggered_frames;
+        }
     }
+    GST_OBJECT_UNLOCK(vmbsrc);
+    return trigger_id;
+}
 
-    result = set_roi(vmbsrc);
-
-    result = apply_trigger_settings(vmbsrc);
+/**
+ * @brief Wraps the image data of a filled frame in a GstBuffer without copying it. The frame is requeued to the capture
+ * engine when the last reference to the memory of the returned buffer is dropped (see release_wrapped_frame)
+ *
+ * @param vmbsrc Holds the frame bookkeeping
+ * @param frame Filled frame that should be passed downstream
+ * @return GstBuffer* Buffer wrapping the frame data, or NULL if the frame data should be copied instead because too
+ * few frames would remain available to the capture engine
+ */
+GstBuffer *wrap_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame)
+{
+    GstVmbSrcFrame *vmb_frame = frame->context[1];
 
-    if (was_acquiring)
+    g_mutex_lock(&vmbsrc->frame_lock);
+    if (vmbsrc->num_frames_in_use + MIN_AVAILABLE_FRAME_BUFFERS >= vmbsrc->frame_buffers->len)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Camera was acquiring before changing feature settings. Restarting.");
-        result = start_image_acquisition(vmbsrc);
+        g_mutex_unlock(&vmbsrc->frame_lock);
+        GST_LOG_OBJECT(vmbsrc, "Too many frames held downstream. Copying image data of frame %llu", frame->frameID);
+        return NULL;
     }
-
-    return result;
+    vmb_frame->is_in_use = true;
+    vmbsrc->num_frames_in_use++;
+    g_mutex_unlock(&vmbsrc->frame_lock);
+
+    // The element must outlive every buffer that references one of its frames
+    gst_object_ref(vmbsrc);
+    GstMemory *pool_memory = vmb_frame->pool_buffer != NULL ? gst_buffer_peek_memory(vmb_frame->pool_buffer, 0) : NULL;
+    if (pool_memory != NULL && !GST_MEMORY_IS_NO_SHARE(pool_memory))
+    {
+        // Share the memory of the pool buffer so that downstream elements can still recognize its type (e.g. to import
+        // DMABuf memory). The release is tied to the shared memory rather than the buffer, as copies of the buffer
+        // (e.g. by gst_buffer_make_writable) reference the same memory and may outlive it
+        GstMemory *memory = gst_memory_share(pool_memory, 0, frame->bufferSize);
+        gst_mini_object_set_qdata(GST_MINI_OBJECT(memory),
+                                  g_quark_from_static_string("GstVmbSrcFrame"),
+                                  vmb_frame,
+                                  release_wrapped_frame);
+        GstBuffer *buffer = gst_buffer_new();
+        gst_buffer_append_memory(buffer, memory);
+        return buffer;
+    }
+    return gst_buffer_new_wrapped_full(0,
+                                       frame->buffer,
+                                       frame->bufferSize,
+                                       0,
+                                       frame->bufferSize,
+                                       vmb_frame,
+                                       release_wrapped_frame);
 }
 
 /**
- * @brief Helper function to set Width, Height, OffsetX and OffsetY feature in correct order to define the region of
- * interest (ROI) on the sensor.
- *
- * The values for setting the ROI are defined as GStreamer properties of the vmbsrc element. If INT_MAX are used for
- * the width/height property (the default value) the full corresponding sensor size for that feature is used.
+ * @brief Called when the memory of a buffer created by wrap_frame is freed. Requeues the frame to the capture engine if acquisition
+ * is still running, or revokes and frees it if the frame buffers were released in the meantime
  *
- * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
- * modified features
- * @return VmbError_t Return status indicating errors if they occurred
+ * @param data The GstVmbSrcFrame that was wrapped
  */
-VmbError_t set_roi(GstVmbSrc *vmbsrc)
+void release_wrapped_frame(gpointer data)
 {
-    // TODO: Improve error handling (Perhaps more explicit allowed values are enough?) Early exit on errors?
+    GstVmbSrcFrame *vmb_frame = data;
+    GstVmbSrc *vmbsrc = vmb_frame->vmbsrc;
 
-    // Reset OffsetX and OffsetY to 0 so that full sensor width is usable for width/height
-    VmbError_t result;
-    GST_DEBUG_OBJECT(vmbsrc, "Temporarily resetting \"OffsetX\" and \"OffsetY\" to 0");
-    result = VmbFeatureIntSet(vmbsrc->camera.handle, "OffsetX", 0);
-    if (result != VmbErrorSuccess)
+    g_mutex_lock(&vmbsrc->frame_lock);
+    vmb_frame->is_in_use = false;
+    if (vmb_frame->is_orphaned)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"OffsetX\" to 0. Return code was: %s",
-                           ErrorCodeToMessage(result));
+        // The frame was already removed from the frame buffers. Frames whose buffer the transport layer allocated are
+        // still announced, as revoking them frees the image data downstream was using. The element is referenced by
+        // every wrapped frame, so the camera cannot have been closed yet
+        if (!vmb_frame->owns_buffer && vmb_frame->pool_buffer == NULL)
+        {
+            VmbFrameRevoke(vmbsrc->camera.handle, &vmb_frame->frame);
+        }
+        free_frame(vmb_frame);
     }
-    result = VmbFeatureIntSet(vmbsrc->camera.handle, "OffsetY", 0);
-    if (result != VmbErrorSuccess)
+    else
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"OffsetY\" to 0. Return code was: %s",
-                           ErrorCodeToMessage(result));
+        vmbsrc->num_frames_in_use--;
+        if (vmbsrc->camera.is_acquiring)
+        {
+            GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_REQUEUE, &vmb_frame->frame, vmb_frame->frame.frameID);
+            VmbError_t result = queue_frame(vmbsrc, &vmb_frame->frame);
+            if (result != VmbErrorSuccess)
+            {
+                GST_WARNING_OBJECT(vmbsrc,
+                                   "Could not requeue released frame. Got error code: %s",
+                                   ErrorCodeToMessage(result));
+            }
+        }
     }
+    g_cond_signal(&vmbsrc->frame_released);
+    g_mutex_unlock(&vmbsrc->frame_lock);
 
-    VmbInt64_t vmb_width;
-    result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "Width", NULL, &vmb_width);
+    gst_object_unref(vmbsrc);
+}
 
-    // Set Width to full sensor if no explicit width was set
-    if (vmbsrc->properties.width == INT_MAX)
+/**
+ * @brief Copies the image data of a filled frame into an output buffer and requeues the frame to the capture engine.
+ * The output buffer is taken from the negotiated buffer pool if there is one
+ *
+ * @param vmbsrc Provides the buffer pool and the video info of the negotiated caps
+ * @param frame Filled frame that should be passed downstream
+ * @param offset Offsets of the planes of the image data in the frame buffer (see get_frame_layout)
+ * @param stride Row strides of the image data in the frame
+ * @return GstBuffer* Buffer holding a copy of the frame data. Unless it is in the layout of the frame, it has a
+ * GstVideoMeta describing the layout
+ */
+GstBuffer *copy_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame, const gsize *offset, const gint *stride)
+{
+    GstVideoInfo *info = &vmbsrc->video_info;
+    // Unpacked image data needs 16 bit per pixel. Otherwise the complete payload is copied
+    gsize size = frame->bufferSize;
+    gsize num_pixels = 0;
+    guint packed_row_bits = 0;
+    if (vmbsrc->unpack_function != NULL)
     {
-        GST_DEBUG_OBJECT(vmbsrc,
-                         "Setting \"Width\" to full width. Got sensor width \"%lld\" (Return Code %s)",
-                         vmb_width,
-                         ErrorCodeToMessage(result));
-        g_object_set(vmbsrc, "width", (int)vmb_width, NULL);
+        guint bits_per_pixel = packed_bits_per_pixel(vmbsrc->packing);
+        packed_row_bits = (guint)info->width * bits_per_pixel;
+        num_pixels = MIN((gsize)info->width * info->height, (gsize)frame->bufferSize * 8 / bits_per_pixel);
+        size = num_pixels * sizeof(guint16);
     }
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"Width\" to %d", vmbsrc->properties.width);
-    result = VmbFeatureIntSet(vmbsrc->camera.handle, "Width", vmbsrc->properties.width);
-    if (result == VmbErrorSuccess)
+    else if (vmbsrc->debayer_function != NULL)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        size = GST_VIDEO_INFO_SIZE(info);
     }
-    else
+    if (GST_VIDEO_INFO_FORMAT(info) != GST_VIDEO_FORMAT_ENCODED)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"Width\" to value \"%d\". Return code was: %s",
-                           vmbsrc->properties.width,
-                           ErrorCodeToMessage(result));
+        // Image data repacked into the default layout can take more space than the payload (e.g. rows aligned to 4 bytes)
+        size = MAX(size, GST_VIDEO_INFO_SIZE(info));
     }
 
-    VmbInt64_t vmb_height;
-    result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "Height", NULL, &vmb_height);
-    // Set Height to full sensor if no explicit height was set
-    if (vmbsrc->properties.height == INT_MAX)
+    GstBuffer *buffer = NULL;
+    GstBufferPool *pool = gst_base_src_get_buffer_pool(GST_BASE_SRC(vmbsrc));
+    if (pool != NULL)
     {
-        GST_DEBUG_OBJECT(vmbsrc,
-                         "Setting \"Height\" to full height. Got sensor height \"%lld\" (Return Code %s)",
-                         vmb_height,
-                         ErrorCodeToMessage(result));
-        g_object_set(vmbsrc, "height", (int)vmb_height, NULL);
+        if (gst_buffer_pool_acquire_buffer(pool, &buffer, NULL) != GST_FLOW_OK)
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Could not acquire buffer from buffer pool. Allocating a new buffer");
+            buffer = NULL;
+        }
+        gst_object_unref(pool);
     }
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"Height\" to %d", vmbsrc->properties.height);
-    result = VmbFeatureIntSet(vmbsrc->camera.handle, "Height", vmbsrc->properties.height);
-    if (result == VmbErrorSuccess)
+
+    // Buffers of the pool are sized for the image data and may be smaller than a payload with chunk data. The layout
+    // described by a video meta of the pool is only known for raw video formats
+    bool is_raw = GST_VIDEO_INFO_FORMAT(info) != GST_VIDEO_FORMAT_ENCODED;
+    gsize min_size = is_raw ? MIN(size, GST_VIDEO_INFO_SIZE(info)) : size;
+    GstVideoMeta *video_meta = buffer != NULL && is_raw ? gst_buffer_get_video_meta(buffer) : NULL;
+    // Packed rows can only be unpacked separately if every row starts at a byte boundary
+    if (buffer != NULL &&
+        ((video_meta == NULL && gst_buffer_get_size(buffer) < min_size) ||
+         (video_meta != NULL && vmbsrc->unpack_function != NULL && packed_row_bits % 8 != 0)))
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        GST_LOG_OBJECT(vmbsrc, "Buffer of buffer pool can not hold the image data. Allocating a new buffer");
+        gst_buffer_unref(buffer);
+        buffer = NULL;
+        video_meta = NULL;
     }
-    else
+    if (buffer == NULL)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"Height\" to value \"%d\". Return code was: %s",
-                           vmbsrc->properties.height,
-                           ErrorCodeToMessage(result));
+        buffer = gst_buffer_new_and_alloc(size);
     }
-    // offsetx
-    if (vmbsrc->properties.offsetx == -1)
+    // Without a layout given by the pool, converted image data and frames downstream can not read in the layout of the
+    // camera are written with the default layout of the negotiated caps
+    const gsize *dest_offset = video_meta != NULL ? video_meta->offset : NULL;
+    const gint *dest_stride = video_meta != NULL ? video_meta->stride : NULL;
+    if (video_meta == NULL && is_raw &&
+        ((vmbsrc->unpack_function != NULL && packed_row_bits % 8 == 0) || vmbsrc->debayer_function != NULL ||
+         (!vmbsrc->is_video_meta_supported && !is_default_layout(info, offset, stride))))
     {
-        VmbInt64_t vmb_offsetx = (vmb_width - vmbsrc->properties.width) >> 1;
-        GST_DEBUG_OBJECT(vmbsrc, "ROI centering along x-axis requested. Desired offsetx=%lld",
-                         vmb_offsetx);
-        // Check if the desired value is valid. If not round to nearest valid value
-        VmbInt64_t offsetx_min = 0;
-        VmbInt64_t offsetx_max = 0;
-        VmbInt64_t offsetx_increment = 0;
-        result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "OffsetX", &offsetx_min, &offsetx_max);
-        if (result == VmbErrorSuccess)
-        {
-            result = VmbFeatureIntIncrementQuery(vmbsrc->camera.handle, "OffsetX", &offsetx_increment);
-            if (result == VmbErrorSuccess)
-            {
-                VmbInt64_t valid_vmb_offsetx = RoundToNearestValidValue(vmb_offsetx, offsetx_min, offsetx_max, offsetx_increment);
-                if (valid_vmb_offsetx != vmb_offsetx)
-                {
-                    GST_DEBUG_OBJECT(vmbsrc,
-                                     "Desired offsetx=%lld was not valid. Using nearest valid value=%lld",
-                                     vmb_offsetx,
-                                     valid_vmb_offsetx);
-                    vmb_offsetx = valid_vmb_offsetx;
-                }
-            }
-            else
-            {
-                GST_DEBUG_OBJECT(vmbsrc,
-                                 "Error during imcrement query for OffsetX. Using inital desired value: %s",
-                                 ErrorCodeToMessage(result));
-            }
-        }
-        else
-        {
-            GST_DEBUG_OBJECT(vmbsrc,
-                             "Error during range query for OffsetX. Using inital desired value: %s",
-                             ErrorCodeToMessage(result));
-        }
-        g_object_set(vmbsrc, "offsetx", (int)vmb_offsetx, NULL);
+        dest_offset = info->offset;
+        dest_stride = info->stride;
+        gst_buffer_add_video_meta_full(buffer,
+                                       GST_VIDEO_FRAME_FLAG_NONE,
+                                       GST_VIDEO_INFO_FORMAT(info),
+                                       GST_VIDEO_INFO_WIDTH(info),
+                                       GST_VIDEO_INFO_HEIGHT(info),
+                                       GST_VIDEO_INFO_N_PLANES(info),
+                                       info->offset,
+                                       info->stride);
     }
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"OffsetX\" to %d", vmbsrc->properties.offsetx);
-    result = VmbFeatureIntSet(vmbsrc->camera.handle, "OffsetX", vmbsrc->properties.offsetx);
-    if (result == VmbErrorSuccess)
+
+    GstMapInfo map;
+    if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE))
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        GST_ERROR_OBJECT(vmbsrc, "Could not map output buffer. Image data of frame %llu is lost", frame->frameID);
+        queue_frame(vmbsrc, frame);
+        return buffer;
     }
-    else
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_COPY_START, frame, frame->frameID);
+    const guint8 *src = frame->buffer;
+    if (vmbsrc->debayer_function != NULL)
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"OffsetX\" to value \"%d\". Return code was: %s",
-                           vmbsrc->properties.offsetx,
-                           ErrorCodeToMessage(result));
+        // Bayer data has a single 8 bit plane without row padding. Rows missing in the payload are not converted
+        gsize data_size = frame->bufferSize - MIN(offset[0], (gsize)frame->bufferSize);
+        guint num_rows = (guint)MIN((gsize)info->height, data_size / MAX(info->width, 1));
+        debayer_frame(vmbsrc, src + offset[0], num_rows, map.data + dest_offset[0], (gsize)dest_stride[0]);
     }
-
-    // offsety
-    if (vmbsrc->properties.offsety == -1)
+    else if (dest_offset != NULL)
     {
-        VmbInt64_t vmb_offsety = (vmb_height - vmbsrc->properties.height) >> 1;
-        GST_DEBUG_OBJECT(vmbsrc, "ROI centering along y-axis requested. Desired offsety=%lld",
-                         vmb_offsety);
-        // Check if the desired value is valid. If not round to nearest valid value
-        VmbInt64_t offsety_min = 0;
-        VmbInt64_t offsety_max = 0;
-        VmbInt64_t offsety_increment = 0;
-        result = VmbFeatureIntRangeQuery(vmbsrc->camera.handle, "OffsetY", &offsety_min, &offsety_max);
-        if (result == VmbErrorSuccess)
+        // The pool or the caps define the memory layout (e.g. padded rows required by downstream hardware). Copy row by
+        // row
+        const GstVideoFormatInfo *finfo = info->finfo;
+        guint num_planes = video_meta != NULL ? MIN(video_meta->n_planes, finfo->n_planes) : finfo->n_planes;
+        for (guint plane = 0; plane < num_planes; plane++)
         {
-            result = VmbFeatureIntIncrementQuery(vmbsrc->camera.handle, "OffsetY", &offsety_increment);
-            if (result == VmbErrorSuccess)
+            gint num_rows = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT(finfo, plane, info->height);
+            gsize row_size = (gsize)MIN(stride[plane] - (gint)vmbsrc->line_padding, dest_stride[plane]);
+            const guint8 *src_plane = src + offset[plane];
+            guint8 *dest_plane = map.data + dest_offset[plane];
+            for (gint row = 0; row < num_rows; row++)
             {
-                VmbInt64_t valid_vmb_offsety = RoundToNearestValidValue(vmb_offsety, offsety_min, offsety_max, offsety_increment);
-                if (valid_vmb_offsety != vmb_offsety)
+                guint8 *dest_row = dest_plane + (gsize)row * dest_stride[plane];
+                if (vmbsrc->unpack_function != NULL)
                 {
-                    GST_DEBUG_OBJECT(vmbsrc,
-                                     "Desired offsety=%lld was not valid. Using nearest valid value=%lld",
-                                     vmb_offsety,
-                                     valid_vmb_offsety);
-                    vmb_offsety = valid_vmb_offsety;
+                    // Packed formats only have a single plane
+                    if ((gsize)(row + 1) * info->width > num_pixels)
+                    {
+                        break;
+                    }
+                    vmbsrc->unpack_function(src_plane + (gsize)row * (packed_row_bits / 8 + vmbsrc->line_padding),
+                                            (guint16 *)dest_row,
+                                            info->width);
+                }
+                else if (src_plane + (gsize)(row + 1) * stride[plane] - vmbsrc->line_padding <=
+                         src + frame->bufferSize)
+                {
+                    memcpy(dest_row, src_plane + (gsize)row * stride[plane], row_size);
                 }
             }
-            else
-            {
-                GST_DEBUG_OBJECT(vmbsrc,
-                                 "Error during imcrement query for OffsetY. Using inital desired value: %s",
-                                 ErrorCodeToMessage(result));
-            }
-        }
-        else
-        {
-            GST_DEBUG_OBJECT(vmbsrc,
-                             "Error during range query for OffsetY. Using inital desired value: %s",
-                             ErrorCodeToMessage(result));
         }
-        g_object_set(vmbsrc, "offsety", (int)vmb_offsety, NULL);
     }
-    GST_DEBUG_OBJECT(vmbsrc, "Setting \"OffsetY\" to %d", vmbsrc->properties.offsety);
-    result = VmbFeatureIntSet(vmbsrc->camera.handle, "OffsetY", vmbsrc->properties.offsety);
-    if (result == VmbErrorSuccess)
+    else if (vmbsrc->unpack_function != NULL)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+        // Rows of packed data that do not end at a byte boundary are unpacked in one piece into rows without padding
+        vmbsrc->unpack_function(src + offset[0], (guint16 *)map.data, num_pixels);
+        gsize unpacked_offset[GST_VIDEO_MAX_PLANES] = {0};
+        gint unpacked_stride[GST_VIDEO_MAX_PLANES] = {(gint)(info->width * sizeof(guint16))};
+        gst_buffer_add_video_meta_full(buffer,
+                                       GST_VIDEO_FRAME_FLAG_NONE,
+                                       GST_VIDEO_INFO_FORMAT(info),
+                                       GST_VIDEO_INFO_WIDTH(info),
+                                       GST_VIDEO_INFO_HEIGHT(info),
+                                       1,
+                                       unpacked_offset,
+                                       unpacked_stride);
     }
     else
     {
-        GST_WARNING_OBJECT(vmbsrc,
-                           "Failed to set \"OffsetY\" to value \"%d\". Return code was: %s",
-                           vmbsrc->properties.offsety,
-                           ErrorCodeToMessage(result));
+        memcpy(map.data, src, MIN(frame->bufferSize, map.size));
     }
-    return result;
+    gst_buffer_unmap(buffer, &map);
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_COPY_END, frame, frame->frameID);
+
+    GST_VMB_TRACE(vmbsrc, GST_VMB_TRACE_REQUEUE, frame, frame->frameID);
+    queue_frame(vmbsrc, frame);
+    return buffer;
 }
 
 /**
- * @brief Helper function to apply values to TriggerSelector, TriggerMode, TriggerSource and TriggerActivation in the
- * correct order
- *
- * Trigger settings are always applied in the order
- * 1. TriggerSelector
- * 2. TriggerActivation
- * 3. TriggerSource
- * 4. TriggerMode
+ * @brief Determines the layout of the image data in the buffer of a filled frame. The image data starts at
+ * frame->imageData, which lies behind a header for some payload types, and every row is followed by "PaddingX" bytes
  *
- * @param vmbsrc Provides access to the camera handle used for the VmbC calls and holds the desired values for the
- * modified features
- * @return VmbError_t Return status indicating errors if they occurred
+ * @param vmbsrc Holds the negotiated format and the row padding of the camera
+ * @param frame Filled frame whose layout is determined
+ * @param offset Set to the offsets of the planes from the start of the frame buffer
+ * @param stride Set to the row strides of the planes
  */
-VmbError_t apply_trigger_settings(GstVmbSrc *vmbsrc)
+void get_frame_layout(GstVmbSrc *vmbsrc, const VmbFrame_t *frame, gsize *offset, gint *stride)
 {
-    GST_DEBUG_OBJECT(vmbsrc, "Applying trigger settings");
-
-    VmbError_t result = VmbErrorSuccess;
-    GEnumValue *enum_entry;
-
-    // TODO: Should  the function start by disabling triggering for all TriggerSelectors to make sure only one is
-    // enabled after the function is done?
-
-    // TriggerSelector
-    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERSELECTOR_VALUES),
-                                  vmbsrc->properties.triggerselector);
-    if (enum_entry->value == GST_VMBSRC_TRIGGERSELECTOR_UNCHANGED)
+    const GstVideoInfo *info = &vmbsrc->video_info;
+    const VmbUint8_t *buffer = frame->buffer;
+    gsize data_offset = 0;
+    if (frame->imageData != NULL && frame->imageData >= buffer && frame->imageData < buffer + frame->bufferSize)
     {
-        GST_DEBUG_OBJECT(vmbsrc,
-                         "\"TriggerSelector\" is set to %s. Not changing camera value", enum_entry->value_nick);
+        data_offset = (gsize)(frame->imageData - buffer);
     }
-    else
+    for (guint plane = 0; plane < info->finfo->n_planes; plane++)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerSelector\" to %s", enum_entry->value_nick);
-        result = VmbFeatureEnumSet(vmbsrc->camera.handle, "TriggerSelector", enum_entry->value_nick);
-        if (result == VmbErrorSuccess)
-        {
-            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
-        }
-        else
-        {
-            GST_ERROR_OBJECT(vmbsrc,
-                             "Failed to set \"TriggerSelector\" to %s. Return code was: %s",
-                             enum_entry->value_nick,
-                             ErrorCodeToMessage(result));
-            if (result == VmbErrorInvalidValue)
-            {
-                log_available_enum_entries(vmbsrc, "TriggerSelector");
-            }
-        }
+        // Formats without pixel description (e.g. Bayer) keep a stride of 0
+        gint row_size = info->finfo->pixel_stride[plane] == 0
+                            ? 0
+                            : GST_VIDEO_FORMAT_INFO_SCALE_WIDTH(info->finfo, plane, info->width) *
+                                  info->finfo->pixel_stride[plane];
+        stride[plane] = row_size == 0 ? 0 : row_size + (gint)vmbsrc->line_padding;
+        offset[plane] = data_offset;
+        data_offset += (gsize)stride[plane] * GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT(info->finfo, plane, info->height);
     }
+}
 
-    // TriggerActivation
-    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERACTIVATION_VALUES),
-                                  vmbsrc->properties.triggeractivation);
-    if (enum_entry->value == GST_VMBSRC_TRIGGERACTIVATION_UNCHANGED)
+/**
+ * @brief Checks whether image data in the given layout can be read by elements that do not support GstVideoMeta
+ *
+ * @param info Negotiated format
+ * @param offset Offsets of the planes
+ * @param stride Row strides of the planes
+ * @return true if the layout equals the default layout of the negotiated caps
+ */
+bool is_default_layout(const GstVideoInfo *info, const gsize *offset, const gint *stride)
+{
+    if (GST_VIDEO_INFO_FORMAT(info) == GST_VIDEO_FORMAT_ENCODED)
     {
-        GST_DEBUG_OBJECT(vmbsrc,
-                         "\"TriggerActivation\" is set to %s. Not changing camera value", enum_entry->value_nick);
+        // Only described by the caps, so there is no other layout
+        return true;
     }
-    else
+    for (guint plane = 0; plane < GST_VIDEO_INFO_N_PLANES(info); plane++)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerActivation\" to %s", enum_entry->value_nick);
-        result = VmbFeatureEnumSet(vmbsrc->camera.handle, "TriggerActivation", enum_entry->value_nick);
-        if (result == VmbErrorSuccess)
-        {
-            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
-        }
-        else
+        if (offset[plane] != GST_VIDEO_INFO_PLANE_OFFSET(info, plane) ||
+            stride[plane] != GST_VIDEO_INFO_PLANE_STRIDE(info, plane))
         {
-            GST_ERROR_OBJECT(vmbsrc,
-                             "Failed to set \"TriggerActivation\" to %s. Return code was: %s",
-                             enum_entry->value_nick,
-                             ErrorCodeToMessage(result));
-            if (result == VmbErrorInvalidValue)
-            {
-                log_available_enum_entries(vmbsrc, "TriggerActivation");
-            }
+            return false;
         }
     }
+    return true;
+}
 
-    // TriggerSource
-    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERSOURCE_VALUES),
-                                  vmbsrc->properties.triggersource);
-    if (enum_entry->value == GST_VMBSRC_TRIGGERSOURCE_UNCHANGED)
+/**
+ * @brief Selects the debayer implementation if the negotiated format is produced by debayering the selected VimbaX
+ * format, and prepares the worker threads converting the row bands of each frame
+ *
+ * @param vmbsrc Holds the debayer settings and the worker threads
+ * @param format_match VimbaX format selected for the negotiated caps
+ * @param gst_format Name of the negotiated GStreamer format
+ */
+void setup_debayering(GstVmbSrc *vmbsrc, const VimbaXGstFormatMatch_t *format_match, const char *gst_format)
+{
+    vmbsrc->debayer_function = NULL;
+    vmbsrc->bayer_pattern = bayer_pattern_from_vimbax_format(format_match->vimbax_format_name);
+    if (vmbsrc->bayer_pattern == VIMBAX_BAYER_NONE || strcmp(gst_format, format_match->gst_format_name) == 0 ||
+        !debayer_output_from_gst_format(gst_format, &vmbsrc->debayer_output))
     {
+        return;
+    }
 
-        GST_DEBUG_OBJECT(vmbsrc,
-                         "\"TriggerSource\" is set to %s. Not changing camera value", enum_entry->value_nick);
+    const char *implementation = NULL;
+    vmbsrc->debayer_function = get_debayer_function(&implementation);
+    guint num_threads = vmbsrc->properties.debayer_threads;
+    if (num_threads == 0)
+    {
+        num_threads = (guint)CLAMP(g_get_num_processors(), 1, DEFAULT_DEBAYER_THREADS);
     }
-    else
+    if (num_threads > 1)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerSource\" to %s", enum_entry->value_nick);
-        result = VmbFeatureEnumSet(vmbsrc->camera.handle, "TriggerSource", enum_entry->value_nick);
-        if (result == VmbErrorSuccess)
+        GError *error = NULL;
+        if (vmbsrc->debayer_pool == NULL)
         {
-            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
+            // Exclusive threads are started right away and stay ready for the next frame
+            vmbsrc->debayer_pool = g_thread_pool_new(debayer_band_thread, vmbsrc, (gint)num_threads - 1, TRUE, &error);
         }
         else
         {
-            GST_ERROR_OBJECT(vmbsrc,
-                             "Failed to set \"TriggerSource\" to %s. Return code was: %s",
-                             enum_entry->value_nick,
-                             ErrorCodeToMessage(result));
-            if (result == VmbErrorInvalidValue)
-            {
-                log_available_enum_entries(vmbsrc, "TriggerSource");
-            }
+            g_thread_pool_set_max_threads(vmbsrc->debayer_pool, (gint)num_threads - 1, &error);
+        }
+        if (error != NULL)
+        {
+            GST_WARNING_OBJECT(vmbsrc, "Could not start debayer threads: %s", error->message);
+            g_clear_error(&error);
         }
     }
+    vmbsrc->num_debayer_bands =
+        vmbsrc->debayer_pool != NULL ? MIN(num_threads, (guint)g_thread_pool_get_max_threads(vmbsrc->debayer_pool) + 1)
+                                     : 1;
+    GST_INFO_OBJECT(vmbsrc,
+                    "Debayering \"%s\" to \"%s\" with %s implementation in %u threads",
+                    format_match->vimbax_format_name,
+                    gst_format,
+                    implementation,
+                    vmbsrc->num_debayer_bands);
+}
 
-    // TriggerMode
-    enum_entry = g_enum_get_value(g_type_class_ref(GST_ENUM_TRIGGERMODE_VALUES),
-                                  vmbsrc->properties.triggermode);
-    if (enum_entry->value == GST_VMBSRC_TRIGGERMODE_UNCHANGED)
+/**
+ * @brief Converts Bayer image data to the negotiated output format. The rows are split into bands that are converted in
+ * parallel by the streaming thread and the threads of the debayer pool
+ *
+ * @param vmbsrc Provides the debayer settings, the video info of the negotiated caps and the worker threads
+ * @param src Bayer image data with the width of the negotiated caps and no row padding
+ * @param height Number of rows in src
+ * @param dest First row of the output image
+ * @param dest_stride Distance in bytes between output rows
+ */
+void debayer_frame(GstVmbSrc *vmbsrc, const guint8 *src, guint height, guint8 *dest, gsize dest_stride)
+{
+    GstVmbSrcDebayerBand bands[MAX_DEBAYER_THREADS];
+    guint num_bands = CLAMP(height / MIN_DEBAYER_BAND_ROWS, 1, vmbsrc->num_debayer_bands);
+    guint band_rows = (height + num_bands - 1) / num_bands;
+    if (band_rows > 0)
     {
-        GST_DEBUG_OBJECT(vmbsrc,
-                         "\"TriggerMode\" is set to %s. Not changing camera value", enum_entry->value_nick);
+        // rounding up may leave fewer bands with rows
+        num_bands = (height + band_rows - 1) / band_rows;
     }
-    else
+
+    for (guint i = 0; i < num_bands; i++)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Setting \"TriggerMode\" to %s", enum_entry->value_nick);
-        result = VmbFeatureEnumSet(vmbsrc->camera.handle, "TriggerMode", enum_entry->value_nick);
-        if (result == VmbErrorSuccess)
-        {
-            GST_DEBUG_OBJECT(vmbsrc, "Setting was changed successfully");
-        }
-        else
-        {
-            GST_ERROR_OBJECT(vmbsrc,
-                             "Failed to set \"TriggerMode\" to %s. Return code was: %s",
-                             enum_entry->value_nick,
-                             ErrorCodeToMessage(result));
-        }
+        bands[i].function = vmbsrc->debayer_function;
+        bands[i].src = src;
+        bands[i].width = (guint)vmbsrc->video_info.width;
+        bands[i].height = height;
+        bands[i].pattern = vmbsrc->bayer_pattern;
+        bands[i].dest = dest;
+        bands[i].dest_stride = dest_stride;
+        bands[i].output = vmbsrc->debayer_output;
+        bands[i].first_row = i * band_rows;
+        bands[i].num_rows = MIN(band_rows, height - bands[i].first_row);
+    }
+
+    g_mutex_lock(&vmbsrc->debayer_lock);
+    vmbsrc->debayer_bands_pending = num_bands > 1 ? num_bands - 1 : 0;
+    g_mutex_unlock(&vmbsrc->debayer_lock);
+    for (guint i = 1; i < num_bands; i++)
+    {
+        g_thread_pool_push(vmbsrc->debayer_pool, &bands[i], NULL);
+    }
+    // The streaming thread converts the first band itself instead of only waiting for the pool
+    debayer_band(&bands[0]);
+
+    g_mutex_lock(&vmbsrc->debayer_lock);
+    while (vmbsrc->debayer_bands_pending > 0)
+    {
+        g_cond_wait(&vmbsrc->debayer_done, &vmbsrc->debayer_lock);
     }
-
-    return result;
+    g_mutex_unlock(&vmbsrc->debayer_lock);
 }
 
 /**
- * @brief Gets the PayloadSize from the connected camera, allocates and announces frame buffers for capturing
+ * @brief Converts the rows of a single band
  *
- * @param vmbsrc Provides the camera handle used for the VmbC calls and holds the frame buffers
- * @return VmbError_t Return status indicating errors if they occurred
+ * @param band Band to convert
  */
-VmbError_t alloc_and_announce_buffers(GstVmbSrc *vmbsrc)
+void debayer_band(const GstVmbSrcDebayerBand *band)
 {
-    VmbUint32_t payload_size;
-    VmbError_t result = VmbPayloadSizeGet(vmbsrc->camera.handle, &payload_size);
-    if (result == VmbErrorSuccess)
-    {
-        GST_DEBUG_OBJECT(vmbsrc, "Got \"PayloadSize\" of: %u", payload_size);
-        GST_DEBUG_OBJECT(vmbsrc, "Allocating and announcing %d VimbaX frames", NUM_FRAME_BUFFERS);
-        GEnumValue *allocation_mode = g_enum_get_value(g_type_class_ref(GST_ENUM_ALLOCATIONMODE_VALUES), vmbsrc->properties.allocation_mode);
-        GST_DEBUG_OBJECT(vmbsrc, "Using allocation mode %s", allocation_mode->value_nick);
-        for (int i = 0; i < NUM_FRAME_BUFFERS; i++)
-        {
-            if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_FRAME)
-            {
-                // The element is responsible for allocating frame buffers. Some transport layers
-                // provide higher performance if specific alignment is observed. Check if this
-                // camera has such a requirement. If not this basically becomes a regular allocation
-                VmbInt64_t buffer_alignment = 1;
-                result = VmbFeatureIntGet(vmbsrc->camera.info.streamHandles[0],
-                                        "StreamBufferAlignment",
-                                        &buffer_alignment);
-                // The result is not really important so we do not have to check it. If the camera
-                // requires alignment, the call will have succeeded. If alignment does not matter,
-                // the call failed but the default value of 1 was not changed
-                GST_DEBUG_OBJECT(vmbsrc,
-                                "Using \"StreamBufferAlignment\" of: %llu (read result was %s)",
-                                buffer_alignment,
-                                ErrorCodeToMessage(result));
-                vmbsrc->frame_buffers[i].buffer = VmbAlignedAlloc(buffer_alignment, payload_size);
-                if (NULL == vmbsrc->frame_buffers[i].buffer)
-                {
-                    result = VmbErrorResources;
-                    break;
-                }
-            }
-            else
-            {
-                // The transport layer will allocate suitable buffers
-                vmbsrc->frame_buffers[i].buffer = NULL;
-            }
+    band->function(band->src,
+                   band->width,
+                   band->height,
+                   band->pattern,
+                   band->dest,
+                   band->dest_stride,
+                   band->output,
+                   band->first_row,
+                   band->num_rows);
+}
 
-            vmbsrc->frame_buffers[i].bufferSize = (VmbUint32_t)payload_size;
-            vmbsrc->frame_buffers[i].context[0] = vmbsrc->filled_frame_queue;
+/**
+ * @brief Worker function of the debayer pool. Converts a single row band and wakes up the streaming thread once all
+ * bands of the frame were converted
+ *
+ * @param data The GstVmbSrcDebayerBand to convert
+ * @param user_data The GstVmbSrc whose frame is converted
+ */
+void debayer_band_thread(gpointer data, gpointer user_data)
+{
+    GstVmbSrc *vmbsrc = user_data;
+    debayer_band(data);
 
-            // Announce Frame
-            result = VmbFrameAnnounce(vmbsrc->camera.handle,
-                                      &vmbsrc->frame_buffers[i],
-                                      (VmbUint32_t)sizeof(VmbFrame_t));
-            if (result != VmbErrorSuccess)
-            {
-                free(vmbsrc->frame_buffers[i].buffer);
-                memset(&vmbsrc->frame_buffers[i], 0, sizeof(VmbFrame_t));
-                break;
-            }
-        }
+    g_mutex_lock(&vmbsrc->debayer_lock);
+    if (--vmbsrc->debayer_bands_pending == 0)
+    {
+        g_cond_signal(&vmbsrc->debayer_done);
     }
-    return result;
+    g_mutex_unlock(&vmbsrc->debayer_lock);
 }
 
 /**
- * @brief Revokes frame buffers, frees their memory and overwrites old pointers with 0
+ * @brief Size of the buffers holding the image data of copied frames
  *
- * @param vmbsrc Provides the camera handle used for the VmbC calls and the frame buffers
+ * @param vmbsrc Provides the camera handle and the selected packing or debayering
+ * @param info Video info of the negotiated caps
+ * @return gsize Size in bytes
  */
-void revoke_and_free_buffers(GstVmbSrc *vmbsrc)
+gsize get_output_size(GstVmbSrc *vmbsrc, const GstVideoInfo *info)
 {
-    for (int i = 0; i < NUM_FRAME_BUFFERS; i++)
+    if (vmbsrc->unpack_function != NULL)
     {
-        if (NULL != vmbsrc->frame_buffers[i].buffer)
-        {
-            VmbFrameRevoke(vmbsrc->camera.handle, &vmbsrc->frame_buffers[i]);
-            if (vmbsrc->properties.allocation_mode == GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_FRAME)
-            {
-                // The element allocated the frame buffers, so it must free the memory also
-                VmbAlignedFree(vmbsrc->frame_buffers[i].buffer);
-            }
-            memset(&vmbsrc->frame_buffers[i], 0, sizeof(VmbFrame_t));
-        }
+        return (gsize)info->width * info->height * sizeof(guint16);
     }
+    if (vmbsrc->debayer_function != NULL)
+    {
+        return GST_VIDEO_INFO_SIZE(info);
+    }
+    VmbUint32_t payload_size;
+    if (VmbPayloadSizeGet(vmbsrc->camera.handle, &payload_size) == VmbErrorSuccess)
+    {
+        return payload_size;
+    }
+    return GST_VIDEO_INFO_SIZE(info);
 }
 
 /**
- * @brief Starts the capture engine, queues VimbaX frames and runs the AcquisitionStart command feature. Frame buffers
- * must be allocated before running this function.
+ * @brief Builds the caps supported with the current camera settings from the "Width" and "Height" features and the
+ * mapped pixel formats
  *
- * @param vmbsrc Provides the camera handle used for the VmbC calls and access to the queued frame buffers
- * @return VmbError_t Return status indicating errors if they occurred
+ * @param vmbsrc Provides the camera handle and the supported formats
+ * @return GstCaps* The supported caps
  */
-VmbError_t start_image_acquisition(GstVmbSrc *vmbsrc)
+GstCaps *query_camera_caps(GstVmbSrc *vmbsrc)
 {
-    // Start Capture Engine
-    GST_DEBUG_OBJECT(vmbsrc, "Starting the capture engine");
-    VmbError_t result = VmbCaptureStart(vmbsrc->camera.handle);
-    if (result == VmbErrorSuccess)
+    GstCaps *caps;
+    caps = gst_pad_get_pad_template_caps(GST_BASE_SRC_PAD(vmbsrc));
+    caps = gst_caps_make_writable(caps);
+
+    VmbInt64_t vmb_width, vmb_height;
+
+    VmbFeatureIntGet(vmbsrc->camera.handle, "Width", &vmb_width);
+    VmbFeatureIntGet(vmbsrc->camera.handle, "Height", &vmb_height);
+
+    GValue width = G_VALUE_INIT;
+    GValue height = G_VALUE_INIT;
+
+    g_value_init(&width, G_TYPE_INT);
+    g_value_init(&height, G_TYPE_INT);
+
+    g_value_set_int(&width, (gint)vmb_width);
+
+    g_value_set_int(&height, (gint)vmb_height);
+
+    GstStructure *raw_caps = gst_caps_get_structure(caps, 0);
+    GstStructure *bayer_caps = gst_caps_get_structure(caps, 1);
+
+    gst_structure_set_value(raw_caps, "width", &width);
+    gst_structure_set_value(raw_caps, "height", &height);
+    // The framerate is variable (0/1) unless a rate was requested, with the frame rate of the camera as max-framerate
+    gint framerate_num, framerate_denom;
+    gint max_framerate_num, max_framerate_denom;
+    bool has_max_framerate = get_output_framerate(
+        vmbsrc, &framerate_num, &framerate_denom, &max_framerate_num, &max_framerate_denom);
+    gst_structure_set(raw_caps,
+                      "framerate", GST_TYPE_FRACTION, framerate_num, framerate_denom,
+                      NULL);
+
+    gst_structure_set_value(bayer_caps, "width", &width);
+    gst_structure_set_value(bayer_caps, "height", &height);
+    gst_structure_set(bayer_caps,
+                      "framerate", GST_TYPE_FRACTION, framerate_num, framerate_denom,
+                      NULL);
+    if (has_max_framerate && framerate_num == 0)
     {
-        GST_DEBUG_OBJECT(vmbsrc, "Queueing the VimbaX frames");
-        for (int i = 0; i < NUM_FRAME_BUFFERS; i++)
+        gst_structure_set(raw_caps,
+                          "max-framerate", GST_TYPE_FRACTION, max_framerate_num, max_framerate_denom,
+                          NULL);
+        gst_structure_set(bayer_caps,
+                          "max-framerate", GST_TYPE_FRACTION, max_framerate_num, max_framerate_denom,
+                          NULL);
+    }
+
+    // Query supported pixel formats from camera and map them to GStreamer formats
+    GValue pixel_format_raw_list = G_VALUE_INIT;
+    g_value_init(&pixel_format_raw_list, GST_TYPE_LIST);
+
+    GValue pixel_format_bayer_list = G_VALUE_INIT;
+    g_value_init(&pixel_format_bayer_list, GST_TYPE_LIST);
+
+    GValue pixel_format = G_VALUE_INIT;
+    g_value_init(&pixel_format, G_TYPE_STRING);
+
+    // Add all supported GStreamer format string to the reported caps
+    bool has_bayer_format = false;
+    for (unsigned int i = 0; i < vmbsrc->camera.supported_formats_count; i++)
+    {
+        if (vmbsrc->properties.packed_formats == GST_VMBSRC_PACKED_FORMATS_NEVER &&
+            vmbsrc->camera.supported_formats[i]->packing != VIMBAX_PACKING_NONE)
         {
-            // Queue Frame
-            result = VmbCaptureFrameQueue(vmbsrc->camera.handle, &vmbsrc->frame_buffers[i], &vimbax_frame_callback);
-            if (VmbErrorSuccess != result)
-            {
-                break;
-            }
+            continue;
         }
-
-        if (VmbErrorSuccess == result)
+        g_value_set_static_string(&pixel_format, vmbsrc->camera.supported_formats[i]->gst_format_name);
+        // TODO: Should this perhaps be done via a flag in vimbax_gst_format_matches?
+        if (starts_with(vmbsrc->camera.supported_formats[i]->vimbax_format_name, "Bayer"))
         {
-            // Start Acquisition
-            GST_DEBUG_OBJECT(vmbsrc, "Running \"AcquisitionStart\" feature");
-            result = VmbFeatureCommandRun(vmbsrc->camera.handle, "AcquisitionStart");
-            VmbBool_t acquisition_start_done = VmbBoolFalse;
-            do
+            gst_value_list_append_value(&pixel_format_bayer_list, &pixel_format);
+            has_bayer_format |= bayer_pattern_from_vimbax_format(
+                                    vmbsrc->camera.supported_formats[i]->vimbax_format_name) != VIMBAX_BAYER_NONE;
+        }
+        else
+        {
+            gst_value_list_append_value(&pixel_format_raw_list, &pixel_format);
+        }
+    }
+    // Debayered formats come after the natively supported ones, which are preferred by fixation
+    if (vmbsrc->properties.debayer && has_bayer_format)
+    {
+        for (int i = 0; i < NUM_DEBAYER_OUTPUTS; i++)
+        {
+            const char *gst_format = debayer_output_gst_format((VimbaXDebayerOutput_t)i);
+            bool is_listed = false;
+            for (guint j = 0; j < gst_value_list_get_size(&pixel_format_raw_list); j++)
             {
-                if (VmbErrorSuccess != VmbFeatureCommandIsDone(vmbsrc->camera.handle,
-                                                               "AcquisitionStart",
-                                                               &acquisition_start_done))
-                {
-                    break;
-                }
-            } while (VmbBoolFalse == acquisition_start_done);
-            vmbsrc->camera.is_acquiring = true;
+                is_listed |= strcmp(g_value_get_string(gst_value_list_get_value(&pixel_format_raw_list, j)),
+                                    gst_format) == 0;
+            }
+            if (!is_listed)
+            {
+                g_value_set_static_string(&pixel_format, gst_format);
+                gst_value_list_append_value(&pixel_format_raw_list, &pixel_format);
+            }
         }
     }
-    return result;
+    gst_structure_set_value(raw_caps, "format", &pixel_format_raw_list);
+    gst_structure_set_value(bayer_caps, "format", &pixel_format_bayer_list);
+
+    g_value_unset(&width);
+    g_value_unset(&height);
+    g_value_unset(&pixel_format_raw_list);
+    g_value_unset(&pixel_format_bayer_list);
+    g_value_unset(&pixel_format);
+
+    return caps;
 }
 
 /**
- * @brief Runs the AcquisitionStop command feature, stops the capture engine and flushes the capture queue
+ * @brief Drops the cached caps so that they are queried from the camera again by the next get_caps call
  *
- * @param vmbsrc Provides the camera handle which is used for the VmbC function calls
- * @return VmbError_t Return status indicating errors if they occurred
+ * @param vmbsrc Holds the cached caps
  */
-VmbError_t stop_image_acquisition(GstVmbSrc *vmbsrc)
+void invalidate_cached_caps(GstVmbSrc *vmbsrc)
 {
-    // Stop Acquisition
-    GST_DEBUG_OBJECT(vmbsrc, "Running \"AcquisitionStop\" feature");
-    VmbError_t result = VmbFeatureCommandRun(vmbsrc->camera.handle, "AcquisitionStop");
-    VmbBool_t acquisition_stop_done = VmbBoolFalse;
-    do
-    {
-        if (VmbErrorSuccess != VmbFeatureCommandIsDone(vmbsrc->camera.handle,
-                                                       "AcquisitionStop",
-                                                       &acquisition_stop_done))
-        {
-            break;
-        }
-    } while (VmbBoolFalse == acquisition_stop_done);
-    vmbsrc->camera.is_acquiring = false;
-
-    // Stop Capture Engine
-    GST_DEBUG_OBJECT(vmbsrc, "Stopping the capture engine");
-    result = VmbCaptureEnd(vmbsrc->camera.handle);
-
-    // Flush the capture queue
-    GST_DEBUG_OBJECT(vmbsrc, "Flushing the capture queue");
-    VmbCaptureQueueFlush(vmbsrc->camera.handle);
-
-    return result;
+    GST_OBJECT_LOCK(vmbsrc);
+    gst_caps_replace(&vmbsrc->cached_caps, NULL);
+    vmbsrc->caps_generation++;
+    GST_OBJECT_UNLOCK(vmbsrc);
 }
 
-void VMB_CALL vimbax_frame_callback(const VmbHandle_t camera_handle, const VmbHandle_t stream_handle, VmbFrame_t *frame)
+/**
+ * @brief Called by VmbC when one of the features the caps are built from changed its value
+ *
+ * @param handle Handle of the module the feature belongs to
+ * @param name Name of the invalidated feature
+ * @param user_context The GstVmbSrc whose cached caps should be invalidated
+ */
+void VMB_CALL caps_feature_invalidated(const VmbHandle_t handle, const char *name, void *user_context)
 {
-    UNUSED(camera_handle); // enable compilation while treating warning of unused vairable as error
-    UNUSED(stream_handle);
-    GST_TRACE("Got Frame");
-    g_async_queue_push(frame->context[0], frame); // context[0] holds vmbsrc->filled_frame_queue
+    UNUSED(handle);
+    GstVmbSrc *vmbsrc = user_context;
+    GST_LOG_OBJECT(vmbsrc, "Feature \"%s\" was invalidated. Dropping cached caps", name);
+    invalidate_cached_caps(vmbsrc);
+}
 
-    // requeueing the frame is done after it was consumed in vmbsrc_create
+/**
+ * @brief Called by VmbC when one of the features latency queries depend on changed its value
+ *
+ * @param handle Handle of the module the feature belongs to
+ * @param name Name of the invalidated feature
+ * @param user_context The GstVmbSrc whose cached latency values should be dropped
+ */
+void VMB_CALL latency_feature_invalidated(const VmbHandle_t handle, const char *name, void *user_context)
+{
+    UNUSED(handle);
+    GstVmbSrc *vmbsrc = user_context;
+    GST_LOG_OBJECT(vmbsrc, "Feature \"%s\" was invalidated. Dropping cached latency values", name);
+    GST_OBJECT_LOCK(vmbsrc);
+    vmbsrc->is_latency_cached = false;
+    GST_OBJECT_UNLOCK(vmbsrc);
 }
 
 /**
@@ -2094,11 +8297,28 @@ void VMB_CALL vimbax_frame_callback(const VmbHandle_t camera_handle, const VmbHa
  * @param vmbsrc provides the camera handle and holds the generated mapping
  */
 void map_supported_pixel_formats(GstVmbSrc *vmbsrc)
+{
+    g_free((void *)vmbsrc->camera.supported_formats);
+    vmbsrc->camera.supported_formats = query_supported_formats(GST_OBJECT(vmbsrc),
+                                                               vmbsrc->camera.handle,
+                                                               &vmbsrc->camera.supported_formats_count);
+}
+
+/**
+ * @brief Get the VimbaX pixel formats a camera supports that have a compatible GStreamer format. Also used by the
+ * device provider, which opens cameras without an element
+ *
+ * @param owner Object the lookup is logged for
+ * @param camera_handle Handle of the opened camera
+ * @param count Set to the number of returned formats
+ * @return const VimbaXGstFormatMatch_t** The matching formats. Free with g_free
+ */
+const VimbaXGstFormatMatch_t **query_supported_formats(GstObject *owner, VmbHandle_t camera_handle, VmbUint32_t *count)
 {
     // get number of supported formats from the camera
-    VmbUint32_t camera_format_count;
+    VmbUint32_t camera_format_count = 0;
     VmbFeatureEnumRangeQuery(
-        vmbsrc->camera.handle,
+        camera_handle,
         "PixelFormat",
         NULL,
         0,
@@ -2107,42 +8327,262 @@ void map_supported_pixel_formats(GstVmbSrc *vmbsrc)
     // get the VimbaX format string supported by the camera
     const char **supported_formats = malloc(camera_format_count * sizeof(char *));
     VmbFeatureEnumRangeQuery(
-        vmbsrc->camera.handle,
+        camera_handle,
         "PixelFormat",
         supported_formats,
         camera_format_count,
         NULL);
 
-    GST_DEBUG_OBJECT(vmbsrc, "Camera returned %d supported formats", camera_format_count);
+    GST_DEBUG_OBJECT(owner, "Camera returned %d supported formats", camera_format_count);
+    // Allocated for the worst case that every reported format can be mapped and shrunk afterwards
+    const VimbaXGstFormatMatch_t **formats = g_new(const VimbaXGstFormatMatch_t *, camera_format_count);
+    *count = 0;
     VmbBool_t is_available;
     for (unsigned int i = 0; i < camera_format_count; i++)
     {
-        VmbFeatureEnumIsAvailable(vmbsrc->camera.handle, "PixelFormat", supported_formats[i], &is_available);
+        VmbFeatureEnumIsAvailable(camera_handle, "PixelFormat", supported_formats[i], &is_available);
         if (is_available)
         {
             const VimbaXGstFormatMatch_t *format_map = gst_format_from_vimbax_format(supported_formats[i]);
             if (format_map != NULL)
             {
-                GST_DEBUG_OBJECT(vmbsrc,
+                GST_DEBUG_OBJECT(owner,
                                  "VimbaX format \"%s\" corresponds to GStreamer format \"%s\"",
                                  supported_formats[i],
                                  format_map->gst_format_name);
-                vmbsrc->camera.supported_formats[vmbsrc->camera.supported_formats_count] = format_map;
-                vmbsrc->camera.supported_formats_count++;
+                formats[*count] = format_map;
+                (*count)++;
             }
             else
             {
-                GST_DEBUG_OBJECT(vmbsrc,
+                GST_DEBUG_OBJECT(owner,
                                  "No corresponding GStreamer format found for VimbaX format \"%s\"",
                                  supported_formats[i]);
             }
         }
         else
         {
-            GST_DEBUG_OBJECT(vmbsrc, "Reported format \"%s\" is not available", supported_formats[i]);
+            GST_DEBUG_OBJECT(owner, "Reported format \"%s\" is not available", supported_formats[i]);
         }
     }
     free((void *)supported_formats);
+    return g_renew(const VimbaXGstFormatMatch_t *, formats, *count);
+}
+
+/**
+ * @brief Builds the caps listed for a camera by the device provider. Unlike query_camera_caps they do not depend on the
+ * current camera settings, so width and height are ranges up to the maximum of the "Width" and "Height" features
+ *
+ * @param owner Object the lookup is logged for
+ * @param camera_handle Handle of the camera, which may be opened in read only mode
+ * @return GstCaps* The caps of all mapped formats of the camera
+ */
+GstCaps *query_device_caps(GstObject *owner, VmbHandle_t camera_handle)
+{
+    VmbInt64_t min, width_max = G_MAXINT, height_max = G_MAXINT;
+    VmbFeatureIntRangeQuery(camera_handle, "Width", &min, &width_max);
+    VmbFeatureIntRangeQuery(camera_handle, "Height", &min, &height_max);
+
+    VmbUint32_t count;
+    const VimbaXGstFormatMatch_t **formats = query_supported_formats(owner, camera_handle, &count);
+    GstCaps *caps = gst_caps_new_empty();
+    for (VmbUint32_t i = 0; i < count; i++)
+    {
+        // Packed and unpacked variants map to the same GStreamer format, which is merged into a single structure
+        GstStructure *structure = gst_structure_new(
+            starts_with(formats[i]->vimbax_format_name, "Bayer") ? "video/x-bayer" : "video/x-raw",
+            "format", G_TYPE_STRING, formats[i]->gst_format_name,
+            "width", GST_TYPE_INT_RANGE, 1, (gint)MIN(width_max, G_MAXINT),
+            "height", GST_TYPE_INT_RANGE, 1, (gint)MIN(height_max, G_MAXINT),
+            "framerate", GST_TYPE_FRACTION_RANGE, 0, 1, G_MAXINT, 1,
+            NULL);
+        caps = gst_caps_merge_structure(caps, structure);
+    }
+    g_free((void *)formats);
+    return caps;
+}
+
+/**
+ * @brief Starts the VimbaX API unless another element or the device provider already did. Every call must be matched
+ * by a call to release_vimbax_api
+ *
+ * @param owner Object the reference is taken for. Only used for logging
+ * @return VmbError_t Result of VmbStartup, or VmbErrorSuccess if the API was already started
+ */
+VmbError_t acquire_vimbax_api(GstObject *owner)
+{
+    VmbError_t result = VmbErrorSuccess;
+    G_LOCK(vmb_open_count);
+    if (0 == vmb_open_count++)
+    {
+        result = VmbStartup(NULL);
+        GST_DEBUG_OBJECT(owner, "VmbStartup returned: %s", ErrorCodeToMessage(result));
+        if (result != VmbErrorSuccess)
+        {
+            GST_ERROR_OBJECT(owner, "VimbaX initialization failed");
+        }
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(owner, "VmbStartup was already called. Current open count: %u", vmb_open_count);
+    }
+    G_UNLOCK(vmb_open_count);
+    return result;
+}
+
+/**
+ * @brief Drops a reference to the VimbaX API taken by acquire_vimbax_api and shuts the API down with the last one
+ *
+ * @param owner Object the reference was taken for. Only used for logging
+ */
+void release_vimbax_api(GstObject *owner)
+{
+    G_LOCK(vmb_open_count);
+    if (0 == --vmb_open_count)
+    {
+        VmbShutdown();
+        GST_INFO_OBJECT(owner, "VimbaX API was shut down");
+    }
+    else
+    {
+        GST_DEBUG_OBJECT(owner, "VmbShutdown not called. Current open count: %u", vmb_open_count);
+    }
+    G_UNLOCK(vmb_open_count);
+}
+
+/**
+ * @brief Selects the VimbaX pixel format requested from the camera for a GStreamer format. If the camera supports a
+ * packed variant (e.g. "Mono12p" for "Mono12") of the first matching format, the "packedformats" property decides which
+ * one is used. In auto mode the packed variant is chosen if it allows a higher frame rate, which means that the link
+ * bandwidth limits the frame rate of the unpacked format. If the camera supports no matching format and "debayer" is
+ * enabled, an 8 bit Bayer format is selected for debayered output formats. Must be called while acquisition is stopped
+ *
+ * @param vmbsrc Provides the camera handle and the supported formats
+ * @param gst_format Name of the negotiated GStreamer format
+ * @return const VimbaXGstFormatMatch_t* Selected format or NULL if the camera supports no matching format
+ */
+const VimbaXGstFormatMatch_t *select_vimbax_format(GstVmbSrc *vmbsrc, const char *gst_format)
+{
+    bool allow_packed = vmbsrc->properties.packed_formats != GST_VMBSRC_PACKED_FORMATS_NEVER;
+    const VimbaXGstFormatMatch_t *unpacked = NULL;
+    const VimbaXGstFormatMatch_t *packed = NULL;
+    for (unsigned int i = 0; i < vmbsrc->camera.supported_formats_count; i++)
+    {
+        const VimbaXGstFormatMatch_t *format = vmbsrc->camera.supported_formats[i];
+        if (strcmp(gst_format, format->gst_format_name) != 0)
+        {
+            continue;
+        }
+        if (format->packing == VIMBAX_PACKING_NONE)
+        {
+            if (unpacked == NULL)
+            {
+                unpacked = format;
+            }
+        }
+        else if (allow_packed && packed == NULL)
+        {
+            packed = format;
+        }
+    }
+    VimbaXDebayerOutput_t debayer_output;
+    if (unpacked == NULL && packed == NULL && vmbsrc->properties.debayer &&
+        debayer_output_from_gst_format(gst_format, &debayer_output))
+    {
+        for (unsigned int i = 0; i < vmbsrc->camera.supported_formats_count; i++)
+        {
+            if (bayer_pattern_from_vimbax_format(vmbsrc->camera.supported_formats[i]->vimbax_format_name) !=
+                VIMBAX_BAYER_NONE)
+            {
+                return vmbsrc->camera.supported_formats[i];
+            }
+        }
+    }
+    if (unpacked == NULL || packed == NULL)
+    {
+        return unpacked != NULL ? unpacked : packed;
+    }
+
+    // Only the packed variant of the same bit depth is a replacement for the unpacked format
+    gchar *packed_name = g_strconcat(unpacked->vimbax_format_name, "p", NULL);
+    packed = NULL;
+    for (unsigned int i = 0; i < vmbsrc->camera.supported_formats_count; i++)
+    {
+        if (strcmp(packed_name, vmbsrc->camera.supported_formats[i]->vimbax_format_name) == 0)
+        {
+            packed = vmbsrc->camera.supported_formats[i];
+            break;
+        }
+    }
+    g_free(packed_name);
+    if (packed == NULL)
+    {
+        return unpacked;
+    }
+    if (vmbsrc->properties.packed_formats == GST_VMBSRC_PACKED_FORMATS_ALWAYS)
+    {
+        return packed;
+    }
+
+    // Both formats are tried on the camera, so the current format is restored afterwards
+    const char *current_format = NULL;
+    if (VmbFeatureEnumGet(vmbsrc->camera.handle, "PixelFormat", &current_format) != VmbErrorSuccess)
+    {
+        current_format = NULL;
+    }
+    double unpacked_frame_rate = get_max_frame_rate(vmbsrc, unpacked->vimbax_format_name);
+    double packed_frame_rate = get_max_frame_rate(vmbsrc, packed->vimbax_format_name);
+    if (current_format != NULL &&
+        VmbFeatureEnumSet(vmbsrc->camera.handle, "PixelFormat", current_format) != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(vmbsrc, "Could not restore \"PixelFormat\" to \"%s\"", current_format);
+    }
+    GST_DEBUG_OBJECT(vmbsrc,
+                     "Maximum frame rate is %f with \"%s\" and %f with \"%s\"",
+                     unpacked_frame_rate,
+                     unpacked->vimbax_format_name,
+                     packed_frame_rate,
+                     packed->vimbax_format_name);
+    // Small differences may come from rounding of the camera and do not justify the cost of unpacking
+    if (packed_frame_rate > unpacked_frame_rate * 1.01)
+    {
+        GST_INFO_OBJECT(vmbsrc,
+                        "Using packed format \"%s\" because the link bandwidth limits the frame rate of \"%s\"",
+                        packed->vimbax_format_name,
+                        unpacked->vimbax_format_name);
+        return packed;
+    }
+    return unpacked;
+}
+
+/**
+ * @brief Sets the pixel format on the camera and reads the highest frame rate possible with it
+ *
+ * @param vmbsrc Provides the camera handle
+ * @param vimbax_format Pixel format to check
+ * @return double Maximum of "AcquisitionFrameRate" or 0 if it could not be read
+ */
+double get_max_frame_rate(GstVmbSrc *vmbsrc, const char *vimbax_format)
+{
+    double min_frame_rate = 0;
+    double max_frame_rate = 0;
+    VmbError_t result = VmbFeatureEnumSet(vmbsrc->camera.handle, "PixelFormat", vimbax_format);
+    if (result == VmbErrorSuccess)
+    {
+        result = VmbFeatureFloatRangeQuery(vmbsrc->camera.handle,
+                                           "AcquisitionFrameRate",
+                                           &min_frame_rate,
+                                           &max_frame_rate);
+    }
+    if (result != VmbErrorSuccess)
+    {
+        GST_DEBUG_OBJECT(vmbsrc,
+                         "Could not read maximum frame rate for \"%s\". Got error code: %s",
+                         vimbax_format,
+                         ErrorCodeToMessage(result));
+        return 0;
+    }
+    return max_frame_rate;
 }
 
 void log_available_enum_entries(GstVmbSrc *vmbsrc, const char *feat_name)
@@ -20,6 +20,14 @@
 #define _GST_vmbsrc_H_
 
 #include "pixelformats.h"
+#include "vmbframemeta.h"
+#include "vmbroipad.h"
+#include "vmbstreampad.h"
+#include "vmbdeviceprovider.h"
+#include "debayer.h"
+#include "raw_recorder.h"
+#include "pinned_memory.h"
+#include "settings_file.h"
 
 #include <gst/base/gstpushsrc.h>
 #include <gst/video/video.h>
@@ -142,13 +150,217 @@ typedef enum
 typedef enum
 {
     GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_FRAME,
-    GST_VMBSRC_ALLOCATION_MODE_ALLOC_AND_ANNOUNCE_FRAME
+    GST_VMBSRC_ALLOCATION_MODE_ALLOC_AND_ANNOUNCE_FRAME,
+    GST_VMBSRC_ALLOCATION_MODE_ANNOUNCE_POOL_BUFFERS
 } GstVimbasrcAllocationMode;
 
+// Ways in which the image data of received frames is passed to downstream elements
+typedef enum
+{
+    GST_VMBSRC_OUTPUT_MODE_COPY,
+    GST_VMBSRC_OUTPUT_MODE_ZERO_COPY
+} GstVmbSrcOutputMode;
+
+// Sources for the presentation timestamps of output buffers
+typedef enum
+{
+    GST_VMBSRC_TIMESTAMP_MODE_PIPELINE_CLOCK,
+    GST_VMBSRC_TIMESTAMP_MODE_CAMERA
+} GstVmbSrcTimestampMode;
+
+// Use of packed pixel formats (e.g. Mono12p) if the camera offers them in addition to the unpacked variant
+typedef enum
+{
+    GST_VMBSRC_PACKED_FORMATS_AUTO,
+    GST_VMBSRC_PACKED_FORMATS_NEVER,
+    GST_VMBSRC_PACKED_FORMATS_ALWAYS
+} GstVmbSrcPackedFormatsMode;
+
+// Order in which filled frames are delivered if downstream is slower than the camera
+typedef enum
+{
+    GST_VMBSRC_DELIVERY_MODE_FIFO,
+    GST_VMBSRC_DELIVERY_MODE_LATEST,
+    GST_VMBSRC_DELIVERY_MODE_BOUNDED_LATENCY
+} GstVmbSrcDeliveryMode;
+
+// Camera events forwarded downstream and emitted as "camera-event" signal. The nicks of GST_FLAGS_CAMERAEVENTS_VALUES
+// are the EventSelector entries of the events
+typedef enum
+{
+    GST_VMBSRC_CAMERA_EVENT_EXPOSURE_END = 1 << 0,
+    GST_VMBSRC_CAMERA_EVENT_FRAME_TRIGGER_READY = 1 << 1
+} GstVmbSrcCameraEventFlags;
+
+// Camera features written from element properties. Properties changed while the camera is acquiring are tracked with
+// these flags until they are written
+typedef enum
+{
+    GST_VMBSRC_FEATURE_EXPOSURETIME = 1 << 0,
+    GST_VMBSRC_FEATURE_EXPOSUREAUTO = 1 << 1,
+    GST_VMBSRC_FEATURE_BALANCEWHITEAUTO = 1 << 2,
+    GST_VMBSRC_FEATURE_GAIN = 1 << 3,
+    // TriggerSelector, TriggerActivation, TriggerSource and TriggerMode. Always written together and in that order
+    GST_VMBSRC_FEATURE_TRIGGER = 1 << 4,
+    // AcquisitionFrameRateEnable and AcquisitionFrameRate, written from "maxframerate"
+    GST_VMBSRC_FEATURE_FRAMERATE = 1 << 5
+} GstVmbSrcFeatureFlags;
+
 typedef struct _GstVmbSrc GstVmbSrc;
 typedef struct _GstVmbSrcClass GstVmbSrcClass;
 
-#define NUM_FRAME_BUFFERS 3
+// vmbsrc elements sharing the same "group" property. Their cameras are opened concurrently and triggered together via
+// action commands. Members, num_acquiring and the action thread state are protected by the global group lock
+typedef struct
+{
+    gchar *name;
+    // Member elements (GstVmbSrc*, not referenced). Elements remove themselves before they are finalized
+    GPtrArray *members;
+    // Held while the cameras of all members are opened so that only the first started member opens them
+    GMutex open_lock;
+    // Number of members whose acquisition is running
+    guint num_acquiring;
+    // Fires action commands at "actioncommandrate" while all members are acquiring
+    GThread *action_thread;
+    bool stop_action_thread;
+    // Member whose settings and camera the action thread uses while it sends a command without holding the group lock.
+    // It does not leave the group before the command was sent
+    GstVmbSrc *commanding_member;
+    // Signalled when num_acquiring or the members change, when a command was sent and when the action thread should
+    // stop
+    GCond cond;
+} GstVmbSrcGroup;
+
+// State of a camera that is kept across element instances in the same process, so that pipelines which are recreated
+// do not repeat slow initialization steps. Sessions are keyed by camera ID and never freed
+typedef struct
+{
+    // Handle of the camera if it was kept open by an element with "keepopen" enabled and is not used by another element
+    VmbHandle_t handle;
+    // Camera info of handle
+    VmbCameraInfo_t info;
+    // Packet size determined by "GVSPAdjustPacketSize". 0 if it was not determined yet or the camera is no GigE camera
+    VmbInt64_t packet_size;
+    // Copy of the format table determined by map_supported_pixel_formats
+    const VimbaXGstFormatMatch_t **supported_formats;
+    VmbUint32_t supported_formats_count;
+    bool has_supported_formats;
+    // SHA-256 of the settings file that was last applied completely to the open camera, followed by the action, chunk
+    // and event settings written after it (see apply_settings_file). Cleared when feature values are written from
+    // element properties or the camera is closed. NULL if unknown
+    gchar *applied_settings_checksum;
+} GstVmbSrcSession;
+
+// Bookkeeping for a single frame announced to VmbC. frame.context[1] points back to the containing GstVmbSrcFrame
+typedef struct
+{
+    VmbFrame_t frame;
+    GstVmbSrc *vmbsrc;
+    // frame.buffer was allocated by the element (AnnounceFrame allocation mode) and must be freed by it
+    bool owns_buffer;
+    // frame.buffer was page-locked with pin_memory and must be unpinned before it is freed
+    bool is_pinned;
+    // Buffer of the negotiated buffer pool backing frame.buffer (AnnouncePoolBuffers allocation mode). It stays mapped
+    // while the frame is announced
+    GstBuffer *pool_buffer;
+    GstMapInfo pool_buffer_map;
+    // The image data is currently wrapped in a GstBuffer held by downstream elements (zero-copy output)
+    bool is_in_use;
+    // The frame buffers were released while the frame was still in use. It is freed once downstream releases it.
+    // Frames whose buffer the transport layer allocated are only revoked then, as revoking them frees the buffer
+    bool is_orphaned;
+    // Monotonic time (in microseconds) at which vimbax_frame_callback received the frame
+    gint64 receive_time;
+    // ID of the software trigger the frame was captured for. 0 if it was not captured for one
+    guint64 trigger_id;
+} GstVmbSrcFrame;
+
+// Row band of a debayered frame converted by a worker thread of the debayer pool
+typedef struct
+{
+    VimbaXDebayerFunction_t function;
+    const guint8 *src;
+    guint width;
+    guint height;
+    VimbaXBayerPattern_t pattern;
+    guint8 *dest;
+    gsize dest_stride;
+    VimbaXDebayerOutput_t output;
+    guint first_row;
+    guint num_rows;
+} GstVmbSrcDebayerBand;
+
+#define DEFAULT_NUM_FRAME_BUFFERS 3
+#define MAX_NUM_FRAME_BUFFERS 1024
+// Default upper limit (in MiB) for the memory the adaptive mode may use for frame buffers
+#define DEFAULT_MAX_FRAME_BUFFER_MEMORY 512
+// Number of frame buffers that always remain available to the capture engine in zero-copy output mode. If handing out
+// another frame would undercut this, the frame data is copied instead
+#define MIN_AVAILABLE_FRAME_BUFFERS 1
+// Default keys and mask of the action commands used to trigger the cameras of a group
+#define DEFAULT_ACTION_DEVICE_KEY 1
+#define DEFAULT_ACTION_GROUP_KEY 1
+#define DEFAULT_ACTION_GROUP_MASK 1
+// Time (in milliseconds) to wait for command features like "AcquisitionStart" or "GVSPAdjustPacketSize" to complete
+#define FEATURE_COMMAND_TIMEOUT 5000
+// Number of times the features of a settings file are written if some of them could not be written yet, e.g. because
+// they depend on features that come later in the file
+#define MAX_SETTINGS_FILE_PASSES 5
+// Number of threads (including the streaming thread) converting Bayer image data if "debayerthreads" is 0, and the
+// maximum that can be configured
+#define DEFAULT_DEBAYER_THREADS 4
+#define MAX_DEBAYER_THREADS 32
+// Maximum number of frames pushed together as a buffer list
+#define MAX_BATCH_SIZE 1024
+// Row bands of debayered frames are not made smaller than this to keep the handoff to the worker threads worthwhile
+#define MIN_DEBAYER_BAND_ROWS 64
+// Time (in microseconds) to wait for downstream elements to release frames before they are revoked
+#define FRAME_RELEASE_TIMEOUT (2 * G_TIME_SPAN_SECOND)
+
+// Time after which the mapping of device timestamps to the pipeline clock is recalibrated in camera timestamp mode
+#define TIMESTAMP_CALIBRATION_INTERVAL GST_SECOND
+// Number of most recent latched timestamps the mapping of device timestamps to the pipeline clock is calculated from
+#define NUM_TIMESTAMP_CALIBRATION_SAMPLES 32
+// Weight (1/n) of a new measurement in the running average of the delay between frame callback and push
+#define PUSH_DELAY_AVERAGE_WEIGHT 16
+// Change of the measured push delay after which a new latency message is posted
+#define PUSH_DELAY_UPDATE_THRESHOLD GST_MSECOND
+// Minimum time (in microseconds) between two latency messages posted because the push delay changed
+#define LATENCY_MESSAGE_INTERVAL G_TIME_SPAN_SECOND
+// Number of buckets in the histogram of push delays. Bucket i counts delays below 2^(i+1) microseconds
+#define NUM_PUSH_DELAY_HISTOGRAM_BUCKETS 32
+// Fixed point scale of the running average of the filled frame queue depth
+#define QUEUE_DEPTH_AVERAGE_SCALE 256
+// Number of most recent ExposureEnd events kept to match them with the frames they belong to
+#define NUM_EXPOSURE_END_EVENTS 64
+
+// Frame ID reported by an ExposureEnd event and the monotonic time (in microseconds) at which the event arrived
+typedef struct
+{
+    guint64 frame_id;
+    gint64 arrival_time;
+} GstVmbSrcExposureEnd;
+
+// Mapping of device timestamps (converted to nanoseconds) to the pipeline clock. Suitable for
+// gst_clock_adjust_with_calibration
+typedef struct
+{
+    // Frequency of the device timestamp ticks in Hz. 0 if the camera does not report it
+    VmbUint64_t tick_frequency;
+    // Samples and last_calibration are only accessed by calibration_thread. clock, is_calibrated and the mapping after
+    // last_calibration are written by it under the object lock and read by the streaming thread
+    // Clock the samples were taken with. The calibration is reset if the pipeline clock changes
+    GstClock *clock;
+    // Pairs of device time and pipeline clock time as expected by gst_calculate_linear_regression
+    GstClockTime samples[2 * NUM_TIMESTAMP_CALIBRATION_SAMPLES];
+    guint num_samples;
+    GstClockTime last_calibration;
+    GstClockTime internal;
+    GstClockTime external;
+    GstClockTime rate_num;
+    GstClockTime rate_denom;
+    bool is_calibrated;
+} GstVmbSrcTimestampCalibration;
 
 struct _GstVmbSrc
 {
@@ -160,9 +372,9 @@ struct _GstVmbSrc
         VmbHandle_t handle;
         VmbCameraInfo_t info;
         VmbUint32_t supported_formats_count;
-        // TODO: This overallocates since no camera will actually support all possible format matches. Allocate and fill
-        // at runtime?
-        const VimbaXGstFormatMatch_t *supported_formats[NUM_FORMAT_MATCHES];
+        // Formats supported by the camera that have a matching GStreamer format (supported_formats_count entries)
+        const VimbaXGstFormatMatch_t **supported_formats;
+        // Set under the object lock once the camera state above was written. Read with is_camera_connected
         bool is_connected;
         bool is_acquiring;
     } camera;
@@ -183,19 +395,207 @@ struct _GstVmbSrc
         int triggeractivation;
         int incomplete_frame_handling;
         int allocation_mode;
+        int output_mode;
+        int timestamp_mode;
+        guint stats_interval;
+        guint num_frame_buffers;
+        gboolean adaptive_frame_buffers;
+        guint max_frame_buffer_memory;
+        int packed_formats;
+        char *group;
+        guint action_device_key;
+        guint action_group_key;
+        guint action_group_mask;
+        double action_command_rate;
+        guint action_schedule_delay;
+        guint chunk_mode;
+        int delivery_mode;
+        guint max_frame_age;
+        gboolean keep_open;
+        char *cpu_affinity;
+        guint thread_priority;
+        guint spin_wait;
+        gboolean debayer;
+        guint debayer_threads;
+        guint batch_size;
+        char *record_location;
+        guint record_frames;
+        gboolean pinned_memory;
+        guint camera_events;
+        guint frame_skip;
+        gdouble max_framerate;
+        guint binning;
+        guint decimation;
     } properties;
 
-    VmbFrame_t frame_buffers[NUM_FRAME_BUFFERS];
+    // Announced frames (GstVmbSrcFrame*). May grow while acquiring if adaptive_frame_buffers is enabled
+    GPtrArray *frame_buffers;
+    // Number of frames currently held downstream (not counting orphaned frames)
+    guint num_frames_in_use;
+    // Number of frames currently queued in the capture engine (updated atomically)
+    gint num_frames_queued;
+    // Set by vimbax_frame_callback when the capture engine ran out of queued frames (updated atomically)
+    gint frame_starvation;
+    // Cleared if announcing additional frames failed or the memory limit was reached
+    bool can_grow_frame_buffers;
+    // Protects frame_buffers, the per frame bookkeeping and camera.is_acquiring against concurrent release of wrapped
+    // frames
+    GMutex frame_lock;
+    // Signalled every time a wrapped frame is released by downstream elements
+    GCond frame_released;
     // queue in which filled VimbaX frames are placed in the vimbax_frame_callback (attached to each queued frame at
     // frame->context[0])
     GAsyncQueue *filled_frame_queue;
+    // Set while GstBaseSrc requested to unlock a blocking create call (updated atomically)
+    gint is_unlocked;
+    // Features (GstVmbSrcFeatureFlags) that were changed while acquiring but are not writable during acquisition. They
+    // are written together by the next create call, which restarts the acquisition once for all of them. Protected by
+    // the object lock
+    guint pending_features;
+    // Features parsed from the settings file (VimbaXSettingsFeature) and the SHA-256 of the file content they were
+    // parsed from. The file is only parsed again if its content changed
+    GArray *settings_features;
+    gchar *settings_checksum;
+    // Streaming thread to which "cpuaffinity" and "threadpriority" were applied. Cleared when either property changes
+    // so that create applies them again. Protected by the object lock
+    GThread *tuned_thread;
+    // Writes filled frames to "recordlocation" instead of pushing them downstream. NULL if not recording. While
+    // recording, record_queue replaces filled_frame_queue as queue the frame callback adds filled frames to
+    VimbaXRawRecorder_t *recorder;
+    GAsyncQueue *record_queue;
+    GThread *record_thread;
+    guint num_frames_recorded;
+    // Returned by create once recording finished. Set by record_thread before it pushes record_finished_sentinel_frame
+    GstFlowReturn record_result;
+    // Set by record_thread once it processed record_flush_sentinel_frame. Protected by record_lock
+    bool is_record_queue_flushed;
+    GMutex record_lock;
+    GCond record_queue_flushed;
     guint64 num_frames_pushed;
+    GstVmbSrcTimestampCalibration timestamp_calibration;
+    // Reference caps of the GstReferenceTimestampMeta carrying the raw device timestamp
+    GstCaps *device_timestamp_caps;
+    // Running average and maximum of the time between vimbax_frame_callback and the end of the create call. Protected
+    // by the object lock
+    GstClockTime push_delay_average;
+    GstClockTime push_delay_max;
+    // push_delay_average at the time the last latency message was posted
+    GstClockTime reported_push_delay;
+    // Monotonic time (in microseconds) at which the last latency message was posted. Protected by the object lock
+    gint64 latency_message_time;
+    // Camera values latency queries are answered from. Read from the camera again by the next query after one of the
+    // latency features changed. Protected by the object lock
+    bool is_latency_cached;
+    GstClockTime cached_exposure_duration;
+    GstClockTime cached_frame_interval;
+    // Camera events (GstVmbSrcCameraEventFlags) whose notification was enabled by start. Disabled again by stop
+    guint enabled_camera_events;
+    // Ring buffer of the most recent ExposureEnd events. Protected by exposure_end_lock
+    GstVmbSrcExposureEnd exposure_ends[NUM_EXPOSURE_END_EVENTS];
+    guint num_exposure_ends;
+    GMutex exposure_end_lock;
+    // Running average and maximum of the time between the ExposureEnd event of a frame and its vimbax_frame_callback.
+    // Protected by the object lock
+    GstClockTime exposure_end_delay_average;
+    GstClockTime exposure_end_delay_max;
+    // Software triggers sent by the "trigger" action signal since start and the number of them that were assigned to
+    // received frames. Triggered frames arrive in the order of their triggers. Only counted while is_software_triggered
+    // is set by apply_trigger_settings for TriggerSource Software and TriggerMode On. Protected by the object lock
+    gboolean is_software_triggered;
+    guint64 num_software_triggers;
+    guint64 num_triggered_frames;
+    // Frame ID of the last frame received while software triggered, to skip the triggers of frames lost on the way
+    guint64 last_triggered_frame_id;
+    // Serializes software triggers so that their IDs are handed out in the order they are sent
+    GMutex trigger_lock;
+    // Serializes latching the device timestamp between the timestamp calibration of the streaming thread and the
+    // scheduling of action commands by the group action thread
+    GMutex timestamp_latch_lock;
+    // Set if the camera itself runs at most at "maxframerate". Otherwise vimbax_frame_callback drops frames exceeding
+    // it. Updated atomically
+    gint is_framerate_limited_by_camera;
+    // Frames vimbax_frame_callback still drops because of "frameskip" and the earliest monotonic time (in microseconds)
+    // at which it passes on the next frame because of "maxframerate". Only accessed by the frame callback and start
+    guint frames_until_push;
+    gint64 next_push_time;
+    // Capture statistics reported via the "stats" property. All members are updated atomically
+    struct
+    {
+        gint frames_received;
+        gint frames_incomplete;
+        gint frames_dropped;
+        // Filled frames that were requeued without being pushed because of the delivery mode
+        gint frames_skipped;
+        // Frames requeued by vimbax_frame_callback because of "frameskip" or "maxframerate"
+        gint frames_rate_limited;
+        gint requeue_failures;
+        gint queue_depth_max;
+        // Scaled by QUEUE_DEPTH_AVERAGE_SCALE
+        gint queue_depth_average;
+        gint push_delay_histogram[NUM_PUSH_DELAY_HISTOGRAM_BUCKETS];
+    } stats;
+    // Monotonic time (in microseconds) at which the last statistics message was posted
+    gint64 last_stats_post;
+    // Posts the statistics messages every "statsinterval" milliseconds while the element is started, so that reading
+    // the Stat* features of the camera does not delay the streaming thread. stats_cond is signalled when the interval
+    // changes or the thread should stop. Protected by stats_lock
+    GThread *stats_thread;
+    bool is_stats_thread_stopping;
+    GMutex stats_lock;
+    GCond stats_cond;
+    // Recalibrates timestamp_calibration while the element is started in camera timestamp mode, so that latching the
+    // device timestamp does not delay the streaming thread. calibration_cond is signalled by the streaming thread if the
+    // mapping does not match the pipeline clock and when the thread should stop. Protected by calibration_lock
+    GThread *calibration_thread;
+    bool is_calibration_thread_stopping;
+    GMutex calibration_lock;
+    GCond calibration_cond;
     GstVideoInfo video_info;
+    // Bytes the camera appends to every row of image data ("PaddingX"). Read when caps are set
+    guint line_padding;
+    // Downstream reads the layout of buffers from GstVideoMeta, so buffers can keep the row padding and data offset of
+    // the camera. Set when allocation is decided
+    bool is_video_meta_supported;
+    // Caps the camera is currently acquiring images for. Set by set_caps, or by create in the AnnouncePoolBuffers
+    // allocation mode, when acquisition was started
+    GstCaps *acquiring_caps;
+    // Caps reported by get_caps for the current camera settings. NULL if they must be queried from the camera again.
+    // Protected by the object lock
+    GstCaps *cached_caps;
+    // Incremented every time cached_caps is invalidated. Protected by the object lock
+    guint caps_generation;
+    // Unpacks the image data of the selected packed pixel format while copying. NULL for unpacked formats
+    VimbaXUnpackFunction_t unpack_function;
+    VimbaXPacking_t packing;
+    // Converts the image data of the selected Bayer format while copying. NULL if the negotiated format is passed on
+    // without debayering
+    VimbaXDebayerFunction_t debayer_function;
+    VimbaXBayerPattern_t bayer_pattern;
+    VimbaXDebayerOutput_t debayer_output;
+    // Number of row bands each debayered frame is split into. All but the first are converted by debayer_pool
+    guint num_debayer_bands;
+    GThreadPool *debayer_pool;
+    // Bands of the current frame that were not converted yet by the pool. Protected by debayer_lock
+    guint debayer_bands_pending;
+    GMutex debayer_lock;
+    GCond debayer_done;
+    // Group this element is a member of. NULL if the "group" property is empty
+    GstVmbSrcGroup *group;
+    // Frame ID of the first frame received after start. Buffer offsets of group members count frames from it
+    VmbUint64_t first_frame_id;
+    bool has_first_frame_id;
+    // Index used in the name of the next requested ROI pad. Protected by the object lock
+    guint next_roi_pad_index;
+    // Stream index used for the next stream pad requested without a name. Protected by the object lock
+    guint next_stream_pad_index;
 };
 
 struct _GstVmbSrcClass
 {
     GstPushSrcClass base_vmbsrc_class;
+
+    // action signals
+    gboolean (*trigger)(GstVmbSrc *vmbsrc, guint64 *trigger_id);
 };
 
 GType gst_vmbsrc_get_type(void);
@@ -203,15 +603,124 @@ GType gst_vmbsrc_get_type(void);
 G_END_DECLS
 
 VmbError_t open_camera_connection(GstVmbSrc *vmbsrc);
+bool is_camera_connected(GstVmbSrc *vmbsrc);
+GstVmbSrcSession *get_session(const char *camera_id);
+void adjust_packet_size(GstVmbSrc *vmbsrc, GstVmbSrcSession *session);
+bool keep_camera_open(GstVmbSrc *vmbsrc);
+gpointer open_camera_connection_thread(gpointer data);
+void join_group(GstVmbSrc *vmbsrc, const char *name);
+void leave_group(GstVmbSrc *vmbsrc);
+VmbError_t open_group_cameras(GstVmbSrc *vmbsrc);
+VmbError_t apply_action_settings(GstVmbSrc *vmbsrc);
+void update_group_acquisition(GstVmbSrc *vmbsrc, bool is_acquiring);
+gpointer group_action_thread(gpointer data);
+VmbError_t run_action_command(GstVmbSrc *vmbsrc);
+gboolean software_trigger(GstVmbSrc *vmbsrc, guint64 *trigger_id);
+VmbError_t apply_chunk_settings(GstVmbSrc *vmbsrc);
+VmbError_t VMB_CALL read_chunk_values(VmbHandle_t featureAccessHandle, void *userContext);
+VmbError_t apply_camera_event_settings(GstVmbSrc *vmbsrc);
+void disable_camera_events(GstVmbSrc *vmbsrc);
+void VMB_CALL camera_event_invalidated(const VmbHandle_t handle, const char *name, void *user_context);
+void update_exposure_end_delay(GstVmbSrc *vmbsrc, guint64 frame_id, gint64 receive_time);
+VmbError_t apply_settings_file(GstVmbSrc *vmbsrc);
+VmbError_t write_settings_features(GstVmbSrc *vmbsrc, GArray *features);
+gchar *read_feature_value(VmbHandle_t handle, const char *name, VmbFeatureDataType_t type);
+VmbError_t load_settings_file(GstVmbSrc *vmbsrc);
+void forget_applied_settings(GstVmbSrc *vmbsrc);
 VmbError_t apply_feature_settings(GstVmbSrc *vmbsrc);
+VmbError_t apply_features(GstVmbSrc *vmbsrc, guint features);
+bool are_features_writable(GstVmbSrc *vmbsrc, guint features);
+bool limit_acquisition_framerate(GstVmbSrc *vmbsrc, double framerate);
+VmbError_t apply_binning_settings(GstVmbSrc *vmbsrc);
+bool is_frame_rate_limited(GstVmbSrc *vmbsrc, gint64 receive_time);
+bool get_output_framerate(GstVmbSrc *vmbsrc,
+                          gint *framerate_num,
+                          gint *framerate_denom,
+                          gint *max_framerate_num,
+                          gint *max_framerate_denom);
+void update_feature(GstVmbSrc *vmbsrc, GstVmbSrcFeatureFlags feature);
+VmbError_t apply_pending_features(GstVmbSrc *vmbsrc);
 VmbError_t set_roi(GstVmbSrc *vmbsrc);
 VmbError_t apply_trigger_settings(GstVmbSrc *vmbsrc);
+bool start_recording(GstVmbSrc *vmbsrc);
+void stop_recording(GstVmbSrc *vmbsrc);
+void flush_record_queue(GstVmbSrc *vmbsrc);
+gpointer record_thread(gpointer data);
+int record_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame);
+GList *get_roi_pads(GstVmbSrc *vmbsrc);
+void reset_roi_pads(GstVmbSrc *vmbsrc);
+bool is_roi_format_supported(const GstVideoInfo *info);
+bool prepare_roi_pad(GstVmbSrc *vmbsrc, GstVmbRoiPad *pad);
+GstBuffer *create_roi_buffer(GstVmbSrc *vmbsrc, GstVmbRoiPad *pad, GstBuffer *buffer);
+void push_roi_buffers(GstVmbSrc *vmbsrc, GstBuffer *buffer);
+void push_request_pad_event(GstVmbSrc *vmbsrc, GstEvent *event);
+GList *get_stream_pads(GstVmbSrc *vmbsrc);
+void prepare_stream_pads(GstVmbSrc *vmbsrc);
+bool prepare_stream_pad(GstVmbSrc *vmbsrc, GstVmbStreamPad *pad);
+void release_stream_pads(GstVmbSrc *vmbsrc);
+void release_stream_pad(GstVmbStreamPad *pad);
+void start_stream_capture(GstVmbSrc *vmbsrc);
+void start_stream_pad_capture(GstVmbSrc *vmbsrc, GstVmbStreamPad *pad);
+void stop_stream_capture(GstVmbSrc *vmbsrc);
+void VMB_CALL stream_frame_callback(const VmbHandle_t camera_handle, const VmbHandle_t stream_handle, VmbFrame_t *frame);
+void stream_pad_loop(gpointer user_data);
+GstCaps *create_stream_caps(GstVmbSrc *vmbsrc, const VmbFrame_t *frame);
+GstBuffer *copy_stream_frame(GstVmbSrc *vmbsrc, GstVmbStreamPad *pad, const VmbFrame_t *frame);
+bool load_pinned_memory_support(GstVmbSrc *vmbsrc);
+void pin_frame_buffer(GstVmbSrc *vmbsrc, GstVmbSrcFrame *vmb_frame, gsize size);
 VmbError_t alloc_and_announce_buffers(GstVmbSrc *vmbsrc);
+VmbUint32_t get_max_payload_size(GstVmbSrc *vmbsrc);
+VmbError_t announce_frame(GstVmbSrc *vmbsrc, VmbUint32_t payload_size);
+VmbInt64_t get_buffer_alignment(GstVmbSrc *vmbsrc);
+void free_frame(GstVmbSrcFrame *vmb_frame);
+VmbError_t grow_frame_buffers(GstVmbSrc *vmbsrc);
 void revoke_and_free_buffers(GstVmbSrc *vmbsrc);
+VmbError_t queue_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame);
+void skip_stale_frames(GstVmbSrc *vmbsrc, gint64 now);
+void tune_streaming_thread(GstVmbSrc *vmbsrc);
+VmbFrame_t *pop_filled_frame(GstVmbSrc *vmbsrc);
+bool is_frame_stale(GstVmbSrc *vmbsrc, gint64 receive_time, gint64 now);
+VmbError_t latch_device_timestamp(GstVmbSrc *vmbsrc, VmbInt64_t *ticks);
+void calibrate_device_timestamps(GstVmbSrc *vmbsrc, GstClock *clock);
+void start_calibration_thread(GstVmbSrc *vmbsrc);
+void stop_calibration_thread(GstVmbSrc *vmbsrc);
+gpointer calibration_thread(gpointer data);
+GstClockTime get_frame_interval(GstVmbSrc *vmbsrc);
+GstClockTime get_exposure_duration(GstVmbSrc *vmbsrc);
+void update_push_delay(GstVmbSrc *vmbsrc, gint64 receive_time);
+GstClockTime push_delay_percentile(const guint *histogram, guint64 total, double fraction);
+GstStructure *get_stats(GstVmbSrc *vmbsrc);
+void add_stat_features(GstStructure *stats, VmbHandle_t handle);
+void update_queue_depth_stats(GstVmbSrc *vmbsrc);
+void post_stats_message(GstVmbSrc *vmbsrc);
+void start_stats_thread(GstVmbSrc *vmbsrc);
+void stop_stats_thread(GstVmbSrc *vmbsrc);
+gpointer stats_thread(gpointer data);
 VmbError_t start_image_acquisition(GstVmbSrc *vmbsrc);
 VmbError_t stop_image_acquisition(GstVmbSrc *vmbsrc);
+void drain_filled_frame_queue(GstVmbSrc *vmbsrc);
 void VMB_CALL vimbax_frame_callback(const VmbHandle_t cameraHandle, const VmbHandle_t stream_handle, VmbFrame_t *pFrame);
+guint64 assign_trigger_id(GstVmbSrc *vmbsrc, const VmbFrame_t *frame);
+GstBuffer *wrap_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame);
+GstFlowReturn take_filled_frame(GstVmbSrc *vmbsrc, bool wait, VmbFrame_t **filled_frame);
+GstBuffer *create_output_buffer(GstVmbSrc *vmbsrc, VmbFrame_t *frame);
+void get_frame_layout(GstVmbSrc *vmbsrc, const VmbFrame_t *frame, gsize *offset, gint *stride);
+bool is_default_layout(const GstVideoInfo *info, const gsize *offset, const gint *stride);
+GstBuffer *copy_frame(GstVmbSrc *vmbsrc, VmbFrame_t *frame, const gsize *offset, const gint *stride);
+void setup_debayering(GstVmbSrc *vmbsrc, const VimbaXGstFormatMatch_t *format_match, const char *gst_format);
+void debayer_frame(GstVmbSrc *vmbsrc, const guint8 *src, guint height, guint8 *dest, gsize dest_stride);
+void debayer_band(const GstVmbSrcDebayerBand *band);
+void debayer_band_thread(gpointer data, gpointer user_data);
+gsize get_output_size(GstVmbSrc *vmbsrc, const GstVideoInfo *info);
+void release_wrapped_frame(gpointer data);
+GstCaps *query_camera_caps(GstVmbSrc *vmbsrc);
+void invalidate_cached_caps(GstVmbSrc *vmbsrc);
+void VMB_CALL caps_feature_invalidated(const VmbHandle_t handle, const char *name, void *user_context);
+void VMB_CALL latency_feature_invalidated(const VmbHandle_t handle, const char *name, void *user_context);
 void map_supported_pixel_formats(GstVmbSrc *vmbsrc);
+const VimbaXGstFormatMatch_t **query_supported_formats(GstObject *owner, VmbHandle_t camera_handle, VmbUint32_t *count);
+const VimbaXGstFormatMatch_t *select_vimbax_format(GstVmbSrc *vmbsrc, const char *gst_format);
+double get_max_frame_rate(GstVmbSrc *vmbsrc, const char *vimbax_format);
 void log_available_enum_entries(GstVmbSrc *vmbsrc, const char *feat_name);
 
 #endif
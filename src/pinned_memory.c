@@ -0,0 +1,90 @@
+#include "pinned_memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+// cudaHostRegisterPortable: the memory is page-locked for all CUDA contexts, not only the current one
+#define CUDA_HOST_REGISTER_PORTABLE 1
+
+typedef int (*CudaHostRegisterFunction_t)(void *address, size_t size, unsigned int flags);
+typedef int (*CudaHostUnregisterFunction_t)(void *address);
+
+static CudaHostRegisterFunction_t cuda_host_register = NULL;
+static CudaHostUnregisterFunction_t cuda_host_unregister = NULL;
+
+// Names of the runtime libraries of the supported CUDA major versions, unversioned names first
+static const char *const cuda_runtime_libraries[] = {
+#ifdef _WIN32
+    "cudart64_12.dll",
+    "cudart64_110.dll",
+    "cudart64_102.dll",
+#else
+    "libcudart.so",
+    "libcudart.so.12",
+    "libcudart.so.11.0",
+    "libcudart.so.10.2",
+#endif
+};
+
+bool pinned_memory_init(const char **library_name)
+{
+    for (size_t i = 0; i < sizeof(cuda_runtime_libraries) / sizeof(cuda_runtime_libraries[0]); i++)
+    {
+#ifdef _WIN32
+        HMODULE library = LoadLibraryA(cuda_runtime_libraries[i]);
+        if (library == NULL)
+        {
+            continue;
+        }
+        cuda_host_register = (CudaHostRegisterFunction_t)(void (*)(void))GetProcAddress(library, "cudaHostRegister");
+        cuda_host_unregister =
+            (CudaHostUnregisterFunction_t)(void (*)(void))GetProcAddress(library, "cudaHostUnregister");
+#else
+        void *library = dlopen(cuda_runtime_libraries[i], RTLD_NOW | RTLD_LOCAL);
+        if (library == NULL)
+        {
+            continue;
+        }
+        // Converting the object pointer returned by dlsym is the documented way of getting functions from it
+        *(void **)&cuda_host_register = dlsym(library, "cudaHostRegister");
+        *(void **)&cuda_host_unregister = dlsym(library, "cudaHostUnregister");
+#endif
+        if (cuda_host_register != NULL && cuda_host_unregister != NULL)
+        {
+            if (library_name != NULL)
+            {
+                *library_name = cuda_runtime_libraries[i];
+            }
+            // The library stays loaded for as long as the process runs since pinned buffers may outlive the element
+            return true;
+        }
+        cuda_host_register = NULL;
+        cuda_host_unregister = NULL;
+#ifdef _WIN32
+        FreeLibrary(library);
+#else
+        dlclose(library);
+#endif
+    }
+    return false;
+}
+
+int pin_memory(void *address, size_t size)
+{
+    if (cuda_host_register == NULL)
+    {
+        return -1;
+    }
+    return cuda_host_register(address, size, CUDA_HOST_REGISTER_PORTABLE);
+}
+
+void unpin_memory(void *address)
+{
+    if (cuda_host_unregister != NULL)
+    {
+        cuda_host_unregister(address);
+    }
+}
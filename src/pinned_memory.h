@@ -0,0 +1,19 @@
+#ifndef PINNED_MEMORY_H_
+#define PINNED_MEMORY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Loads the CUDA runtime library at runtime, so the plugin neither links against CUDA nor requires it to be installed.
+// Must be called once before the other functions, e.g. guarded by g_once. Returns false if no CUDA runtime was found.
+// If library_name is not NULL it is set to the name of the loaded library
+bool pinned_memory_init(const char **library_name);
+
+// Page-locks size bytes at address with cudaHostRegister, so that CUDA and GL uploads can transfer them by DMA without
+// a staging copy. Returns 0 on success or the cudaError_t code. Fails with -1 if pinned_memory_init was not successful
+int pin_memory(void *address, size_t size);
+
+// Releases memory that was page-locked by pin_memory
+void unpin_memory(void *address);
+
+#endif // PINNED_MEMORY_H_
@@ -3,8 +3,10 @@
 
 #include <VmbC/VmbCommonTypes.h>
 
+#include "unpack.h"
+
 // Helper as GStreamer only provides these macros for x-raw formats
-#define GST_BAYER_FORMATS_ALL "{ bggr, grbg, gbrg, rggb }"
+#define GST_BAYER_FORMATS_ALL "{ bggr, grbg, gbrg, rggb, bggr10le, grbg10le, gbrg10le, rggb10le, bggr12le, grbg12le, gbrg12le, rggb12le, bggr16le, grbg16le, gbrg16le, rggb16le }"
 
 #define GST_BAYER_CAPS_MAKE(format)       \
     "video/x-bayer, "                     \
@@ -17,32 +19,56 @@ typedef struct
 {
     const char *vimbax_format_name;
     const char *gst_format_name;
+    // packed formats are unpacked to 16 bit per pixel while copying the image data
+    VimbaXPacking_t packing;
 } VimbaXGstFormatMatch_t;
 
 // TODO: Check if same capitalization as below for the VimbaX capabilities is guaranteed
 static VimbaXGstFormatMatch_t vimbax_gst_format_matches[] = {
-    {"Mono8", "GRAY8"},
-    {"Mono10", "GRAY16_LE"},
-    {"Mono12", "GRAY16_LE"},
-    {"Mono14", "GRAY16_LE"},
-    {"Mono16", "GRAY16_LE"},
-    {"RGB8", "RGB"},
-    {"RGB8Packed", "RGB"},
-    {"BGR8", "BGR"},
-    {"BGR8Packed", "BGR"},
-    {"Argb8", "ARGB"},
-    {"Rgba8", "RGBA"},
-    {"Bgra8", "BGRA"},
-    {"Yuv422", "UYVY"},
-    {"YUV422Packed", "UYVY"},
-    {"YCbCr422_8_CbYCrY", "UYVY"},
-    {"Yuv444", "IYU2"},
-    {"YUV444Packed", "IYU2"},
-    {"YCbCr8_CbYCr", "IYU2"},
-    {"BayerGR8", "grbg"},
-    {"BayerRG8", "rggb"},
-    {"BayerGB8", "gbrg"},
-    {"BayerBG8", "bggr"}};
+    {"Mono8", "GRAY8", VIMBAX_PACKING_NONE},
+    {"Mono10", "GRAY16_LE", VIMBAX_PACKING_NONE},
+    {"Mono10p", "GRAY16_LE", VIMBAX_PACKING_10P},
+    {"Mono12", "GRAY16_LE", VIMBAX_PACKING_NONE},
+    {"Mono12p", "GRAY16_LE", VIMBAX_PACKING_12P},
+    {"Mono14", "GRAY16_LE", VIMBAX_PACKING_NONE},
+    {"Mono16", "GRAY16_LE", VIMBAX_PACKING_NONE},
+    {"RGB8", "RGB", VIMBAX_PACKING_NONE},
+    {"RGB8Packed", "RGB", VIMBAX_PACKING_NONE},
+    {"BGR8", "BGR", VIMBAX_PACKING_NONE},
+    {"BGR8Packed", "BGR", VIMBAX_PACKING_NONE},
+    {"Argb8", "ARGB", VIMBAX_PACKING_NONE},
+    {"Rgba8", "RGBA", VIMBAX_PACKING_NONE},
+    {"Bgra8", "BGRA", VIMBAX_PACKING_NONE},
+    {"Yuv422", "UYVY", VIMBAX_PACKING_NONE},
+    {"YUV422Packed", "UYVY", VIMBAX_PACKING_NONE},
+    {"YCbCr422_8_CbYCrY", "UYVY", VIMBAX_PACKING_NONE},
+    {"Yuv444", "IYU2", VIMBAX_PACKING_NONE},
+    {"YUV444Packed", "IYU2", VIMBAX_PACKING_NONE},
+    {"YCbCr8_CbYCr", "IYU2", VIMBAX_PACKING_NONE},
+    {"BayerGR8", "grbg", VIMBAX_PACKING_NONE},
+    {"BayerRG8", "rggb", VIMBAX_PACKING_NONE},
+    {"BayerGB8", "gbrg", VIMBAX_PACKING_NONE},
+    {"BayerBG8", "bggr", VIMBAX_PACKING_NONE},
+    {"BayerGR10", "grbg10le", VIMBAX_PACKING_NONE},
+    {"BayerRG10", "rggb10le", VIMBAX_PACKING_NONE},
+    {"BayerGB10", "gbrg10le", VIMBAX_PACKING_NONE},
+    {"BayerBG10", "bggr10le", VIMBAX_PACKING_NONE},
+    {"BayerGR10p", "grbg10le", VIMBAX_PACKING_10P},
+    {"BayerRG10p", "rggb10le", VIMBAX_PACKING_10P},
+    {"BayerGB10p", "gbrg10le", VIMBAX_PACKING_10P},
+    {"BayerBG10p", "bggr10le", VIMBAX_PACKING_10P},
+    {"BayerGR12", "grbg12le", VIMBAX_PACKING_NONE},
+    {"BayerRG12", "rggb12le", VIMBAX_PACKING_NONE},
+    {"BayerGB12", "gbrg12le", VIMBAX_PACKING_NONE},
+    {"BayerBG12", "bggr12le", VIMBAX_PACKING_NONE},
+    {"BayerGR12p", "grbg12le", VIMBAX_PACKING_12P},
+    {"BayerRG12p", "rggb12le", VIMBAX_PACKING_12P},
+    {"BayerGB12p", "gbrg12le", VIMBAX_PACKING_12P},
+    {"BayerBG12p", "bggr12le", VIMBAX_PACKING_12P},
+    {"BayerGR16", "grbg16le", VIMBAX_PACKING_NONE},
+    {"BayerRG16", "rggb16le", VIMBAX_PACKING_NONE},
+    {"BayerGB16", "gbrg16le", VIMBAX_PACKING_NONE},
+    {"BayerBG16", "bggr16le", VIMBAX_PACKING_NONE}};
 #define NUM_FORMAT_MATCHES (sizeof(vimbax_gst_format_matches) / sizeof(vimbax_gst_format_matches[0]))
 
 // lookup supported gst cap by format string from camera
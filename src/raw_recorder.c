@@ -0,0 +1,303 @@
+#ifdef __linux__
+// Required for O_DIRECT
+#define _GNU_SOURCE
+#endif
+
+#include "raw_recorder.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct VimbaXRawRecorder
+{
+#ifdef _WIN32
+    HANDLE file;
+#else
+    int fd;
+#endif
+    bool is_unbuffered;
+    FILE *index;
+    // number of bytes written to the raw file. Preallocated space behind it is released when the recorder is closed
+    uint64_t size;
+    uint64_t allocated_size;
+};
+
+static FILE *open_index(const char *path, int *error)
+{
+    size_t length = strlen(path);
+    char *index_path = malloc(length + sizeof(".idx"));
+    if (index_path == NULL)
+    {
+        *error = ENOMEM;
+        return NULL;
+    }
+    memcpy(index_path, path, length);
+    memcpy(index_path + length, ".idx", sizeof(".idx"));
+    FILE *index = fopen(index_path, "wb");
+    *error = index == NULL ? errno : 0;
+    free(index_path);
+    if (index == NULL)
+    {
+        return NULL;
+    }
+
+    VimbaXRawRecorderIndexHeader_t header = {{0}, RAW_RECORDER_INDEX_VERSION, sizeof(VimbaXRawRecorderIndexEntry_t)};
+    memcpy(header.magic, RAW_RECORDER_INDEX_MAGIC, sizeof(RAW_RECORDER_INDEX_MAGIC));
+    if (fwrite(&header, sizeof(header), 1, index) != 1)
+    {
+        *error = errno != 0 ? errno : EIO;
+        fclose(index);
+        return NULL;
+    }
+    return index;
+}
+
+#ifdef _WIN32
+// Windows error codes of failed file operations are reported as EIO, except for the most common ones
+static int from_windows_error(DWORD error)
+{
+    switch (error)
+    {
+    case ERROR_ACCESS_DENIED:
+        return EACCES;
+    case ERROR_PATH_NOT_FOUND:
+    case ERROR_FILE_NOT_FOUND:
+        return ENOENT;
+    case ERROR_DISK_FULL:
+    case ERROR_HANDLE_DISK_FULL:
+        return ENOSPC;
+    default:
+        return EIO;
+    }
+}
+
+static int set_file_size(HANDLE file, uint64_t size)
+{
+    LARGE_INTEGER position;
+    position.QuadPart = (LONGLONG)size;
+    if (!SetFilePointerEx(file, position, NULL, FILE_BEGIN) || !SetEndOfFile(file))
+    {
+        return from_windows_error(GetLastError());
+    }
+    return 0;
+}
+
+static HANDLE create_raw_file(const char *path, DWORD flags)
+{
+    return CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | flags, NULL);
+}
+
+VimbaXRawRecorder_t *raw_recorder_open(const char *path, int *error)
+{
+    VimbaXRawRecorder_t *recorder = calloc(1, sizeof(VimbaXRawRecorder_t));
+    if (recorder == NULL)
+    {
+        *error = ENOMEM;
+        return NULL;
+    }
+    recorder->is_unbuffered = true;
+    recorder->file = create_raw_file(path, FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH);
+    if (recorder->file == INVALID_HANDLE_VALUE && GetLastError() == ERROR_INVALID_PARAMETER)
+    {
+        recorder->is_unbuffered = false;
+        recorder->file = create_raw_file(path, 0);
+    }
+    if (recorder->file == INVALID_HANDLE_VALUE)
+    {
+        *error = from_windows_error(GetLastError());
+        free(recorder);
+        return NULL;
+    }
+    recorder->index = open_index(path, error);
+    if (recorder->index == NULL)
+    {
+        CloseHandle(recorder->file);
+        free(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+int raw_recorder_preallocate(VimbaXRawRecorder_t *recorder, uint64_t size)
+{
+    if (size <= recorder->allocated_size)
+    {
+        return 0;
+    }
+    int error = set_file_size(recorder->file, size);
+    if (error == 0)
+    {
+        recorder->allocated_size = size;
+    }
+    return error;
+}
+
+int raw_recorder_write_frame(VimbaXRawRecorder_t *recorder, const void *data, size_t size, uint64_t *offset)
+{
+    // The file is not opened for overlapped I/O because writes are issued by a dedicated thread. OVERLAPPED only passes
+    // the file offset
+    *offset = recorder->size;
+    OVERLAPPED overlapped = {0};
+    overlapped.Offset = (DWORD)(recorder->size & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(recorder->size >> 32);
+    const char *position = data;
+    while (size > 0)
+    {
+        DWORD written = 0;
+        DWORD chunk = size > 0x40000000 ? 0x40000000 : (DWORD)size;
+        if (!WriteFile(recorder->file, position, chunk, &written, &overlapped))
+        {
+            return from_windows_error(GetLastError());
+        }
+        recorder->size += written;
+        position += written;
+        size -= written;
+        overlapped.Offset = (DWORD)(recorder->size & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(recorder->size >> 32);
+    }
+    return 0;
+}
+
+int raw_recorder_close(VimbaXRawRecorder_t *recorder)
+{
+    int error = 0;
+    if (recorder->allocated_size > recorder->size)
+    {
+        error = set_file_size(recorder->file, recorder->size);
+    }
+    CloseHandle(recorder->file);
+    if (fclose(recorder->index) != 0 && error == 0)
+    {
+        error = errno;
+    }
+    free(recorder);
+    return error;
+}
+#else
+VimbaXRawRecorder_t *raw_recorder_open(const char *path, int *error)
+{
+    VimbaXRawRecorder_t *recorder = calloc(1, sizeof(VimbaXRawRecorder_t));
+    if (recorder == NULL)
+    {
+        *error = ENOMEM;
+        return NULL;
+    }
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+    recorder->is_unbuffered = true;
+    recorder->fd = open(path, flags | O_DIRECT, 0644);
+    if (recorder->fd < 0 && errno == EINVAL)
+    {
+        // e.g. tmpfs does not support O_DIRECT
+        recorder->is_unbuffered = false;
+        recorder->fd = open(path, flags, 0644);
+    }
+#else
+    recorder->fd = open(path, flags, 0644);
+#ifdef F_NOCACHE
+    recorder->is_unbuffered = recorder->fd >= 0 && fcntl(recorder->fd, F_NOCACHE, 1) == 0;
+#endif
+#endif
+    if (recorder->fd < 0)
+    {
+        *error = errno;
+        free(recorder);
+        return NULL;
+    }
+    recorder->index = open_index(path, error);
+    if (recorder->index == NULL)
+    {
+        close(recorder->fd);
+        free(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+int raw_recorder_preallocate(VimbaXRawRecorder_t *recorder, uint64_t size)
+{
+    if (size <= recorder->allocated_size)
+    {
+        return 0;
+    }
+#ifdef __linux__
+    int error = posix_fallocate(recorder->fd, (off_t)recorder->allocated_size, (off_t)(size - recorder->allocated_size));
+    if (error == 0)
+    {
+        recorder->allocated_size = size;
+    }
+    return error;
+#else
+    return ENOSYS;
+#endif
+}
+
+int raw_recorder_write_frame(VimbaXRawRecorder_t *recorder, const void *data, size_t size, uint64_t *offset)
+{
+    *offset = recorder->size;
+    const char *position = data;
+    while (size > 0)
+    {
+        ssize_t written = pwrite(recorder->fd, position, size, (off_t)recorder->size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno;
+        }
+        if (written == 0)
+        {
+            return EIO;
+        }
+        recorder->size += (uint64_t)written;
+        position += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+int raw_recorder_close(VimbaXRawRecorder_t *recorder)
+{
+    int error = 0;
+    if (recorder->allocated_size > recorder->size && ftruncate(recorder->fd, (off_t)recorder->size) != 0)
+    {
+        error = errno;
+    }
+    if (close(recorder->fd) != 0 && error == 0)
+    {
+        error = errno;
+    }
+    if (fclose(recorder->index) != 0 && error == 0)
+    {
+        error = errno;
+    }
+    free(recorder);
+    return error;
+}
+#endif // _WIN32
+
+bool raw_recorder_is_unbuffered(const VimbaXRawRecorder_t *recorder)
+{
+    return recorder->is_unbuffered;
+}
+
+int raw_recorder_write_index(VimbaXRawRecorder_t *recorder, const VimbaXRawRecorderIndexEntry_t *entry)
+{
+    if (fwrite(entry, sizeof(*entry), 1, recorder->index) != 1)
+    {
+        return errno != 0 ? errno : EIO;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#ifndef RAW_RECORDER_H_
+#define RAW_RECORDER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Alignment of frame data addresses, sizes and file offsets required for unbuffered writes. Covers the logical block
+// size of common disks and the page size
+#define RAW_RECORDER_ALIGNMENT 4096
+
+// Start of the index file, followed by one VimbaXRawRecorderIndexEntry_t per recorded frame. All values are stored in
+// host byte order
+#define RAW_RECORDER_INDEX_MAGIC "VMBXIDX"
+#define RAW_RECORDER_INDEX_VERSION 1
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    // size of a single index entry, for readers of later versions that append fields
+    uint32_t entry_size;
+} VimbaXRawRecorderIndexHeader_t;
+
+typedef struct
+{
+    uint64_t frame_id;
+    // device timestamp in ticks of the camera. 0 if the camera did not report one
+    uint64_t timestamp;
+    // position of the frame data in the raw file
+    uint64_t offset;
+    // number of bytes of frame data. The frame occupies this size rounded up to RAW_RECORDER_ALIGNMENT in the raw file
+    uint32_t size;
+    // PFNC pixel format, dimensions and receive status as reported in VmbFrame_t
+    uint32_t pixel_format;
+    uint32_t width;
+    uint32_t height;
+    int32_t receive_status;
+    // GstVmbChunkFlags of the chunk values below that were read from the frame
+    uint32_t chunk_fields;
+    double exposure_time;
+    double gain;
+    uint64_t chunk_frame_id;
+    uint64_t line_status_all;
+    uint64_t chunk_timestamp;
+} VimbaXRawRecorderIndexEntry_t;
+
+typedef struct VimbaXRawRecorder VimbaXRawRecorder_t;
+
+// Creates (or truncates) the raw file at path for unbuffered writes (O_DIRECT on Linux, F_NOCACHE on macOS and
+// FILE_FLAG_NO_BUFFERING on Windows) and the index file at path with ".idx" appended. If the file system does not
+// support unbuffered writes, buffered writes are used. Returns NULL and sets error to an errno value on failure
+VimbaXRawRecorder_t *raw_recorder_open(const char *path, int *error);
+
+// true if frame data bypasses the page cache
+bool raw_recorder_is_unbuffered(const VimbaXRawRecorder_t *recorder);
+
+// Reserves size bytes of disk space for the raw file so that writes do not have to allocate blocks. Returns 0 on success
+// or an errno value (ENOSYS if not supported on this platform)
+int raw_recorder_preallocate(VimbaXRawRecorder_t *recorder, uint64_t size);
+
+// Appends size bytes from data to the raw file. data must be aligned to RAW_RECORDER_ALIGNMENT and size rounded up to a
+// multiple of it. offset is set to the position the data was written to. Returns 0 on success or an errno value
+int raw_recorder_write_frame(VimbaXRawRecorder_t *recorder, const void *data, size_t size, uint64_t *offset);
+
+// Appends an entry to the index file. Returns 0 on success or an errno value
+int raw_recorder_write_index(VimbaXRawRecorder_t *recorder, const VimbaXRawRecorderIndexEntry_t *entry);
+
+// Releases preallocated space that was not written and closes both files. Returns 0 on success or an errno value
+int raw_recorder_close(VimbaXRawRecorder_t *recorder);
+
+#endif // RAW_RECORDER_H_
@@ -0,0 +1,313 @@
+#include "settings_file.h"
+
+#include <string.h>
+
+typedef enum
+{
+    // Element only grouping features, possibly starting the section of a module
+    SETTINGS_CONTEXT_GROUP,
+    // <Selector Name="..."> element holding the features of each selector value
+    SETTINGS_CONTEXT_SELECTOR,
+    // Element inside a <Selector> naming the selector value its features belong to
+    SETTINGS_CONTEXT_SELECTOR_ENTRY
+} SettingsContextKind;
+
+// An open element enclosing the features parsed next
+typedef struct
+{
+    SettingsContextKind kind;
+    VimbaXSettingsModule module;
+    // Name and type of the feature selected by a <Selector> element
+    gchar *selector;
+    VmbFeatureDataType_t selector_type;
+} SettingsContext;
+
+typedef struct
+{
+    GArray *features;
+    // Feature whose element is currently open, NULL outside of <Feature> elements
+    VimbaXSettingsFeature *current;
+    GString *text;
+    // SettingsContext of every open element apart from <Feature>, innermost last
+    GArray *contexts;
+} SettingsParserState;
+
+// Element names (or values of their Name attribute) starting the section of a module. Sections without one of these
+// names belong to the module of their enclosing section, which is the camera itself at the top level
+static const struct
+{
+    const gchar *name;
+    VimbaXSettingsModule module;
+} settings_modules[] = {
+    {"RemoteDevice", VIMBAX_SETTINGS_MODULE_REMOTE_DEVICE},
+    {"Stream", VIMBAX_SETTINGS_MODULE_STREAM},
+    {"LocalDevice", VIMBAX_SETTINGS_MODULE_OTHER},
+    {"Interface", VIMBAX_SETTINGS_MODULE_OTHER},
+    {"TransportLayer", VIMBAX_SETTINGS_MODULE_OTHER},
+    {"System", VIMBAX_SETTINGS_MODULE_OTHER}};
+
+static gboolean parse_feature_type(const gchar *type, VmbFeatureDataType_t *data_type)
+{
+    static const struct
+    {
+        const gchar *name;
+        VmbFeatureDataType_t data_type;
+    } types[] = {
+        {"Integer", VmbFeatureDataInt},
+        {"Int", VmbFeatureDataInt},
+        {"Float", VmbFeatureDataFloat},
+        {"Enumeration", VmbFeatureDataEnum},
+        {"Enum", VmbFeatureDataEnum},
+        {"String", VmbFeatureDataString},
+        {"Boolean", VmbFeatureDataBool},
+        {"Bool", VmbFeatureDataBool}};
+    for (gsize i = 0; i < G_N_ELEMENTS(types); i++)
+    {
+        if (g_ascii_strcasecmp(type, types[i].name) == 0)
+        {
+            *data_type = types[i].data_type;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static const gchar *find_attribute(const gchar **attribute_names, const gchar **attribute_values, const gchar *name)
+{
+    for (gsize i = 0; attribute_names[i] != NULL; i++)
+    {
+        if (strcmp(attribute_names[i], name) == 0)
+        {
+            return attribute_values[i];
+        }
+    }
+    return NULL;
+}
+
+static gboolean find_module(const gchar *name, VimbaXSettingsModule *module)
+{
+    for (gsize i = 0; name != NULL && i < G_N_ELEMENTS(settings_modules); i++)
+    {
+        if (g_ascii_strcasecmp(name, settings_modules[i].name) == 0)
+        {
+            *module = settings_modules[i].module;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static SettingsContext *current_context(SettingsParserState *state)
+{
+    if (state->contexts->len == 0)
+    {
+        return NULL;
+    }
+    return &g_array_index(state->contexts, SettingsContext, state->contexts->len - 1);
+}
+
+static void append_feature(SettingsParserState *state,
+                           const gchar *name,
+                           VimbaXSettingsModule module,
+                           VmbFeatureDataType_t type,
+                           const gchar *value,
+                           VimbaXSettingsOperation operation)
+{
+    VimbaXSettingsFeature feature = {g_strdup(name), module, type, g_strdup(value), operation};
+    g_array_append_val(state->features, feature);
+}
+
+// Opens an element other than <Feature>
+static void push_context(SettingsParserState *state,
+                         const gchar *element_name,
+                         const gchar **attribute_names,
+                         const gchar **attribute_values,
+                         GError **error)
+{
+    SettingsContext *parent = current_context(state);
+    SettingsContext context = {SETTINGS_CONTEXT_GROUP,
+                               parent != NULL ? parent->module : VIMBAX_SETTINGS_MODULE_REMOTE_DEVICE,
+                               NULL,
+                               VmbFeatureDataEnum};
+    const gchar *name = find_attribute(attribute_names, attribute_values, "Name");
+    if (strcmp(element_name, "Selector") == 0)
+    {
+        const gchar *type = find_attribute(attribute_names, attribute_values, "Type");
+        if (name == NULL || (type != NULL && !parse_feature_type(type, &context.selector_type)))
+        {
+            g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT, "<Selector> without Name or valid Type");
+            return;
+        }
+        context.kind = SETTINGS_CONTEXT_SELECTOR;
+        context.selector = g_strdup(name);
+        // The file does not necessarily contain the value of the selector itself, and the value parsed last for it may
+        // belong to the entry of an earlier <Selector>. The value is therefore read from the camera when it is applied
+        append_feature(state, name, context.module, context.selector_type, NULL, VIMBAX_SETTINGS_OPERATION_SAVE);
+    }
+    else if (parent != NULL && parent->kind == SETTINGS_CONTEXT_SELECTOR)
+    {
+        if (name == NULL)
+        {
+            g_set_error(error,
+                        G_MARKUP_ERROR,
+                        G_MARKUP_ERROR_MISSING_ATTRIBUTE,
+                        "<%s> in <Selector Name=\"%s\"> without Name",
+                        element_name,
+                        parent->selector);
+            return;
+        }
+        // The features of this entry only apply while the selector has its value
+        context.kind = SETTINGS_CONTEXT_SELECTOR_ENTRY;
+        append_feature(state,
+                       parent->selector,
+                       context.module,
+                       parent->selector_type,
+                       name,
+                       VIMBAX_SETTINGS_OPERATION_WRITE);
+    }
+    else if (!find_module(element_name, &context.module))
+    {
+        find_module(name, &context.module);
+    }
+    g_array_append_val(state->contexts, context);
+}
+
+// Closes an element other than <Feature>
+static void pop_context(SettingsParserState *state)
+{
+    SettingsContext *context = current_context(state);
+    if (context == NULL)
+    {
+        return;
+    }
+    if (context->kind == SETTINGS_CONTEXT_SELECTOR)
+    {
+        append_feature(state,
+                       context->selector,
+                       context->module,
+                       context->selector_type,
+                       NULL,
+                       VIMBAX_SETTINGS_OPERATION_RESTORE);
+    }
+    g_free(context->selector);
+    g_array_set_size(state->contexts, state->contexts->len - 1);
+}
+
+static void settings_start_element(GMarkupParseContext *context,
+                                   const gchar *element_name,
+                                   const gchar **attribute_names,
+                                   const gchar **attribute_values,
+                                   gpointer user_data,
+                                   GError **error)
+{
+    (void)context;
+    SettingsParserState *state = user_data;
+    if (state->current != NULL)
+    {
+        g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT, "Element inside <Feature>");
+        return;
+    }
+    if (strcmp(element_name, "Feature") != 0)
+    {
+        push_context(state, element_name, attribute_names, attribute_values, error);
+        return;
+    }
+
+    const gchar *name = find_attribute(attribute_names, attribute_values, "Name");
+    const gchar *type = find_attribute(attribute_names, attribute_values, "Type");
+    SettingsContext *enclosing = current_context(state);
+    VimbaXSettingsFeature feature = {0};
+    feature.module = enclosing != NULL ? enclosing->module : VIMBAX_SETTINGS_MODULE_REMOTE_DEVICE;
+    if (name == NULL || type == NULL)
+    {
+        g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_MISSING_ATTRIBUTE, "<Feature> without Name or Type");
+        return;
+    }
+    if (!parse_feature_type(type, &feature.type))
+    {
+        g_set_error(error,
+                    G_MARKUP_ERROR,
+                    G_MARKUP_ERROR_INVALID_CONTENT,
+                    "Feature \"%s\" has unsupported type \"%s\"",
+                    name,
+                    type);
+        return;
+    }
+    feature.name = g_strdup(name);
+    g_array_append_val(state->features, feature);
+    state->current = &g_array_index(state->features, VimbaXSettingsFeature, state->features->len - 1);
+    g_string_truncate(state->text, 0);
+}
+
+static void settings_end_element(GMarkupParseContext *context,
+                                 const gchar *element_name,
+                                 gpointer user_data,
+                                 GError **error)
+{
+    (void)context;
+    (void)error;
+    SettingsParserState *state = user_data;
+    if (strcmp(element_name, "Feature") != 0)
+    {
+        pop_context(state);
+    }
+    else if (state->current != NULL)
+    {
+        state->current->value = g_strstrip(g_strdup(state->text->str));
+        state->current = NULL;
+    }
+}
+
+static void settings_text(GMarkupParseContext *context,
+                          const gchar *text,
+                          gsize text_len,
+                          gpointer user_data,
+                          GError **error)
+{
+    (void)context;
+    (void)error;
+    SettingsParserState *state = user_data;
+    if (state->current != NULL)
+    {
+        g_string_append_len(state->text, text, (gssize)text_len);
+    }
+}
+
+GArray *parse_settings_file(const gchar *contents, gsize length, GError **error)
+{
+    static const GMarkupParser parser = {settings_start_element, settings_end_element, settings_text, NULL, NULL};
+    SettingsParserState state = {g_array_new(FALSE, TRUE, sizeof(VimbaXSettingsFeature)),
+                                 NULL,
+                                 g_string_new(NULL),
+                                 g_array_new(FALSE, TRUE, sizeof(SettingsContext))};
+
+    GMarkupParseContext *context = g_markup_parse_context_new(&parser, 0, &state, NULL);
+    gboolean success = g_markup_parse_context_parse(context, contents, (gssize)length, error) &&
+                       g_markup_parse_context_end_parse(context, error);
+    g_markup_parse_context_free(context);
+    g_string_free(state.text, TRUE);
+    // Elements left open by a malformed file
+    while (state.contexts->len > 0)
+    {
+        pop_context(&state);
+    }
+    g_array_free(state.contexts, TRUE);
+
+    if (!success)
+    {
+        free_settings_features(state.features);
+        return NULL;
+    }
+    return state.features;
+}
+
+void free_settings_features(GArray *features)
+{
+    for (guint i = 0; i < features->len; i++)
+    {
+        VimbaXSettingsFeature *feature = &g_array_index(features, VimbaXSettingsFeature, i);
+        g_free(feature->name);
+        g_free(feature->value);
+    }
+    g_array_free(features, TRUE);
+}
@@ -0,0 +1,55 @@
+#ifndef SETTINGS_FILE_H_
+#define SETTINGS_FILE_H_
+
+#include <glib.h>
+
+#include <VmbC/VmbC.h>
+
+// Module of the camera a feature of a settings file belongs to
+typedef enum
+{
+    // Features of the camera itself, which are written via the camera handle
+    VIMBAX_SETTINGS_MODULE_REMOTE_DEVICE,
+    // Features of the first stream of the camera
+    VIMBAX_SETTINGS_MODULE_STREAM,
+    // Features of the transport layer, interface or local device, which can only be loaded with VmbSettingsLoad
+    VIMBAX_SETTINGS_MODULE_OTHER
+} VimbaXSettingsModule;
+
+// What is done with a feature of a settings file when it is applied
+typedef enum
+{
+    // Write the value of the feature
+    VIMBAX_SETTINGS_OPERATION_WRITE,
+    // Read the current value of the feature from the camera and keep it for the matching restore
+    VIMBAX_SETTINGS_OPERATION_SAVE,
+    // Write back the value read by the innermost save that was not restored yet
+    VIMBAX_SETTINGS_OPERATION_RESTORE
+} VimbaXSettingsOperation;
+
+// A feature value stored in a VimbaX settings XML file (as written by VmbSettingsSave)
+typedef struct
+{
+    gchar *name;
+    VimbaXSettingsModule module;
+    // VmbFeatureDataInt, VmbFeatureDataFloat, VmbFeatureDataEnum, VmbFeatureDataString or VmbFeatureDataBool
+    VmbFeatureDataType_t type;
+    // Value as written in the file with surrounding whitespace removed. NULL for saves and restores
+    gchar *value;
+    VimbaXSettingsOperation operation;
+} VimbaXSettingsFeature;
+
+// Parses the <Feature Name="..." Type="...">value</Feature> elements of a settings file in the order they appear in the
+// file, which is the order in which VmbSettingsSave wrote them and respects selector dependencies. Features inside a
+// <Selector Name="..."> element are only valid for the selector value named by their enclosing entry element (e.g.
+// <EnumEntry Name="...">), so a feature setting the selector to that value is inserted before them. The <Selector>
+// element is enclosed in a save and a restore of the selector, so that it leaves the selector at the value the camera
+// had before the element rather than guessing it from the file. Each feature is tagged with the module of the
+// section it appears in (see VimbaXSettingsModule). Returns a GArray of VimbaXSettingsFeature that must be freed with
+// free_settings_features, or NULL if the file is malformed or contains a feature type that can not be applied
+// individually
+GArray *parse_settings_file(const gchar *contents, gsize length, GError **error);
+
+void free_settings_features(GArray *features);
+
+#endif // SETTINGS_FILE_H_
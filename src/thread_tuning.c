@@ -0,0 +1,84 @@
+#ifdef __linux__
+// Required for cpu_set_t and pthread_setaffinity_np
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#endif
+
+#include "thread_tuning.h"
+
+#include <errno.h>
+
+#ifdef __linux__
+int set_current_thread_affinity(const char *cpu_list)
+{
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    const char *position = cpu_list;
+    while (*position != '\0')
+    {
+        char *end;
+        unsigned long first = strtoul(position, &end, 10);
+        if (end == position)
+        {
+            return EINVAL;
+        }
+        unsigned long last = first;
+        if (*end == '-')
+        {
+            position = end + 1;
+            last = strtoul(position, &end, 10);
+            if (end == position || last < first)
+            {
+                return EINVAL;
+            }
+        }
+        if (last >= CPU_SETSIZE)
+        {
+            return EINVAL;
+        }
+        for (unsigned long cpu = first; cpu <= last; cpu++)
+        {
+            CPU_SET(cpu, &cpus);
+        }
+        if (*end == ',')
+        {
+            end++;
+        }
+        else if (*end != '\0')
+        {
+            return EINVAL;
+        }
+        position = end;
+    }
+    if (CPU_COUNT(&cpus) == 0)
+    {
+        return EINVAL;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+int set_current_thread_priority(unsigned int priority)
+{
+    if (priority > MAX_THREAD_PRIORITY)
+    {
+        return EINVAL;
+    }
+    struct sched_param param = {0};
+    param.sched_priority = (int)priority;
+    return pthread_setschedparam(pthread_self(), priority > 0 ? SCHED_FIFO : SCHED_OTHER, &param);
+}
+#else
+int set_current_thread_affinity(const char *cpu_list)
+{
+    (void)cpu_list;
+    return ENOSYS;
+}
+
+int set_current_thread_priority(unsigned int priority)
+{
+    (void)priority;
+    return ENOSYS;
+}
+#endif // __linux__
@@ -0,0 +1,16 @@
+#ifndef THREAD_TUNING_H_
+#define THREAD_TUNING_H_
+
+// Highest priority accepted by set_current_thread_priority (the upper end of the SCHED_FIFO range on Linux)
+#define MAX_THREAD_PRIORITY 99
+
+// Pins the calling thread to the CPUs given as comma separated list of CPU numbers and ranges (e.g. "2" or "0,4-7").
+// Returns 0 on success or an errno value: EINVAL for a malformed list and ENOSYS if not supported on this platform
+int set_current_thread_affinity(const char *cpu_list);
+
+// Runs the calling thread with SCHED_FIFO at the given priority (1 to MAX_THREAD_PRIORITY) or with the default
+// scheduling policy if priority is 0. Returns 0 on success or an errno value (usually EPERM without CAP_SYS_NICE, ENOSYS
+// if not supported on this platform)
+int set_current_thread_priority(unsigned int priority);
+
+#endif // THREAD_TUNING_H_
@@ -0,0 +1,200 @@
+#include "unpack.h"
+
+// SIMD kernels are compiled with function specific target attributes and selected at runtime, so the plugin itself does
+// not require a newer instruction set than the rest of the build
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UNPACK_X86_KERNELS
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define UNPACK_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+static void unpack_10p_scalar(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    size_t i = 0;
+    for (; i + 4 <= num_pixels; i += 4, src += 5)
+    {
+        dest[i] = (uint16_t)(src[0] | ((src[1] & 0x03) << 8));
+        dest[i + 1] = (uint16_t)((src[1] >> 2) | ((src[2] & 0x0F) << 6));
+        dest[i + 2] = (uint16_t)((src[2] >> 4) | ((src[3] & 0x3F) << 4));
+        dest[i + 3] = (uint16_t)((src[3] >> 6) | (src[4] << 2));
+    }
+    // remaining pixels of an incomplete group. Each of them is fully contained in the two bytes read for it
+    for (unsigned int bit = 0; i < num_pixels; i++, bit += 10)
+    {
+        unsigned int value = src[bit / 8] | (src[bit / 8 + 1] << 8);
+        dest[i] = (uint16_t)((value >> (bit % 8)) & 0x03FF);
+    }
+}
+
+static void unpack_12p_scalar(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    size_t i = 0;
+    for (; i + 2 <= num_pixels; i += 2, src += 3)
+    {
+        dest[i] = (uint16_t)(src[0] | ((src[1] & 0x0F) << 8));
+        dest[i + 1] = (uint16_t)((src[1] >> 4) | (src[2] << 4));
+    }
+    if (i < num_pixels)
+    {
+        dest[i] = (uint16_t)(src[0] | ((src[1] & 0x0F) << 8));
+    }
+}
+
+#ifdef UNPACK_X86_KERNELS
+// The vector loops read 16 (SSE) or 32 (AVX2) bytes but only consume the bytes of complete pixel groups. Loop conditions
+// leave enough pixels for the tail so that no byte behind the packed data is read
+
+__attribute__((target("sse4.1"))) static void unpack_10p_sse41(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    // move the two bytes containing each pixel into its 16 bit lane
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9);
+    // shift every pixel to the top of its lane. Multiplying allows a different shift per lane
+    const __m128i align = _mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1);
+    size_t i = 0;
+    for (; i + 16 <= num_pixels; i += 8, src += 10)
+    {
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), shuffle);
+        v = _mm_srli_epi16(_mm_mullo_epi16(v, align), 6);
+        _mm_storeu_si128((__m128i *)(dest + i), v);
+    }
+    unpack_10p_scalar(src, dest + i, num_pixels - i);
+}
+
+__attribute__((target("sse4.1"))) static void unpack_12p_sse41(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+    const __m128i mask = _mm_set1_epi16(0x0FFF);
+    size_t i = 0;
+    for (; i + 16 <= num_pixels; i += 8, src += 12)
+    {
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), shuffle);
+        // even pixels occupy the lower 12 bits of their lane, odd pixels the upper 12 bits
+        v = _mm_blend_epi16(_mm_and_si128(v, mask), _mm_srli_epi16(v, 4), 0xAA);
+        _mm_storeu_si128((__m128i *)(dest + i), v);
+    }
+    unpack_12p_scalar(src, dest + i, num_pixels - i);
+}
+
+// AVX2 shuffles only work within 128 bit lanes, so each lane is loaded separately from the start of its pixel groups
+__attribute__((target("avx2"))) static void unpack_10p_avx2(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9,
+                                             0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9);
+    const __m256i align = _mm256_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1, 64, 16, 4, 1, 64, 16, 4, 1);
+    size_t i = 0;
+    for (; i + 32 <= num_pixels; i += 16, src += 20)
+    {
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+                                            _mm_loadu_si128((const __m128i *)(src + 10)),
+                                            1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_srli_epi16(_mm256_mullo_epi16(v, align), 6);
+        _mm256_storeu_si256((__m256i *)(dest + i), v);
+    }
+    unpack_10p_sse41(src, dest + i, num_pixels - i);
+}
+
+__attribute__((target("avx2"))) static void unpack_12p_avx2(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+                                             0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+    const __m256i mask = _mm256_set1_epi16(0x0FFF);
+    size_t i = 0;
+    for (; i + 32 <= num_pixels; i += 16, src += 24)
+    {
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+                                            _mm_loadu_si128((const __m128i *)(src + 12)),
+                                            1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_blend_epi16(_mm256_and_si256(v, mask), _mm256_srli_epi16(v, 4), 0xAA);
+        _mm256_storeu_si256((__m256i *)(dest + i), v);
+    }
+    unpack_12p_sse41(src, dest + i, num_pixels - i);
+}
+#endif // UNPACK_X86_KERNELS
+
+#ifdef UNPACK_NEON_KERNELS
+static void unpack_10p_neon(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    static const uint8_t shuffle_indices[16] = {0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9};
+    // negative values shift right, which NEON allows per lane
+    static const int16_t shifts[8] = {0, -2, -4, -6, 0, -2, -4, -6};
+    const uint8x16_t shuffle = vld1q_u8(shuffle_indices);
+    const int16x8_t shift = vld1q_s16(shifts);
+    const uint16x8_t mask = vdupq_n_u16(0x03FF);
+    size_t i = 0;
+    // reads 16 bytes but consumes 10, see the x86 kernels for the loop condition
+    for (; i + 16 <= num_pixels; i += 8, src += 10)
+    {
+        uint16x8_t v = vreinterpretq_u16_u8(vqtbl1q_u8(vld1q_u8(src), shuffle));
+        vst1q_u16(dest + i, vandq_u16(vshlq_u16(v, shift), mask));
+    }
+    unpack_10p_scalar(src, dest + i, num_pixels - i);
+}
+
+static void unpack_12p_neon(const uint8_t *src, uint16_t *dest, size_t num_pixels)
+{
+    const uint16x8_t mask = vdupq_n_u16(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= num_pixels; i += 16, src += 24)
+    {
+        // deinterleave the three bytes of each pixel pair
+        uint8x8x3_t v = vld3_u8(src);
+        uint16x8_t middle = vmovl_u8(v.val[1]);
+        uint16x8x2_t pixels;
+        pixels.val[0] = vorrq_u16(vmovl_u8(v.val[0]), vshlq_n_u16(vandq_u16(middle, mask), 8));
+        pixels.val[1] = vorrq_u16(vshrq_n_u16(middle, 4), vshlq_n_u16(vmovl_u8(v.val[2]), 4));
+        vst2q_u16(dest + i, pixels);
+    }
+    unpack_12p_scalar(src, dest + i, num_pixels - i);
+}
+#endif // UNPACK_NEON_KERNELS
+
+unsigned int packed_bits_per_pixel(VimbaXPacking_t packing)
+{
+    switch (packing)
+    {
+    case VIMBAX_PACKING_10P:
+        return 10;
+    case VIMBAX_PACKING_12P:
+        return 12;
+    default:
+        return 16;
+    }
+}
+
+VimbaXUnpackFunction_t get_unpack_function(VimbaXPacking_t packing, const char **implementation_name)
+{
+    if (packing == VIMBAX_PACKING_NONE)
+    {
+        return NULL;
+    }
+
+    const char *name = "scalar";
+    VimbaXUnpackFunction_t function = packing == VIMBAX_PACKING_10P ? unpack_10p_scalar : unpack_12p_scalar;
+#if defined(UNPACK_X86_KERNELS)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        name = "AVX2";
+        function = packing == VIMBAX_PACKING_10P ? unpack_10p_avx2 : unpack_12p_avx2;
+    }
+    else if (__builtin_cpu_supports("sse4.1"))
+    {
+        name = "SSE4.1";
+        function = packing == VIMBAX_PACKING_10P ? unpack_10p_sse41 : unpack_12p_sse41;
+    }
+#elif defined(UNPACK_NEON_KERNELS)
+    // NEON is part of every AArch64 CPU
+    name = "NEON";
+    function = packing == VIMBAX_PACKING_10P ? unpack_10p_neon : unpack_12p_neon;
+#endif
+
+    if (implementation_name != NULL)
+    {
+        *implementation_name = name;
+    }
+    return function;
+}
@@ -0,0 +1,27 @@
+#ifndef UNPACK_H_
+#define UNPACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bit packing of VimbaX pixel formats whose pixel data must be unpacked before it can be passed downstream
+typedef enum
+{
+    VIMBAX_PACKING_NONE,
+    // GenICam PFNC "p" formats with 10 bit per pixel: 4 pixels in 5 bytes, least significant bits first
+    VIMBAX_PACKING_10P,
+    // GenICam PFNC "p" formats with 12 bit per pixel: 2 pixels in 3 bytes, least significant bits first
+    VIMBAX_PACKING_12P
+} VimbaXPacking_t;
+
+// Unpacks num_pixels pixels starting at src (which must be at a byte boundary) into one 16 bit value per pixel
+typedef void (*VimbaXUnpackFunction_t)(const uint8_t *src, uint16_t *dest, size_t num_pixels);
+
+// number of bits a single pixel occupies in the packed pixel data
+unsigned int packed_bits_per_pixel(VimbaXPacking_t packing);
+
+// select the fastest unpack implementation the CPU supports. Returns NULL for VIMBAX_PACKING_NONE. If implementation_name
+// is not NULL it is set to a description of the selected implementation
+VimbaXUnpackFunction_t get_unpack_function(VimbaXPacking_t packing, const char **implementation_name);
+
+#endif // UNPACK_H_
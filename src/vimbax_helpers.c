@@ -2,8 +2,20 @@
 
 #include <VmbC/VmbC.h>
 
+#include <glib.h>
+
+#include <string.h>
+
+#ifndef MAX
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+// First and maximum sleep (in microseconds) between two checks of WaitForCommandDone
+#define COMMAND_DONE_INITIAL_BACKOFF 50
+#define COMMAND_DONE_MAX_BACKOFF (10 * 1000)
 
 //
 // Translates VimbaX error codes to readable error messages
@@ -125,3 +137,153 @@ VmbInt64_t RoundToNearestValidValue(VmbInt64_t value, VmbInt64_t min, VmbInt64_t
     }
     return MAX(MIN((steps * increment) + min, max), min);
 }
+
+//
+// Waits until a command feature that was run reports that it is done. The first check happens immediately, after that
+// the time between checks doubles up to COMMAND_DONE_MAX_BACKOFF so that short commands return quickly without spinning
+// on long running ones
+//
+// Parameters:
+//  [in]    handle      Handle of the module providing the command
+//  [in]    name        Name of the command feature
+//  [in]    timeoutMs   Time in milliseconds after which waiting is aborted
+//
+// Returns:
+//  VmbErrorSuccess once the command is done, VmbErrorTimeout if it was not done in time or the error of
+//  VmbFeatureCommandIsDone
+//
+VmbError_t WaitForCommandDone(VmbHandle_t handle, const char *name, unsigned int timeoutMs)
+{
+    gint64 deadline = g_get_monotonic_time() + (gint64)timeoutMs * G_TIME_SPAN_MILLISECOND;
+    gulong backoff = COMMAND_DONE_INITIAL_BACKOFF;
+    while (TRUE)
+    {
+        VmbBool_t isDone = VmbBoolFalse;
+        VmbError_t result = VmbFeatureCommandIsDone(handle, name, &isDone);
+        if (result != VmbErrorSuccess || isDone)
+        {
+            return result;
+        }
+        gint64 remaining = deadline - g_get_monotonic_time();
+        if (remaining <= 0)
+        {
+            return VmbErrorTimeout;
+        }
+        g_usleep(MIN(backoff, (gulong)remaining));
+        backoff = MIN(backoff * 2, COMMAND_DONE_MAX_BACKOFF);
+    }
+}
+
+//
+// Writes an integer feature unless it already has the given value. Features that can not be read are written
+// regardless
+//
+// Parameters:
+//  [in]    handle      Handle of the module providing the feature
+//  [in]    name        Name of the feature
+//  [in]    value       Value to write
+//
+// Returns:
+//  The result of VmbFeatureIntSet or VmbErrorSuccess if the feature already had the value
+//
+VmbError_t FeatureIntSetIfChanged(VmbHandle_t handle, const char *name, VmbInt64_t value)
+{
+    VmbInt64_t current;
+    if (VmbFeatureIntGet(handle, name, &current) == VmbErrorSuccess && current == value)
+    {
+        return VmbErrorSuccess;
+    }
+    return VmbFeatureIntSet(handle, name, value);
+}
+
+//
+// Writes a float feature unless it already has the given value. Features that can not be read are written regardless
+//
+// Parameters:
+//  [in]    handle      Handle of the module providing the feature
+//  [in]    name        Name of the feature
+//  [in]    value       Value to write
+//
+// Returns:
+//  The result of VmbFeatureFloatSet or VmbErrorSuccess if the feature already had the value
+//
+VmbError_t FeatureFloatSetIfChanged(VmbHandle_t handle, const char *name, double value)
+{
+    double current;
+    if (VmbFeatureFloatGet(handle, name, &current) == VmbErrorSuccess && current == value)
+    {
+        return VmbErrorSuccess;
+    }
+    return VmbFeatureFloatSet(handle, name, value);
+}
+
+//
+// Writes an enum feature unless it already has the given entry selected. Features that can not be read are written
+// regardless
+//
+// Parameters:
+//  [in]    handle      Handle of the module providing the feature
+//  [in]    name        Name of the feature
+//  [in]    value       Name of the enum entry to select
+//
+// Returns:
+//  The result of VmbFeatureEnumSet or VmbErrorSuccess if the entry was already selected
+//
+VmbError_t FeatureEnumSetIfChanged(VmbHandle_t handle, const char *name, const char *value)
+{
+    const char *current;
+    if (VmbFeatureEnumGet(handle, name, &current) == VmbErrorSuccess && current != NULL && strcmp(current, value) == 0)
+    {
+        return VmbErrorSuccess;
+    }
+    return VmbFeatureEnumSet(handle, name, value);
+}
+
+//
+// Writes a boolean feature unless it already has the given value. Features that can not be read are written regardless
+//
+// Parameters:
+//  [in]    handle      Handle of the module providing the feature
+//  [in]    name        Name of the feature
+//  [in]    value       Value to write
+//
+// Returns:
+//  The result of VmbFeatureBoolSet or VmbErrorSuccess if the feature already had the value
+//
+VmbError_t FeatureBoolSetIfChanged(VmbHandle_t handle, const char *name, VmbBool_t value)
+{
+    VmbBool_t current;
+    if (VmbFeatureBoolGet(handle, name, &current) == VmbErrorSuccess && !current == !value)
+    {
+        return VmbErrorSuccess;
+    }
+    return VmbFeatureBoolSet(handle, name, value);
+}
+
+//
+// Writes a string feature unless it already has the given value. Features that can not be read are written regardless
+//
+// Parameters:
+//  [in]    handle      Handle of the module providing the feature
+//  [in]    name        Name of the feature
+//  [in]    value       Value to write
+//
+// Returns:
+//  The result of VmbFeatureStringSet or VmbErrorSuccess if the feature already had the value
+//
+VmbError_t FeatureStringSetIfChanged(VmbHandle_t handle, const char *name, const char *value)
+{
+    VmbUint32_t size = 0;
+    if (VmbFeatureStringGet(handle, name, NULL, 0, &size) == VmbErrorSuccess && size == strlen(value) + 1)
+    {
+        char *current = g_malloc(size);
+        gboolean is_equal = VmbFeatureStringGet(handle, name, current, size, NULL) == VmbErrorSuccess &&
+                            strcmp(current, value) == 0;
+        g_free(current);
+        if (is_equal)
+        {
+            return VmbErrorSuccess;
+        }
+    }
+    return VmbFeatureStringSet(handle, name, value);
+}
@@ -7,4 +7,12 @@ const char *ErrorCodeToMessage(VmbError_t eError);
 
 VmbInt64_t RoundToNearestValidValue(VmbInt64_t value, VmbInt64_t min, VmbInt64_t max, VmbInt64_t increment);
 
+VmbError_t WaitForCommandDone(VmbHandle_t handle, const char *name, unsigned int timeoutMs);
+
+VmbError_t FeatureIntSetIfChanged(VmbHandle_t handle, const char *name, VmbInt64_t value);
+VmbError_t FeatureFloatSetIfChanged(VmbHandle_t handle, const char *name, double value);
+VmbError_t FeatureEnumSetIfChanged(VmbHandle_t handle, const char *name, const char *value);
+VmbError_t FeatureBoolSetIfChanged(VmbHandle_t handle, const char *name, VmbBool_t value);
+VmbError_t FeatureStringSetIfChanged(VmbHandle_t handle, const char *name, const char *value);
+
 #endif // VIMBAX_HELPERS_H_
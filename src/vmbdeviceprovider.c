@@ -0,0 +1,477 @@
+#include "vmbdeviceprovider.h"
+#include "vimbax_helpers.h"
+
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC(gst_vmb_device_provider_debug_category);
+#define GST_CAT_DEFAULT gst_vmb_device_provider_debug_category
+
+typedef enum
+{
+    GST_VMB_DISCOVERY_DETECTED,
+    GST_VMB_DISCOVERY_LOST,
+    GST_VMB_DISCOVERY_STOP
+} GstVmbDiscoveryEventType;
+
+// Camera discovery event of VimbaX, passed from the VimbaX event thread to the enumeration thread
+typedef struct
+{
+    GstVmbDiscoveryEventType type;
+    gchar *camera_id;
+} GstVmbDiscoveryEvent;
+
+// Pushed to discovery_events to end the enumeration thread
+static GstVmbDiscoveryEvent stop_event = {GST_VMB_DISCOVERY_STOP, NULL};
+
+G_DEFINE_TYPE(GstVmbDevice, gst_vmb_device, GST_TYPE_DEVICE)
+
+G_DEFINE_TYPE_WITH_CODE(GstVmbDeviceProvider,
+                        gst_vmb_device_provider,
+                        GST_TYPE_DEVICE_PROVIDER,
+                        GST_DEBUG_CATEGORY_INIT(gst_vmb_device_provider_debug_category,
+                                                "vmbdeviceprovider",
+                                                0,
+                                                "debug category for the vmbsrc device provider"))
+
+static GstElement *gst_vmb_device_create_element(GstDevice *device, const gchar *name)
+{
+    GstElement *element = gst_element_factory_make("vmbsrc", name);
+    if (element != NULL)
+    {
+        g_object_set(element, "camera", GST_VMB_DEVICE(device)->camera_id, NULL);
+    }
+    return element;
+}
+
+static gboolean gst_vmb_device_reconfigure_element(GstDevice *device, GstElement *element)
+{
+    GstElementFactory *factory = gst_element_get_factory(element);
+    if (factory == NULL || strcmp(gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory)), "vmbsrc") != 0)
+    {
+        return FALSE;
+    }
+    // The camera is only opened again when the element is started
+    if (GST_STATE(element) > GST_STATE_READY)
+    {
+        return FALSE;
+    }
+    g_object_set(element, "camera", GST_VMB_DEVICE(device)->camera_id, NULL);
+    return TRUE;
+}
+
+static void gst_vmb_device_finalize(GObject *object)
+{
+    g_free(GST_VMB_DEVICE(object)->camera_id);
+    G_OBJECT_CLASS(gst_vmb_device_parent_class)->finalize(object);
+}
+
+static void gst_vmb_device_class_init(GstVmbDeviceClass *klass)
+{
+    GstDeviceClass *device_class = GST_DEVICE_CLASS(klass);
+    device_class->create_element = gst_vmb_device_create_element;
+    device_class->reconfigure_element = gst_vmb_device_reconfigure_element;
+    G_OBJECT_CLASS(klass)->finalize = gst_vmb_device_finalize;
+}
+
+static void gst_vmb_device_init(GstVmbDevice *device)
+{
+    device->camera_id = NULL;
+}
+
+/**
+ * @brief Takes a reference to the VimbaX API for the provider unless it already holds one
+ *
+ * @param provider The provider that needs the VimbaX API
+ * @return gboolean TRUE if the VimbaX API is started
+ */
+static gboolean ensure_vimbax_api(GstVmbDeviceProvider *provider)
+{
+    gboolean has_vimbax_api;
+    g_mutex_lock(&provider->lock);
+    if (!provider->has_vimbax_api)
+    {
+        if (acquire_vimbax_api(GST_OBJECT(provider)) == VmbErrorSuccess)
+        {
+            provider->has_vimbax_api = TRUE;
+        }
+        else
+        {
+            // The open count was incremented regardless of the VmbStartup result
+            release_vimbax_api(GST_OBJECT(provider));
+        }
+    }
+    has_vimbax_api = provider->has_vimbax_api;
+    g_mutex_unlock(&provider->lock);
+    return has_vimbax_api;
+}
+
+/**
+ * @brief Creates the device for a camera. The camera is opened in read only mode to read its pixel formats, which does
+ * not interfere with applications currently using it
+ *
+ * @param provider The provider the camera was found by
+ * @param info Camera info reported by VimbaX
+ * @return GstDevice* The new device with a floating reference
+ */
+static GstDevice *create_device(GstVmbDeviceProvider *provider, const VmbCameraInfo_t *info)
+{
+    GstCaps *caps;
+    VmbHandle_t handle;
+    VmbError_t result = VmbCameraOpen(info->cameraIdString, VmbAccessModeRead, &handle);
+    if (result == VmbErrorSuccess)
+    {
+        caps = query_device_caps(GST_OBJECT(provider), handle);
+        VmbCameraClose(handle);
+    }
+    else
+    {
+        GST_WARNING_OBJECT(provider,
+                           "Could not open camera %s to read its pixel formats. Got error code: %s",
+                           info->cameraIdString,
+                           ErrorCodeToMessage(result));
+        caps = gst_caps_from_string("video/x-raw; video/x-bayer");
+    }
+
+    GstStructure *properties = gst_structure_new("vimbax-camera-properties",
+                                                 "device.api", G_TYPE_STRING, "vimbax",
+                                                 "device.id", G_TYPE_STRING, info->cameraIdString,
+                                                 "device.id-extended", G_TYPE_STRING, info->cameraIdExtended,
+                                                 "device.model", G_TYPE_STRING, info->modelName,
+                                                 "device.serial", G_TYPE_STRING, info->serialString,
+                                                 NULL);
+    gchar *display_name = g_strdup_printf("%s (%s)", info->cameraName, info->serialString);
+    GstVmbDevice *device = g_object_new(GST_TYPE_VMB_DEVICE,
+                                        "display-name",
+                                        display_name,
+                                        "caps",
+                                        caps,
+                                        "device-class",
+                                        "Video/Source",
+                                        "properties",
+                                        properties,
+                                        NULL);
+    device->camera_id = g_strdup(info->cameraIdString);
+    g_free(display_name);
+    gst_structure_free(properties);
+    gst_caps_unref(caps);
+    GST_DEBUG_OBJECT(provider, "Found camera %s", info->cameraIdString);
+    return GST_DEVICE(device);
+}
+
+/**
+ * @brief Adds a camera to the cache of the provider
+ *
+ * @param provider The provider caching the device
+ * @param info Camera info reported by VimbaX
+ * @param announce Also add the device to the devices of the started provider, which posts a device added message
+ */
+static void add_device(GstVmbDeviceProvider *provider, const VmbCameraInfo_t *info, gboolean announce)
+{
+    GstDevice *device = gst_object_ref_sink(create_device(provider, info));
+    g_mutex_lock(&provider->lock);
+    g_hash_table_replace(provider->devices, g_strdup(info->cameraIdString), gst_object_ref(device));
+    g_mutex_unlock(&provider->lock);
+    if (announce)
+    {
+        gst_device_provider_device_add(GST_DEVICE_PROVIDER(provider), device);
+    }
+    gst_object_unref(device);
+}
+
+/**
+ * @brief Removes a camera from the cache of the provider
+ *
+ * @param provider The provider caching the device
+ * @param camera_id ID of the camera that is no longer reachable
+ * @param announce Also remove the device from the devices of the started provider, which posts a device removed
+ * message
+ */
+static void remove_device(GstVmbDeviceProvider *provider, const gchar *camera_id, gboolean announce)
+{
+    gchar *key = NULL;
+    GstDevice *device = NULL;
+    g_mutex_lock(&provider->lock);
+    gboolean is_cached =
+        g_hash_table_lookup_extended(provider->devices, camera_id, (gpointer *)&key, (gpointer *)&device);
+    if (is_cached)
+    {
+        g_hash_table_steal(provider->devices, camera_id);
+    }
+    g_mutex_unlock(&provider->lock);
+    if (!is_cached)
+    {
+        return;
+    }
+    GST_DEBUG_OBJECT(provider, "Lost camera %s", camera_id);
+    if (announce && GST_OBJECT_PARENT(device) != NULL)
+    {
+        gst_device_provider_device_remove(GST_DEVICE_PROVIDER(provider), device);
+    }
+    g_free(key);
+    gst_object_unref(device);
+}
+
+/**
+ * @brief Synchronizes the cache with the cameras VimbaX currently lists. Only cameras that are not cached yet are opened
+ *
+ * @param provider The provider caching the devices
+ * @param announce Also update the devices of the started provider
+ */
+static void enumerate_cameras(GstVmbDeviceProvider *provider, gboolean announce)
+{
+    g_mutex_lock(&provider->enumeration_lock);
+    VmbUint32_t count = 0;
+    VmbError_t result = VmbCamerasList(NULL, 0, &count, sizeof(VmbCameraInfo_t));
+    VmbCameraInfo_t *cameras = g_new0(VmbCameraInfo_t, MAX(count, 1));
+    if (result == VmbErrorSuccess && count > 0)
+    {
+        // Cameras found in the meantime are reported with VmbErrorMoreData and left for the next enumeration
+        VmbUint32_t list_length = count;
+        result = VmbCamerasList(cameras, list_length, &count, sizeof(VmbCameraInfo_t));
+        count = MIN(count, list_length);
+    }
+    if (result != VmbErrorSuccess && result != VmbErrorMoreData)
+    {
+        GST_WARNING_OBJECT(provider, "Could not list cameras. Got error code: %s", ErrorCodeToMessage(result));
+        g_free(cameras);
+        g_mutex_unlock(&provider->enumeration_lock);
+        return;
+    }
+    GST_DEBUG_OBJECT(provider, "VimbaX lists %u cameras", count);
+
+    // Cameras that are no longer listed were lost while discovery events were not handled
+    GList *lost = NULL;
+    g_mutex_lock(&provider->lock);
+    GHashTableIter iter;
+    gpointer camera_id;
+    g_hash_table_iter_init(&iter, provider->devices);
+    while (g_hash_table_iter_next(&iter, &camera_id, NULL))
+    {
+        gboolean is_listed = FALSE;
+        for (VmbUint32_t i = 0; i < count && !is_listed; i++)
+        {
+            is_listed = strcmp(camera_id, cameras[i].cameraIdString) == 0;
+        }
+        if (!is_listed)
+        {
+            lost = g_list_prepend(lost, g_strdup(camera_id));
+        }
+    }
+    g_mutex_unlock(&provider->lock);
+    for (GList *item = lost; item != NULL; item = item->next)
+    {
+        remove_device(provider, item->data, announce);
+    }
+    g_list_free_full(lost, g_free);
+
+    for (VmbUint32_t i = 0; i < count; i++)
+    {
+        g_mutex_lock(&provider->lock);
+        GstDevice *device = g_hash_table_lookup(provider->devices, cameras[i].cameraIdString);
+        if (device != NULL)
+        {
+            gst_object_ref(device);
+        }
+        g_mutex_unlock(&provider->lock);
+        if (device == NULL)
+        {
+            add_device(provider, &cameras[i], announce);
+            continue;
+        }
+        // Cached while the provider was not started
+        if (announce && GST_OBJECT_PARENT(device) == NULL)
+        {
+            gst_device_provider_device_add(GST_DEVICE_PROVIDER(provider), device);
+        }
+        gst_object_unref(device);
+    }
+    g_free(cameras);
+    g_mutex_unlock(&provider->enumeration_lock);
+}
+
+/**
+ * @brief Applies a camera discovery event to the cache and the devices of the started provider
+ *
+ * @param provider The provider caching the devices
+ * @param event The event to handle
+ */
+static void handle_discovery_event(GstVmbDeviceProvider *provider, const GstVmbDiscoveryEvent *event)
+{
+    g_mutex_lock(&provider->enumeration_lock);
+    if (event->type == GST_VMB_DISCOVERY_LOST)
+    {
+        remove_device(provider, event->camera_id, TRUE);
+    }
+    else
+    {
+        g_mutex_lock(&provider->lock);
+        gboolean is_cached = g_hash_table_contains(provider->devices, event->camera_id);
+        g_mutex_unlock(&provider->lock);
+        VmbCameraInfo_t info;
+        if (!is_cached && VmbCameraInfoQuery(event->camera_id, &info, sizeof(info)) == VmbErrorSuccess)
+        {
+            add_device(provider, &info, TRUE);
+        }
+    }
+    g_mutex_unlock(&provider->enumeration_lock);
+}
+
+static gpointer enumeration_thread_func(gpointer data)
+{
+    GstVmbDeviceProvider *provider = data;
+    enumerate_cameras(provider, TRUE);
+    for (;;)
+    {
+        GstVmbDiscoveryEvent *event = g_async_queue_pop(provider->discovery_events);
+        if (event == &stop_event)
+        {
+            break;
+        }
+        handle_discovery_event(provider, event);
+        g_free(event->camera_id);
+        g_free(event);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Called by VmbC on its event thread when a camera was plugged in, removed or changed its reachability. The
+ * event is only queued, since handling it opens the camera
+ *
+ * @param handle Handle of the VimbaX system module
+ * @param name Name of the invalidated feature
+ * @param user_context The GstVmbDeviceProvider the event is queued for
+ */
+static void VMB_CALL camera_discovery_invalidated(const VmbHandle_t handle, const char *name, void *user_context)
+{
+    GstVmbDeviceProvider *provider = user_context;
+    const char *type = NULL;
+    char camera_id[256];
+    VmbUint32_t length;
+    if (VmbFeatureEnumGet(handle, "EventCameraDiscoveryType", &type) != VmbErrorSuccess ||
+        VmbFeatureStringGet(handle, "EventCameraDiscoveryCameraID", camera_id, sizeof(camera_id), &length) !=
+            VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(provider, "Could not read the values of \"%s\"", name);
+        return;
+    }
+    GstVmbDiscoveryEventType event_type;
+    if (strcmp(type, "Detected") == 0 || strcmp(type, "Reachable") == 0)
+    {
+        event_type = GST_VMB_DISCOVERY_DETECTED;
+    }
+    else if (strcmp(type, "Lost") == 0 || strcmp(type, "Unreachable") == 0)
+    {
+        event_type = GST_VMB_DISCOVERY_LOST;
+    }
+    else
+    {
+        return;
+    }
+    GST_LOG_OBJECT(provider, "Camera %s: %s", camera_id, type);
+    GstVmbDiscoveryEvent *event = g_new(GstVmbDiscoveryEvent, 1);
+    event->type = event_type;
+    event->camera_id = g_strdup(camera_id);
+    g_async_queue_push(provider->discovery_events, event);
+}
+
+static GList *gst_vmb_device_provider_probe(GstDeviceProvider *device_provider)
+{
+    GstVmbDeviceProvider *provider = GST_VMB_DEVICE_PROVIDER(device_provider);
+    if (!ensure_vimbax_api(provider))
+    {
+        return NULL;
+    }
+    enumerate_cameras(provider, FALSE);
+
+    GList *devices = NULL;
+    g_mutex_lock(&provider->lock);
+    GHashTableIter iter;
+    gpointer device;
+    g_hash_table_iter_init(&iter, provider->devices);
+    while (g_hash_table_iter_next(&iter, NULL, &device))
+    {
+        devices = g_list_prepend(devices, gst_object_ref(device));
+    }
+    g_mutex_unlock(&provider->lock);
+    return devices;
+}
+
+static gboolean gst_vmb_device_provider_start(GstDeviceProvider *device_provider)
+{
+    GstVmbDeviceProvider *provider = GST_VMB_DEVICE_PROVIDER(device_provider);
+    if (!ensure_vimbax_api(provider))
+    {
+        return FALSE;
+    }
+    VmbError_t result = VmbFeatureInvalidationRegister(gVmbHandle,
+                                                       "EventCameraDiscovery",
+                                                       camera_discovery_invalidated,
+                                                       provider);
+    if (result != VmbErrorSuccess)
+    {
+        GST_WARNING_OBJECT(provider,
+                           "Could not register for camera discovery events. Cameras plugged in or removed later are "
+                           "not reported. Got error code: %s",
+                           ErrorCodeToMessage(result));
+    }
+    // Opening the cameras to read their caps can take seconds, so start returns right away and devices are added as
+    // they are found
+    provider->enumeration_thread = g_thread_new("vmbdeviceprovider", enumeration_thread_func, provider);
+    return TRUE;
+}
+
+static void gst_vmb_device_provider_stop(GstDeviceProvider *device_provider)
+{
+    GstVmbDeviceProvider *provider = GST_VMB_DEVICE_PROVIDER(device_provider);
+    VmbFeatureInvalidationUnregister(gVmbHandle, "EventCameraDiscovery", camera_discovery_invalidated);
+    g_async_queue_push(provider->discovery_events, &stop_event);
+    g_thread_join(provider->enumeration_thread);
+    provider->enumeration_thread = NULL;
+    // Events queued after the thread ended
+    GstVmbDiscoveryEvent *event;
+    while ((event = g_async_queue_try_pop(provider->discovery_events)) != NULL)
+    {
+        g_free(event->camera_id);
+        g_free(event);
+    }
+}
+
+static void gst_vmb_device_provider_finalize(GObject *object)
+{
+    GstVmbDeviceProvider *provider = GST_VMB_DEVICE_PROVIDER(object);
+    g_hash_table_unref(provider->devices);
+    g_async_queue_unref(provider->discovery_events);
+    if (provider->has_vimbax_api)
+    {
+        release_vimbax_api(GST_OBJECT(provider));
+    }
+    g_mutex_clear(&provider->lock);
+    g_mutex_clear(&provider->enumeration_lock);
+    G_OBJECT_CLASS(gst_vmb_device_provider_parent_class)->finalize(object);
+}
+
+static void gst_vmb_device_provider_class_init(GstVmbDeviceProviderClass *klass)
+{
+    GstDeviceProviderClass *provider_class = GST_DEVICE_PROVIDER_CLASS(klass);
+    provider_class->probe = gst_vmb_device_provider_probe;
+    provider_class->start = gst_vmb_device_provider_start;
+    provider_class->stop = gst_vmb_device_provider_stop;
+    G_OBJECT_CLASS(klass)->finalize = gst_vmb_device_provider_finalize;
+
+    gst_device_provider_class_set_static_metadata(provider_class,
+                                                  "VimbaX Device Provider",
+                                                  "Source/Video",
+                                                  "Lists cameras that can be used with vmbsrc",
+                                                  "Allied Vision Technologies GmbH");
+}
+
+static void gst_vmb_device_provider_init(GstVmbDeviceProvider *provider)
+{
+    provider->has_vimbax_api = FALSE;
+    provider->devices = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, gst_object_unref);
+    g_mutex_init(&provider->lock);
+    g_mutex_init(&provider->enumeration_lock);
+    provider->discovery_events = g_async_queue_new();
+    provider->enumeration_thread = NULL;
+}
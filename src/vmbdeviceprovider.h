@@ -0,0 +1,65 @@
+#ifndef VMBDEVICEPROVIDER_H_
+#define VMBDEVICEPROVIDER_H_
+
+#include <gst/gst.h>
+
+#include <VmbC/VmbC.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_VMB_DEVICE (gst_vmb_device_get_type())
+#define GST_VMB_DEVICE(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_VMB_DEVICE, GstVmbDevice))
+#define GST_TYPE_VMB_DEVICE_PROVIDER (gst_vmb_device_provider_get_type())
+#define GST_VMB_DEVICE_PROVIDER(obj) \
+    (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_VMB_DEVICE_PROVIDER, GstVmbDeviceProvider))
+
+// Camera found by the device provider. Creates vmbsrc elements with the "camera" property set to its ID
+typedef struct
+{
+    GstDevice parent;
+
+    gchar *camera_id;
+} GstVmbDevice;
+
+typedef struct
+{
+    GstDeviceClass parent_class;
+} GstVmbDeviceClass;
+
+// Lists the cameras reachable via VimbaX. Found devices are cached together with their supported caps, so later
+// enumerations only open cameras that were not seen before. Starting the provider enumerates the cameras on a separate
+// thread, which then updates the cache from the camera discovery events of VimbaX. The provider keeps its reference to
+// the VimbaX API until it is finalized, so that vmbsrc elements created from its devices do not start the API again
+typedef struct
+{
+    GstDeviceProvider parent;
+
+    // Holds a reference to the VimbaX API acquired with acquire_vimbax_api
+    gboolean has_vimbax_api;
+    // Cached GstVmbDevices by camera ID. Protected by lock
+    GHashTable *devices;
+    GMutex lock;
+    // Serializes enumerations and the handling of discovery events, so that no camera is opened twice to read its caps
+    GMutex enumeration_lock;
+    // Discovery events handled by the enumeration thread, which runs while the provider is started
+    GAsyncQueue *discovery_events;
+    GThread *enumeration_thread;
+} GstVmbDeviceProvider;
+
+typedef struct
+{
+    GstDeviceProviderClass parent_class;
+} GstVmbDeviceProviderClass;
+
+GType gst_vmb_device_get_type(void);
+GType gst_vmb_device_provider_get_type(void);
+
+// Implemented in gstvmbsrc.c, which holds the reference count of the VimbaX API and the mapping of pixel formats
+VmbError_t acquire_vimbax_api(GstObject *owner);
+void release_vimbax_api(GstObject *owner);
+// Caps of all formats the opened camera can output, with the sensor size as upper bound of width and height
+GstCaps *query_device_caps(GstObject *owner, VmbHandle_t camera_handle);
+
+G_END_DECLS
+
+#endif // VMBDEVICEPROVIDER_H_
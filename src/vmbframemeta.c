@@ -0,0 +1,60 @@
+#include "vmbframemeta.h"
+
+#include <string.h>
+
+static gboolean gst_vmb_frame_meta_init(GstMeta *meta, gpointer params, GstBuffer *buffer)
+{
+    (void)buffer;
+    GstVmbFrameMeta *frame_meta = (GstVmbFrameMeta *)meta;
+    if (params != NULL)
+    {
+        frame_meta->values = *(const GstVmbChunkValues *)params;
+    }
+    else
+    {
+        memset(&frame_meta->values, 0, sizeof(frame_meta->values));
+    }
+    return TRUE;
+}
+
+static gboolean gst_vmb_frame_meta_transform(GstBuffer *dest, GstMeta *meta, GstBuffer *buffer, GQuark type, gpointer data)
+{
+    (void)buffer;
+    (void)type;
+    (void)data;
+    // The values describe the acquisition of the whole frame and stay valid for every transformation of the buffer
+    return gst_buffer_add_vmb_frame_meta(dest, &((GstVmbFrameMeta *)meta)->values) != NULL;
+}
+
+GType gst_vmb_frame_meta_api_get_type(void)
+{
+    static GType type = 0;
+    static const gchar *tags[] = {NULL};
+    if (g_once_init_enter(&type))
+    {
+        GType api_type = gst_meta_api_type_register("GstVmbFrameMetaAPI", tags);
+        g_once_init_leave(&type, api_type);
+    }
+    return type;
+}
+
+const GstMetaInfo *gst_vmb_frame_meta_get_info(void)
+{
+    static const GstMetaInfo *meta_info = NULL;
+    if (g_once_init_enter(&meta_info))
+    {
+        const GstMetaInfo *info = gst_meta_register(GST_VMB_FRAME_META_API_TYPE,
+                                                    "GstVmbFrameMeta",
+                                                    sizeof(GstVmbFrameMeta),
+                                                    gst_vmb_frame_meta_init,
+                                                    NULL,
+                                                    gst_vmb_frame_meta_transform);
+        g_once_init_leave(&meta_info, info);
+    }
+    return meta_info;
+}
+
+GstVmbFrameMeta *gst_buffer_add_vmb_frame_meta(GstBuffer *buffer, const GstVmbChunkValues *values)
+{
+    return (GstVmbFrameMeta *)gst_buffer_add_meta(buffer, GST_VMB_FRAME_META_INFO, (gpointer)values);
+}
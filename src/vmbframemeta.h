@@ -0,0 +1,58 @@
+#ifndef VMBFRAMEMETA_H_
+#define VMBFRAMEMETA_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+// Chunks whose values can be attached to buffers. The values double as flags of the "chunkmode" property of vmbsrc
+typedef enum
+{
+    GST_VMB_CHUNK_EXPOSURE_TIME = 1 << 0,
+    GST_VMB_CHUNK_GAIN = 1 << 1,
+    GST_VMB_CHUNK_FRAME_ID = 1 << 2,
+    GST_VMB_CHUNK_LINE_STATUS_ALL = 1 << 3,
+    GST_VMB_CHUNK_TIMESTAMP = 1 << 4
+} GstVmbChunkFlags;
+
+// Values of the chunks the camera transmitted together with the image data of a frame
+typedef struct
+{
+    // GstVmbChunkFlags of the values that were read from the chunk data. All other values are 0
+    guint fields;
+    // ChunkExposureTime in microseconds
+    gdouble exposure_time;
+    // ChunkGain in dB
+    gdouble gain;
+    guint64 frame_id;
+    // ChunkLineStatusAll. Bit n holds the status of Line n
+    guint64 line_status_all;
+    // ChunkTimestamp in device timestamp ticks
+    guint64 timestamp;
+    // ID returned by the "trigger" action signal of vmbsrc for the software trigger the frame was assigned to. 0 if the
+    // frame was not captured for one. Best-effort, as a trigger ignored by the camera shifts the IDs of the following
+    // frames. Not a chunk, so it has no flag in fields
+    guint64 trigger_id;
+} GstVmbChunkValues;
+
+// Acquisition metadata of the frame a buffer was created from
+typedef struct
+{
+    GstMeta meta;
+    GstVmbChunkValues values;
+} GstVmbFrameMeta;
+
+GType gst_vmb_frame_meta_api_get_type(void);
+#define GST_VMB_FRAME_META_API_TYPE (gst_vmb_frame_meta_api_get_type())
+
+const GstMetaInfo *gst_vmb_frame_meta_get_info(void);
+#define GST_VMB_FRAME_META_INFO (gst_vmb_frame_meta_get_info())
+
+#define gst_buffer_get_vmb_frame_meta(b) ((GstVmbFrameMeta *)gst_buffer_get_meta((b), GST_VMB_FRAME_META_API_TYPE))
+
+// attach a GstVmbFrameMeta holding a copy of values to buffer
+GstVmbFrameMeta *gst_buffer_add_vmb_frame_meta(GstBuffer *buffer, const GstVmbChunkValues *values);
+
+G_END_DECLS
+
+#endif // VMBFRAMEMETA_H_
@@ -0,0 +1,130 @@
+#include "vmbroipad.h"
+
+enum
+{
+    PROP_0,
+    PROP_X,
+    PROP_Y,
+    PROP_WIDTH,
+    PROP_HEIGHT
+};
+
+G_DEFINE_TYPE(GstVmbRoiPad, gst_vmb_roi_pad, GST_TYPE_PAD)
+
+static void gst_vmb_roi_pad_set_property(GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+    GstVmbRoiPad *pad = GST_VMB_ROI_PAD(object);
+    GST_OBJECT_LOCK(pad);
+    switch (property_id)
+    {
+    case PROP_X:
+        pad->x = g_value_get_uint(value);
+        break;
+    case PROP_Y:
+        pad->y = g_value_get_uint(value);
+        break;
+    case PROP_WIDTH:
+        pad->width = g_value_get_uint(value);
+        break;
+    case PROP_HEIGHT:
+        pad->height = g_value_get_uint(value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+        break;
+    }
+    pad->is_region_changed = TRUE;
+    GST_OBJECT_UNLOCK(pad);
+}
+
+static void gst_vmb_roi_pad_get_property(GObject *object, guint property_id, GValue *value, GParamSpec *pspec)
+{
+    GstVmbRoiPad *pad = GST_VMB_ROI_PAD(object);
+    GST_OBJECT_LOCK(pad);
+    switch (property_id)
+    {
+    case PROP_X:
+        g_value_set_uint(value, pad->x);
+        break;
+    case PROP_Y:
+        g_value_set_uint(value, pad->y);
+        break;
+    case PROP_WIDTH:
+        g_value_set_uint(value, pad->width);
+        break;
+    case PROP_HEIGHT:
+        g_value_set_uint(value, pad->height);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+        break;
+    }
+    GST_OBJECT_UNLOCK(pad);
+}
+
+static void gst_vmb_roi_pad_finalize(GObject *object)
+{
+    GstVmbRoiPad *pad = GST_VMB_ROI_PAD(object);
+    gst_caps_replace(&pad->caps, NULL);
+    G_OBJECT_CLASS(gst_vmb_roi_pad_parent_class)->finalize(object);
+}
+
+static void gst_vmb_roi_pad_class_init(GstVmbRoiPadClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+    gobject_class->set_property = gst_vmb_roi_pad_set_property;
+    gobject_class->get_property = gst_vmb_roi_pad_get_property;
+    gobject_class->finalize = gst_vmb_roi_pad_finalize;
+
+    g_object_class_install_property(
+        gobject_class,
+        PROP_X,
+        g_param_spec_uint(
+            "x",
+            "X",
+            "Horizontal offset of the region in the acquired frame in pixels",
+            0,
+            G_MAXINT,
+            0,
+            G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_Y,
+        g_param_spec_uint(
+            "y",
+            "Y",
+            "Vertical offset of the region in the acquired frame in pixels",
+            0,
+            G_MAXINT,
+            0,
+            G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_WIDTH,
+        g_param_spec_uint(
+            "width",
+            "Width",
+            "Width of the region in pixels. 0 to extend it to the right edge of the frame",
+            0,
+            G_MAXINT,
+            0,
+            G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class,
+        PROP_HEIGHT,
+        g_param_spec_uint(
+            "height",
+            "Height",
+            "Height of the region in pixels. 0 to extend it to the bottom edge of the frame",
+            0,
+            G_MAXINT,
+            0,
+            G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS));
+}
+
+static void gst_vmb_roi_pad_init(GstVmbRoiPad *pad)
+{
+    pad->needs_stream_start = TRUE;
+    gst_video_info_init(&pad->frame_info);
+    gst_video_info_init(&pad->region_info);
+}
@@ -0,0 +1,52 @@
+#ifndef VMBROIPAD_H_
+#define VMBROIPAD_H_
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_VMB_ROI_PAD (gst_vmb_roi_pad_get_type())
+#define GST_VMB_ROI_PAD(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_VMB_ROI_PAD, GstVmbRoiPad))
+
+// Request src pad of vmbsrc outputting a sub-rectangle of every acquired frame
+typedef struct
+{
+    GstPad parent;
+
+    // Region given by the pad properties. Protected by the object lock of the pad. A width or height of 0 extends the
+    // region to the right or bottom edge of the frame
+    guint x;
+    guint y;
+    guint width;
+    guint height;
+    // Set when the region changed, so that new caps are pushed with the next buffer
+    gboolean is_region_changed;
+
+    // Set until the stream-start and segment of the next stream were pushed. Protected by the object lock of the pad,
+    // as the event thread of VimbaX reads it before pushing camera events on the pad
+    gboolean needs_stream_start;
+
+    // Streaming state. Only accessed by the streaming thread of vmbsrc
+    // Caps last pushed on the pad. NULL until the first buffer after start
+    GstCaps *caps;
+    // Frame layout the region was last computed for
+    GstVideoInfo frame_info;
+    // Region clamped to the negotiated frame size and aligned to the chroma subsampling of the format
+    guint region_x;
+    guint region_y;
+    GstVideoInfo region_info;
+    // Downstream supports GstVideoMeta, so buffers can be views of the frame instead of cropped copies
+    gboolean has_video_meta;
+} GstVmbRoiPad;
+
+typedef struct
+{
+    GstPadClass parent_class;
+} GstVmbRoiPadClass;
+
+GType gst_vmb_roi_pad_get_type(void);
+
+G_END_DECLS
+
+#endif // VMBROIPAD_H_
@@ -0,0 +1,25 @@
+#include "vmbstreampad.h"
+
+G_DEFINE_TYPE(GstVmbStreamPad, gst_vmb_stream_pad, GST_TYPE_PAD)
+
+static void gst_vmb_stream_pad_finalize(GObject *object)
+{
+    GstVmbStreamPad *pad = GST_VMB_STREAM_PAD(object);
+    gst_caps_replace(&pad->caps, NULL);
+    g_async_queue_unref(pad->filled_frames);
+    g_mutex_clear(&pad->lock);
+    G_OBJECT_CLASS(gst_vmb_stream_pad_parent_class)->finalize(object);
+}
+
+static void gst_vmb_stream_pad_class_init(GstVmbStreamPadClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+    gobject_class->finalize = gst_vmb_stream_pad_finalize;
+}
+
+static void gst_vmb_stream_pad_init(GstVmbStreamPad *pad)
+{
+    pad->filled_frames = g_async_queue_new();
+    g_mutex_init(&pad->lock);
+    pad->needs_stream_start = TRUE;
+}
@@ -0,0 +1,54 @@
+#ifndef VMBSTREAMPAD_H_
+#define VMBSTREAMPAD_H_
+
+#include <gst/gst.h>
+
+#include <VmbC/VmbC.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_VMB_STREAM_PAD (gst_vmb_stream_pad_get_type())
+#define GST_VMB_STREAM_PAD(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_VMB_STREAM_PAD, GstVmbStreamPad))
+
+// Request src pad of vmbsrc outputting the frames of an additional stream of the camera. Every stream pad captures into
+// its own announced frames, copies them into buffers of its own pool and pushes them from its own task
+typedef struct
+{
+    GstPad parent;
+
+    // Index of the stream in the stream handles of the camera. Stream 0 is output on the always src pad of vmbsrc
+    guint stream_index;
+
+    // Capture state. Set up when vmbsrc is started, or when the pad is requested while vmbsrc is started, and torn down
+    // when it is stopped
+    VmbHandle_t stream_handle;
+    // Frames announced to the stream. Their buffers are allocated by the transport layer
+    VmbFrame_t *frames;
+    guint num_frames;
+    // Filled frames placed by the frame callback of the stream and taken by the task of the pad
+    GAsyncQueue *filled_frames;
+    GstBufferPool *pool;
+    // Protects is_capturing and capture_generation against a concurrent restart of the acquisition
+    GMutex lock;
+    gboolean is_capturing;
+    // Incremented every time the capture is started. Frames queued for an earlier capture are discarded by the task
+    guint capture_generation;
+
+    // Set until the stream-start and segment of the next stream were pushed. Protected by the object lock of the pad,
+    // as the event thread of VimbaX reads it before pushing camera events on the pad
+    gboolean needs_stream_start;
+
+    // Caps last pushed on the pad. Only accessed by the task of the pad, which drops them with every stream-start
+    GstCaps *caps;
+} GstVmbStreamPad;
+
+typedef struct
+{
+    GstPadClass parent_class;
+} GstVmbStreamPadClass;
+
+GType gst_vmb_stream_pad_get_type(void);
+
+G_END_DECLS
+
+#endif // VMBSTREAMPAD_H_
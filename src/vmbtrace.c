@@ -0,0 +1,110 @@
+// GstTracerRecord is not covered by the API stability guarantees of GStreamer
+#define GST_USE_UNSTABLE_API
+
+#include "vmbtrace.h"
+
+#ifdef GST_VMB_ENABLE_LTTNG
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "vmbtrace_lttng.h"
+#endif
+
+// Names of the stages as they appear in the "stage" field of the records. Parsed by bench/vmbsrc_trace_stats.py
+static const char *stage_names[NUM_GST_VMB_TRACE_STAGES] = {
+    "announce",
+    "queue",
+    "callback",
+    "dequeue",
+    "copy-start",
+    "copy-end",
+    "requeue",
+    "push",
+};
+
+static GstTracerRecord *frame_record = NULL;
+static GstDebugCategory *tracer_category = NULL;
+
+static gpointer register_frame_record(gpointer data)
+{
+    (void)data;
+    GST_DEBUG_CATEGORY_GET(tracer_category, "GST_TRACER");
+    frame_record = gst_tracer_record_new("vmbsrc-frame.class",
+                                         "element",
+                                         GST_TYPE_STRUCTURE,
+                                         gst_structure_new("value",
+                                                           "type",
+                                                           G_TYPE_GTYPE,
+                                                           G_TYPE_STRING,
+                                                           "related-to",
+                                                           GST_TYPE_TRACER_VALUE_SCOPE,
+                                                           GST_TRACER_VALUE_SCOPE_ELEMENT,
+                                                           NULL),
+                                         "stage",
+                                         GST_TYPE_STRUCTURE,
+                                         gst_structure_new("value",
+                                                           "type",
+                                                           G_TYPE_GTYPE,
+                                                           G_TYPE_STRING,
+                                                           "related-to",
+                                                           GST_TYPE_TRACER_VALUE_SCOPE,
+                                                           GST_TRACER_VALUE_SCOPE_PROCESS,
+                                                           NULL),
+                                         "frame",
+                                         GST_TYPE_STRUCTURE,
+                                         gst_structure_new("value",
+                                                           "type",
+                                                           G_TYPE_GTYPE,
+                                                           G_TYPE_UINT64,
+                                                           "related-to",
+                                                           GST_TYPE_TRACER_VALUE_SCOPE,
+                                                           GST_TRACER_VALUE_SCOPE_PROCESS,
+                                                           NULL),
+                                         "frame-id",
+                                         GST_TYPE_STRUCTURE,
+                                         gst_structure_new("value",
+                                                           "type",
+                                                           G_TYPE_GTYPE,
+                                                           G_TYPE_UINT64,
+                                                           "related-to",
+                                                           GST_TYPE_TRACER_VALUE_SCOPE,
+                                                           GST_TRACER_VALUE_SCOPE_PROCESS,
+                                                           NULL),
+                                         "ts",
+                                         GST_TYPE_STRUCTURE,
+                                         gst_structure_new("value",
+                                                           "type",
+                                                           G_TYPE_GTYPE,
+                                                           G_TYPE_UINT64,
+                                                           "related-to",
+                                                           GST_TYPE_TRACER_VALUE_SCOPE,
+                                                           GST_TRACER_VALUE_SCOPE_PROCESS,
+                                                           NULL),
+                                         NULL);
+    // The record lives as long as the plugin
+    GST_OBJECT_FLAG_SET(frame_record, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+    return NULL;
+}
+
+void gst_vmb_trace_init(void)
+{
+    static GOnce once = G_ONCE_INIT;
+    g_once(&once, register_frame_record, NULL);
+}
+
+void gst_vmb_trace(GstElement *element, GstVmbTraceStage stage, const void *frame, guint64 frame_id)
+{
+    guint64 address = (guint64)(guintptr)frame;
+#ifdef GST_VMB_ENABLE_LTTNG
+    tracepoint(vmbsrc, frame, GST_ELEMENT_NAME(element), stage_names[stage], address, frame_id);
+#endif
+    // Reading the clock is skipped unless the records are logged
+    if (gst_debug_category_get_threshold(tracer_category) >= GST_LEVEL_TRACE)
+    {
+        gst_tracer_record_log(frame_record,
+                              GST_ELEMENT_NAME(element),
+                              stage_names[stage],
+                              address,
+                              frame_id,
+                              gst_util_get_timestamp());
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef VMBTRACE_H_
+#define VMBTRACE_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+// Stages of the lifecycle of a frame that are traced if the plugin is built with ENABLE_TRACING
+typedef enum
+{
+    // The frame was announced to the stream
+    GST_VMB_TRACE_ANNOUNCE,
+    // The frame is handed to the capture engine via VmbCaptureFrameQueue
+    GST_VMB_TRACE_QUEUE,
+    // vimbax_frame_callback was called for the filled frame
+    GST_VMB_TRACE_CALLBACK,
+    // The streaming thread took the filled frame from the queue of filled frames
+    GST_VMB_TRACE_DEQUEUE,
+    // The image data of the frame is copied (and converted) into an output buffer
+    GST_VMB_TRACE_COPY_START,
+    GST_VMB_TRACE_COPY_END,
+    // Output no longer needs the frame, so it is returned to the capture engine
+    GST_VMB_TRACE_REQUEUE,
+    // The buffer created from the frame is pushed downstream
+    GST_VMB_TRACE_PUSH,
+    NUM_GST_VMB_TRACE_STAGES
+} GstVmbTraceStage;
+
+#ifdef GST_VMB_ENABLE_TRACING
+// Registers the "vmbsrc-frame" tracer record and, if built with ENABLE_LTTNG, the LTTng tracepoint provider
+void gst_vmb_trace_init(void);
+
+// Logs a "vmbsrc-frame" record to the GST_TRACER debug category (if its threshold is TRACE) and emits the
+// vmbsrc:frame LTTng tracepoint (if enabled in the LTTng session). frame is the address of the VmbFrame_t, which
+// identifies the frame buffer across its lifecycle
+void gst_vmb_trace(GstElement *element, GstVmbTraceStage stage, const void *frame, guint64 frame_id);
+
+#define GST_VMB_TRACE_INIT() gst_vmb_trace_init()
+#define GST_VMB_TRACE(element, stage, frame, frame_id) gst_vmb_trace(GST_ELEMENT(element), stage, frame, frame_id)
+#else
+// Trace points are compiled out, so they cost nothing
+#define GST_VMB_TRACE_INIT() ((void)0)
+#define GST_VMB_TRACE(element, stage, frame, frame_id) ((void)0)
+#endif // GST_VMB_ENABLE_TRACING
+
+G_END_DECLS
+
+#endif // VMBTRACE_H_
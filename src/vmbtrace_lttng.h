@@ -0,0 +1,24 @@
+// LTTng-UST tracepoint provider of vmbsrc. Only used if the plugin is built with ENABLE_LTTNG. Record with
+//   lttng create vmbsrc && lttng enable-event --userspace 'vmbsrc:*' && lttng start
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER vmbsrc
+
+#undef TRACEPOINT_INCLUDE
+// Resolved from the include path of lttng/tracepoint-event.h, which is why src is added to the include directories
+#define TRACEPOINT_INCLUDE "vmbtrace_lttng.h"
+
+#if !defined(VMBTRACE_LTTNG_H_) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define VMBTRACE_LTTNG_H_
+
+#include <lttng/tracepoint.h>
+
+// Fields match the "vmbsrc-frame" tracer record, except for the timestamp, which LTTng records itself
+TRACEPOINT_EVENT(vmbsrc,
+                 frame,
+                 TP_ARGS(const char *, element, const char *, stage, uint64_t, frame, uint64_t, frame_id),
+                 TP_FIELDS(ctf_string(element, element) ctf_string(stage, stage) ctf_integer_hex(uint64_t, frame, frame)
+                               ctf_integer(uint64_t, frame_id, frame_id)))
+
+#endif // VMBTRACE_LTTNG_H_
+
+#include <lttng/tracepoint-event.h>